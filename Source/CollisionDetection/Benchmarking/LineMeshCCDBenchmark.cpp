@@ -0,0 +1,103 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCollisionData.h"
+#include "imstkLineMesh.h"
+#include "imstkLineMeshToLineMeshCCD.h"
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace imstk;
+
+///
+/// \brief Coiled thread of numSegments segments around the x axis, pitch is the
+/// distance between the turns
+///
+std::shared_ptr<LineMesh>
+makeCoil(const int numSegments, const double pitch)
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(numSegments + 1);
+    auto lines    = std::make_shared<VecDataArray<int, 2>>(numSegments);
+    for (int i = 0; i < numSegments + 1; i++)
+    {
+        // 16 segments a turn
+        const double angle = i * 2.0 * PI / 16.0;
+        (*vertices)[i] = Vec3d(angle / (2.0 * PI) * pitch, std::cos(angle) * 0.01, std::sin(angle) * 0.01);
+    }
+    for (int i = 0; i < numSegments; i++)
+    {
+        (*lines)[i] = Vec2i(i, i + 1);
+    }
+
+    auto mesh = std::make_shared<LineMesh>();
+    mesh->initialize(vertices, lines);
+    return mesh;
+}
+
+///
+/// \brief Self collision of a tightly coiled thread moving sideways, its turns
+/// closer than the thread thickness
+///
+static void
+BM_LineMeshToLineMeshCCDSelf(benchmark::State& state)
+{
+    const int numSegments = static_cast<int>(state.range(0));
+    auto      prevMesh    = makeCoil(numSegments, 0.0015);
+    auto      mesh        = makeCoil(numSegments, 0.0015);
+    mesh->translate(Vec3d(0.0, 0.001, 0.0), Geometry::TransformType::ApplyToData);
+
+    LineMeshToLineMeshCCD cd;
+    cd.setInputGeometryA(mesh);
+    cd.setInputGeometryB(mesh);
+    cd.setGenerateCD(true, true);
+
+    for (auto _ : state)
+    {
+        cd.updatePreviousTimestepGeometry(prevMesh, prevMesh);
+        cd.update();
+    }
+
+    state.counters["Segments"] = numSegments;
+    state.counters["Contacts"] = static_cast<double>(cd.getCollisionData()->elementsA.size());
+}
+
+BENCHMARK(BM_LineMeshToLineMeshCCDSelf)
+->Unit(benchmark::kMicrosecond)->Arg(64)->Arg(128)->Arg(256)->Arg(512)->Arg(1024)->Arg(2048);
+
+///
+/// \brief Two coiled threads, one moving through the other
+///
+static void
+BM_LineMeshToLineMeshCCD(benchmark::State& state)
+{
+    const int numSegments = static_cast<int>(state.range(0));
+    auto      meshA       = makeCoil(numSegments, 0.004);
+    auto      prevMeshB   = makeCoil(numSegments, 0.004);
+    auto      meshB       = makeCoil(numSegments, 0.004);
+    meshB->translate(Vec3d(0.0, 0.005, 0.0), Geometry::TransformType::ApplyToData);
+
+    LineMeshToLineMeshCCD cd;
+    cd.setInputGeometryA(meshA);
+    cd.setInputGeometryB(meshB);
+    cd.setGenerateCD(true, true);
+
+    for (auto _ : state)
+    {
+        cd.updatePreviousTimestepGeometry(meshA, prevMeshB);
+        cd.update();
+    }
+
+    state.counters["Segments"] = numSegments;
+    state.counters["Contacts"] = static_cast<double>(cd.getCollisionData()->elementsA.size());
+}
+
+BENCHMARK(BM_LineMeshToLineMeshCCD)
+->Unit(benchmark::kMicrosecond)->Arg(64)->Arg(128)->Arg(256)->Arg(512)->Arg(1024)->Arg(2048);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -20,6 +20,7 @@
 #include "imstkSphere.h"
 #include "imstkSurfaceMesh.h"
 #include "imstkSurfaceMeshToCapsuleCD.h"
+#include "imstkSurfaceMeshToSurfaceMeshCD.h"
 #include "imstkTetrahedralMesh.h"
 #include "imstkGeometryUtilities.h"
 
@@ -60,5 +61,30 @@ BM_SurfaceMeshToCapsuleCD(benchmark::State& state)
 BENCHMARK(BM_SurfaceMeshToCapsuleCD)
 ->Unit(benchmark::kMicrosecond)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12)->Arg(16)->Arg(24)->Arg(32)->Arg(48)->Arg(62)->Arg(78)->Arg(100);
 
+///
+/// \brief Mesh to mesh collision of two perpendicular crossing triangle grids
+/// with and without the AabbTree broad phase
+///
+static void
+BM_SurfaceMeshToSurfaceMeshCD(benchmark::State& state)
+{
+    auto meshA = makeSurfaceMesh(state.range(0));
+    auto meshB = GeometryUtils::toTriangleGrid(Vec3d{ 0.01, 0, 0.01 }, Vec2d{ 1, 1 }, Vec2i{ state.range(0), state.range(0) },
+        Quatd(Rotd(PI_2, Vec3d{ 1, 0, 0 })));
+
+    SurfaceMeshToSurfaceMeshCD cd;
+    cd.setInputGeometryA(meshA);
+    cd.setInputGeometryB(meshB);
+    cd.setBroadPhaseEnabled(state.range(1) != 0);
+
+    for (auto _ : state)
+    {
+        cd.update();
+    }
+}
+
+BENCHMARK(BM_SurfaceMeshToSurfaceMeshCD)
+->Unit(benchmark::kMicrosecond)->ArgsProduct({ { 4, 8, 16, 32, 62 }, { 0, 1 } });
+
 // Run the benchmark
 BENCHMARK_MAIN();
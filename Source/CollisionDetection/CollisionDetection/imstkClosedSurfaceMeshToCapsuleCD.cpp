@@ -43,7 +43,6 @@ ClosedSurfaceMeshToCapsuleCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
 
     // \todo: Doesn't remove duplicate contacts (shared edges), refer to SurfaceMeshCD for easy method to do so
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int cellId)
         {
             const Vec3i& cell = indices[cellId];
@@ -133,10 +132,7 @@ ClosedSurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
                 // Capsule body intersecting triangle
                 else if (caseType == 2)
@@ -163,12 +159,11 @@ ClosedSurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
             }
         }, surfMesh->getNumTriangles() > 200);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
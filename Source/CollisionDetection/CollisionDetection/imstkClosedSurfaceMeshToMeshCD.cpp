@@ -7,6 +7,7 @@
 #include "imstkClosedSurfaceMeshToMeshCD.h"
 #include "imstkCollisionUtils.h"
 #include "imstkLineMesh.h"
+#include "imstkParallelFor.h"
 #include "imstkSurfaceMesh.h"
 #include "imstkVecDataArray.h"
 
@@ -97,7 +98,7 @@ struct PointSetData
 
 struct SurfMeshData
 {
-    SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh);
+    SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh, const AabbTree* tree);
 
     // Get geometry B data
     std::shared_ptr<SurfaceMesh> m_surfMesh;
@@ -105,6 +106,7 @@ struct SurfMeshData
     const VecDataArray<double, 3>& vertices;
     const std::vector<std::unordered_set<int>>& vertexFaces;
     const VecDataArray<double, 3>& faceNormals;
+    const AabbTree* tree; ///< Tree over the cells, nullptr to test every cell
 };
 
 PointSetData::PointSetData(std::shared_ptr<PointSet> pointSet) :
@@ -113,12 +115,13 @@ PointSetData::PointSetData(std::shared_ptr<PointSet> pointSet) :
 {
 }
 
-SurfMeshData::SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh) :
+SurfMeshData::SurfMeshData(std::shared_ptr<SurfaceMesh> surfMesh, const AabbTree* tree) :
     m_surfMesh(surfMesh),
     cells(*surfMesh->getCells()),
     vertices(*surfMesh->getVertexPositions()),
     vertexFaces(surfMesh->getVertexToCellMap()),
-    faceNormals(*surfMesh->getCellNormals())
+    faceNormals(*surfMesh->getCellNormals()),
+    tree(tree)
 {
 }
 
@@ -211,22 +214,40 @@ polySignedDist(const Vec3d& pos, const SurfMeshData& surfMeshData,
 
     // Find the closest point out of all elements
     // \todo: We could early reject backface cull all triangles (this is effectively case 6 done early)
-    for (int j = 0; j < surfMeshData.cells.size(); j++)
+    auto testCell =
+        [&](const int j)
+        {
+            const Vec3i& cell = surfMeshData.cells[j];
+            const Vec3d& x1   = surfMeshData.vertices[cell[0]];
+            const Vec3d& x2   = surfMeshData.vertices[cell[1]];
+            const Vec3d& x3   = surfMeshData.vertices[cell[2]];
+
+            int          ptOnTriangleCaseType;
+            const Vec3d  closestPtOnTri = CollisionUtils::closestPointOnTriangle(pos, x1, x2, x3, ptOnTriangleCaseType);
+            const double sqrDist = (closestPtOnTri - pos).squaredNorm();
+            // On ties keep the lowest cell id, the same as testing the cells in order
+            if (sqrDist < minSqrDist || (sqrDist == minSqrDist && j < closestCell))
+            {
+                minSqrDist      = sqrDist;
+                closestPt       = closestPtOnTri;
+                closestCell     = j;
+                closestCellCase = ptOnTriangleCaseType;
+            }
+        };
+    if (surfMeshData.tree != nullptr)
+    {
+        surfMeshData.tree->visitNearest(
+            [&](const Vec3d& lowerCorner, const Vec3d& upperCorner)
+            {
+                return AabbTree::pointToBoxSqrDist(pos, lowerCorner, upperCorner);
+            },
+            [&](const int j, double&) { testCell(j); }, minSqrDist);
+    }
+    else
     {
-        const Vec3i& cell = surfMeshData.cells[j];
-        const Vec3d& x1   = surfMeshData.vertices[cell[0]];
-        const Vec3d& x2   = surfMeshData.vertices[cell[1]];
-        const Vec3d& x3   = surfMeshData.vertices[cell[2]];
-
-        int          ptOnTriangleCaseType;
-        const Vec3d  closestPtOnTri = CollisionUtils::closestPointOnTriangle(pos, x1, x2, x3, ptOnTriangleCaseType);
-        const double sqrDist = (closestPtOnTri - pos).squaredNorm();
-        if (sqrDist < minSqrDist)
+        for (int j = 0; j < surfMeshData.cells.size(); j++)
         {
-            minSqrDist      = sqrDist;
-            closestPt       = closestPtOnTri;
-            closestCell     = j;
-            closestCellCase = ptOnTriangleCaseType;
+            testCell(j);
         }
     }
 
@@ -290,6 +311,85 @@ polySignedDist(const Vec3d& pos, const SurfMeshData& surfMeshData,
     }
 }
 
+///
+/// \brief Finds the nearest edge of the closed SurfaceMesh to the edge (a, b)
+/// whose nearest point on (a, b) is inside the closed SurfaceMesh
+/// \param a, first vertex of the edge
+/// \param b, second vertex of the edge
+/// \param surfMeshData, closed SurfaceMesh to find the nearest edge on
+/// \param closestTriId, id of the triangle of the nearest edge, -1 if none
+/// \param closestEdgeId, local edge id (0, 1, 2) in the triangle of the nearest edge
+///
+static void
+closestInsideEdge(const Vec3d& a, const Vec3d& b, const SurfMeshData& surfMeshData,
+                  int& closestTriId, int& closestEdgeId)
+{
+    static const int triEdgePattern[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+
+    double minSqrDist = IMSTK_DOUBLE_MAX;
+    closestTriId  = -1;
+    closestEdgeId = -1;
+
+    // For every edge of triangle j
+    auto testCell =
+        [&](const int j)
+        {
+            const Vec3i& cellB = surfMeshData.cells[j];
+            for (int k = 0; k < 3; k++)
+            {
+                const Vec2i edgeB(cellB[triEdgePattern[k][0]], cellB[triEdgePattern[k][1]]);
+
+                // Compute the closest point on the two edges
+                // Check the case, the edges must be within each others bounds/ranges
+                Vec3d ptA, ptB;
+                if (CollisionUtils::edgeToEdgeClosestPoints(
+                    a, b, surfMeshData.vertices[edgeB[0]], surfMeshData.vertices[edgeB[1]],
+                    ptA, ptB) == 0)
+                {
+                    // Find the closest element to this point on the edge
+                    const double sqrDist = (ptB - ptA).squaredNorm();
+                    // Use the closest one only, on ties keep the lowest triangle id
+                    if (sqrDist < minSqrDist || (sqrDist == minSqrDist && j < closestTriId))
+                    {
+                        // Check if the point on the oppositie edge nearest to edgeB is inside B
+                        int          caseType    = -1;
+                        int          closestCell = -1;
+                        Vec3i        vIds       = Vec3i::Zero();
+                        const double signedDist = polySignedDist(ptA, surfMeshData, caseType, vIds, closestCell);
+                        if (signedDist <= 0.0)
+                        {
+                            minSqrDist    = sqrDist;
+                            closestTriId  = j;
+                            closestEdgeId = k;
+                        }
+                    }
+                }
+            }
+        };
+
+    if (surfMeshData.tree != nullptr)
+    {
+        // The distance between the bounds of the edge and a node bounds the distance
+        // to any edge in the node
+        const Vec3d edgeLower = a.cwiseMin(b);
+        const Vec3d edgeUpper = a.cwiseMax(b);
+        surfMeshData.tree->visitNearest(
+            [&](const Vec3d& lowerCorner, const Vec3d& upperCorner)
+            {
+                return AabbTree::boxToBoxSqrDist(edgeLower, edgeUpper, lowerCorner, upperCorner);
+            },
+            [&](const int j, double&) { testCell(j); }, minSqrDist);
+    }
+    else
+    {
+        // For every triangle/cell of meshB
+        for (int j = 0; j < surfMeshData.cells.size(); j++)
+        {
+            testCell(j);
+        }
+    }
+}
+
 ClosedSurfaceMeshToMeshCD::ClosedSurfaceMeshToMeshCD()
 {
     setRequiredInputType<PointSet>(0);
@@ -311,6 +411,21 @@ ClosedSurfaceMeshToMeshCD::computeCollisionDataAB(
         surfMesh->computeTrianglesNormals();
         surfMesh->computeVertexToCellMap();
 
+        // Build the tree on first use or when the cells changed, otherwise refit it
+        if (m_useAabbTree)
+        {
+            std::shared_ptr<VecDataArray<int, 3>> cells = surfMesh->getCells();
+            if (!m_tree.isBuilt() || m_treeCells != cells || m_tree.getNumPrimitives() != static_cast<size_t>(cells->size()))
+            {
+                m_tree.build(*surfMesh->getVertexPositions(), *cells);
+                m_treeCells = cells;
+            }
+            else
+            {
+                m_tree.refit(*surfMesh->getVertexPositions(), *cells);
+            }
+        }
+
         // Narrow phase
         if (m_generateVertexTriangleContacts)
         {
@@ -348,19 +463,28 @@ ClosedSurfaceMeshToMeshCD::vertexToTriangleTest(
     std::vector<CollisionElement>& elementsB)
 {
     PointSetData pointSetData(std::dynamic_pointer_cast<PointSet>(geomA));
-    SurfMeshData surfMeshData(std::dynamic_pointer_cast<SurfaceMesh>(geomB));
+    SurfMeshData surfMeshData(std::dynamic_pointer_cast<SurfaceMesh>(geomB), m_useAabbTree ? &m_tree : nullptr);
+
+    // Find the closest feature of every vertex in parallel, every vertex only
+    // writes its own entry
+    const int numVertices = pointSetData.vertices.size();
+    m_closestFeatures.resize(numVertices);
+    ParallelUtils::parallelFor(numVertices,
+        [&](const int i)
+        {
+            ClosestFeature& feature = m_closestFeatures[i];
+            m_signedDistances[i] = polySignedDist(pointSetData.vertices[i], surfMeshData,
+                feature.caseType, feature.vIds, feature.closestCell);
+        }, numVertices > 50);
 
-    // For every vertex
-    for (int i = 0; i < pointSetData.vertices.size(); i++)
+    // Gather the contacts in vertex order
+    for (int i = 0; i < numVertices; i++)
     {
-        const Vec3d& p = pointSetData.vertices[i];
-
-        int          caseType    = -1;
-        int          closestCell = -1;
-        Vec3i        vertexIds   = Vec3i::Zero();
-        const double signedDist  = polySignedDist(p, surfMeshData, caseType, vertexIds, closestCell);
-        m_signedDistances[i] = signedDist;
-        if (signedDist <= 0.0)
+        const ClosestFeature& feature     = m_closestFeatures[i];
+        const int             caseType    = feature.caseType;
+        const int             closestCell = feature.closestCell;
+        const Vec3i&          vertexIds   = feature.vIds;
+        if (m_signedDistances[i] <= 0.0)
         {
             m_vertexInside[i] = true;
             // The nearest feature to this vertex is another vertex
@@ -432,7 +556,7 @@ ClosedSurfaceMeshToMeshCD::lineMeshEdgeToTriangleTest(
     std::vector<CollisionElement>& elementsA,
     std::vector<CollisionElement>& elementsB)
 {
-    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB));
+    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB), m_useAabbTree ? &m_tree : nullptr);
 
     // Get geometry A data
     std::shared_ptr<LineMesh>                lineMesh = std::dynamic_pointer_cast<LineMesh>(geomA);
@@ -443,76 +567,47 @@ ClosedSurfaceMeshToMeshCD::lineMeshEdgeToTriangleTest(
 
     const int triEdgePattern[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
 
-    // For every edge/line segment of the line mesh
-    for (int i = 0; i < meshACells.size(); i++)
-    {
-        const Vec2i& edgeA = meshACells[i];
-
-        // Only check edges that don't exist totally inside
-        if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
+    // For every edge/line segment of the line mesh find the nearest edge in parallel
+    const int numEdges = meshACells.size();
+    m_closestEdges.resize(numEdges);
+    ParallelUtils::parallelFor(numEdges,
+        [&](const int i)
         {
-            double minSqrDist    = IMSTK_DOUBLE_MAX;
-            int    closestTriId  = -1;
-            int    closestEdgeId = -1;
+            const Vec2i& edgeA = meshACells[i];
+            m_closestEdges[i] = Vec2i(-1, -1);
 
-            // For every triangle/cell of meshB
-            for (int j = 0; j < surfMeshBData.cells.size(); j++)
+            // Only check edges that don't exist totally inside
+            if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
             {
-                const Vec3i& cellB = surfMeshBData.cells[j];
-
-                // For every edge of that triangle
-                for (int k = 0; k < 3; k++)
-                {
-                    const Vec2i edgeB(cellB[triEdgePattern[k][0]], cellB[triEdgePattern[k][1]]);
-
-                    // Compute the closest point on the two edges
-                    // Check the case, the edges must be within each others bounds/ranges
-                    Vec3d ptA, ptB;
-                    if (CollisionUtils::edgeToEdgeClosestPoints(
-                        meshAVertices[edgeA[0]], meshAVertices[edgeA[1]],
-                        surfMeshBData.vertices[edgeB[0]], surfMeshBData.vertices[edgeB[1]],
-                        ptA, ptB) == 0)
-                    {
-                        // Find the closest element to this point on the edge
-                        const double sqrDist = (ptB - ptA).squaredNorm();
-                        // Use the closest one only
-                        if (sqrDist < minSqrDist)
-                        {
-                            // Check if the point on the oppositie edge nearest to edgeB is inside B
-                            int          caseType    = -1;
-                            int          closestCell = -1;
-                            Vec3i        vIds       = Vec3i::Zero();
-                            const double signedDist = polySignedDist(ptA, surfMeshBData, caseType, vIds, closestCell);
-                            if (signedDist <= 0.0)
-                            {
-                                minSqrDist    = sqrDist;
-                                closestTriId  = j;
-                                closestEdgeId = k;
-                            }
-                        }
-                    }
-                }
+                closestInsideEdge(meshAVertices[edgeA[0]], meshAVertices[edgeA[1]], surfMeshBData,
+                    m_closestEdges[i][0], m_closestEdges[i][1]);
             }
+        }, numEdges > 10);
 
-            if (closestTriId != -1)
-            {
-                CellIndexElement elemA;
-                elemA.ids[0]   = edgeA[0];
-                elemA.ids[1]   = edgeA[1];
-                elemA.parentId = i; // Edge id
-                elemA.idCount  = 2;
-                elemA.cellType = IMSTK_EDGE;
-
-                CellIndexElement elemB;
-                elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
-                elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
-                elemB.parentId = closestTriId; // Triangle id
-                elemB.idCount  = 2;
-                elemB.cellType = IMSTK_EDGE;
-
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-            }
+    // Gather the contacts in edge order
+    for (int i = 0; i < numEdges; i++)
+    {
+        const Vec2i& edgeA         = meshACells[i];
+        const int    closestTriId  = m_closestEdges[i][0];
+        const int    closestEdgeId = m_closestEdges[i][1];
+        if (closestTriId != -1)
+        {
+            CellIndexElement elemA;
+            elemA.ids[0]   = edgeA[0];
+            elemA.ids[1]   = edgeA[1];
+            elemA.parentId = i; // Edge id
+            elemA.idCount  = 2;
+            elemA.cellType = IMSTK_EDGE;
+
+            CellIndexElement elemB;
+            elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
+            elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
+            elemB.parentId = closestTriId; // Triangle id
+            elemB.idCount  = 2;
+            elemB.cellType = IMSTK_EDGE;
+
+            elementsA.push_back(elemA);
+            elementsB.push_back(elemB);
         }
     }
 }
@@ -524,7 +619,7 @@ ClosedSurfaceMeshToMeshCD::surfMeshEdgeToTriangleTest(
     std::vector<CollisionElement>& elementsA,
     std::vector<CollisionElement>& elementsB)
 {
-    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB));
+    SurfMeshData surfMeshBData(std::dynamic_pointer_cast<SurfaceMesh>(geomB), m_useAabbTree ? &m_tree : nullptr);
 
     // Get geometry A data
     std::shared_ptr<SurfaceMesh>             surfMeshA = std::dynamic_pointer_cast<SurfaceMesh>(geomA);
@@ -547,98 +642,70 @@ ClosedSurfaceMeshToMeshCD::surfMeshEdgeToTriangleTest(
     // Additionally we don't check edges whose vertices are already inside the closed surface (determined
     // in the vertex-triangle pass)
     const int triEdgePattern[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
-    int       edgeCheckCount       = 0;
     if (m_generateEdgeEdgeContacts)
     {
-        // For every edge/line segment of the line mesh
-        for (int i = 0; i < meshACells.size(); i++)
-        {
-            const Vec3i& cellA = meshACells[i];
-
-            // For every edge of triangle A
-            for (int j = 0; j < 3; j++)
+        // For every edge of every triangle A find the nearest edge in parallel
+        const int numCells = meshACells.size();
+        m_closestEdges.resize(numCells * 3);
+        ParallelUtils::parallelFor(numCells,
+            [&](const int i)
             {
-                const Vec2i edgeA = Vec2i(cellA[triEdgePattern[j][0]], cellA[triEdgePattern[j][1]]);
+                const Vec3i& cellA = meshACells[i];
 
-                // Only check edges that don't exist totally inside
-                if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]])
+                // For every edge of triangle A
+                for (int j = 0; j < 3; j++)
                 {
-                    double minSqrDist    = IMSTK_DOUBLE_MAX;
-                    int    closestTriId  = -1;
-                    int    closestEdgeId = -1;
+                    const Vec2i edgeA = Vec2i(cellA[triEdgePattern[j][0]], cellA[triEdgePattern[j][1]]);
+                    Vec2i&      closestEdge = m_closestEdges[i * 3 + j];
+                    closestEdge = Vec2i(-1, -1);
 
+                    // Only check edges that don't exist totally inside
                     // If proximity is used, only check edges with vertices within proximity of the closed surface
-                    if (m_proximity <= 0.0 || (m_signedDistances[edgeA[0]] < m_proximity && m_signedDistances[edgeA[1]] < m_proximity))
+                    if (!m_vertexInside[edgeA[0]] && !m_vertexInside[edgeA[1]]
+                        && (m_proximity <= 0.0 || (m_signedDistances[edgeA[0]] < m_proximity && m_signedDistances[edgeA[1]] < m_proximity)))
                     {
-                        edgeCheckCount++;
-                        // For every triangle/cell of meshB
-                        for (int k = 0; k < surfMeshBData.cells.size(); k++)
-                        {
-                            const Vec3i& cellB = surfMeshBData.cells[k];
-
-                            // For every edge of that triangle
-                            for (int edgeId = 0; edgeId < 3; edgeId++)
-                            {
-                                const Vec2i edgeB(cellB[triEdgePattern[edgeId][0]], cellB[triEdgePattern[edgeId][1]]);
-
-                                // Compute the closest point on the two edges
-                                // Check the case, the edges must be within each others bounds/ranges
-                                Vec3d ptA, ptB;
-                                if (CollisionUtils::edgeToEdgeClosestPoints(
-                                    meshAVertices[edgeA[0]], meshAVertices[edgeA[1]],
-                                    surfMeshBData.vertices[edgeB[0]], surfMeshBData.vertices[edgeB[1]],
-                                    ptA, ptB) == 0)
-                                {
-                                    // Find the closest element to this point on the edge
-                                    const double sqrDist = (ptB - ptA).squaredNorm();
-                                    // Use the closest one only
-                                    if (sqrDist < minSqrDist)
-                                    {
-                                        // Check if the point on the oppositie edge nearest to edgeB is inside B
-                                        int          caseType    = -1;
-                                        int          closestCell = -1;
-                                        Vec3i        vIds       = Vec3i::Zero();
-                                        const double signedDist = polySignedDist(ptA, surfMeshBData, caseType, vIds, closestCell);
-                                        if (signedDist <= 0.0)
-                                        {
-                                            minSqrDist    = sqrDist;
-                                            closestTriId  = k;
-                                            closestEdgeId = edgeId;
-                                        }
-                                    }
-                                }
-                            }
-                        }
+                        closestInsideEdge(meshAVertices[edgeA[0]], meshAVertices[edgeA[1]], surfMeshBData,
+                            closestEdge[0], closestEdge[1]);
                     }
+                }
+            }, numCells > 10);
 
-                    if (closestTriId != -1)
+        // Gather the contacts in edge order
+        for (int i = 0; i < numCells; i++)
+        {
+            const Vec3i& cellA = meshACells[i];
+            for (int j = 0; j < 3; j++)
+            {
+                const Vec2i edgeA         = Vec2i(cellA[triEdgePattern[j][0]], cellA[triEdgePattern[j][1]]);
+                const int   closestTriId  = m_closestEdges[i * 3 + j][0];
+                const int   closestEdgeId = m_closestEdges[i * 3 + j][1];
+                if (closestTriId != -1)
+                {
+                    // Before inserting check if it already exists
+                    EdgePair edgePair(
+                        edgeA[0], edgeA[1],
+                        surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]],
+                        surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]]);
+                    if (hashedEdges.count(edgePair) == 0)
                     {
-                        // Before inserting check if it already exists
-                        EdgePair edgePair(
-                            edgeA[0], edgeA[1],
-                            surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]],
-                            surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]]);
-                        if (hashedEdges.count(edgePair) == 0)
-                        {
-                            CellIndexElement elemA;
-                            elemA.ids[0]   = edgeA[0];
-                            elemA.ids[1]   = edgeA[1];
-                            elemA.parentId = i; // Triangle id
-                            elemA.idCount  = 2;
-                            elemA.cellType = IMSTK_EDGE;
-
-                            CellIndexElement elemB;
-                            elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
-                            elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
-                            elemB.parentId = closestTriId; // Triangle id
-                            elemB.idCount  = 2;
-                            elemB.cellType = IMSTK_EDGE;
-
-                            elementsA.push_back(elemA);
-                            elementsB.push_back(elemB);
-
-                            hashedEdges.insert(edgePair);
-                        }
+                        CellIndexElement elemA;
+                        elemA.ids[0]   = edgeA[0];
+                        elemA.ids[1]   = edgeA[1];
+                        elemA.parentId = i; // Triangle id
+                        elemA.idCount  = 2;
+                        elemA.cellType = IMSTK_EDGE;
+
+                        CellIndexElement elemB;
+                        elemB.ids[0]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][0]];
+                        elemB.ids[1]   = surfMeshBData.cells[closestTriId][triEdgePattern[closestEdgeId][1]];
+                        elemB.parentId = closestTriId; // Triangle id
+                        elemB.idCount  = 2;
+                        elemB.cellType = IMSTK_EDGE;
+
+                        elementsA.push_back(elemA);
+                        elementsB.push_back(elemB);
+
+                        hashedEdges.insert(edgePair);
                     }
                 }
             }
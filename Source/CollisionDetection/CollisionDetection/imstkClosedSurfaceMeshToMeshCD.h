@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "imstkAabbTree.h"
 #include "imstkCollisionDetectionAlgorithm.h"
 #include "imstkDataArray.h"
 #include "imstkMacros.h"
@@ -39,6 +40,10 @@ class SurfaceMesh;
 /// is an extremely costly operation in brute force and is off by default.
 /// Additionally it cannot find the globally best edge to resolve too.
 ///
+/// The closest feature queries are accelerated with an AabbTree over the cells
+/// of the closed SurfaceMesh, refit every update while its cells stay the
+/// same. Vertices and edges of the other mesh are queried in parallel.
+///
 /// Extrapolation is used past an opening based on the nearest elements normal.
 /// So some openings are ok depending on the intention. For instance, a
 /// triangle mesh plane is valid, assuming "beneath" the plane is inside and
@@ -89,6 +94,14 @@ public:
     bool getDoBroadPhase() const { return m_doBroadPhase; }
 ///
 
+    ///
+    /// \brief Get/Set whether closest features are found with the AabbTree,
+    /// when off every cell of the closed SurfaceMesh is tested. default true
+    ///@{
+    void setUseAabbTree(const bool useAabbTree) { m_useAabbTree = useAabbTree; }
+    bool getUseAabbTree() const { return m_useAabbTree; }
+    ///@}
+
 protected:
     ///
     /// \brief Compute collision data for AB simultaneously
@@ -129,6 +142,23 @@ private:
     bool m_generateEdgeEdgeContacts       = false;
     bool m_generateVertexTriangleContacts = true;
     bool m_doBroadPhase = true;
+    bool m_useAabbTree  = true;
+
+    AabbTree m_tree;                                   ///< Tree over the cells of the closed SurfaceMesh
+    std::shared_ptr<VecDataArray<int, 3>> m_treeCells; ///< Cells m_tree was built with
+
+    ///
+    /// \brief Closest feature of a vertex or edge, computed in parallel
+    /// and gathered in order
+    ///
+    struct ClosestFeature
+    {
+        int caseType    = -1;
+        int closestCell = -1;
+        Vec3i vIds      = Vec3i::Zero();
+    };
+    std::vector<ClosestFeature> m_closestFeatures; ///< Per vertex of A
+    std::vector<Vec2i> m_closestEdges;             ///< Per edge of A, (triangle id, edge id) of the nearest edge of B
 
     std::vector<bool> m_vertexInside;
     DataArray<double> m_signedDistances;
@@ -44,6 +44,9 @@ public:
     /// Shortest distance vector between the infinite lines defined by the two segments
     const Vec3d w;
 
+    /// Thickness of the lines unless set otherwise, see setThickness
+    static constexpr double DefaultThickness = 0.0016;
+
     EdgeEdgeCCDState(const Vec3d& i0, const Vec3d& i1, const Vec3d& j0, const Vec3d& j1);
 
     /// Parameterized position of closest point on segment xi--xi1 to segment xj--xj1.
@@ -125,7 +128,7 @@ private:
     double m_epsilon = 1e-10;
 
     // Thickness of colliding LineMeshes.
-    double m_thickness = 0.0016; // 0.0016
+    double m_thickness = DefaultThickness;
 
     /// Squared magnitude of vector ei
     double a() const
@@ -40,7 +40,6 @@ ImplicitGeometryToPointSetCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int i)
         {
@@ -62,12 +61,11 @@ ImplicitGeometryToPointSetCD::computeCollisionDataAB(
                 elemB.ptIndex = i;
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemA, elemB);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 
 void
@@ -87,7 +85,6 @@ ImplicitGeometryToPointSetCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int i)
         {
@@ -104,11 +101,11 @@ ImplicitGeometryToPointSetCD::computeCollisionDataA(
                 elemA.pt  = pt + n * depth;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_localElements.add(elemA);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA);
 }
 
 void
@@ -128,7 +125,6 @@ ImplicitGeometryToPointSetCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int i)
         {
@@ -144,10 +140,10 @@ ImplicitGeometryToPointSetCD::computeCollisionDataB(
                 elemB.ptIndex = i;
                 elemB.penetrationDepth = std::abs(signedDistance);
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemB);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -55,7 +55,6 @@ LineMeshToCapsuleCD::computeCollisionDataAB(
         return;
     }
 
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int i)
         {
             const Vec2i& cell = indices[i];
@@ -131,10 +130,7 @@ LineMeshToCapsuleCD::computeCollisionDataAB(
                         elemB.dir = contactNormal;                                // Direction to resolve point on capsuel
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                     // Capsule contact with x2
                     else if (caseType == 1)
@@ -152,10 +148,7 @@ LineMeshToCapsuleCD::computeCollisionDataAB(
                         elemB.dir = contactNormal;                                // Direction to resolve point on capsuel
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                     // Capsule contact between x1 and x2
                     else if (caseType == 2)
@@ -175,10 +168,7 @@ LineMeshToCapsuleCD::computeCollisionDataAB(
                         elemB.pt  = capClosestPt - capsuleRadius * contactNormal; // Contact point on capsule
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                     // Capsule centerline coincident with segment
                     else if (caseType == 3)
@@ -202,13 +192,12 @@ LineMeshToCapsuleCD::computeCollisionDataAB(
                         elemB.pt  = capClosestPt - capsuleRadius * escapeDirection; // Contact point on sphere
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                 }
             }
             }, indices.size() > 500);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include "imstkEdgeEdgeCCDState.h"
 #include "imstkLineMesh.h"
 #include "imstkLineMeshToLineMeshCCD.h"
+#include "imstkParallelUtils.h"
+
+#include <algorithm>
 
 namespace imstk
 {
@@ -124,53 +127,118 @@ LineMeshToLineMeshCCD::internalComputeCollision(
     const VecDataArray<int, 2>&           linesA    = *linesAPtr;
     std::shared_ptr<VecDataArray<int, 2>> linesBPtr = meshB->getCells();
     const VecDataArray<int, 2>&           linesB    = *linesBPtr;
-    for (size_t i = 0; i < static_cast<size_t>(meshA->getNumCells()); ++i)
+    // Broad phase, sweep and prune over the swept bounds of the segments sorted on x.
+    // In self collision all bounds are of the one mesh
+    m_sweptBounds.clear();
+    computeSweptBounds(prevA, verticesA, linesA, false);
+    if (!selfCollision)
     {
-        const Vec2i& cellA = linesA[i];
-        size_t       j     = selfCollision ? i + 2 : 0;
-        for (; j < static_cast<size_t>(meshB->getNumCells()); ++j)
+        computeSweptBounds(prevB, verticesB, linesB, true);
+    }
+    std::sort(m_sweptBounds.begin(), m_sweptBounds.end(),
+        [](const SweptBounds& a, const SweptBounds& b) { return a.lower[0] < b.lower[0]; });
+
+    // Every segment is tested against those after it that start before it ends on x,
+    // pairs that also overlap on y and z go to the narrow phase
+    ParallelUtils::parallelFor(m_sweptBounds.size(),
+        [&](const size_t k)
         {
-            // If performing self-collision, do not process self or immediate neighboring cells (lines).
-            if (selfCollision && (std::max(i, j) - std::min(i, j) <= 1))
+            const SweptBounds& boundsK = m_sweptBounds[k];
+            for (size_t l = k + 1; l < m_sweptBounds.size() && m_sweptBounds[l].lower[0] <= boundsK.upper[0]; l++)
             {
-                continue;
-            }
-            const Vec2i& cellB = linesB[j];
+                const SweptBounds& boundsL = m_sweptBounds[l];
+                if (!selfCollision && boundsK.isB == boundsL.isB)
+                {
+                    continue;
+                }
+                if (boundsK.lower[1] > boundsL.upper[1] || boundsL.lower[1] > boundsK.upper[1]
+                    || boundsK.lower[2] > boundsL.upper[2] || boundsL.lower[2] > boundsK.upper[2])
+                {
+                    continue;
+                }
 
-            EdgeEdgeCCDState currState(verticesA[cellA(0)], verticesA[cellA(1)], verticesB[cellB(0)], verticesB[cellB(1)]);
-            EdgeEdgeCCDState prevState(prevA[cellA(0)], prevA[cellA(1)], prevB[cellB(0)], prevB[cellB(1)]);
+                // Line ids of the pair, i on A and j on B. In self collision the order is not
+                // kept, i is the lower
+                const bool   swap = selfCollision ? (boundsK.cellId > boundsL.cellId) : boundsK.isB;
+                const size_t i    = static_cast<size_t>(swap ? boundsL.cellId : boundsK.cellId);
+                const size_t j    = static_cast<size_t>(swap ? boundsK.cellId : boundsL.cellId);
 
-            // Test for collision between current and previous timestep, and create collision info.
-            double relativeTimeOfImpact = 0.0;
-            int    collisionCase = EdgeEdgeCCDState::testCollision(prevState, currState, relativeTimeOfImpact);
-            if (collisionCase != 0)
-            {
-                if (elementsA)
+                // If performing self-collision, do not process self or immediate neighboring cells (lines).
+                if (selfCollision && (j - i <= 1))
                 {
-                    CellIndexElement elemA;
-                    elemA.cellType = IMSTK_EDGE;
-                    elemA.idCount  = 2;
-                    elemA.parentId = static_cast<int>(i); // line id
-                    elemA.ids[0]   = cellA(0);
-                    elemA.ids[1]   = cellA(1);
-                    CollisionElement e(elemA);
-                    e.m_ccdData = true;
-                    elementsA->push_back(e);
+                    continue;
                 }
-                if (elementsB)
+                const Vec2i& cellA = linesA[i];
+                const Vec2i& cellB = linesB[j];
+
+                EdgeEdgeCCDState currState(verticesA[cellA(0)], verticesA[cellA(1)], verticesB[cellB(0)], verticesB[cellB(1)]);
+                EdgeEdgeCCDState prevState(prevA[cellA(0)], prevA[cellA(1)], prevB[cellB(0)], prevB[cellB(1)]);
+
+                // Test for collision between current and previous timestep, and create collision info.
+                double relativeTimeOfImpact = 0.0;
+                int    collisionCase = EdgeEdgeCCDState::testCollision(prevState, currState, relativeTimeOfImpact);
+                if (collisionCase == 0)
                 {
-                    CellIndexElement elemB;
-                    elemB.cellType = IMSTK_EDGE;
-                    elemB.idCount  = 2;
-                    elemB.parentId = static_cast<int>(j); // line id
-                    elemB.ids[0]   = cellB(0);
-                    elemB.ids[1]   = cellB(1);
-                    CollisionElement e(elemB);
-                    e.m_ccdData = true;
-                    elementsB->push_back(e);
+                    continue;
+                }
+
+                CellIndexElement elemA;
+                elemA.cellType = IMSTK_EDGE;
+                elemA.idCount  = 2;
+                elemA.parentId = static_cast<int>(i); // line id
+                elemA.ids[0]   = cellA(0);
+                elemA.ids[1]   = cellA(1);
+                CollisionElement eA(elemA);
+                eA.m_ccdData = true;
+
+                CellIndexElement elemB;
+                elemB.cellType = IMSTK_EDGE;
+                elemB.idCount  = 2;
+                elemB.parentId = static_cast<int>(j); // line id
+                elemB.ids[0]   = cellB(0);
+                elemB.ids[1]   = cellB(1);
+                CollisionElement eB(elemB);
+                eB.m_ccdData = true;
+
+                if (elementsA && elementsB)
+                {
+                    m_localElements.add(eA, eB);
+                }
+                else
+                {
+                    m_localElements.add(elementsA ? eA : eB);
                 }
             }
-        }
+        }, m_sweptBounds.size() > 100);
+
+    if (elementsA && elementsB)
+    {
+        m_localElements.appendTo(*elementsA, *elementsB);
+    }
+    else
+    {
+        m_localElements.appendTo(elementsA ? *elementsA : *elementsB);
+    }
+}
+
+void
+LineMeshToLineMeshCCD::computeSweptBounds(const VecDataArray<double, 3>& prevVertices,
+                                          const VecDataArray<double, 3>& vertices,
+                                          const VecDataArray<int, 2>& lines, const bool isB)
+{
+    // Padded by the line thickness, segments closer than that collide
+    const Vec3d padding = Vec3d::Constant(EdgeEdgeCCDState::DefaultThickness);
+    for (int i = 0; i < lines.size(); i++)
+    {
+        const Vec2i& cell = lines[i];
+        SweptBounds  bounds;
+        bounds.lower = prevVertices[cell[0]].cwiseMin(prevVertices[cell[1]])
+                       .cwiseMin(vertices[cell[0]]).cwiseMin(vertices[cell[1]]) - padding;
+        bounds.upper = prevVertices[cell[0]].cwiseMax(prevVertices[cell[1]])
+                       .cwiseMax(vertices[cell[0]]).cwiseMax(vertices[cell[1]]) + padding;
+        bounds.cellId = i;
+        bounds.isB    = isB;
+        m_sweptBounds.push_back(bounds);
     }
 }
 
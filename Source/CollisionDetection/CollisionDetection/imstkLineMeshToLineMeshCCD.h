@@ -24,6 +24,10 @@ template<typename T, int N> class VecDataArray;
 /// Self collision mode is indicated to the algorithm by providing
 /// geometryA (input 0) == geometryB (input 1).
 ///
+/// Segments are culled by sweep and prune over their swept bounds, the bounds of a
+/// segment at the previous and current timestep, before the pairs that remain are
+/// tested in parallel.
+///
 class LineMeshToLineMeshCCD : public CCDAlgorithm
 {
 public:
@@ -69,6 +73,24 @@ protected:
         std::vector<CollisionElement>& elementsB) override;
 
 private:
+    ///
+    /// \brief Swept bounds of a segment of either mesh
+    ///
+    struct SweptBounds
+    {
+        Vec3d lower;
+        Vec3d upper;
+        int   cellId;
+        bool  isB; ///< Segment of mesh B, unused in self collision
+    };
+
+    ///
+    /// \brief Compute the swept bounds of the segments of a mesh and append them to m_sweptBounds
+    ///
+    void computeSweptBounds(const VecDataArray<double, 3>& prevVertices,
+                            const VecDataArray<double, 3>& vertices,
+                            const VecDataArray<int, 2>& lines, const bool isB);
+
     void internalComputeCollision(
         std::shared_ptr<Geometry>      geomA,
         std::shared_ptr<Geometry>      geomB,
@@ -77,5 +99,7 @@ private:
 
     std::shared_ptr<LineMesh> m_prevA;
     std::shared_ptr<LineMesh> m_prevB;
+
+    std::vector<SweptBounds> m_sweptBounds; ///< Swept bounds of all segments sorted on x
 };
 } // namespace imstk
\ No newline at end of file
@@ -37,7 +37,6 @@ LineMeshToSphereCD::computeCollisionDataAB(
     std::shared_ptr<VecDataArray<double, 3>> verticesPtr = lineMesh->getVertexPositions();
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
 
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int i)
         {
             const Vec2i& cell = indices[i];
@@ -88,10 +87,7 @@ LineMeshToSphereCD::computeCollisionDataAB(
                         elemB.dir = contactNormal;                               // Direction to resolve point on sphere
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                     // Sphere contact with x2
                     else if (caseType == 1)
@@ -112,10 +108,7 @@ LineMeshToSphereCD::computeCollisionDataAB(
                         elemB.dir = contactNormal;                               // Direction to resolve point on sphere
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                     // Sphere contact between x1 and x2
                     else if (caseType == 2)
@@ -137,13 +130,12 @@ LineMeshToSphereCD::computeCollisionDataAB(
                         elemB.pt  = spherePos - sphereRadius * contactNormal;   // Contact point on sphere
                         elemB.penetrationDepth = penetrationDepth;
 
-                        lock.lock();
-                        elementsA.push_back(elemA);
-                        elementsB.push_back(elemB);
-                        lock.unlock();
+                        m_localElements.add(elemA, elemB);
                     }
                 }
             }
             }, indices.size() > 500);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -37,7 +37,6 @@ PointSetToCylinderCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -59,12 +58,11 @@ PointSetToCylinderCD::computeCollisionDataAB(
                 elemB.pt  = cylinderContactPt;     // Contact point on surface of cylinder
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemA, elemB);
             }
                 }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 
 void
@@ -83,7 +81,6 @@ PointSetToCylinderCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -100,11 +97,11 @@ PointSetToCylinderCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_localElements.add(elemA);
             }
                 }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA);
 }
 
 void
@@ -123,7 +120,6 @@ PointSetToCylinderCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -140,10 +136,10 @@ PointSetToCylinderCD::computeCollisionDataB(
                 elemB.pt  = cylinderContactPt;     // Contact point on surface of cylinder
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemB);
             }
                 }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -36,7 +36,6 @@ PointSetToOrientedBoxCD::computeCollisionDataAB(
     const Vec3d             boxPos      = box->getPosition();
     const Mat3d             cubeRot     = box->getOrientation().toRotationMatrix();
     const Vec3d             cubeExtents = box->getExtents();
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -58,12 +57,11 @@ PointSetToOrientedBoxCD::computeCollisionDataAB(
                 elemB.pt  = cubeContactPt;       // Contact point on surface of cube
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemA, elemB);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 
 void
@@ -81,7 +79,6 @@ PointSetToOrientedBoxCD::computeCollisionDataA(
     const Vec3d             boxPos      = box->getPosition();
     const Mat3d             cubeRot     = box->getOrientation().toRotationMatrix();
     const Vec3d             cubeExtents = box->getExtents();
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -98,11 +95,11 @@ PointSetToOrientedBoxCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_localElements.add(elemA);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA);
 }
 
 void
@@ -120,7 +117,6 @@ PointSetToOrientedBoxCD::computeCollisionDataB(
     const Vec3d             boxPos      = box->getPosition();
     const Mat3d             cubeRot     = box->getOrientation().toRotationMatrix();
     const Vec3d             cubeExtents = box->getExtents();
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(vertices.size(),
         [&](const int idx)
         {
@@ -137,10 +133,10 @@ PointSetToOrientedBoxCD::computeCollisionDataB(
                 elemB.pt  = cubeContactPt;       // Contact point on surface of cube
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemB);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsB);
 }
 } // namespace imstk
\ No newline at end of file
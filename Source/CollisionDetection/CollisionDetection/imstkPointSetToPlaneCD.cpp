@@ -38,7 +38,6 @@ PointSetToPlaneCD::computeCollisionDataAB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(static_cast<unsigned int>(vertices.size()),
         [&](const unsigned int idx)
         {
@@ -59,12 +58,11 @@ PointSetToPlaneCD::computeCollisionDataAB(
                 elemB.pt  = vertices[idx] + planeNormal * depth; // Point on plane
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemA, elemB);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 
 void
@@ -81,7 +79,6 @@ PointSetToPlaneCD::computeCollisionDataA(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(static_cast<unsigned int>(vertices.size()),
         [&](const unsigned int idx)
         {
@@ -97,11 +94,11 @@ PointSetToPlaneCD::computeCollisionDataA(
                 elemA.ptIndex = idx;
                 elemA.penetrationDepth = depth;
 
-                lock.lock();
-                elementsA.push_back(elemA);
-                lock.unlock();
+                m_localElements.add(elemA);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsA);
 }
 
 void
@@ -118,7 +115,6 @@ PointSetToPlaneCD::computeCollisionDataB(
 
     std::shared_ptr<VecDataArray<double, 3>> vertexData = pointSet->getVertexPositions();
     const VecDataArray<double, 3>&           vertices   = *vertexData;
-    ParallelUtils::SpinLock                  lock;
     ParallelUtils::parallelFor(static_cast<unsigned int>(vertices.size()),
         [&](const unsigned int idx)
         {
@@ -134,10 +130,10 @@ PointSetToPlaneCD::computeCollisionDataB(
                 elemB.pt  = vertices[idx] + planeNormal * depth; // Point on plane
                 elemB.penetrationDepth = depth;
 
-                lock.lock();
-                elementsB.push_back(elemB);
-                lock.unlock();
+                m_localElements.add(elemB);
             }
         }, vertices.size() > 100);
+
+    m_localElements.appendTo(elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -55,7 +55,6 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
     }
 
     // \todo: Doesn't remove duplicate contacts (shared edges), refer to SurfaceMeshCD for easy method to do so
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int i)
         {
             const Vec3i& cell = indices[i];
@@ -170,10 +169,7 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
                 // Contact with triangle face
                 else if (caseType == 2)
@@ -196,10 +192,7 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
                 // Contact with trianlge vertex
                 else if (caseType == 3)
@@ -220,10 +213,7 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.dir = contactNormal;                            // Direction to resolve point
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
                 // Capsule body intersecting triangle
                 else if (caseType == 4)
@@ -249,15 +239,14 @@ SurfaceMeshToCapsuleCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - contactNormal * penetrationDepth;
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
             }
     }, surfMesh->getNumTriangles() > 200);
     // Tipping point for payoff is around 200 triangles, the benchmark is very simple
     // with regard to triangle distribution and tests
     // 200 triangles was determined experimentally see SurfaceMeshCDBenchmark
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -38,7 +38,6 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           vertices    = *verticesPtr;
 
     // \todo: Doesn't remove duplicate contacts (shared edges), refer to SurfaceMeshCD for easy method to do so
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(indices.size(), [&](int i)
         {
             const Vec3i& cell = indices[i];
@@ -88,10 +87,7 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
                 else if (caseType == 2) // Triangle vs point on sphere
                 {
@@ -114,10 +110,7 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
                     elemB.pt  = spherePos - sphereRadius * contactNormal; // Contact point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
                 else if (caseType == 3)
                 {
@@ -137,12 +130,11 @@ SurfaceMeshToSphereCD::computeCollisionDataAB(
                     elemB.dir = contactNormal;                            // Direction to resolve point on sphere
                     elemB.penetrationDepth = penetrationDepth;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
             }
         });
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
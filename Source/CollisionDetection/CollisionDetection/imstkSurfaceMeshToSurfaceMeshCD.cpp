@@ -9,74 +9,62 @@
 #include "imstkSurfaceMesh.h"
 #include "imstkGeometryUtilities.h"
 
-struct EdgePair
-{
-    EdgePair(uint32_t a1, uint32_t a2, uint32_t b1, uint32_t b2)
-    {
-        edgeA[0] = a1;
-        edgeA[1] = a2;
-        edgeB[0] = b1;
-        edgeB[1] = b2;
+#include <unordered_set>
 
-        edgeAId = getIdA();
-        edgeBId = getIdB();
-    }
+namespace imstk
+{
+namespace
+{
+///
+/// \brief Returns a unique id for an edge, order of the vertices doesn't matter
+/// ie: f(vertexId1, vertexId2)=f(vertexId2, vertexId1)
+///
+inline uint64_t
+getEdgeId(const int v1, const int v2)
+{
+    const uint64_t max = static_cast<uint64_t>(std::max(v1, v2));
+    const uint64_t min = static_cast<uint64_t>(std::min(v1, v2));
+    return max * (max + 1) / 2 + min;
+}
 
-    ///
-    /// \brief Reversible edges are equivalent, reversible vertices in the edges are equivalent as well
-    /// EdgePair(0,1,5,2)==EdgePair(1,0,5,2)==EdgePair(1,0,2,5)==...
-    ///
-    bool operator==(const EdgePair& other) const
-    {
-        return (edgeAId == other.edgeAId && edgeBId == other.edgeBId)
-               || (edgeAId == other.edgeBId && edgeBId == other.edgeAId);
-    }
+///
+/// \brief Key of an edge of mesh A and an edge of mesh B, the two full edge ids
+/// as an edge id alone takes more than 32 bits past 92681 vertices
+///
+using EdgePairKey = std::pair<uint64_t, uint64_t>;
 
-    // These functions return a unique int for an edge, order doesn't matter
-    // ie: f(vertexId1, vertexId2)=f(vertexId2, vertexId1)
-    const uint32_t getIdA() const
-    {
-        const uint32_t max = std::max(edgeA[0], edgeA[1]);
-        const uint32_t min = std::min(edgeA[0], edgeA[1]);
-        return max * (max + 1) / 2 + min;
-    }
+inline EdgePairKey
+getEdgePairKey(const Vec2i& edgeA, const Vec2i& edgeB)
+{
+    return EdgePairKey(getEdgeId(edgeA[0], edgeA[1]), getEdgeId(edgeB[0], edgeB[1]));
+}
 
-    const uint32_t getIdB() const
+struct EdgePairKeyHash
+{
+    size_t operator()(const EdgePairKey& key) const
     {
-        const uint32_t max = std::max(edgeB[0], edgeB[1]);
-        const uint32_t min = std::min(edgeB[0], edgeB[1]);
-        return max * (max + 1) / 2 + min;
+        return std::hash<uint64_t>()(key.first * 0x9E3779B97F4A7C15ull ^ key.second);
     }
-
-    uint32_t edgeA[2];
-    uint32_t edgeAId;
-    uint32_t edgeB[2];
-    uint32_t edgeBId;
 };
 
-namespace std
-{
-template<>
-struct hash<EdgePair>
-{
-    // EdgePair has 4 uints to hash, they bound the same range, 0 to max vertices of a mesh
-    // A complete unique hash split into 4, would limit us to 256 max vertices so we will have
-    // collisions but they will be unlikely given small portions of the mesh are in contact at
-    // any one time
-    std::size_t operator()(const EdgePair& k) const
-    {
-        // Shift by 8 each time, there will be overlap every 256 ints
-        //return ((k.edgeA[0] ^ (k.edgeA[1] << 8)) ^ (k.edgeB[0] << 16)) ^ (k.edgeB[1] << 24);
+///
+/// \brief Number of triangle pairs tested per parallel pass, bounds the memory
+/// of the narrow phase results when every pair is tested
+///
+const size_t NarrowPhaseChunkSize = 4096;
 
-        // The edge ids are more compact since f(1,0)=f(0,1) there are fewer permutations,
-        // This should allow up to ~360 max vertices..., not that much better
-        return (k.edgeAId ^ (k.edgeBId << 16));
-    }
+///
+/// \brief Result of the narrow phase test of a triangle pair
+///
+struct TriangleContact
+{
+    int contactType = -1;
+    std::pair<Vec2i, Vec2i> eeContact;
+    std::pair<int, Vec3i>   vtContact;
+    std::pair<Vec3i, int>   tvContact;
 };
-} // namespace std
+} // namespace
 
-namespace imstk
-{
 SurfaceMeshToSurfaceMeshCD::SurfaceMeshToSurfaceMeshCD()
 {
     setRequiredInputType<SurfaceMesh>(0);
@@ -86,6 +74,21 @@ SurfaceMeshToSurfaceMeshCD::SurfaceMeshToSurfaceMeshCD()
     setGenerateCD(true, true);
 }
 
+void
+SurfaceMeshToSurfaceMeshCD::updateTree(AabbTree& tree, std::shared_ptr<VecDataArray<int, 3>>& treeCells,
+                                       const VecDataArray<double, 3>& vertices, std::shared_ptr<VecDataArray<int, 3>> cells)
+{
+    if (!tree.isBuilt() || treeCells != cells || tree.getNumPrimitives() != static_cast<size_t>(cells->size()))
+    {
+        tree.build(vertices, *cells);
+        treeCells = cells;
+    }
+    else
+    {
+        tree.refit(vertices, *cells);
+    }
+}
+
 void
 SurfaceMeshToSurfaceMeshCD::computeCollisionDataAB(
     std::shared_ptr<Geometry>      geomA,
@@ -105,22 +108,60 @@ SurfaceMeshToSurfaceMeshCD::computeCollisionDataAB(
     std::shared_ptr<VecDataArray<int, 3>>    indicesBPtr  = surfMeshB->getCells();
     const VecDataArray<int, 3>&              indicesB     = *indicesBPtr;
 
-    std::unordered_set<EdgePair> edges;
-    for (int i = 0; i < indicesA.size(); i++)
+    // Broad phase, gather the triangle pairs whose bounds overlap. Without it every pair
+    // is tested, the pairs are then generated from their index rather than stored
+    m_intersectingPairs.clear();
+    size_t numPairs = 0;
+    if (m_broadPhaseEnabled)
+    {
+        updateTree(m_treeA, m_treeACells, verticesA, indicesAPtr);
+        updateTree(m_treeB, m_treeBCells, verticesB, indicesBPtr);
+        AabbTree::getOverlappingPairs(m_treeA, m_treeB, m_intersectingPairs);
+        numPairs = m_intersectingPairs.size();
+    }
+    else
     {
-        const Vec3i& cellA = indicesA[i];
-        for (int j = 0; j < indicesB.size(); j++)
+        numPairs = static_cast<size_t>(indicesA.size()) * indicesB.size();
+    }
+    const size_t numCellsB = static_cast<size_t>(indicesB.size());
+    auto         getPair   = [&](const size_t k)
+                             {
+                                 return m_broadPhaseEnabled ? m_intersectingPairs[k] :
+                                        std::pair<int, int>(static_cast<int>(k / numCellsB), static_cast<int>(k % numCellsB));
+                             };
+
+    // Narrow phase, test the candidate pairs in parallel a chunk at a time then gather
+    // the contacts of the chunk in the order of the pairs
+    std::unordered_set<EdgePairKey, EdgePairKeyHash> edges;
+    std::vector<TriangleContact>                     contacts(std::min(numPairs, NarrowPhaseChunkSize));
+    for (size_t chunkStart = 0; chunkStart < numPairs; chunkStart += NarrowPhaseChunkSize)
+    {
+        const size_t chunkSize = std::min(numPairs - chunkStart, NarrowPhaseChunkSize);
+        ParallelUtils::parallelFor(chunkSize,
+            [&](const size_t k)
+            {
+                const std::pair<int, int> pair  = getPair(chunkStart + k);
+                const Vec3i&              cellA = indicesA[pair.first];
+                const Vec3i&              cellB = indicesB[pair.second];
+
+                // vtContact needs to be checked both ways but eeContact is symmetric
+                TriangleContact& contact = contacts[k];
+                contact.contactType = CollisionUtils::triangleToTriangle(cellA, cellB,
+                    verticesA[cellA[0]], verticesA[cellA[1]], verticesA[cellA[2]],
+                    verticesB[cellB[0]], verticesB[cellB[1]], verticesB[cellB[2]],
+                    contact.eeContact, contact.vtContact, contact.tvContact);
+            }, chunkSize > 100);
+
+        for (size_t k = 0; k < chunkSize; k++)
         {
-            const Vec3i& cellB = indicesB[j];
-
-            // vtContact needs to be checked both ways but eeContact is symmetric
-            std::pair<Vec2i, Vec2i> eeContact;
-            std::pair<int, Vec3i>   vtContact;
-            std::pair<Vec3i, int>   tvContact;
-            const int               contactType = CollisionUtils::triangleToTriangle(cellA, cellB,
-                verticesA[cellA[0]], verticesA[cellA[1]], verticesA[cellA[2]],
-                verticesB[cellB[0]], verticesB[cellB[1]], verticesB[cellB[2]],
-                eeContact, vtContact, tvContact);
+            const std::pair<int, int>      pair        = getPair(chunkStart + k);
+            const int                      i           = pair.first;
+            const int                      j           = pair.second;
+            const TriangleContact&         contact     = contacts[k];
+            const std::pair<Vec2i, Vec2i>& eeContact   = contact.eeContact;
+            const std::pair<int, Vec3i>&   vtContact   = contact.vtContact;
+            const std::pair<Vec3i, int>&   tvContact   = contact.tvContact;
+            const int                      contactType = contact.contactType;
 
             // If you want to visualize the cells in contact
             // report triangle vs triangle instead
@@ -153,7 +194,7 @@ SurfaceMeshToSurfaceMeshCD::computeCollisionDataAB(
                 elemB.ids[0]   = vtContact.second[0];
                 elemB.ids[1]   = vtContact.second[1];
                 elemB.ids[2]   = vtContact.second[2];
-                elemA.parentId = j; // Triangle id
+                elemB.parentId = j; // Triangle id
 
                 elementsA.push_back(elemA);
                 elementsB.push_back(elemB);
@@ -161,14 +202,8 @@ SurfaceMeshToSurfaceMeshCD::computeCollisionDataAB(
             // Type 0, edge-edge contact
             else if (contactType == 0)
             {
-                // Create an edge pair and hash it to see if we already have this contact from
-                // another triangle
-                const EdgePair edgePair = {
-                    static_cast<uint32_t>(eeContact.first[0]),
-                    static_cast<uint32_t>(eeContact.first[1]),
-                    static_cast<uint32_t>(eeContact.second[0]),
-                    static_cast<uint32_t>(eeContact.second[1]) };
-                if (edges.count(edgePair) == 0)
+                // Check if we already have this contact from another triangle
+                if (edges.insert(getEdgePairKey(eeContact.first, eeContact.second)).second)
                 {
                     CellIndexElement elemA;
                     elemA.idCount  = 2;
@@ -182,11 +217,10 @@ SurfaceMeshToSurfaceMeshCD::computeCollisionDataAB(
                     elemB.cellType = IMSTK_EDGE;
                     elemB.ids[0]   = eeContact.second[0];
                     elemB.ids[1]   = eeContact.second[1];
-                    elemA.parentId = j; // Triangle id
+                    elemB.parentId = j; // Triangle id
 
                     elementsA.push_back(elemA);
                     elementsB.push_back(elemB);
-                    edges.insert(edgePair);
                 }
             }
             // Type 3, triangle-vertex contact
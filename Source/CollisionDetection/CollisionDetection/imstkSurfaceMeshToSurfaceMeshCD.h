@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "imstkAabbTree.h"
 #include "imstkCollisionDetectionAlgorithm.h"
 #include "imstkMacros.h"
 
@@ -16,7 +17,10 @@ class SurfaceMesh;
 ///
 /// \class SurfaceMeshToSurfaceMeshCD
 ///
-/// \brief Collision detection for surface meshes
+/// \brief Collision detection for surface meshes. Candidate triangle pairs
+/// are found with an AabbTree per mesh, built once and refit every update
+/// while the cells of the meshes stay the same. The candidates are then
+/// tested in parallel.
 ///
 class SurfaceMeshToSurfaceMeshCD : public CollisionDetectionAlgorithm
 {
@@ -30,6 +34,21 @@ public:
     void setMaxNumContacts(const int maxNumContacts) { m_maxNumContacts = maxNumContacts; }
     const int getMaxNumContacts() const { return m_maxNumContacts; }
 
+    ///
+    /// \brief Get/Set whether the AabbTree broad phase is used, when off
+    /// every triangle pair is tested
+    ///@{
+    void setBroadPhaseEnabled(const bool broadPhaseEnabled) { m_broadPhaseEnabled = broadPhaseEnabled; }
+    bool getBroadPhaseEnabled() const { return m_broadPhaseEnabled; }
+    ///@}
+
+    ///
+    /// \brief Get the trees used for the broad phase of mesh A and B
+    ///@{
+    const AabbTree& getTreeA() const { return m_treeA; }
+    const AabbTree& getTreeB() const { return m_treeB; }
+    ///@}
+
 protected:
     ///
     /// \brief Compute collision data for AB simultaneously
@@ -40,8 +59,20 @@ protected:
         std::vector<CollisionElement>& elementsA,
         std::vector<CollisionElement>& elementsB) override;
 
+    ///
+    /// \brief Builds the tree on first use or when the cells changed, otherwise refits it
+    ///
+    static void updateTree(AabbTree& tree, std::shared_ptr<VecDataArray<int, 3>>& treeCells,
+                           const VecDataArray<double, 3>& vertices, std::shared_ptr<VecDataArray<int, 3>> cells);
+
 protected:
     std::vector<std::pair<int, int>> m_intersectingPairs;
-    int m_maxNumContacts = 1000;
+    int  m_maxNumContacts    = 1000;
+    bool m_broadPhaseEnabled = true;
+
+    AabbTree m_treeA;
+    AabbTree m_treeB;
+    std::shared_ptr<VecDataArray<int, 3>> m_treeACells = nullptr; ///< Cells m_treeA was built with
+    std::shared_ptr<VecDataArray<int, 3>> m_treeBCells = nullptr; ///< Cells m_treeB was built with
 };
 } // namespace imstk
\ No newline at end of file
@@ -40,7 +40,6 @@ TetraToLineMeshCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           lineVerts   = *verticesPtr;
 
     // Brute force
-    ParallelUtils::SpinLock lock;
     ParallelUtils::parallelFor(lines.size(), [&](int i)
         {
             const Vec3d& x0 = lineVerts[lines[i][0]];
@@ -64,12 +63,11 @@ TetraToLineMeshCD::computeCollisionDataAB(
                     elemB.idCount  = 1;
                     elemB.cellType = IMSTK_EDGE;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
             }
         });
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
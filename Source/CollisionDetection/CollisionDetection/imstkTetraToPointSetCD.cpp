@@ -37,7 +37,7 @@ TetraToPointSetCD::computeCollisionDataAB(
     const VecDataArray<double, 3>&           verticesMeshB    = *verticesMeshBPtr;
 
     // For every tet in meshA, test if any points lie in it
-    ParallelUtils::SpinLock lock;
+    tbb::enumerable_thread_specific<std::vector<size_t>> vertexIdBuffers;
     ParallelUtils::parallelFor(tetMesh->getNumCells(),
         [&](const int tetIdA)
         {
@@ -46,7 +46,8 @@ TetraToPointSetCD::computeCollisionDataAB(
             tetMesh->computeTetrahedronBoundingBox(tetIdA, min, max);
 
             // For every other point in near the bounding box
-            std::vector<size_t> meshBVertexIds = m_hashTableB.getPointsInAABB(min, max);
+            std::vector<size_t>& meshBVertexIds = vertexIdBuffers.local();
+            m_hashTableB.getPointsInAABB(meshBVertexIds, min, max);
             for (size_t vertexIdB : meshBVertexIds)
             {
                 Vec3d vPos = verticesMeshB[vertexIdB];
@@ -68,12 +69,11 @@ TetraToPointSetCD::computeCollisionDataAB(
                     elemB.idCount  = 1;
                     elemB.cellType = IMSTK_VERTEX;
 
-                    lock.lock();
-                    elementsA.push_back(elemA);
-                    elementsB.push_back(elemB);
-                    lock.unlock();
+                    m_localElements.add(elemA, elemB);
                 }
             }
         });
+
+    m_localElements.appendTo(elementsA, elementsB);
 }
 } // namespace imstk
\ No newline at end of file
@@ -8,7 +8,7 @@
 
 #include "imstkCollisionDetectionAlgorithm.h"
 #include "imstkMacros.h"
-#include "imstkSpatialHashTableSeparateChaining.h"
+#include "imstkSpatialHashTableCompact.h"
 
 namespace imstk
 {
@@ -38,7 +38,7 @@ public:
         std::vector<CollisionElement>& elementsB) override;
 
 protected:
-    SpatialHashTableSeparateChaining m_hashTableA; ///< Spatial hash table
-    SpatialHashTableSeparateChaining m_hashTableB; ///< Spatial hash table
+    SpatialHashTableCompact m_hashTableA; ///< Spatial hash table
+    SpatialHashTableCompact m_hashTableB; ///< Spatial hash table
 };
 } // namespace imstk
\ No newline at end of file
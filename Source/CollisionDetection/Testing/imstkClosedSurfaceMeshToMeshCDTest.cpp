@@ -8,11 +8,110 @@
 
 #include "imstkClosedSurfaceMeshToMeshCD.h"
 #include "imstkGeometryUtilities.h"
+#include "imstkLineMesh.h"
 #include "imstkOrientedBox.h"
 #include "imstkSurfaceMesh.h"
 
 using namespace imstk;
 
+namespace
+{
+///
+/// \brief Create a closed latitude/longitude sphere with outward facing triangles
+///
+std::shared_ptr<SurfaceMesh>
+makeClosedSphere(const double radius, const int numLat, const int numLon)
+{
+    auto                     verticesPtr = std::make_shared<VecDataArray<double, 3>>();
+    VecDataArray<double, 3>& vertices    = *verticesPtr;
+    vertices.push_back(Vec3d(0.0, radius, 0.0));
+    for (int i = 1; i < numLat; i++)
+    {
+        const double theta = PI * i / numLat;
+        for (int j = 0; j < numLon; j++)
+        {
+            const double phi = 2.0 * PI * j / numLon;
+            vertices.push_back(radius * Vec3d(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    vertices.push_back(Vec3d(0.0, -radius, 0.0));
+
+    auto                  indicesPtr = std::make_shared<VecDataArray<int, 3>>();
+    VecDataArray<int, 3>& indices    = *indicesPtr;
+    auto                  addTriangle = [&](const int a, const int b, const int c)
+                                        {
+                                            // Orient outwards
+                                            const Vec3d n = (vertices[b] - vertices[a]).cross(vertices[c] - vertices[a]);
+                                            if (n.dot(vertices[a] + vertices[b] + vertices[c]) > 0.0)
+                                            {
+                                                indices.push_back(Vec3i(a, b, c));
+                                            }
+                                            else
+                                            {
+                                                indices.push_back(Vec3i(a, c, b));
+                                            }
+                                        };
+    const int southPole = vertices.size() - 1;
+    for (int j = 0; j < numLon; j++)
+    {
+        const int j1 = (j + 1) % numLon;
+        addTriangle(0, 1 + j, 1 + j1);
+        for (int i = 0; i < numLat - 2; i++)
+        {
+            const int v0 = 1 + i * numLon;
+            const int v1 = v0 + numLon;
+            addTriangle(v0 + j, v1 + j, v1 + j1);
+            addTriangle(v0 + j, v1 + j1, v0 + j1);
+        }
+        addTriangle(southPole, 1 + (numLat - 2) * numLon + j1, 1 + (numLat - 2) * numLon + j);
+    }
+
+    auto surfMesh = std::make_shared<SurfaceMesh>();
+    surfMesh->initialize(verticesPtr, indicesPtr);
+    return surfMesh;
+}
+
+///
+/// \brief Run the CD with and without the AabbTree and check both give the same contacts
+///
+void
+testAabbTreeMatchesBruteForce(std::shared_ptr<PointSet> meshA, std::shared_ptr<SurfaceMesh> closedMesh,
+                              const bool generateEdgeEdgeContacts)
+{
+    std::shared_ptr<CollisionData> colData[2];
+    ClosedSurfaceMeshToMeshCD      meshCD[2];
+    for (int i = 0; i < 2; i++)
+    {
+        meshCD[i].setInput(meshA, 0);
+        meshCD[i].setInput(closedMesh, 1);
+        meshCD[i].setGenerateCD(true, true);
+        meshCD[i].setGenerateEdgeEdgeContacts(generateEdgeEdgeContacts);
+        meshCD[i].setUseAabbTree(i == 1);
+        meshCD[i].update();
+        colData[i] = meshCD[i].getCollisionData();
+    }
+
+    ASSERT_GT(colData[0]->elementsA.size(), 0);
+    ASSERT_EQ(colData[0]->elementsA.size(), colData[1]->elementsA.size());
+    ASSERT_EQ(colData[0]->elementsB.size(), colData[1]->elementsB.size());
+    for (size_t i = 0; i < colData[0]->elementsB.size(); i++)
+    {
+        const CellIndexElement& elemA0 = colData[0]->elementsA[i].m_element.m_CellIndexElement;
+        const CellIndexElement& elemA1 = colData[1]->elementsA[i].m_element.m_CellIndexElement;
+        const CellIndexElement& elemB0 = colData[0]->elementsB[i].m_element.m_CellIndexElement;
+        const CellIndexElement& elemB1 = colData[1]->elementsB[i].m_element.m_CellIndexElement;
+        EXPECT_EQ(elemA0.cellType, elemA1.cellType);
+        EXPECT_EQ(elemB0.cellType, elemB1.cellType);
+        EXPECT_EQ(elemB0.parentId, elemB1.parentId);
+        for (int j = 0; j < 4; j++)
+        {
+            EXPECT_EQ(elemA0.ids[j], elemA1.ids[j]);
+            EXPECT_EQ(elemB0.ids[j], elemB1.ids[j]);
+        }
+    }
+}
+} // namespace
+
 TEST(imstkClosedSurfaceMeshToMeshCDTest, IntersectionTestAB_EdgeToEdge)
 {
     // Create two cubes
@@ -182,4 +281,46 @@ TEST(imstkClosedSurfaceMeshToMeshCDTest, IntersectionTestAB_VertexToEdge)
 
     EXPECT_EQ(colData->elementsA[0].m_element.m_CellIndexElement.idCount, 2);
     EXPECT_EQ(colData->elementsB[0].m_element.m_CellIndexElement.idCount, 1);
-}
\ No newline at end of file
+}
+
+TEST(imstkClosedSurfaceMeshToMeshCDTest, AabbTreeMatchesBruteForce_PointSet)
+{
+    std::shared_ptr<SurfaceMesh> sphereMesh = makeClosedSphere(1.0, 10, 12);
+
+    // Grid of points, some inside some outside the sphere
+    auto verticesPtr = std::make_shared<VecDataArray<double, 3>>();
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                verticesPtr->push_back(Vec3d(i, j, k) * 0.3 - Vec3d(1.03, 1.07, 1.01));
+            }
+        }
+    }
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(verticesPtr);
+
+    testAabbTreeMatchesBruteForce(pointSet, sphereMesh, false);
+}
+
+TEST(imstkClosedSurfaceMeshToMeshCDTest, AabbTreeMatchesBruteForce_LineMesh)
+{
+    std::shared_ptr<SurfaceMesh> sphereMesh = makeClosedSphere(1.0, 10, 12);
+
+    // Long segments whose vertices are all outside the sphere but pass through it
+    auto verticesPtr = std::make_shared<VecDataArray<double, 3>>();
+    auto indicesPtr  = std::make_shared<VecDataArray<int, 2>>();
+    for (int i = 0; i < 10; i++)
+    {
+        const double y = -0.9 + 0.2 * i;
+        verticesPtr->push_back(Vec3d(-2.0, y, 0.05 * i));
+        verticesPtr->push_back(Vec3d(2.0, y, 0.1 - 0.03 * i));
+        indicesPtr->push_back(Vec2i(2 * i, 2 * i + 1));
+    }
+    auto lineMesh = std::make_shared<LineMesh>();
+    lineMesh->initialize(verticesPtr, indicesPtr);
+
+    testAabbTreeMatchesBruteForce(lineMesh, sphereMesh, true);
+}
@@ -0,0 +1,95 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCollisionElementBuffers.h"
+#include "imstkParallelUtils.h"
+#include "imstkPointSet.h"
+#include "imstkPointSetToSphereCD.h"
+#include "imstkSphere.h"
+#include "imstkVecDataArray.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+///
+/// \brief Test that pairs added from many threads come out paired and complete,
+/// appended after the existing elements
+///
+TEST(imstkCollisionElementBuffersTest, AppendPairs)
+{
+    CollisionElementBuffers buffers;
+
+    std::vector<CollisionElement> elementsA(1);
+    std::vector<CollisionElement> elementsB(1);
+    const int                     numPairs = 10000;
+    for (int frame = 0; frame < 2; frame++)
+    {
+        elementsA.resize(1);
+        elementsB.resize(1);
+        ParallelUtils::parallelFor(numPairs,
+            [&](const int i)
+            {
+                PointIndexDirectionElement elemA;
+                elemA.ptIndex = i;
+                PointIndexDirectionElement elemB;
+                elemB.ptIndex = numPairs + i;
+                buffers.add(elemA, elemB);
+            });
+        buffers.appendTo(elementsA, elementsB);
+
+        ASSERT_EQ(elementsA.size(), numPairs + 1);
+        ASSERT_EQ(elementsB.size(), numPairs + 1);
+        std::vector<bool> found(numPairs, false);
+        for (int i = 1; i < numPairs + 1; i++)
+        {
+            const int idA = elementsA[i].m_element.m_PointIndexDirectionElement.ptIndex;
+            const int idB = elementsB[i].m_element.m_PointIndexDirectionElement.ptIndex;
+            EXPECT_EQ(idB, numPairs + idA);
+            found[idA] = true;
+        }
+        EXPECT_EQ(std::count(found.begin(), found.end(), true), numPairs);
+    }
+}
+
+///
+/// \brief Test that the elements of the last detection are in the front buffers
+/// and the ones before in the back, or only in the back when pipelined
+///
+TEST(imstkCollisionElementBuffersTest, DoubleBuffered)
+{
+    auto pointSet = std::make_shared<PointSet>();
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(1);
+    (*vertices)[0] = Vec3d(0.0, 0.0, 0.0);
+    pointSet->initialize(vertices);
+    auto sphere = std::make_shared<Sphere>(Vec3d(0.0, 0.0, 0.0), 1.0);
+
+    PointSetToSphereCD cd;
+    cd.setInputGeometryA(pointSet);
+    cd.setInputGeometryB(sphere);
+    std::shared_ptr<CollisionData> colData = cd.getCollisionData();
+
+    cd.update();
+    EXPECT_EQ(colData->elementsA.size(), 1);
+    EXPECT_EQ(colData->backElementsA.size(), 0);
+
+    // Move out of contact, the contact of the last frame is in the back
+    sphere->setPosition(Vec3d(5.0, 0.0, 0.0));
+    sphere->updatePostTransformData();
+    cd.update();
+    EXPECT_EQ(colData->elementsA.size(), 0);
+    EXPECT_EQ(colData->backElementsA.size(), 1);
+
+    // Pipelined the front is left alone until swapped
+    cd.setPipelined(true);
+    sphere->setPosition(Vec3d(0.0, 0.0, 0.0));
+    sphere->updatePostTransformData();
+    cd.update();
+    EXPECT_EQ(colData->elementsA.size(), 0);
+    EXPECT_EQ(colData->backElementsA.size(), 1);
+    colData->swapBuffers();
+    EXPECT_EQ(colData->elementsA.size(), 1);
+}
@@ -4,12 +4,15 @@
 ** See accompanying NOTICE for details.
 */
 
+#include "imstkEdgeEdgeCCDState.h"
 #include "imstkLineMesh.h"
 #include "imstkLineMeshToLineMeshCCD.h"
 #include "imstkVecDataArray.h"
 
 #include <gtest/gtest.h>
 
+#include <set>
+
 using namespace imstk;
 
 // Defined in imstkTetraToLineMeshCDTest.cpp
@@ -232,3 +235,66 @@ TEST(imstkLineMeshToLineMeshCCDTest, NonIntersectionTestAB)
     EXPECT_EQ(0, colData->elementsA.size());
     EXPECT_EQ(0, colData->elementsB.size());
 }
+
+///
+/// \brief Test that the broad phase finds the same segment pairs as testing every
+/// pair, for a zigzag line moving through a straight one
+///
+TEST(imstkLineMeshToLineMeshCCDTest, BroadPhaseAB)
+{
+    std::vector<Vec3d> pointsA;
+    std::vector<Vec3d> pointsB;
+    for (int i = 0; i < 100; i++)
+    {
+        pointsA.push_back(Vec3d(0.0025 + i * 0.01, 0.0, 0.0));
+        pointsB.push_back(Vec3d(0.005 + i * 0.01, (i % 2 == 0) ? -0.1 : 0.1, 0.05));
+    }
+    auto lineMeshA_prev = makeLineMesh(pointsA);
+    auto lineMeshA_curr = makeLineMesh(pointsA);
+    auto lineMeshB_prev = makeLineMesh(pointsB);
+    for (Vec3d& point : pointsB)
+    {
+        point[2] = -0.05;
+    }
+    auto lineMeshB_curr = makeLineMesh(pointsB);
+
+    LineMeshToLineMeshCCD lineMeshToLineMeshCCD;
+    lineMeshToLineMeshCCD.updatePreviousTimestepGeometry(lineMeshA_prev, lineMeshB_prev);
+    lineMeshToLineMeshCCD.setInput(lineMeshA_curr, 0);
+    lineMeshToLineMeshCCD.setInput(lineMeshB_curr, 1);
+    lineMeshToLineMeshCCD.setGenerateCD(true, true);
+    lineMeshToLineMeshCCD.update();
+    std::shared_ptr<CollisionData> colData = lineMeshToLineMeshCCD.getCollisionData();
+
+    std::set<std::pair<int, int>> expectedPairs;
+    const VecDataArray<int, 2>&    linesA = *lineMeshA_curr->getCells();
+    const VecDataArray<int, 2>&    linesB = *lineMeshB_curr->getCells();
+    for (int i = 0; i < linesA.size(); i++)
+    {
+        for (int j = 0; j < linesB.size(); j++)
+        {
+            EdgeEdgeCCDState currState(
+                lineMeshA_curr->getVertexPosition(linesA[i][0]), lineMeshA_curr->getVertexPosition(linesA[i][1]),
+                lineMeshB_curr->getVertexPosition(linesB[j][0]), lineMeshB_curr->getVertexPosition(linesB[j][1]));
+            EdgeEdgeCCDState prevState(
+                lineMeshA_prev->getVertexPosition(linesA[i][0]), lineMeshA_prev->getVertexPosition(linesA[i][1]),
+                lineMeshB_prev->getVertexPosition(linesB[j][0]), lineMeshB_prev->getVertexPosition(linesB[j][1]));
+            double relativeTimeOfImpact = 0.0;
+            if (EdgeEdgeCCDState::testCollision(prevState, currState, relativeTimeOfImpact) != 0)
+            {
+                expectedPairs.insert({ i, j });
+            }
+        }
+    }
+    ASSERT_EQ(expectedPairs.size(), 99);
+
+    std::set<std::pair<int, int>> pairs;
+    ASSERT_EQ(colData->elementsA.size(), colData->elementsB.size());
+    for (size_t k = 0; k < colData->elementsA.size(); k++)
+    {
+        pairs.insert({ colData->elementsA[k].m_element.m_CellIndexElement.parentId,
+                       colData->elementsB[k].m_element.m_CellIndexElement.parentId });
+    }
+    EXPECT_EQ(colData->elementsA.size(), expectedPairs.size());
+    EXPECT_EQ(pairs, expectedPairs);
+}
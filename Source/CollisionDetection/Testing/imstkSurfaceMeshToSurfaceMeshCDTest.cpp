@@ -0,0 +1,162 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCollisionData.h"
+#include "imstkGeometryUtilities.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkSurfaceMeshToSurfaceMeshCD.h"
+#include "imstkVecDataArray.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Count the cell types of the given elements
+///
+std::array<int, 3>
+countCellTypes(const std::vector<CollisionElement>& elements)
+{
+    std::array<int, 3> counts = { 0, 0, 0 };
+    for (const CollisionElement& elem : elements)
+    {
+        EXPECT_EQ(CollisionElementType::CellIndex, elem.m_type);
+        counts[elem.m_element.m_CellIndexElement.idCount - 1]++;
+    }
+    return counts;
+}
+} // namespace
+
+TEST(imstkSurfaceMeshToSurfaceMeshCDTest, IntersectionTestAB_VertexTriangle)
+{
+    // Triangle A pierces triangle B with a vertex
+    auto surfMeshA    = std::make_shared<SurfaceMesh>();
+    auto verticesAPtr = std::make_shared<VecDataArray<double, 3>>(3);
+    (*verticesAPtr)[0] = Vec3d(0.0, -0.1, 0.0);
+    (*verticesAPtr)[1] = Vec3d(0.5, 1.0, 0.0);
+    (*verticesAPtr)[2] = Vec3d(-0.5, 1.0, 0.0);
+    auto indicesAPtr = std::make_shared<VecDataArray<int, 3>>(1);
+    (*indicesAPtr)[0] = Vec3i(0, 1, 2);
+    surfMeshA->initialize(verticesAPtr, indicesAPtr);
+
+    auto surfMeshB    = std::make_shared<SurfaceMesh>();
+    auto verticesBPtr = std::make_shared<VecDataArray<double, 3>>(3);
+    (*verticesBPtr)[0] = Vec3d(-1.0, 0.0, -1.0);
+    (*verticesBPtr)[1] = Vec3d(1.0, 0.0, -1.0);
+    (*verticesBPtr)[2] = Vec3d(0.0, 0.0, 1.0);
+    auto indicesBPtr = std::make_shared<VecDataArray<int, 3>>(1);
+    (*indicesBPtr)[0] = Vec3i(0, 1, 2);
+    surfMeshB->initialize(verticesBPtr, indicesBPtr);
+
+    SurfaceMeshToSurfaceMeshCD colDetect;
+    colDetect.setInput(surfMeshA, 0);
+    colDetect.setInput(surfMeshB, 1);
+    colDetect.update();
+
+    std::shared_ptr<CollisionData> colData = colDetect.getCollisionData();
+    ASSERT_EQ(1, colData->elementsA.size());
+    ASSERT_EQ(1, colData->elementsB.size());
+
+    const CellIndexElement& elemA = colData->elementsA[0].m_element.m_CellIndexElement;
+    const CellIndexElement& elemB = colData->elementsB[0].m_element.m_CellIndexElement;
+    EXPECT_EQ(IMSTK_VERTEX, elemA.cellType);
+    EXPECT_EQ(0, elemA.ids[0]);
+    EXPECT_EQ(IMSTK_TRIANGLE, elemB.cellType);
+    EXPECT_EQ(0, elemB.parentId);
+
+    // Moving A away should give no contacts on the next update (tree refit)
+    for (int i = 0; i < verticesAPtr->size(); i++)
+    {
+        (*verticesAPtr)[i][1] += 2.0;
+    }
+    colDetect.update();
+    EXPECT_EQ(0, colData->elementsA.size());
+    EXPECT_EQ(0, colData->elementsB.size());
+}
+
+///
+/// \brief Test that the broad phase finds the same contacts as testing every triangle pair
+///
+TEST(imstkSurfaceMeshToSurfaceMeshCDTest, BroadPhaseMatchesBruteForce)
+{
+    // Two perpendicular crossing grids
+    std::shared_ptr<SurfaceMesh> surfMeshA =
+        GeometryUtils::toTriangleGrid(Vec3d::Zero(), Vec2d(1.0, 1.0), Vec2i(12, 12));
+    std::shared_ptr<SurfaceMesh> surfMeshB =
+        GeometryUtils::toTriangleGrid(Vec3d(0.03, 0.0, 0.01), Vec2d(1.0, 1.0), Vec2i(9, 9),
+            Quatd(Rotd(PI_2, Vec3d(1.0, 0.0, 0.0))));
+
+    SurfaceMeshToSurfaceMeshCD bruteForceCD;
+    bruteForceCD.setInput(surfMeshA, 0);
+    bruteForceCD.setInput(surfMeshB, 1);
+    bruteForceCD.setBroadPhaseEnabled(false);
+    bruteForceCD.update();
+
+    SurfaceMeshToSurfaceMeshCD broadPhaseCD;
+    broadPhaseCD.setInput(surfMeshA, 0);
+    broadPhaseCD.setInput(surfMeshB, 1);
+    broadPhaseCD.update();
+    EXPECT_TRUE(broadPhaseCD.getTreeA().isBuilt());
+    EXPECT_TRUE(broadPhaseCD.getTreeB().isBuilt());
+
+    std::shared_ptr<CollisionData> bruteForceData = bruteForceCD.getCollisionData();
+    std::shared_ptr<CollisionData> broadPhaseData = broadPhaseCD.getCollisionData();
+    ASSERT_GT(bruteForceData->elementsA.size(), 0);
+    EXPECT_EQ(bruteForceData->elementsA.size(), broadPhaseData->elementsA.size());
+    EXPECT_EQ(bruteForceData->elementsB.size(), broadPhaseData->elementsB.size());
+    EXPECT_EQ(countCellTypes(bruteForceData->elementsA), countCellTypes(broadPhaseData->elementsA));
+    EXPECT_EQ(countCellTypes(bruteForceData->elementsB), countCellTypes(broadPhaseData->elementsB));
+}
+
+///
+/// \brief Test that edge-edge contacts of meshes with many vertices are not merged,
+/// the ids of the two edges of B differ by exactly 2^32
+///
+TEST(imstkSurfaceMeshToSurfaceMeshCDTest, IntersectionTestAB_EdgeEdgeLargeIds)
+{
+    auto surfMeshA    = std::make_shared<SurfaceMesh>();
+    auto verticesAPtr = std::make_shared<VecDataArray<double, 3>>(3);
+    (*verticesAPtr)[0] = Vec3d(-1.0, 0.0, 0.0);
+    (*verticesAPtr)[1] = Vec3d(1.0, 0.0, 0.0);
+    (*verticesAPtr)[2] = Vec3d(0.0, 2.0, 0.0);
+    auto indicesAPtr = std::make_shared<VecDataArray<int, 3>>(1);
+    (*indicesAPtr)[0] = Vec3i(0, 1, 2);
+    surfMeshA->initialize(verticesAPtr, indicesAPtr);
+
+    // Two triangles that each link with edge (0, 1) of A through their edge (0, 2)
+    auto surfMeshB    = std::make_shared<SurfaceMesh>();
+    auto verticesBPtr = std::make_shared<VecDataArray<double, 3>>(136345);
+    verticesBPtr->fill(Vec3d(0.0, 0.0, 5.0));
+    auto indicesBPtr = std::make_shared<VecDataArray<int, 3>>(2);
+    (*indicesBPtr)[0] = Vec3i(1, 2, 100000);
+    (*indicesBPtr)[1] = Vec3i(105957, 3, 136344);
+    for (int i = 0; i < 2; i++)
+    {
+        const double x = i == 0 ? -0.5 : 0.5;
+        const Vec3i& cell = (*indicesBPtr)[i];
+        (*verticesBPtr)[cell[0]] = Vec3d(x, -0.5, -0.5);
+        (*verticesBPtr)[cell[1]] = Vec3d(x, -0.5, 0.5);
+        (*verticesBPtr)[cell[2]] = Vec3d(x, 0.5, 0.1);
+    }
+    surfMeshB->initialize(verticesBPtr, indicesBPtr);
+
+    SurfaceMeshToSurfaceMeshCD colDetect;
+    colDetect.setInput(surfMeshA, 0);
+    colDetect.setInput(surfMeshB, 1);
+    colDetect.update();
+
+    std::shared_ptr<CollisionData> colData = colDetect.getCollisionData();
+    ASSERT_EQ(2, colData->elementsA.size());
+    ASSERT_EQ(2, colData->elementsB.size());
+    for (int i = 0; i < 2; i++)
+    {
+        const CellIndexElement& elemB = colData->elementsB[i].m_element.m_CellIndexElement;
+        EXPECT_EQ(IMSTK_EDGE, elemB.cellType);
+        EXPECT_EQ(i, elemB.parentId);
+    }
+}
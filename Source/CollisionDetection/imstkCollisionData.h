@@ -207,11 +207,26 @@ struct CollisionElement
 ///
 /// \brief Describes the contact manifold between two geometries
 ///
+/// The elements are double buffered. Detection fills the back buffers and swaps
+/// them to the front, so elementsA/B are always the ones last detected whilst the
+/// back buffers hold the frame before. Both keep their capacity across frames.
+///
 class CollisionData
 {
 public:
-    std::vector<CollisionElement> elementsA;
+    ///
+    /// \brief Swap the front and back element buffers
+    ///
+    void swapBuffers()
+    {
+        std::swap(elementsA, backElementsA);
+        std::swap(elementsB, backElementsB);
+    }
+
+    std::vector<CollisionElement> elementsA;     ///< Elements to handle
     std::vector<CollisionElement> elementsB;
+    std::vector<CollisionElement> backElementsA; ///< Elements being detected
+    std::vector<CollisionElement> backElementsB;
     std::shared_ptr<Geometry>     geomA;
     std::shared_ptr<Geometry>     geomB;
     std::shared_ptr<Geometry>     prevGeomA;
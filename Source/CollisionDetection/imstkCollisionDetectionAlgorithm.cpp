@@ -75,11 +75,20 @@ CollisionDetectionAlgorithm::requestUpdate()
         }
     }
 
-    std::shared_ptr<Geometry> geomA = (*m_collisionDataVector)[0]->geomA = getInput(0);
-    std::shared_ptr<Geometry> geomB = (*m_collisionDataVector)[0]->geomB = getInput(1);
+    // The geometries are only written when the inputs change as pipelined
+    // handling may be reading them
+    std::shared_ptr<CollisionData> colData = (*m_collisionDataVector)[0];
+    std::shared_ptr<Geometry>      geomA   = getInput(0);
+    std::shared_ptr<Geometry>      geomB   = getInput(1);
+    if (colData->geomA != geomA || colData->geomB != geomB)
+    {
+        colData->geomA = geomA;
+        colData->geomB = geomB;
+    }
 
-    std::vector<CollisionElement>* a = &(*m_collisionDataVector)[0]->elementsA;
-    std::vector<CollisionElement>* b = &(*m_collisionDataVector)[0]->elementsB;
+    // Detect into the back buffers, the front ones may still be handled
+    std::vector<CollisionElement>* a = &colData->backElementsA;
+    std::vector<CollisionElement>* b = &colData->backElementsB;
 
     a->resize(0);
     b->resize(0);
@@ -125,5 +134,10 @@ CollisionDetectionAlgorithm::requestUpdate()
             computeCollisionDataAB(geomA, geomB, *a, *b);
         }
     }
+
+    if (!m_pipelined)
+    {
+        colData->swapBuffers();
+    }
 }
 } // namespace imstk
\ No newline at end of file
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "imstkCollisionData.h"
+#include "imstkCollisionElementBuffers.h"
 #include "imstkGeometryAlgorithm.h"
 
 namespace imstk
@@ -70,6 +71,17 @@ public:
         m_generateCD_B = generateB;
     }
 
+    ///
+    /// \brief Get/Set whether the detected elements are left in the back buffers of
+    /// the CollisionData until CollisionData::swapBuffers is called, instead of being
+    /// swapped to the front at the end of the update. This lets the handling of the
+    /// last elements run at the same time as the next detection, the swap being the
+    /// point where both are done. Defaults to false
+    /// @{
+    void setPipelined(const bool pipelined) { m_pipelined = pipelined; }
+    bool getPipelined() const { return m_pipelined; }
+    /// @}
+
     void setInputGeometryA(std::shared_ptr<Geometry> geometryA) { setInput(geometryA, 0); }
 
     void setInputGeometryB(std::shared_ptr<Geometry> geometryB) { setInput(geometryB, 1); }
@@ -117,10 +129,12 @@ protected:
         std::vector<CollisionElement>& imstkNotUsed(elementsB)) { m_computeColDataBImplemented = false; }
 
     std::shared_ptr<std::vector<std::shared_ptr<CollisionData>>> m_collisionDataVector;
+    CollisionElementBuffers m_localElements; ///< Per thread elements of parallel detections
 
     bool m_flipOutput   = false;
     bool m_generateCD_A = true;
     bool m_generateCD_B = true;
+    bool m_pipelined    = false;
 
     bool m_computeColDataAImplemented = true;
     bool m_computeColDataBImplemented = true;
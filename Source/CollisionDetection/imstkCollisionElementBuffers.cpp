@@ -0,0 +1,60 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCollisionElementBuffers.h"
+#include "imstkParallelUtils.h"
+
+namespace imstk
+{
+void
+CollisionElementBuffers::appendTo(std::vector<CollisionElement>& elementsA, std::vector<CollisionElement>& elementsB)
+{
+    appendSide(elementsA, &ThreadBuffers::elementsA);
+    appendSide(elementsB, &ThreadBuffers::elementsB);
+    for (ThreadBuffers& buffers : m_threadBuffers)
+    {
+        buffers.elementsA.clear();
+        buffers.elementsB.clear();
+    }
+}
+
+void
+CollisionElementBuffers::appendTo(std::vector<CollisionElement>& elements)
+{
+    appendSide(elements, &ThreadBuffers::elementsA);
+    for (ThreadBuffers& buffers : m_threadBuffers)
+    {
+        buffers.elementsA.clear();
+    }
+}
+
+void
+CollisionElementBuffers::appendSide(std::vector<CollisionElement>& elements,
+                                    std::vector<CollisionElement> ThreadBuffers::* side)
+{
+    // Prefix sum of the buffer sizes gives where each buffer goes
+    m_buffers.clear();
+    m_bufferOffsets.clear();
+    size_t size = elements.size();
+    for (ThreadBuffers& buffers : m_threadBuffers)
+    {
+        if (!(buffers.*side).empty())
+        {
+            m_buffers.push_back(&buffers);
+            m_bufferOffsets.push_back(size);
+            size += (buffers.*side).size();
+        }
+    }
+    elements.resize(size);
+
+    ParallelUtils::parallelFor(m_buffers.size(),
+        [&](const size_t i)
+        {
+            const std::vector<CollisionElement>& buffer = m_buffers[i]->*side;
+            std::copy(buffer.begin(), buffer.end(), elements.begin() + m_bufferOffsets[i]);
+        }, size > 1000);
+}
+} // namespace imstk
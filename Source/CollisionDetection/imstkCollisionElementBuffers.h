@@ -0,0 +1,74 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkCollisionData.h"
+
+#include <tbb/enumerable_thread_specific.h>
+
+namespace imstk
+{
+///
+/// \class CollisionElementBuffers
+///
+/// \brief Per thread buffers of collision elements. Threads of a parallel
+/// detection add to their own buffers without locking, once done the buffers are
+/// appended to the output, offsets found by prefix sum and copied in parallel.
+/// Buffers keep their capacity so a steady state detection does not allocate.
+///
+/// Elements are either all added in pairs, A and B stay paired on output, or all
+/// single sided, appended to the one output given
+///
+class CollisionElementBuffers
+{
+public:
+    CollisionElementBuffers() = default;
+    virtual ~CollisionElementBuffers() = default;
+
+    ///
+    /// \brief Add a pair of elements to the buffers of the calling thread
+    ///
+    void add(const CollisionElement& elemA, const CollisionElement& elemB)
+    {
+        ThreadBuffers& buffers = m_threadBuffers.local();
+        buffers.elementsA.push_back(elemA);
+        buffers.elementsB.push_back(elemB);
+    }
+
+    ///
+    /// \brief Add a single sided element to the buffers of the calling thread
+    ///
+    void add(const CollisionElement& elem) { m_threadBuffers.local().elementsA.push_back(elem); }
+
+    ///
+    /// \brief Append the pairs of all threads to elementsA and elementsB and clear the buffers
+    ///
+    void appendTo(std::vector<CollisionElement>& elementsA, std::vector<CollisionElement>& elementsB);
+
+    ///
+    /// \brief Append the single sided elements of all threads to elements and clear the buffers
+    ///
+    void appendTo(std::vector<CollisionElement>& elements);
+
+protected:
+    struct ThreadBuffers
+    {
+        std::vector<CollisionElement> elementsA;
+        std::vector<CollisionElement> elementsB;
+    };
+
+    ///
+    /// \brief Append one side of the buffers of all threads to elements
+    ///
+    void appendSide(std::vector<CollisionElement>& elements,
+                    std::vector<CollisionElement> ThreadBuffers::* side);
+
+    tbb::enumerable_thread_specific<ThreadBuffers> m_threadBuffers;
+    std::vector<ThreadBuffers*> m_buffers;       ///< Buffers of the threads that added elements
+    std::vector<size_t>         m_bufferOffsets; ///< Offset of every buffer in the output
+};
+} // namespace imstk
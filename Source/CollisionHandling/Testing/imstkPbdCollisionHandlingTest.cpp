@@ -0,0 +1,237 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCollisionData.h"
+#include "imstkPbdCollisionHandling.h"
+#include "imstkPbdModel.h"
+#include "imstkPbdModelConfig.h"
+#include "imstkPbdObject.h"
+#include "imstkSurfaceMesh.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Creates a dim x dim grid of vertices triangulated in the xz plane at height y
+///
+std::shared_ptr<SurfaceMesh>
+makeTriangleGrid(const int dim, const double y)
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(dim * dim);
+    auto indices  = std::make_shared<VecDataArray<int, 3>>();
+    for (int z = 0; z < dim; z++)
+    {
+        for (int x = 0; x < dim; x++)
+        {
+            (*vertices)[z * dim + x] = Vec3d(x * 0.1, y + 0.01 * std::sin(x + z), z * 0.1);
+            if (x < dim - 1 && z < dim - 1)
+            {
+                const int i = z * dim + x;
+                indices->push_back(Vec3i(i, i + 1, i + dim));
+                indices->push_back(Vec3i(i + 1, i + dim + 1, i + dim));
+            }
+        }
+    }
+    auto mesh = std::make_shared<SurfaceMesh>();
+    mesh->initialize(vertices, indices);
+    return mesh;
+}
+
+std::shared_ptr<PbdObject>
+makePbdObject(const std::string& name, std::shared_ptr<PbdModel> model, std::shared_ptr<SurfaceMesh> mesh)
+{
+    auto pbdObject = std::make_shared<PbdObject>(name);
+    pbdObject->setPhysicsGeometry(mesh);
+    pbdObject->setCollidingGeometry(mesh);
+    pbdObject->setDynamicalModel(model);
+    pbdObject->getPbdBody()->uniformMassValue = 0.01;
+    return pbdObject;
+}
+
+CollisionElement
+makeCellElement(const CellTypeId cellType, const std::vector<int>& ids)
+{
+    CellIndexElement elem;
+    elem.cellType = cellType;
+    elem.idCount  = static_cast<int>(ids.size());
+    std::copy(ids.begin(), ids.end(), elem.ids);
+    return elem;
+}
+
+///
+/// \brief Two-way element pairs of every deformable case between two grids, plus
+/// one-way point direction elements on A, enough to be filled in parallel
+///
+std::shared_ptr<CollisionData>
+makeCollisionData(const int dim, const bool oneWay)
+{
+    auto      colData  = std::make_shared<CollisionData>();
+    const int numTris  = 2 * (dim - 1) * (dim - 1);
+    const int numVerts = dim * dim;
+    if (oneWay)
+    {
+        for (int i = 0; i < numVerts; i++)
+        {
+            PointIndexDirectionElement elem;
+            elem.ptIndex = i;
+            elem.dir     = Vec3d(0.0, 1.0, 0.0);
+            elem.penetrationDepth = 0.01 * (i % 7);
+            colData->elementsA.push_back(elem);
+        }
+        return colData;
+    }
+    for (int i = 0; i < numTris; i++)
+    {
+        const int v = i % numVerts;
+        // Vertex-triangle, both ways around
+        colData->elementsA.push_back(makeCellElement(IMSTK_VERTEX, { v }));
+        colData->elementsB.push_back(makeCellElement(IMSTK_TRIANGLE, { i }));
+        colData->elementsA.push_back(makeCellElement(IMSTK_TRIANGLE, { i }));
+        colData->elementsB.push_back(makeCellElement(IMSTK_VERTEX, { v }));
+        // Edge-edge
+        colData->elementsA.push_back(makeCellElement(IMSTK_EDGE, { v, (v + 1) % numVerts }));
+        colData->elementsB.push_back(makeCellElement(IMSTK_EDGE, { (v + dim) % numVerts, (v + 1) % numVerts }));
+        // Vertex-edge and vertex-vertex
+        colData->elementsA.push_back(makeCellElement(IMSTK_VERTEX, { v }));
+        colData->elementsB.push_back(makeCellElement(IMSTK_EDGE, { v, (v + dim) % numVerts }));
+        colData->elementsA.push_back(makeCellElement(IMSTK_VERTEX, { v }));
+        colData->elementsB.push_back(makeCellElement(IMSTK_VERTEX, { (v + 3) % numVerts }));
+    }
+    return colData;
+}
+
+///
+/// \brief Handles the collision data between a pbd grid and another grid, pbd or not,
+/// returns the handler and its model
+///
+std::pair<std::shared_ptr<PbdCollisionHandling>, std::shared_ptr<PbdModel>>
+handle(std::shared_ptr<PbdCollisionHandling> handler, const bool objBIsPbd, const bool oneWay)
+{
+    const int dim   = 8;
+    auto      model = std::make_shared<PbdModel>();
+    model->getConfig()->m_doPartitioning = false;
+
+    std::shared_ptr<PbdObject>       objA = makePbdObject("A", model, makeTriangleGrid(dim, 0.0));
+    std::shared_ptr<CollidingObject> objB;
+    if (objBIsPbd)
+    {
+        objB = makePbdObject("B", model, makeTriangleGrid(dim, 0.05));
+    }
+    else
+    {
+        objB = std::make_shared<CollidingObject>("B");
+        objB->setCollidingGeometry(makeTriangleGrid(dim, 0.05));
+    }
+    objA->initialize();
+    objB->initialize();
+    model->initialize();
+
+    std::shared_ptr<CollisionData> colData = makeCollisionData(dim, oneWay);
+    colData->geomA = objA->getCollidingGeometry();
+    colData->geomB = objB->getCollidingGeometry();
+
+    handler->setInputObjectA(objA);
+    handler->setInputObjectB(objB);
+    handler->setInputCollisionData(colData);
+    handler->update();
+    return { handler, model };
+}
+
+///
+/// \brief Checks both handlers generated the same constraints in the same order, virtual
+/// particles may be claimed in another order in parallel so those are compared by position
+///
+void
+expectSameConstraints(PbdCollisionHandling& handlerA, PbdModel& modelA,
+                      PbdCollisionHandling& handlerB, PbdModel& modelB)
+{
+    const std::vector<PbdConstraint*>& constraintsA = handlerA.getConstraints();
+    const std::vector<PbdConstraint*>& constraintsB = handlerB.getConstraints();
+    ASSERT_EQ(constraintsA.size(), constraintsB.size());
+    for (size_t i = 0; i < constraintsA.size(); i++)
+    {
+        PbdConstraint& constraintA = *constraintsA[i];
+        PbdConstraint& constraintB = *constraintsB[i];
+        ASSERT_EQ(typeid(constraintA), typeid(constraintB));
+        EXPECT_EQ(constraintA.getRestValue(), constraintB.getRestValue());
+        EXPECT_EQ(constraintA.getStiffness(), constraintB.getStiffness());
+        EXPECT_EQ(constraintA.getCompliance(), constraintB.getCompliance());
+
+        const std::vector<PbdParticleId>& particlesA = constraintA.getParticles();
+        const std::vector<PbdParticleId>& particlesB = constraintB.getParticles();
+        ASSERT_EQ(particlesA.size(), particlesB.size());
+        for (size_t j = 0; j < particlesA.size(); j++)
+        {
+            ASSERT_EQ(particlesA[j].first, particlesB[j].first);
+            if (particlesA[j].first == 0)
+            {
+                EXPECT_EQ(modelA.getBodies().getPosition(particlesA[j]), modelB.getBodies().getPosition(particlesB[j]));
+            }
+            else
+            {
+                EXPECT_EQ(particlesA[j].second, particlesB[j].second);
+            }
+        }
+    }
+}
+
+///
+/// \brief Counts the vertex-triangle constraints it adds
+///
+class VertexTriangleCountingCH : public PbdCollisionHandling
+{
+public:
+    void addConstraint_V_T(const ColElemSide& sideA, const ColElemSide& sideB) override
+    {
+        m_numVertexTriangle++;
+        PbdCollisionHandling::addConstraint_V_T(sideA, sideB);
+    }
+
+    int m_numVertexTriangle = 0;
+};
+} // namespace
+
+///
+/// \brief Test that generating the contacts in parallel gives the same constraints,
+/// on the same particles with the same rest values, as generating them serially
+///
+TEST(imstkPbdCollisionHandlingTest, ParallelHandlingEquivalent)
+{
+    for (const bool objBIsPbd : { true, false })
+    {
+        for (const bool oneWay : { false, true })
+        {
+            auto serialHandler   = std::make_shared<PbdCollisionHandling>();
+            auto parallelHandler = std::make_shared<PbdCollisionHandling>();
+            parallelHandler->setUseParallelHandling(true);
+            EXPECT_TRUE(parallelHandler->getUseParallelHandling());
+
+            auto serial   = handle(serialHandler, objBIsPbd, oneWay);
+            auto parallel = handle(parallelHandler, objBIsPbd, oneWay);
+            EXPECT_FALSE(serialHandler->getConstraints().empty());
+            expectSameConstraints(*serial.first, *serial.second, *parallel.first, *parallel.second);
+            EXPECT_EQ(serial.second->getBodies().m_bodies[0]->vertices->size(),
+                parallel.second->getBodies().m_bodies[0]->vertices->size());
+        }
+    }
+}
+
+///
+/// \brief Test that a subclass overriding the addConstraint functions still has them
+/// called when parallel handling is asked for
+///
+TEST(imstkPbdCollisionHandlingTest, ParallelHandlingKeepsOverrides)
+{
+    auto handler = std::make_shared<VertexTriangleCountingCH>();
+    handler->setUseParallelHandling(true);
+    handle(handler, true, false);
+
+    // Two pairs of every triangle are vertex-triangle
+    EXPECT_EQ(handler->m_numVertexTriangle, 2 * 2 * 7 * 7);
+}
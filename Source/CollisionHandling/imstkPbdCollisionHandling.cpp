@@ -5,6 +5,7 @@
 */
 
 #include "imstkPbdCollisionHandling.h"
+#include "imstkParallelUtils.h"
 #include "imstkPbdContactConstraint.h"
 #include "imstkPbdEdgeEdgeCCDConstraint.h"
 #include "imstkPbdEdgeEdgeConstraint.h"
@@ -24,6 +25,21 @@ namespace imstk
     m_funcTable[{ case0, case1, case2 }] = [this](const ColElemSide& sideA, const ColElemSide& sideB) \
                                            { func(sideA, sideB); }
 
+///
+/// \brief Adds a zero mass virtual particle, in the next reserved one when handling in parallel
+///
+static PbdParticleId
+addVirtualParticle(const PbdCollisionHandling::CollisionSideData& side, const Vec3d& pos)
+{
+    if (side.virtualParticleCursor == nullptr)
+    {
+        return side.model->addVirtualParticle(pos, 0.0);
+    }
+    const PbdParticleId pid = { 0, (*side.virtualParticleCursor)++ };
+    side.model->setVirtualParticle(pid, pos, 0.0);
+    return pid;
+}
+
 std::pair<PbdParticleId, Vec3d>
 PbdCollisionHandling::getBodyAndContactPoint(const CollisionElement& elem, const CollisionSideData& data)
 {
@@ -84,7 +100,7 @@ getElementVertIds(const CollisionElement& elem, const PbdCollisionHandling::Coll
             int vid = cell[i];
             if (side.bodyId == 0)
             {
-                vid = side.model->addVirtualParticle((*side.vertices)[vid], 0.0).second;
+                vid = addVirtualParticle(side, (*side.vertices)[vid]).second;
             }
             results[i] = { side.bodyId, vid };
         }
@@ -125,7 +141,7 @@ PbdCollisionHandling::getVertex(const CollisionElement& elem, const CollisionSid
         }
         if (side.bodyId == 0)
         {
-            ptId = side.model->addVirtualParticle((*side.vertices)[ptId], 0.0).second;
+            ptId = addVirtualParticle(side, (*side.vertices)[ptId]).second;
         }
         results[0] = { side.bodyId, ptId };
     }
@@ -133,7 +149,7 @@ PbdCollisionHandling::getVertex(const CollisionElement& elem, const CollisionSid
     {
         if (elem.m_type == CollisionElementType::PointDirection)
         {
-            results[0] = { side.model->addVirtualParticle(elem.m_element.m_PointDirectionElement.pt, 0.0) };
+            results[0] = { addVirtualParticle(side, elem.m_element.m_PointDirectionElement.pt) };
         }
     }
     return results;
@@ -190,9 +206,12 @@ PbdCollisionHandling::PbdCollisionHandling()
     REGISTER_CASE(PbdContactCase::Edge, PbdContactCase::Edge, true, addConstraint_E_E_CCD);
 }
 
-PbdCollisionHandling::~PbdCollisionHandling()
+void
+PbdCollisionHandling::setUseParallelHandling(const bool useParallelHandling)
 {
-    deleteCollisionConstraints();
+    LOG_IF(WARNING, useParallelHandling && !getSupportsParallelHandling())
+        << getTypeName() << " may override the addConstraint functions, contacts are generated serially";
+    m_useParallelHandling = useParallelHandling;
 }
 
 PbdCollisionHandling::CollisionSideData
@@ -284,22 +303,6 @@ PbdCollisionHandling::getCaseFromElement(const ColElemSide& elem)
     return PbdContactCase::None;
 }
 
-template<class T>
-T*
-PbdCollisionHandling::getCachedConstraint(ConstraintType type)
-{
-    if (!m_constraintCache[type].empty())
-    {
-        T* result = static_cast<T*>(m_constraintCache[type].back());
-        m_constraintCache[type].pop_back();
-        return result;
-    }
-    else
-    {
-        return new T;
-    }
-}
-
 void
 PbdCollisionHandling::handle(
     const std::vector<CollisionElement>& elementsA,
@@ -333,12 +336,17 @@ PbdCollisionHandling::handle(
         // If obj B is also pbd simulated, make sure they share the same model
         CHECK(dataSideB.pbdObj == nullptr || dataSideA.model == dataSideB.model) <<
             "PbdCollisionHandling input objects must share PbdModel";
+        m_constraintArena = &dataSideA.model->getConstraintArena();
 
         // For CCD (store if available)
         dataSideA.prevGeometry = m_colData->prevGeomA.get();
         dataSideB.prevGeometry = m_colData->prevGeomB.get();
 
-        if (elementsA.size() == elementsB.size())
+        if (m_useParallelHandling && getSupportsParallelHandling())
+        {
+            handleInParallel(elementsA, elementsB, dataSideA, dataSideB);
+        }
+        else if (elementsA.size() == elementsB.size())
         {
             // Deal with two way contacts
             for (size_t i = 0; i < elementsA.size(); i++)
@@ -382,12 +390,12 @@ PbdCollisionHandling::handle(
         }
         // ObjA guaranteed to be PbdObject
         auto pbdObjectA = std::dynamic_pointer_cast<PbdObject>(getInputObjectA());
-        pbdObjectA->getPbdModel()->getSolver()->addConstraints(&m_collisionConstraints);
+        pbdObjectA->getPbdModel()->getSolver()->addConstraints(&m_collisionConstraints, m_constraintListMode);
     }
 }
 
-void
-PbdCollisionHandling::handleElementPair(ColElemSide sideA, ColElemSide sideB)
+PbdCHTableKey
+PbdCollisionHandling::getCaseKey(ColElemSide& sideA, ColElemSide& sideB)
 {
     PbdCHTableKey key;
     key.elemAType = getCaseFromElement(sideA);
@@ -420,6 +428,13 @@ PbdCollisionHandling::handleElementPair(ColElemSide sideA, ColElemSide sideB)
             }
         }
     }
+    return key;
+}
+
+void
+PbdCollisionHandling::handleElementPair(ColElemSide sideA, ColElemSide sideB)
+{
+    const PbdCHTableKey key = getCaseKey(sideA, sideB);
 
     auto iter = m_funcTable.find(key);
     if (iter != m_funcTable.end())
@@ -433,8 +448,170 @@ PbdCollisionHandling::handleElementPair(ColElemSide sideA, ColElemSide sideB)
     }
 }
 
+PbdCollisionHandling::ConstraintType
+PbdCollisionHandling::getConstraintType(const PbdCHTableKey& key)
+{
+    // Mirrors the cases registered in the function table
+    if (key.ccd)
+    {
+        return (key.elemAType == PbdContactCase::Edge && key.elemBType == PbdContactCase::Edge) ? EdgeEdgeCCD : NumTypes;
+    }
+    if (key.elemAType == PbdContactCase::Body)
+    {
+        switch (key.elemBType)
+        {
+        case PbdContactCase::Vertex:
+        case PbdContactCase::Primitive:
+        case PbdContactCase::None:
+            return BodyVertex;
+        case PbdContactCase::Edge:
+            return BodyEdge;
+        case PbdContactCase::Triangle:
+            return BodyTriangle;
+        case PbdContactCase::Body:
+            return BodyBody;
+        default:
+            return NumTypes;
+        }
+    }
+    if (key.elemAType == PbdContactCase::Vertex || key.elemAType == PbdContactCase::Primitive)
+    {
+        switch (key.elemBType)
+        {
+        case PbdContactCase::Vertex:
+            return VertexVertex;
+        case PbdContactCase::Edge:
+            return VertexEdge;
+        case PbdContactCase::Triangle:
+            return VertexTriangle;
+        case PbdContactCase::None:
+            return (key.elemAType == PbdContactCase::Vertex) ? VertexVertex : NumTypes;
+        default:
+            return NumTypes;
+        }
+    }
+    if (key.elemAType == PbdContactCase::Edge && key.elemBType == PbdContactCase::Edge)
+    {
+        return EdgeEdge;
+    }
+    return NumTypes;
+}
+
+template<class T>
+void
+PbdCollisionHandling::fillBucket(ConstraintType type,
+                                 bool (PbdCollisionHandling::* fill)(T&, const ColElemSide&, const ColElemSide&))
+{
+    const std::vector<std::pair<ColElemSide, ColElemSide>>& bucket = m_elementBuckets[type];
+    if (bucket.empty())
+    {
+        return;
+    }
+
+    // Acquire a constraint per element pair up front so they can be filled in parallel
+    const size_t start = m_constraintArena->acquire<T>(bucket.size());
+    m_filled.resize(bucket.size());
+    ParallelUtils::parallelFor(bucket.size(),
+        [&](const size_t i)
+        {
+            m_filled[i] = (this->*fill)(*m_constraintArena->get<T>(start + i), bucket[i].first, bucket[i].second);
+        }, bucket.size() > 50);
+
+    // Filled constraints go to the bin, the others are left unused until the arena resets
+    std::vector<PbdConstraint*>& bin = m_constraintBins[type];
+    for (size_t i = 0; i < bucket.size(); i++)
+    {
+        if (m_filled[i])
+        {
+            bin.push_back(m_constraintArena->get<T>(start + i));
+        }
+    }
+}
+
+void
+PbdCollisionHandling::handleInParallel(
+    const std::vector<CollisionElement>& elementsA,
+    const std::vector<CollisionElement>& elementsB,
+    CollisionSideData& dataSideA, CollisionSideData& dataSideB)
+{
+    // Bucket the element pairs by the constraint they give
+    for (int i = 0; i < NumTypes; i++)
+    {
+        m_elementBuckets[i].clear();
+    }
+    auto bucketElementPair = [&](ColElemSide sideA, ColElemSide sideB)
+                             {
+                                 const PbdCHTableKey  key  = getCaseKey(sideA, sideB);
+                                 const ConstraintType type = getConstraintType(key);
+                                 if (type != NumTypes)
+                                 {
+                                     m_elementBuckets[type].push_back({ sideA, sideB });
+                                 }
+                                 else
+                                 {
+                                     // CH's may not handle all CollisionElements types
+                                     LOG(INFO) << "Could not find handling case " << key;
+                                 }
+                             };
+    size_t numPairs = 0;
+    if (elementsA.size() == elementsB.size())
+    {
+        for (size_t i = 0; i < elementsA.size(); i++)
+        {
+            bucketElementPair({ &elementsA[i], &dataSideA }, { &elementsB[i], &dataSideB });
+        }
+        numPairs = elementsA.size();
+    }
+    else
+    {
+        for (size_t i = 0; i < elementsA.size(); i++)
+        {
+            bucketElementPair({ &elementsA[i], &dataSideA }, { nullptr, nullptr });
+        }
+        for (size_t i = 0; i < elementsB.size(); i++)
+        {
+            bucketElementPair({ &elementsB[i], &dataSideB }, { nullptr, nullptr });
+        }
+        numPairs = elementsA.size() + elementsB.size();
+    }
+
+    // Reserve the virtual particles, a pair adds at most one per vertex of its
+    // non-pbd element plus one to resolve towards, so no more than 4
+    PbdModel*        model = dataSideA.model;
+    const int        firstVirtualId = model->getBodies().m_bodies[0]->vertices->size();
+    std::atomic<int> virtualParticleCursor(firstVirtualId);
+    model->resizeVirtualParticles(firstVirtualId + 4 * static_cast<int>(numPairs));
+    dataSideA.virtualParticleCursor = &virtualParticleCursor;
+    dataSideB.virtualParticleCursor = &virtualParticleCursor;
+
+    fillBucket<PbdBodyToBodyNormalConstraint>(BodyBody, &PbdCollisionHandling::fillConstraint_Body_Body);
+    fillBucket<PbdVertexToBodyConstraint>(BodyVertex, &PbdCollisionHandling::fillConstraint_Body_V);
+    fillBucket<PbdEdgeToBodyConstraint>(BodyEdge, &PbdCollisionHandling::fillConstraint_Body_E);
+    fillBucket<PbdTriangleToBodyConstraint>(BodyTriangle, &PbdCollisionHandling::fillConstraint_Body_T);
+    fillBucket<PbdPointPointConstraint>(VertexVertex, &PbdCollisionHandling::fillConstraint_V_V);
+    fillBucket<PbdPointEdgeConstraint>(VertexEdge, &PbdCollisionHandling::fillConstraint_V_E);
+    fillBucket<PbdEdgeEdgeConstraint>(EdgeEdge, &PbdCollisionHandling::fillConstraint_E_E);
+    fillBucket<PbdPointTriangleConstraint>(VertexTriangle, &PbdCollisionHandling::fillConstraint_V_T);
+    fillBucket<PbdEdgeEdgeCCDConstraint>(EdgeEdgeCCD, &PbdCollisionHandling::fillConstraint_E_E_CCD);
+
+    model->resizeVirtualParticles(virtualParticleCursor);
+    dataSideA.virtualParticleCursor = nullptr;
+    dataSideB.virtualParticleCursor = nullptr;
+}
+
 void
 PbdCollisionHandling::addConstraint_Body_V(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdVertexToBodyConstraint* constraint = m_constraintArena->acquire<PbdVertexToBodyConstraint>();
+    if (fillConstraint_Body_V(*constraint, sideA, sideB))
+    {
+        m_constraintBins[BodyVertex].push_back(constraint);
+    }
+}
+
+bool
+PbdCollisionHandling::fillConstraint_Body_V(PbdVertexToBodyConstraint& constraint,
+                                            const ColElemSide& sideA, const ColElemSide& sideB)
 {
     const std::pair<PbdParticleId, Vec3d>& ptAAndContact = getBodyAndContactPoint(*sideA.elem, *sideA.data);
     PbdParticleId                          ptB;
@@ -461,65 +638,89 @@ PbdCollisionHandling::addConstraint_Body_V(const ColElemSide& sideA, const ColEl
         }
         else
         {
-            return;
+            return false;
         }
-        ptB = sideA.data->model->addVirtualParticle(resolvePos, 0.0);
+        ptB = addVirtualParticle(*sideA.data, resolvePos);
     }
     else
     {
         ptB = getVertex(*sideB.elem, *sideB.data)[0];
     }
 
-    PbdVertexToBodyConstraint* constraint = getCachedConstraint<PbdVertexToBodyConstraint>(BodyVertex);
-    constraint->initConstraint(sideA.data->model->getBodies(),
+    constraint.initConstraint(sideA.data->model->getBodies(),
                         ptAAndContact.first,
                         ptAAndContact.second,
                         ptB,
                         sideA.data->compliance);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[BodyVertex].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_Body_E(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdEdgeToBodyConstraint* constraint = m_constraintArena->acquire<PbdEdgeToBodyConstraint>();
+    fillConstraint_Body_E(*constraint, sideA, sideB);
+    m_constraintBins[BodyEdge].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_Body_E(PbdEdgeToBodyConstraint& constraint,
+                                            const ColElemSide& sideA, const ColElemSide& sideB)
 {
     const std::pair<PbdParticleId, Vec3d>& ptAAndContact = getBodyAndContactPoint(*sideA.elem, *sideA.data);
     std::array<PbdParticleId, 2>           ptsB = getEdge(*sideB.elem, *sideB.data);
 
-    PbdEdgeToBodyConstraint* constraint = getCachedConstraint<PbdEdgeToBodyConstraint>(BodyEdge);
-    constraint->initConstraint(sideB.data->model->getBodies(),
+    constraint.initConstraint(sideB.data->model->getBodies(),
                         ptAAndContact.first,
                         ptAAndContact.second,
                         ptsB[0], ptsB[1],
                         sideA.data->compliance);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[BodyEdge].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_Body_T(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdTriangleToBodyConstraint* constraint = m_constraintArena->acquire<PbdTriangleToBodyConstraint>();
+    fillConstraint_Body_T(*constraint, sideA, sideB);
+    m_constraintBins[BodyTriangle].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_Body_T(PbdTriangleToBodyConstraint& constraint,
+                                            const ColElemSide& sideA, const ColElemSide& sideB)
 {
     const std::pair<PbdParticleId, Vec3d>& ptAAndContact = getBodyAndContactPoint(*sideA.elem, *sideA.data);
     std::array<PbdParticleId, 3>           ptsB = getTriangle(*sideB.elem, *sideB.data);
 
-    PbdTriangleToBodyConstraint* constraint = getCachedConstraint<PbdTriangleToBodyConstraint>(BodyTriangle);
-    constraint->initConstraint(sideB.data->model->getBodies(),
+    constraint.initConstraint(sideB.data->model->getBodies(),
                         ptAAndContact.first,
                         ptAAndContact.second,
                         ptsB[0], ptsB[1], ptsB[2],
                         sideA.data->compliance);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[BodyTriangle].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_Body_Body(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdBodyToBodyNormalConstraint* constraint = m_constraintArena->acquire<PbdBodyToBodyNormalConstraint>();
+    fillConstraint_Body_Body(*constraint, sideA, sideB);
+    m_constraintBins[BodyBody].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_Body_Body(PbdBodyToBodyNormalConstraint& constraint,
+                                               const ColElemSide& sideA, const ColElemSide& sideB)
 {
     const std::pair<PbdParticleId, Vec3d>& ptAAndContact = getBodyAndContactPoint(*sideA.elem, *sideA.data);
     const std::pair<PbdParticleId, Vec3d>& ptBAndContact = getBodyAndContactPoint(*sideB.elem, *sideB.data);
@@ -530,9 +731,7 @@ PbdCollisionHandling::addConstraint_Body_Body(const ColElemSide& sideA, const Co
         normal = sideA.elem->m_element.m_PointDirectionElement.dir;
     }
 
-    PbdBodyToBodyNormalConstraint* constraint = getCachedConstraint<PbdBodyToBodyNormalConstraint>(BodyBody);
-
-    constraint->initConstraint(
+    constraint.initConstraint(
                         sideA.data->model->getBodies(),
                         ptAAndContact.first,
                         ptAAndContact.second,
@@ -540,48 +739,73 @@ PbdCollisionHandling::addConstraint_Body_Body(const ColElemSide& sideA, const Co
                         ptBAndContact.second,
                         normal,
                         sideA.data->compliance);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[BodyBody].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_V_T(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdPointTriangleConstraint* constraint = m_constraintArena->acquire<PbdPointTriangleConstraint>();
+    fillConstraint_V_T(*constraint, sideA, sideB);
+    m_constraintBins[VertexTriangle].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_V_T(PbdPointTriangleConstraint& constraint,
+                                         const ColElemSide& sideA, const ColElemSide& sideB)
 {
     const PbdParticleId          ptA  = getVertex(*sideA.elem, *sideA.data)[0];
     std::array<PbdParticleId, 3> ptsB = getTriangle(*sideB.elem, *sideB.data);
 
-    PbdPointTriangleConstraint* constraint = getCachedConstraint<PbdPointTriangleConstraint>(VertexTriangle);
-    constraint->initConstraint(ptA, ptsB[0], ptsB[1], ptsB[2],
+    constraint.initConstraint(ptA, ptsB[0], ptsB[1], ptsB[2],
                         sideA.data->stiffness, sideB.data->stiffness);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setEnableBoundaryCollisions(m_enableBoundaryCollisions);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[VertexTriangle].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setEnableBoundaryCollisions(m_enableBoundaryCollisions);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_E_E(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdEdgeEdgeConstraint* constraint = m_constraintArena->acquire<PbdEdgeEdgeConstraint>();
+    fillConstraint_E_E(*constraint, sideA, sideB);
+    m_constraintBins[EdgeEdge].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_E_E(PbdEdgeEdgeConstraint& constraint,
+                                         const ColElemSide& sideA, const ColElemSide& sideB)
 {
     std::array<PbdParticleId, 2> ptsA = getEdge(*sideA.elem, *sideA.data);
     std::array<PbdParticleId, 2> ptsB = getEdge(*sideB.elem, *sideB.data);
 
-    PbdEdgeEdgeConstraint* constraint = getCachedConstraint<PbdEdgeEdgeConstraint>(EdgeEdge);
-    constraint->initConstraint(ptsA[0], ptsA[1], ptsB[0], ptsB[1],
+    constraint.initConstraint(ptsA[0], ptsA[1], ptsB[0], ptsB[1],
                         sideA.data->stiffness, sideB.data->stiffness);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setEnableBoundaryCollisions(m_enableBoundaryCollisions);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[EdgeEdge].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setEnableBoundaryCollisions(m_enableBoundaryCollisions);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_E_E_CCD(
     const ColElemSide& sideA,
     const ColElemSide& sideB)
+{
+    PbdEdgeEdgeCCDConstraint* constraint = m_constraintArena->acquire<PbdEdgeEdgeCCDConstraint>();
+    fillConstraint_E_E_CCD(*constraint, sideA, sideB);
+    m_constraintBins[EdgeEdgeCCD].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_E_E_CCD(PbdEdgeEdgeCCDConstraint& constraint,
+                                             const ColElemSide& sideA, const ColElemSide& sideB)
 {
     std::array<PbdParticleId, 2> ptsA = getEdge(*sideA.elem, *sideA.data);
     std::array<PbdParticleId, 2> ptsB = getEdge(*sideB.elem, *sideB.data);
@@ -591,35 +815,53 @@ PbdCollisionHandling::addConstraint_E_E_CCD(
     std::array<Vec3d*, 2> prevPtsA = getElementVertIdsPrev<2>(ptsA, *sideA.data);
     std::array<Vec3d*, 2> prevPtsB = getElementVertIdsPrev<2>(ptsB, *sideB.data);
 
-    PbdEdgeEdgeCCDConstraint* constraint = getCachedConstraint<PbdEdgeEdgeCCDConstraint>(EdgeEdgeCCD);
-    constraint->initConstraint(
+    constraint.initConstraint(
                         prevPtsA[0], prevPtsA[1], prevPtsB[0], prevPtsB[1],
                         ptsA[0], ptsA[1], ptsB[0], ptsB[1],
                         sideA.data->stiffness, sideB.data->stiffness,
                         m_ccdSubsteps);
-    constraint->setEnableBoundaryCollisions(m_enableBoundaryCollisions);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[EdgeEdgeCCD].push_back(constraint);
+    constraint.setEnableBoundaryCollisions(m_enableBoundaryCollisions);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_V_E(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdPointEdgeConstraint* constraint = m_constraintArena->acquire<PbdPointEdgeConstraint>();
+    fillConstraint_V_E(*constraint, sideA, sideB);
+    m_constraintBins[VertexEdge].push_back(constraint);
+}
+
+bool
+PbdCollisionHandling::fillConstraint_V_E(PbdPointEdgeConstraint& constraint,
+                                         const ColElemSide& sideA, const ColElemSide& sideB)
 {
     const PbdParticleId          ptA  = getVertex(*sideA.elem, *sideA.data)[0];
     std::array<PbdParticleId, 2> ptsB = getEdge(*sideB.elem, *sideB.data);
 
-    PbdPointEdgeConstraint* constraint = getCachedConstraint<PbdPointEdgeConstraint>(VertexEdge);
-    constraint->initConstraint(ptA, ptsB[0], ptsB[1],
+    constraint.initConstraint(ptA, ptsB[0], ptsB[1],
                         sideA.data->stiffness, sideB.data->stiffness);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setEnableBoundaryCollisions(m_enableBoundaryCollisions);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[VertexEdge].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setEnableBoundaryCollisions(m_enableBoundaryCollisions);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::addConstraint_V_V(const ColElemSide& sideA, const ColElemSide& sideB)
+{
+    PbdPointPointConstraint* constraint = m_constraintArena->acquire<PbdPointPointConstraint>();
+    if (fillConstraint_V_V(*constraint, sideA, sideB))
+    {
+        m_constraintBins[VertexVertex].push_back(constraint);
+    }
+}
+
+bool
+PbdCollisionHandling::fillConstraint_V_V(PbdPointPointConstraint& constraint,
+                                         const ColElemSide& sideA, const ColElemSide& sideB)
 {
     // One special case with one-way
     const PbdParticleId ptA = getVertex(*sideA.elem, *sideA.data)[0];
@@ -647,44 +889,31 @@ PbdCollisionHandling::addConstraint_V_V(const ColElemSide& sideA, const ColElemS
         }
         else
         {
-            return;
+            return false;
         }
-        ptB = sideA.data->model->addVirtualParticle(resolvePos, 0.0);
+        ptB = addVirtualParticle(*sideA.data, resolvePos);
     }
     else
     {
         ptB = getVertex(*sideB.elem, *sideB.data)[0];
     }
 
-    PbdPointPointConstraint* constraint = getCachedConstraint<PbdPointPointConstraint>(VertexVertex);
-    constraint->initConstraint(ptA, ptB,
+    constraint.initConstraint(ptA, ptB,
                         sideA.data->stiffness,
         (sideB.data == nullptr) ? 0.0 : sideB.data->stiffness);
-    constraint->setFriction(m_friction);
-    constraint->setRestitution(m_restitution);
-    constraint->setEnableBoundaryCollisions(m_enableBoundaryCollisions);
-    constraint->setCorrectVelocity(m_useCorrectVelocity);
-    m_constraintBins[VertexVertex].push_back(constraint);
+    constraint.setFriction(m_friction);
+    constraint.setRestitution(m_restitution);
+    constraint.setEnableBoundaryCollisions(m_enableBoundaryCollisions);
+    constraint.setCorrectVelocity(m_useCorrectVelocity);
+    return true;
 }
 
 void
 PbdCollisionHandling::deleteCollisionConstraints()
 {
-    // Deletes all collision Constraints
-    // There could be a large variance in constraints/contacts count,
-    // 10s to 100s of constraints changing frequently over few frames.
+    // The constraints themselves belong to the arena of the model
     for (int i = 0; i < NumTypes; i++)
     {
-        for (size_t j = 0; j < m_constraintCache[i].size(); j++)
-        {
-            delete  m_constraintCache[i][j];
-        }
-        m_constraintCache[i].resize(0);
-
-        for (size_t j = 0; j < m_constraintBins[i].size(); j++)
-        {
-            delete  m_constraintBins[i][j];
-        }
         m_constraintBins[i].resize(0);
     }
 
@@ -698,8 +927,7 @@ PbdCollisionHandling::orderCollisionConstraints()
     for (int i = 0; i < NumTypes; i++)
     {
         m_collisionConstraints.insert(m_collisionConstraints.end(), m_constraintBins[i].begin(), m_constraintBins[i].end());
-        m_constraintCache[i].insert(m_constraintCache[i].end(), m_constraintBins[i].begin(), m_constraintBins[i].end());
         m_constraintBins[i].resize(0);
     }
 }
-} // namespace imstk
\ No newline at end of file
+} // namespace imstk
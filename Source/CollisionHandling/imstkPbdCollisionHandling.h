@@ -8,7 +8,10 @@
 
 #include "imstkCollisionHandling.h"
 #include "imstkPbdConstraint.h"
+#include "imstkPbdSolver.h"
 
+#include <atomic>
+#include <typeinfo>
 #include <unordered_map>
 
 namespace imstk
@@ -94,8 +97,18 @@ struct hash<imstk::PbdCHTableKey>
 
 namespace imstk
 {
+class PbdBodyToBodyNormalConstraint;
+class PbdConstraintArena;
+class PbdEdgeEdgeCCDConstraint;
+class PbdEdgeEdgeConstraint;
+class PbdEdgeToBodyConstraint;
 class PbdObject;
 class PbdModel;
+class PbdPointEdgeConstraint;
+class PbdPointPointConstraint;
+class PbdPointTriangleConstraint;
+class PbdTriangleToBodyConstraint;
+class PbdVertexToBodyConstraint;
 class PointSet;
 class PointwiseMap;
 
@@ -143,6 +156,8 @@ public:
         int bodyId = 0;
 
         Geometry* prevGeometry = nullptr;
+
+        std::atomic<int>* virtualParticleCursor = nullptr; ///< Next reserved virtual particle when handling in parallel
     };
     ///
     /// \brief Packs the collision element together with the
@@ -155,7 +170,7 @@ public:
     };
 
     PbdCollisionHandling();
-    ~PbdCollisionHandling() override;
+    ~PbdCollisionHandling() override = default;
 
     IMSTK_TYPE_NAME(PbdCollisionHandling)
 
@@ -217,6 +232,26 @@ public:
     double getDeformableStiffnessB() const { return m_stiffness[1]; }
     /// @}
 
+    ///
+    /// \brief Get/Set how the solver projects the constraints of this handler. Defaults
+    /// to serial. Colored projects them in parallel which pays off with many contacts,
+    /// but loses the order given by orderCollisionConstraints
+    /// @{
+    void setConstraintListMode(const PbdSolver::ConstraintListMode mode) { m_constraintListMode = mode; }
+    PbdSolver::ConstraintListMode getConstraintListMode() const { return m_constraintListMode; }
+    /// @}
+
+    ///
+    /// \brief Get/Set whether contacts are generated in parallel. Element pairs are first
+    /// bucketed by case, then the constraints of every bucket are acquired at once and
+    /// filled in parallel. Pays off with thousands of contacts. The addConstraint
+    /// functions are not used in this mode, so it is ignored, with a warning, when
+    /// getSupportsParallelHandling is false. Defaults to false
+    /// @{
+    void setUseParallelHandling(const bool useParallelHandling);
+    bool getUseParallelHandling() const { return m_useParallelHandling; }
+    /// @}
+
     ///
     /// \brief Return the constraints generated by this handler
     /// This list of constraints is ordered in orderCollisionConstraints
@@ -252,6 +287,14 @@ protected:
     ///
     CollisionSideData getDataFromObject(std::shared_ptr<CollidingObject> obj);
 
+    ///
+    /// \brief Whether contacts may be generated in parallel. The parallel handling fills
+    /// the constraints itself, bypassing the addConstraint functions and the function
+    /// table. Subclasses may override or register those, so this is false for them
+    /// unless they override it, true for PbdCollisionHandling itself
+    ///
+    virtual bool getSupportsParallelHandling() const { return typeid(*this) == typeid(PbdCollisionHandling); }
+
     ///
     /// \brief Get the contact case from the collision element and data as
     /// additional context
@@ -270,6 +313,20 @@ protected:
     ///
     void handleElementPair(ColElemSide sideA, ColElemSide sideB);
 
+    ///
+    /// \brief Get the case of an element pair, swaps the sides such that only one
+    /// of symmetric cases has to be handled
+    ///
+    PbdCHTableKey getCaseKey(ColElemSide& sideA, ColElemSide& sideB);
+
+    ///
+    /// \brief Handle all element pairs, bucketed by constraint type and filled in parallel
+    ///
+    void handleInParallel(
+        const std::vector<CollisionElement>& elementsA,
+        const std::vector<CollisionElement>& elementsB,
+        CollisionSideData& dataSideA, CollisionSideData& dataSideB);
+
     // -----------------One-Way Rigid on X Cases-----------------
     virtual void addConstraint_Body_V(
         const ColElemSide& sideA,
@@ -302,6 +359,22 @@ protected:
         const ColElemSide& sideA,
         const ColElemSide& sideB);
 
+    ///
+    /// \brief Initialize the constraint of a case from the element pair, used by the
+    /// addConstraint functions and the parallel handling. Returns false when the pair
+    /// gives no constraint, thread safe when virtual particles are reserved
+    ///@{
+    bool fillConstraint_Body_V(PbdVertexToBodyConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_Body_E(PbdEdgeToBodyConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_Body_T(PbdTriangleToBodyConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_Body_Body(PbdBodyToBodyNormalConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_V_T(PbdPointTriangleConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_E_E(PbdEdgeEdgeConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_E_E_CCD(PbdEdgeEdgeCCDConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_V_E(PbdPointEdgeConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    bool fillConstraint_V_V(PbdPointPointConstraint& constraint, const ColElemSide& sideA, const ColElemSide& sideB);
+    ///@}
+
 private:
     double m_restitution = 0.0;  ///< Coefficient of restitution (1.0 = perfect elastic, 0.0 = inelastic)
     double m_friction    = 0.0;  ///< Coefficient of friction (1.0 = full frictional force, 0.0 = none)
@@ -313,9 +386,11 @@ private:
     bool   m_useCorrectVelocity       = true;
     std::array<double, 2> m_stiffness = { 0.3, 0.3 };
     int m_ccdSubsteps = 25;
+    PbdSolver::ConstraintListMode m_constraintListMode = PbdSolver::ConstraintListMode::Serial; ///< How the solver projects the constraints
+    bool m_useParallelHandling = false;                                                         ///< Generate the contacts in parallel
 
     ///
-    /// \brief Clear the collision constraints without clearning memory
+    /// \brief Clear the collision constraints, their memory belongs to the model
     ///
     void deleteCollisionConstraints();
 
@@ -349,17 +424,31 @@ protected:
         NumTypes
     };
 
+
+    ///
+    /// \brief Get the type of constraint a case gives, NumTypes if not handled
+    ///
+    static ConstraintType getConstraintType(const PbdCHTableKey& key);
+
+    ///
+    /// \brief Acquires a constraint per element pair of a bucket from the arena and
+    /// fills them in parallel. Filled constraints are added to the bin in the order
+    /// of the bucket
+    ///
     template<class T>
-    T* getCachedConstraint(ConstraintType type);
+    void fillBucket(ConstraintType type,
+                    bool (PbdCollisionHandling::* fill)(T&, const ColElemSide&, const ColElemSide&));
 
     // Vectors to split out constraint types and allow for ordering
-    // A single constraint instance should always either be in a bin or the cache
-    // additionally it _may_ be in the m_collisionConstraints structure
+    // Constraints are acquired from the arena of the model, so they live for a frame
     std::vector<PbdConstraint*> m_constraintBins[NumTypes];
-    std::vector<PbdConstraint*> m_constraintCache[NumTypes];
+    PbdConstraintArena*         m_constraintArena = nullptr; ///< Arena of the model handled last
 
     std::vector<PbdConstraint*> m_collisionConstraints; ///< Vector of all collision constraints
 
+    std::vector<std::pair<ColElemSide, ColElemSide>> m_elementBuckets[NumTypes]; ///< Element pairs by constraint type, for parallel handling
+    std::vector<char> m_filled;                                                   ///< If the constraint of a bucket element was filled
+
     std::unordered_map<PbdCHTableKey, std::function<void(
                                                         const ColElemSide& elemA, const ColElemSide& elemB)>> m_funcTable;
 };
@@ -370,6 +370,7 @@ RigidBodyCH::addConstraint(
             m_beta,
             RbdConstraint::Side::A);
     contactConstraint->compute(rbdObj->getRigidBodyModel2()->getTimeStep());
+    contactConstraint->m_id = rbdObj->getRigidBodyModel2()->computeContactId(*rbdObj->getRigidBody(), nullptr, contactPt, 0);
     rbdObj->getRigidBodyModel2()->addConstraint(contactConstraint);
 
     if (m_useFriction)
@@ -381,6 +382,7 @@ RigidBodyCH::addConstraint(
                 m_frictionalCoefficient,
                 RbdConstraint::Side::A);
         frictionConstraint->compute(rbdObj->getRigidBodyModel2()->getTimeStep());
+        frictionConstraint->m_id = rbdObj->getRigidBodyModel2()->computeContactId(*rbdObj->getRigidBody(), nullptr, contactPt, 1);
         rbdObj->getRigidBodyModel2()->addConstraint(frictionConstraint);
     }
 }
@@ -400,6 +402,8 @@ RigidBodyCH::addConstraint(
             contactNormal.normalized(), contactPt, contactDepth,
             m_beta);
         contactConstraint->compute(rbdObjA->getRigidBodyModel2()->getTimeStep());
+        contactConstraint->m_id = rbdObjA->getRigidBodyModel2()->computeContactId(
+            *rbdObjA->getRigidBody(), rbdObjB->getRigidBody().get(), contactPt, 0);
         rbdObjA->getRigidBodyModel2()->addConstraint(contactConstraint);
 
         if (m_useFriction)
@@ -410,6 +414,8 @@ RigidBodyCH::addConstraint(
                     m_frictionalCoefficient,
                     RbdConstraint::Side::AB);
             frictionConstraint->compute(rbdObjA->getRigidBodyModel2()->getTimeStep());
+            frictionConstraint->m_id = rbdObjA->getRigidBodyModel2()->computeContactId(
+                *rbdObjA->getRigidBody(), rbdObjB->getRigidBody().get(), contactPt, 1);
             rbdObjA->getRigidBodyModel2()->addConstraint(frictionConstraint);
         }
     }
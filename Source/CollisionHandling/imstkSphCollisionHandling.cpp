@@ -36,6 +36,30 @@ SphCollisionHandling::handle(
         << "Invalid boundary friction coefficient (value must be in [0, 1])";
 #endif
 
+    // The fluid is stepped on another thread, it applies the corrections before its next step
+    if (sphModel->getAsyncStepping())
+    {
+        std::vector<std::pair<size_t, Vec3d>> corrections;
+        corrections.reserve(elementsA.size());
+        for (const CollisionElement& colElem : elementsA)
+        {
+            if (colElem.m_type == CollisionElementType::PointIndexDirection)
+            {
+                const int particleIndex = colElem.m_element.m_PointIndexDirectionElement.ptIndex;
+                const Vec3d& n     = -colElem.m_element.m_PointIndexDirectionElement.dir;
+                const double depth = colElem.m_element.m_PointIndexDirectionElement.penetrationDepth;
+                corrections.push_back({ static_cast<size_t>(particleIndex), n * depth });
+            }
+        }
+        const double boundaryFriction = m_boundaryFriction;
+        sphModel->queueParticleCorrections(corrections,
+            [boundaryFriction](Vec3d& pos, Vec3d& velocity, const Vec3d& penetrationVector)
+            {
+                solve(pos, velocity, penetrationVector, boundaryFriction);
+            });
+        return;
+    }
+
     std::shared_ptr<SphState>                state = sphModel->getCurrentState();
     std::shared_ptr<VecDataArray<double, 3>> positionsPtr  = state->getPositions();
     std::shared_ptr<VecDataArray<double, 3>> velocitiesPtr = state->getVelocities();
@@ -62,14 +86,14 @@ SphCollisionHandling::handle(
                     const int particleIndex = colElem.m_element.m_PointIndexDirectionElement.ptIndex;
                     const Vec3d& n     = -colElem.m_element.m_PointIndexDirectionElement.dir;
                     const double depth = colElem.m_element.m_PointIndexDirectionElement.penetrationDepth;
-                    solve(positions[particleIndex], velocities[particleIndex], n * depth);
+                    solve(positions[particleIndex], velocities[particleIndex], n * depth, m_boundaryFriction);
                 }
             });
     }
 }
 
 void
-SphCollisionHandling::solve(Vec3d& pos, Vec3d& velocity, const Vec3d& penetrationVector)
+SphCollisionHandling::solve(Vec3d& pos, Vec3d& velocity, const Vec3d& penetrationVector, const double boundaryFriction)
 {
     // Correct particle position
     pos -= penetrationVector;
@@ -90,10 +114,10 @@ SphCollisionHandling::solve(Vec3d& pos, Vec3d& velocity, const Vec3d& penetratio
     {
         Vec3d correctedVel = oldVel - vn * n; // From now, vel is parallel with the solid surface
 
-        if (m_boundaryFriction > 1.0e-20)
+        if (boundaryFriction > 1.0e-20)
         {
             const double velLength      = correctedVel.norm();
-            const double frictionLength = vn * m_boundaryFriction; // This is always positive
+            const double frictionLength = vn * boundaryFriction; // This is always positive
             if (frictionLength < velLength && velLength > 1.0e-10)
             {
                 correctedVel -= (correctedVel / velLength) * frictionLength; // Subtract a friction from velocity, which is proportional to the amount of penetration
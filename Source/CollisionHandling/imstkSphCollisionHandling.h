@@ -20,7 +20,8 @@ class SphObject;
 ///
 /// \brief The SphCollisionHandling consumes PointIndexDirection contact data
 /// to resolve positions and correct velocities of SPH particles. It does
-/// not correct pressures/densities.
+/// not correct pressures/densities. When the fluid is stepped on its own
+/// thread the corrections are queued to the model instead.
 ///
 class SphCollisionHandling : public CollisionHandling
 {
@@ -55,7 +56,7 @@ protected:
     ///
     /// \brief Solves positiona and corrects velocity of individual particle
     ///
-    void solve(Vec3d& pos, Vec3d& velocity, const Vec3d& penetrationVector);
+    static void solve(Vec3d& pos, Vec3d& velocity, const Vec3d& penetrationVector, const double boundaryFriction);
 
 private:
     std::shared_ptr<CollisionDetectionAlgorithm> m_colDetect = nullptr;
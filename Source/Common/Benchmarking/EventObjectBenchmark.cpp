@@ -0,0 +1,122 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkEventObject.h"
+#include "imstkParallelUtils.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace imstk;
+
+class BenchmarkSender : public EventObject
+{
+public:
+    /* *INDENT-OFF* */
+    SIGNAL(BenchmarkSender, modified);
+    SIGNAL(BenchmarkSender, other);
+    /* *INDENT-ON* */
+};
+
+class BenchmarkReceiver : public EventObject
+{
+public:
+    void receive(Event*) { count++; }
+
+    int count = 0;
+};
+
+///
+/// \brief Post to a sender with observers on other signals only, the cost paid by
+/// most modified events
+///
+static void
+BM_PostNoObserver(benchmark::State& state)
+{
+    auto sender   = std::make_shared<BenchmarkSender>();
+    auto receiver = std::make_shared<BenchmarkReceiver>();
+    connect(sender, BenchmarkSender::other, receiver, &BenchmarkReceiver::receive);
+
+    for (auto _ : state)
+    {
+        sender->postEvent(Event(BenchmarkSender::modified()));
+    }
+}
+
+BENCHMARK(BM_PostNoObserver)->Unit(benchmark::kNanosecond);
+
+///
+/// \brief Post and dispatch to a number of direct observers
+///
+static void
+BM_PostDirect(benchmark::State& state)
+{
+    auto sender   = std::make_shared<BenchmarkSender>();
+    auto receiver = std::make_shared<BenchmarkReceiver>();
+    for (int i = 0; i < state.range(0); i++)
+    {
+        connect(sender, BenchmarkSender::modified, receiver, &BenchmarkReceiver::receive);
+    }
+
+    for (auto _ : state)
+    {
+        sender->postEvent(Event(BenchmarkSender::modified()));
+    }
+    benchmark::DoNotOptimize(receiver->count);
+}
+
+BENCHMARK(BM_PostDirect)->Unit(benchmark::kNanosecond)->Arg(1)->Arg(4)->Arg(16);
+
+///
+/// \brief Post to a number of queued observers then dispatch the queue
+///
+static void
+BM_PostQueued(benchmark::State& state)
+{
+    auto sender   = std::make_shared<BenchmarkSender>();
+    auto receiver = std::make_shared<BenchmarkReceiver>();
+    for (int i = 0; i < state.range(0); i++)
+    {
+        queueConnect(sender, BenchmarkSender::modified, receiver, &BenchmarkReceiver::receive);
+    }
+
+    for (auto _ : state)
+    {
+        sender->postEvent(Event(BenchmarkSender::modified()));
+        receiver->doAllEvents();
+    }
+    benchmark::DoNotOptimize(receiver->count);
+}
+
+BENCHMARK(BM_PostQueued)->Unit(benchmark::kNanosecond)->Arg(1)->Arg(4)->Arg(16);
+
+///
+/// \brief Post from many threads to one queued observer, then dispatch on one
+///
+static void
+BM_PostQueuedFromThreads(benchmark::State& state)
+{
+    auto sender   = std::make_shared<BenchmarkSender>();
+    auto receiver = std::make_shared<BenchmarkReceiver>();
+    queueConnect(sender, BenchmarkSender::modified, receiver, &BenchmarkReceiver::receive);
+
+    const int numPosts = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        ParallelUtils::parallelFor(numPosts,
+            [&](const int)
+            {
+                sender->postEvent(Event(BenchmarkSender::modified()));
+            });
+        receiver->doAllEvents();
+    }
+    state.counters["Posts"] = benchmark::Counter(static_cast<double>(numPosts),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_PostQueuedFromThreads)->Unit(benchmark::kMicrosecond)->Arg(1000)->Arg(10000);
+
+// Run the benchmark
+BENCHMARK_MAIN();
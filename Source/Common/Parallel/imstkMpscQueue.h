@@ -0,0 +1,181 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace imstk
+{
+namespace ParallelUtils
+{
+///
+/// \class MpscQueue
+///
+/// \brief Lock free multiple producer single consumer queue. Any thread may push,
+/// only one thread at a time may pop. Push is a single atomic exchange, pop does
+/// not wait on producers.
+///
+/// Nodes are recycled, a node popped by the consumer goes back to the thread that
+/// pushed it, so a steady stream of pushes does not allocate.
+///
+/// A push that has not finished linking its node may not yet be visible to a
+/// concurrent pop, the queue then appears to end early and the value is seen on the
+/// next pop. Copies of the queue are empty, as with SpinLock it can be a member of
+/// copyable classes. The per thread node caches are created on the first push, a
+/// queue never pushed to holds none.
+///
+template<typename T>
+class MpscQueue
+{
+protected:
+    struct NodeCache;
+
+    struct Node
+    {
+        T value;
+        std::atomic<Node*> next  = { nullptr };
+        NodeCache*         owner = nullptr;
+    };
+
+    ///
+    /// \brief Nodes of a producer thread, returned holds nodes popped by the consumer
+    /// until the producer takes them all back
+    ///
+    struct NodeCache
+    {
+        std::vector<std::unique_ptr<Node>> nodes;
+        std::vector<Node*> free;
+        std::atomic<Node*> returned = { nullptr };
+    };
+
+public:
+    MpscQueue() { init(); }
+    MpscQueue(const MpscQueue&) { init(); }
+    virtual ~MpscQueue() { delete m_caches.load(std::memory_order_acquire); }
+
+    MpscQueue& operator=(const MpscQueue&) { return *this; }
+
+public:
+    ///
+    /// \brief Push a value to the back of the queue, thread safe
+    ///
+    void push(T value)
+    {
+        Node* node = acquireNode();
+        node->value = std::move(value);
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    ///
+    /// \brief Pop a value from the front of the queue, consumer only
+    /// \return false if empty
+    ///
+    bool pop(T& value)
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        // The popped node stays as the new stub, the old stub is recycled
+        value       = std::move(next->value);
+        next->value = T();
+        m_tail      = next;
+        releaseNode(tail);
+        return true;
+    }
+
+    ///
+    /// \brief Returns if the queue is empty, consumer only
+    ///
+    bool empty() const { return m_tail->next.load(std::memory_order_acquire) == nullptr; }
+
+protected:
+    void init()
+    {
+        m_stub.next.store(nullptr, std::memory_order_relaxed);
+        m_head.store(&m_stub, std::memory_order_relaxed);
+        m_tail = &m_stub;
+    }
+
+    Node* acquireNode()
+    {
+        NodeCache& cache = getCaches().local();
+        if (cache.free.empty())
+        {
+            // Take back the nodes the consumer is done with
+            Node* node = cache.returned.exchange(nullptr, std::memory_order_acquire);
+            while (node != nullptr)
+            {
+                cache.free.push_back(node);
+                node = node->next.load(std::memory_order_relaxed);
+            }
+        }
+        if (cache.free.empty())
+        {
+            cache.nodes.push_back(std::make_unique<Node>());
+            cache.nodes.back()->owner = &cache;
+            return cache.nodes.back().get();
+        }
+        Node* node = cache.free.back();
+        cache.free.pop_back();
+        return node;
+    }
+
+    ///
+    /// \brief Returns the node caches, created by the first push
+    ///
+    tbb::enumerable_thread_specific<NodeCache>& getCaches()
+    {
+        tbb::enumerable_thread_specific<NodeCache>* caches = m_caches.load(std::memory_order_acquire);
+        if (caches == nullptr)
+        {
+            auto newCaches = new tbb::enumerable_thread_specific<NodeCache>();
+            if (m_caches.compare_exchange_strong(caches, newCaches, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                caches = newCaches;
+            }
+            else
+            {
+                // Another producer created them first
+                delete newCaches;
+            }
+        }
+        return *caches;
+    }
+
+    void releaseNode(Node* node)
+    {
+        if (node == &m_stub)
+        {
+            return;
+        }
+        std::atomic<Node*>& returned = node->owner->returned;
+        Node*               head     = returned.load(std::memory_order_relaxed);
+        do
+        {
+            node->next.store(head, std::memory_order_relaxed);
+        }
+        while (!returned.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    Node m_stub;                ///< Node the queue starts with, holds no value
+    std::atomic<Node*> m_head;  ///< Last pushed node, producers push after it
+    Node*              m_tail;  ///< Node before the front, owned by the consumer
+
+    std::atomic<tbb::enumerable_thread_specific<NodeCache>*> m_caches = { nullptr }; ///< Nodes of each producer thread
+};
+} // namespace ParallelUtils
+} // namespace imstk
@@ -173,5 +173,28 @@ findAABB(const VecDataArray<double, 3>& points, Vec3d& lowerCorner, Vec3d& upper
     lowerCorner = pObj.getLowerCorner();
     upperCorner = pObj.getUpperCorner();
 }
+
+///
+/// \brief In place inclusive prefix sum, data[i] becomes data[0] + ... + data[i]
+///
+template<typename T>
+void
+inclusiveScan(std::vector<T>& data)
+{
+    tbb::parallel_scan(tbb::blocked_range<size_t>(0, data.size()), T(0),
+        [&](const tbb::blocked_range<size_t>& r, T sum, const bool isFinalScan)
+        {
+            for (size_t i = r.begin(); i != r.end(); i++)
+            {
+                sum += data[i];
+                if (isFinalScan)
+                {
+                    data[i] = sum;
+                }
+            }
+            return sum;
+        },
+        [](const T& a, const T& b) { return a + b; });
+}
 } // end namespace ParallelUtils
 } // end namespace imstk
@@ -108,6 +108,7 @@ TaskGraph::addEdge(std::shared_ptr<TaskNode> srcNode, std::shared_ptr<TaskNode>
 
     m_adjList[srcNode].insert(destNode);
     m_invAdjList[destNode].insert(srcNode);
+    modified();
 }
 
 void
@@ -165,6 +166,7 @@ TaskGraph::removeEdge(std::shared_ptr<TaskNode> srcNode, std::shared_ptr<TaskNod
     {
         m_invAdjList.erase(destNode);
     }
+    modified();
 }
 
 bool
@@ -175,6 +177,7 @@ TaskGraph::addNode(std::shared_ptr<TaskNode> node)
     {
         // Put it in this graph
         m_nodes.push_back(node);
+        modified();
         return true;
     }
     else
@@ -194,6 +197,7 @@ TaskGraph::addFunction(std::string name, std::function<void()> func)
 {
     std::shared_ptr<TaskNode> node = std::make_shared<TaskNode>(func, name);
     m_nodes.push_back(node);
+    modified();
     return node;
 }
 
@@ -223,6 +227,7 @@ TaskGraph::removeNode(std::shared_ptr<TaskNode> node)
     if (it != endNode())
     {
         m_nodes.erase(it);
+        modified();
     }
     return true;
 }
@@ -262,6 +267,7 @@ TaskGraph::removeNodeAndRedirect(std::shared_ptr<TaskNode> node)
     if (it != endNode())
     {
         m_nodes.erase(it);
+        modified();
     }
 
     return true;
@@ -598,6 +604,7 @@ TaskGraph::removeUnusedNodes(std::shared_ptr<TaskGraph> graph)
     {
         results->m_nodes[iter++] = i;
     }
+    results->modified();
     return results;
 }
 
@@ -791,4 +798,81 @@ TaskGraph::getCriticalPath(std::shared_ptr<TaskGraph> graph)
     results.push_front(graph->getSource());
     return results;
 }
+
+std::vector<std::pair<std::shared_ptr<TaskNode>, std::shared_ptr<TaskNode>>>
+TaskGraph::getUnorderedWrites(std::shared_ptr<TaskGraph> graph)
+{
+    using NodePair = std::pair<std::shared_ptr<TaskNode>, std::shared_ptr<TaskNode>>;
+
+    // Gather the writers of every resource
+    std::unordered_map<const void*, TaskNodeVector> resourceWriters;
+    for (const auto& node : graph->getNodes())
+    {
+        for (const void* resource : node->m_writes)
+        {
+            if (resource != nullptr)
+            {
+                resourceWriters[resource].push_back(node);
+            }
+        }
+    }
+
+    // Compute the nodes reachable from a writer via BFS, cached per node
+    const TaskNodeAdjList& adjList = graph->getAdjList();
+    std::unordered_map<std::shared_ptr<TaskNode>, TaskNodeSet> descendants;
+    auto getDescendants =
+        [&](const std::shared_ptr<TaskNode>& node) -> const TaskNodeSet&
+        {
+            auto iter = descendants.find(node);
+            if (iter != descendants.end())
+            {
+                return iter->second;
+            }
+            TaskNodeSet& visitedNodes = descendants[node];
+            std::queue<std::shared_ptr<TaskNode>> nodeQueue;
+            nodeQueue.push(node);
+            while (!nodeQueue.empty())
+            {
+                std::shared_ptr<TaskNode> currNode = nodeQueue.front();
+                nodeQueue.pop();
+                if (adjList.count(currNode) != 0)
+                {
+                    for (const auto& childNode : adjList.at(currNode))
+                    {
+                        if (visitedNodes.insert(childNode).second)
+                        {
+                            nodeQueue.push(childNode);
+                        }
+                    }
+                }
+            }
+            return visitedNodes;
+        };
+
+    std::vector<NodePair> results;
+    std::unordered_set<size_t> reportedPairs; // Pairs may share multiple resources
+    for (const auto& writers : resourceWriters)
+    {
+        const TaskNodeVector& nodes = writers.second;
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            for (size_t j = i + 1; j < nodes.size(); j++)
+            {
+                if (nodes[i] == nodes[j]
+                    || getDescendants(nodes[i]).count(nodes[j]) != 0
+                    || getDescendants(nodes[j]).count(nodes[i]) != 0)
+                {
+                    continue;
+                }
+                const size_t id1 = std::min(nodes[i]->getGlobalId(), nodes[j]->getGlobalId());
+                const size_t id2 = std::max(nodes[i]->getGlobalId(), nodes[j]->getGlobalId());
+                if (reportedPairs.insert(id1 * TaskNode::getNumGlobalIds() + id2).second)
+                {
+                    results.push_back(NodePair(nodes[i], nodes[j]));
+                }
+            }
+        }
+    }
+    return results;
+}
 } // namespace imstk
\ No newline at end of file
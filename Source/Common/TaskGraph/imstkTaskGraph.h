@@ -70,7 +70,8 @@ public:
 
     ///
     /// \brief Get the nodes belonging to this graph
-    /// HS This is bad, there are algorithms that change the nodes of the graph from the outside
+    /// HS This is bad, there are algorithms that change the nodes of the graph from the outside,
+    /// those must call modified()
     ///
     TaskNodeVector& getNodes() { return m_nodes; }
 
@@ -197,8 +198,22 @@ public:
     {
         m_adjList.clear();
         m_invAdjList.clear();
+        modified();
     }
 
+    ///
+    /// \brief Marks the graph as changed. Called by every node & edge operation,
+    /// needs to be called manually when nodes are changed through getNodes
+    ///
+    void modified() { m_modifiedCount++; }
+
+    ///
+    /// \brief Returns the number of times the graph was changed. Controllers
+    /// compare it with the value seen when they last built their execution
+    /// structures to detect changes
+    ///
+    size_t getModifiedCount() const { return m_modifiedCount; }
+
 // Graph algorithms, todo: Move into filtering module
 public:
     ///
@@ -261,6 +276,13 @@ public:
     ///
     static TaskNodeList getCriticalPath(std::shared_ptr<TaskGraph> graph);
 
+    ///
+    /// \brief Returns every pair of nodes that write the same resource (TaskNode::m_writes)
+    /// where neither node reaches the other. Such nodes may run concurrently when the
+    /// graph is executed in parallel
+    ///
+    static std::vector<std::pair<std::shared_ptr<TaskNode>, std::shared_ptr<TaskNode>>> getUnorderedWrites(std::shared_ptr<TaskGraph> graph);
+
 protected:
     TaskNodeVector  m_nodes;
     TaskNodeAdjList m_adjList;    ///< This gives the outputs of every node
@@ -268,5 +290,7 @@ protected:
 
     std::shared_ptr<TaskNode> m_source = nullptr;
     std::shared_ptr<TaskNode> m_sink   = nullptr;
+
+    size_t m_modifiedCount = 0;
 };
 } // namespace imstk
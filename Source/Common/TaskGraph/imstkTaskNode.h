@@ -9,6 +9,7 @@
 #include <atomic>
 #include <functional>
 #include <string>
+#include <vector>
 
 namespace imstk
 {
@@ -39,6 +40,7 @@ public:
         m_computeTime  = other.m_computeTime;
         m_enableTiming = other.m_enableTiming;
         m_func         = other.m_func;
+        m_writes       = other.m_writes;
         m_globalId     = getUniqueID();
     }
 
@@ -52,6 +54,7 @@ public:
         m_computeTime  = other.m_computeTime;
         m_enableTiming = other.m_enableTiming;
         m_func         = other.m_func;
+        m_writes       = other.m_writes;
         m_globalId     = getUniqueID();
     }
 
@@ -95,6 +98,12 @@ public:
     double m_computeTime  = 0.0;
     bool   m_enableTiming = false;
 
+    ///
+    /// Resources (ie: geometries) the function writes. Only used to check that
+    /// nodes writing the same resource are ordered, see TaskGraph::getUnorderedWrites
+    ///
+    std::vector<const void*> m_writes;
+
 protected:
     std::function<void()> m_func = nullptr; ///< Don't allow user to call directly (must use execute)
 
@@ -17,32 +17,61 @@ using namespace tbb::flow;
 
 namespace imstk
 {
-void
-TbbTaskGraphController::execute()
+///
+/// \struct TbbFlowGraph
+///
+/// \brief The tbb flow graph built from a TaskGraph. Member order matters,
+/// the nodes have to be destroyed before the graph
+///
+struct TbbFlowGraph
 {
     using TbbContinueNode = continue_node<continue_msg>;
 
+    TbbFlowGraph() : start(g) { }
+
     graph g;
+    broadcast_node<continue_msg> start;
+    std::vector<std::unique_ptr<TbbContinueNode>> nodes;
+};
 
-    broadcast_node<continue_msg> start(g);
+TbbTaskGraphController::TbbTaskGraphController() = default;
 
-    // Create a continue node for every TaskNode (except start)
-    std::unordered_map<std::shared_ptr<TaskNode>, TbbContinueNode> tbbNodes;
-    using NodeKeyValuePair = std::pair<std::shared_ptr<TaskNode>, TbbContinueNode>;
+TbbTaskGraphController::~TbbTaskGraphController() = default;
+
+void
+TbbTaskGraphController::setTaskGraph(std::shared_ptr<TaskGraph> graph)
+{
+    TaskGraphController::setTaskGraph(graph);
+    m_flowGraph = nullptr;
+}
+
+void
+TbbTaskGraphController::init()
+{
+    buildFlowGraph();
+}
+
+void
+TbbTaskGraphController::buildFlowGraph()
+{
+    using TbbContinueNode = TbbFlowGraph::TbbContinueNode;
+
+    m_flowGraph = std::make_unique<TbbFlowGraph>();
+    m_flowGraphModifiedCount = m_graph->getModifiedCount();
 
+    // Create a continue node for every TaskNode (except start)
     const TaskNodeVector& nodes = m_graph->getNodes();
-    if (nodes.size() == 0)
-    {
-        return;
-    }
+    std::unordered_map<std::shared_ptr<TaskNode>, TbbContinueNode*> tbbNodes;
     tbbNodes.reserve(nodes.size());
+    m_flowGraph->nodes.reserve(nodes.size());
     for (size_t i = 0; i < nodes.size(); i++)
     {
         if (m_graph->getSource() != nodes[i])
         {
             std::shared_ptr<TaskNode> node = nodes[i];
-            tbbNodes.insert(NodeKeyValuePair(node, TbbContinueNode(g,
-                [node](continue_msg) { node->execute(); })));
+            m_flowGraph->nodes.push_back(std::make_unique<TbbContinueNode>(m_flowGraph->g,
+                [node](continue_msg) { node->execute(); }));
+            tbbNodes[node] = m_flowGraph->nodes.back().get();
         }
     }
 
@@ -53,22 +82,35 @@ TbbTaskGraphController::execute()
         {
             for (const auto& outputNode : i.second)
             {
-                TbbContinueNode& tbbNode2 = tbbNodes.at(outputNode);
-                make_edge(start, tbbNode2);
+                make_edge(m_flowGraph->start, *tbbNodes.at(outputNode));
             }
         }
         else
         {
-            TbbContinueNode& tbbNode1 = tbbNodes.at(i.first);
+            TbbContinueNode& tbbNode1 = *tbbNodes.at(i.first);
             for (const auto& outputNode : i.second)
             {
-                TbbContinueNode& tbbNode2 = tbbNodes.at(outputNode);
-                make_edge(tbbNode1, tbbNode2);
+                make_edge(tbbNode1, *tbbNodes.at(outputNode));
             }
         }
     }
+}
+
+void
+TbbTaskGraphController::execute()
+{
+    if (m_graph == nullptr || m_graph->getNodes().size() == 0)
+    {
+        return;
+    }
+
+    // Only rebuild when the TaskGraph changed since the last build
+    if (m_flowGraph == nullptr || m_flowGraphModifiedCount != m_graph->getModifiedCount())
+    {
+        buildFlowGraph();
+    }
 
-    start.try_put(continue_msg());
-    g.wait_for_all();
+    m_flowGraph->start.try_put(continue_msg());
+    m_flowGraph->g.wait_for_all();
 }
-} // namespace imstk
\ No newline at end of file
+} // namespace imstk
@@ -10,14 +10,34 @@
 
 namespace imstk
 {
+struct TbbFlowGraph;
+
 ///
 /// \class TbbTaskGraphController
 ///
-/// \brief This class runs an input TaskGraph in parallel using tbb tasks
+/// \brief This class runs an input TaskGraph in parallel using tbb tasks.
+/// The tbb flow graph is built once on initialize and reused by every
+/// execute, it is only rebuilt when the TaskGraph is modified
 ///
 class TbbTaskGraphController : public TaskGraphController
 {
 public:
+    TbbTaskGraphController();
+    ~TbbTaskGraphController() override;
+
+    void setTaskGraph(std::shared_ptr<TaskGraph> graph) override;
+
     void execute() override;
+
+protected:
+    void init() override;
+
+    ///
+    /// \brief Builds the tbb flow graph from the TaskGraph
+    ///
+    void buildFlowGraph();
+
+    std::unique_ptr<TbbFlowGraph> m_flowGraph;
+    size_t m_flowGraphModifiedCount = 0; ///< TaskGraph modified count the flow graph was built with
 };
-}; // namespace imstk
\ No newline at end of file
+}; // namespace imstk
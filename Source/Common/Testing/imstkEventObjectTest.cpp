@@ -8,6 +8,7 @@
 #include "gmock/gmock.h"
 
 #include "imstkEventObject.h"
+#include "imstkParallelUtils.h"
 
 using namespace imstk;
 using testing::ElementsAre;
@@ -32,6 +33,18 @@ public:
     }
 };
 
+///
+/// \brief Event larger than the payload of a Command
+///
+class MockLargeEvent : public imstk::Event
+{
+public:
+    MockLargeEvent(const Signal type, const int value) : Event(type), m_value(value) { }
+
+    int    m_value;
+    double m_data[16] = {};
+};
+
 class MockReceiver : public imstk::EventObject
 {
 public:
@@ -180,6 +193,33 @@ TEST(imstkEventObjectTest, PointerQueuedForeachBackwards)
     EXPECT_THAT(r->items, ElementsAre(2, 1));
 }
 
+///
+/// \brief Test that a queued handler may process the events of its receiver again,
+/// events queued during processing are done by the nested call
+///
+TEST(imstkEventObjectTest, QueuedReentrant)
+{
+    auto m = std::make_shared<MockSender>();
+    auto r = std::make_shared<MockReceiver>();
+
+    queueConnect(m, MockSender::SignalTwo, r, &MockReceiver::receiverTwo);
+    queueConnect<Event>(m, MockSender::SignalOne, r,
+        [&](Event*)
+        {
+            r->items.push_back(1);
+            m->postTwo();
+            r->doAllEvents();
+        });
+
+    m->postOne();
+    m->postOne();
+    r->doAllEvents();
+    EXPECT_THAT(r->items, ElementsAre(1, 2, 1, 2));
+
+    r->doAllEvents();
+    EXPECT_THAT(r->items, ElementsAre(1, 2, 1, 2));
+}
+
 ///
 /// \brief Test that when a receiver is deconstructed it is removed
 /// and others still work
@@ -209,4 +249,41 @@ TEST(imstkEventObjectTest, ReceiverDeconstruct)
 
     // r1 should increment to 2
     EXPECT_EQ(2, r1->items.size());
-}
\ No newline at end of file
+}
+
+///
+/// \brief Test that events queued from many threads are all received
+///
+TEST(imstkEventObjectTest, QueuedFromThreads)
+{
+    auto m = std::make_shared<MockSender>();
+    auto r = std::make_shared<MockReceiver>();
+
+    queueConnect(m, MockSender::SignalOne, r, &MockReceiver::receiverOne);
+
+    for (int frame = 0; frame < 2; frame++)
+    {
+        r->items.clear();
+        ParallelUtils::parallelFor(10000, [&](const int) { m->postOne(); });
+        r->doAllEvents();
+        EXPECT_EQ(10000, r->items.size());
+    }
+}
+
+///
+/// \brief Test that events too large for the payload of a command are still
+/// queued and copied whole
+///
+TEST(imstkEventObjectTest, QueuedLargeEvent)
+{
+    auto m = std::make_shared<MockSender>();
+    auto r = std::make_shared<MockReceiver>();
+
+    int value = 0;
+    queueConnect<MockLargeEvent>(m, MockSender::SignalOne, r,
+        [&](MockLargeEvent* e) { value = e->m_value; });
+
+    m->postEvent(MockLargeEvent(MockSender::SignalOne(), 5));
+    r->foreachEvent([&](Command c) { c.invoke(); });
+    EXPECT_EQ(5, value);
+}
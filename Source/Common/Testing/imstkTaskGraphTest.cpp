@@ -115,6 +115,32 @@ TEST(imstkTaskGraphTest, AddRemoveNodesNoEdges)
     EXPECT_THAT(taskGraph->getNodes(), UnorderedElementsAre(taskGraph->getSource(), taskGraph->getSink()));
 }
 
+TEST(imstkTaskGraphTest, ModifiedCount)
+{
+    auto taskGraph = std::make_shared<TaskGraph>();
+    auto node1     = std::make_shared<TaskNode>();
+
+    size_t count = taskGraph->getModifiedCount();
+    taskGraph->addNode(node1);
+    EXPECT_GT(taskGraph->getModifiedCount(), count);
+
+    // Adding an existing node doesn't change the graph
+    count = taskGraph->getModifiedCount();
+    taskGraph->addNode(node1);
+    EXPECT_EQ(taskGraph->getModifiedCount(), count);
+
+    taskGraph->addEdge(taskGraph->getSource(), node1);
+    EXPECT_GT(taskGraph->getModifiedCount(), count);
+
+    count = taskGraph->getModifiedCount();
+    taskGraph->removeNode(node1);
+    EXPECT_GT(taskGraph->getModifiedCount(), count);
+
+    count = taskGraph->getModifiedCount();
+    taskGraph->modified();
+    EXPECT_GT(taskGraph->getModifiedCount(), count);
+}
+
 TEST(imstkTaskGraphTest, AddEdgesAndAdjancency)
 {
     auto taskGraph = std::make_shared<TaskGraph>();
@@ -614,6 +640,39 @@ TEST(imstkTaskGraphTest, RemoveUnusedNodes)
     }
 }
 
+TEST(imstkTaskGraphTest, UnorderedWrites)
+{
+    int  resource1 = 0;
+    int  resource2 = 0;
+    auto node1     = std::make_shared<TaskNode>();
+    auto node2     = std::make_shared<TaskNode>();
+    auto node3     = std::make_shared<TaskNode>();
+    node1->m_writes = { &resource1 };
+    node2->m_writes = { &resource1, &resource2 };
+    node3->m_writes = { &resource2 };
+
+    auto taskGraph = std::make_shared<TaskGraph>();
+    taskGraph->addNodes({ node1, node2, node3 });
+
+    // node1 -> node2 ordered, node3 parallel to both
+    taskGraph->addEdges({
+        { taskGraph->getSource(), node1 },
+        { node1, node2 },
+        { node2, taskGraph->getSink() },
+        { taskGraph->getSource(), node3 },
+        { node3, taskGraph->getSink() }
+        });
+
+    auto results = TaskGraph::getUnorderedWrites(taskGraph);
+    ASSERT_EQ(1, results.size());
+    EXPECT_THAT(std::vector<std::shared_ptr<TaskNode>>({ results[0].first, results[0].second }),
+        UnorderedElementsAre(node2, node3));
+
+    // Ordering node3 after node2 resolves it
+    taskGraph->addEdge(node2, node3);
+    EXPECT_EQ(0, TaskGraph::getUnorderedWrites(taskGraph).size());
+}
+
 //TEST(imstkTaskGraphTest, DISABLED_ResolveCriticalNodes0)
 //{
 //    /*
@@ -10,6 +10,8 @@
 #include "imstkTaskGraph.h"
 #include "imstkTaskNode.h"
 
+#include <atomic>
+
 using namespace imstk;
 
 TEST(imstkTbbTaskGraphControllerTest, SumData)
@@ -68,4 +70,39 @@ TEST(imstkTbbTaskGraphControllerTest, SumData)
     controller.setTaskGraph(graph);
     EXPECT_EQ(controller.initialize(), true) << "TaskGraph failed to initialize";
     controller.execute();
-}
\ No newline at end of file
+}
+
+TEST(imstkTbbTaskGraphControllerTest, ExecuteAfterModified)
+{
+    std::atomic<int> countA(0);
+    std::atomic<int> countB(0);
+
+    auto                      graph = std::make_shared<TaskGraph>();
+    std::shared_ptr<TaskNode> nodeA = graph->addFunction("A", [&]() { countA++; });
+    graph->addEdge(graph->getSource(), nodeA);
+    graph->addEdge(nodeA, graph->getSink());
+
+    TbbTaskGraphController controller;
+    controller.setTaskGraph(graph);
+    EXPECT_EQ(controller.initialize(), true) << "TaskGraph failed to initialize";
+
+    // The flow graph is reused across executions
+    for (int i = 0; i < 10; i++)
+    {
+        controller.execute();
+    }
+    EXPECT_EQ(countA, 10);
+
+    // Modifying the graph should be picked up on the next execute
+    std::shared_ptr<TaskNode> nodeB = graph->addFunction("B", [&]() { countB++; });
+    graph->addEdge(nodeA, nodeB);
+    graph->addEdge(nodeB, graph->getSink());
+    controller.execute();
+    EXPECT_EQ(countA, 11);
+    EXPECT_EQ(countB, 1);
+
+    graph->removeNode(nodeB);
+    controller.execute();
+    EXPECT_EQ(countA, 12);
+    EXPECT_EQ(countB, 1);
+}
@@ -6,22 +6,59 @@
 
 #pragma once
 
+#include "imstkMpscQueue.h"
 #include "imstkSpinLock.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <functional>
 #include <list>
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
-#define SIGNAL(className,signalName) static std::string signalName() { return #className "::"#signalName; }
+#define SIGNAL(className,signalName) static constexpr imstk::Signal signalName() { return imstk::Signal(#className "::"#signalName); }
 
 namespace imstk
 {
 class EventObject;
 
+using SignalId = std::uint64_t;
+
+///
+/// \class Signal
+///
+/// \brief Key of a signal, an integer id hashed from its name at compile time.
+/// Observers are looked up by id, the name is kept for debugging
+///
+class Signal
+{
+public:
+    constexpr Signal(const char* name) : m_id(hash(name)), m_name(name) { }
+
+    constexpr bool operator==(const Signal& other) const { return m_id == other.m_id; }
+    constexpr bool operator!=(const Signal& other) const { return m_id != other.m_id; }
+
+    ///
+    /// \brief 64 bit FNV-1a hash of the name
+    ///
+    static constexpr SignalId hash(const char* name)
+    {
+        SignalId id = 14695981039346656037ull;
+        for (; *name != '\0'; name++)
+        {
+            id = (id ^ static_cast<unsigned char>(*name)) * 1099511628211ull;
+        }
+        return id;
+    }
+
+public:
+    SignalId    m_id;
+    const char* m_name;
+};
+
 ///
 /// \class Event
 ///
@@ -32,11 +69,11 @@ class EventObject;
 class Event
 {
 public:
-    Event(const std::string type) : m_type(type),m_sender(nullptr) { }
+    Event(const Signal type) : m_type(type),m_sender(nullptr) { }
     virtual~Event() = default;
 
 public:
-    std::string  m_type;
+    Signal       m_type;
     EventObject* m_sender;
 };
 
@@ -44,11 +81,60 @@ public:
 /// \brief Stores everything needed to invoke an event
 /// A call may not be present, in which case invoke doesn't do anything
 ///
+/// The event is copied into a small buffer held by the command, only events
+/// larger than the buffer are allocated
+///
 class Command
 {
 public:
-    Command() : m_call(nullptr),m_event(nullptr) { }
-    Command(std::function<void(Event*)> call,std::shared_ptr<Event> event) : m_call(call),m_event(event) { }
+    using Call = std::shared_ptr<const std::function<void(Event*)>>;
+
+    static constexpr size_t PayloadSize = 64;
+
+public:
+    Command() = default;
+    template<typename T>
+    Command(Call call, const T& event) : m_call(std::move(call))
+    {
+        static_assert(std::is_base_of<Event, T>::value, "event not derived from Event");
+        if (sizeof(T) <= PayloadSize && alignof(T) <= alignof(std::max_align_t))
+        {
+            m_copyFunc = [](const Event* src, void* buffer) -> Event*
+                         {
+                             return new (buffer) T(*static_cast<const T*>(src));
+                         };
+            m_event = m_copyFunc(&event, m_payload);
+        }
+        else
+        {
+            m_heapEvent = std::make_shared<T>(event);
+            m_event     = m_heapEvent.get();
+        }
+    }
+
+    Command(const Command& other) { copy(other); }
+    Command(Command&& other) { move(other); }
+    ~Command() { destroy(); }
+
+    Command& operator=(const Command& other)
+    {
+        if (this != &other)
+        {
+            destroy();
+            copy(other);
+        }
+        return *this;
+    }
+
+    Command& operator=(Command&& other)
+    {
+        if (this != &other)
+        {
+            destroy();
+            move(other);
+        }
+        return *this;
+    }
 
 public:
     ///
@@ -61,32 +147,82 @@ public:
         {
             if (m_call != nullptr)
             {
-                m_call(m_event.get());
+                (*m_call)(m_event);
             }
         }
     }
 
+protected:
+    void copy(const Command& other)
+    {
+        m_call      = other.m_call;
+        m_copyFunc  = other.m_copyFunc;
+        m_heapEvent = other.m_heapEvent;
+        if (m_heapEvent != nullptr)
+        {
+            m_event = m_heapEvent.get();
+        }
+        else if (other.m_event != nullptr)
+        {
+            m_event = m_copyFunc(other.m_event, m_payload);
+        }
+    }
+
+    ///
+    /// \brief Takes the call and heap event of other, the payload is still copied
+    ///
+    void move(Command& other)
+    {
+        m_call      = std::move(other.m_call);
+        m_copyFunc  = other.m_copyFunc;
+        m_heapEvent = std::move(other.m_heapEvent);
+        if (m_heapEvent != nullptr)
+        {
+            m_event       = m_heapEvent.get();
+            other.m_event = nullptr;
+        }
+        else if (other.m_event != nullptr)
+        {
+            m_event = m_copyFunc(other.m_event, m_payload);
+        }
+    }
+
+    void destroy()
+    {
+        if (m_event != nullptr && m_heapEvent == nullptr)
+        {
+            m_event->~Event();
+        }
+        m_event = nullptr;
+        m_heapEvent.reset();
+    }
+
 public:
-    std::function<void(Event*)> m_call  = nullptr;
-    std::shared_ptr<Event>      m_event = nullptr;
+    Call   m_call  = nullptr;
+    Event* m_event = nullptr; ///< The event, in the payload or on the heap
+
+protected:
+    alignas(std::max_align_t) unsigned char m_payload[PayloadSize];
+    Event* (* m_copyFunc)(const Event*, void*) = nullptr; ///< Copy constructs the event into a buffer
+    std::shared_ptr<Event> m_heapEvent = nullptr;            ///< Events too large for the payload
 };
 
 template<class T,class RecieverType>
-static void connect(std::shared_ptr<EventObject>,std::string(*)(),
+static void connect(std::shared_ptr<EventObject>,Signal (*)(),
                     std::shared_ptr<RecieverType>,void(RecieverType::*)(T*));
 template<class T>
-static void connect(std::shared_ptr<EventObject>, std::string (*)(),
+static void connect(std::shared_ptr<EventObject>, Signal (*)(),
                     std::function<void(T*)>);
 
 template<class T, class RecieverType>
-static void queueConnect(std::shared_ptr<EventObject>, std::string (*)(),
+static void queueConnect(std::shared_ptr<EventObject>, Signal (*)(),
                          std::shared_ptr<RecieverType>, void (RecieverType::*)(T*));
 template<class T>
-static void queueConnect(std::shared_ptr<EventObject>, std::string (*)(),
+static void queueConnect(std::shared_ptr<EventObject>, Signal (*)(),
                          std::shared_ptr<EventObject>, std::function<void(T*)>);
 
 static void disconnect(std::shared_ptr<EventObject>,
-                       std::shared_ptr<EventObject>, std::string (*)());
+                       std::shared_ptr<EventObject>, Signal (*)());
 
 ///
 /// \class EventObject
@@ -99,13 +235,16 @@ static void disconnect(std::shared_ptr<EventObject>,
 /// they like.
 /// These can be connected with the connect/queuedConnect/disconnect functions
 /// Lambda recievers cannot be disconnected unless all receivers to a signal are removed
+/// Observers are keyed by the integer id of the signal. The queue is lock free, any thread
+/// may post to it but only one thread at a time may process the events of an object
 /// \todo ThreadObject affinity
 ///
 class EventObject
 {
 public:
     // tuple<IsLambda, Receiver, Receiving Function
-    using Observer = std::tuple<bool, std::weak_ptr<EventObject>, std::function<void (Event*)>>;
+    // The function is shared with the commands queued for it
+    using Observer = std::tuple<bool, std::weak_ptr<EventObject>, Command::Call>;
 
 public:
     virtual ~EventObject() = default;
@@ -120,67 +259,61 @@ public:
     template<typename T>
     void postEvent(const T& e)
     {
-        std::shared_ptr<T> ePtr = std::make_shared<T>(e);
+        // The event is copied on the stack, queued observers copy it into their commands
+        T event = e;
         // Don't overwrite the sender if the user provided one
-        if (ePtr->m_sender == nullptr)
+        if (event.m_sender == nullptr)
         {
-            ePtr->m_sender = this;
+            event.m_sender = this;
         }
 
         // For every direct observer
         // Directly call its function
-        for (auto i = directObservers.begin(); i != directObservers.end(); i++)
+        std::vector<Observer>* directs = findObservers(directObservers, e.m_type.m_id);
+        if (directs != nullptr)
         {
-            if (i->first == e.m_type)
+            for (std::vector<Observer>::iterator j = directs->begin(); j != directs->end();)
             {
-                std::vector<Observer>& observers = i->second;
-                for (std::vector<Observer>::iterator j = observers.begin(); j != observers.end();)
+                const bool           isLambda      = std::get<0>(*j);
+                const Command::Call& receivingFunc = std::get<2>(*j);
+
+                // If the receiver or receiving function is nullptr, cleanup
+                // This would occur on deconstruction of a receiver
+                if ((!isLambda && std::get<1>(*j).expired()) || receivingFunc == nullptr)
+                {
+                    j = directs->erase(j);
+                }
+                else
                 {
-                    bool                        isLambda      = std::get<0>(*j);
-                    std::function<void(Event*)> receivingFunc = std::get<2>(*j);
-
-                    // If the receiver or receiving function is nullptr, cleanup
-                    // This would occur on deconstruction of a receiver
-                    if ((!isLambda && std::get<1>(*j).expired()) || receivingFunc == nullptr)
-                    {
-                        j = i->second.erase(j);
-                    }
-                    else
-                    {
-                        // Call the receiving function
-                        receivingFunc(ePtr.get());
-                        j++;
-                    }
+                    // Call the receiving function
+                    (*receivingFunc)(&event);
+                    j++;
                 }
             }
         }
 
         // For every queued observer
-        for (auto i = queuedObservers.begin(); i != queuedObservers.end(); i++)
+        // Looked up after the direct calls as they may connect observers
+        std::vector<Observer>* queueds = findObservers(queuedObservers, e.m_type.m_id);
+        if (queueds != nullptr)
         {
-            if (i->first == e.m_type)
+            for (std::vector<Observer>::iterator j = queueds->begin(); j != queueds->end();)
             {
-                std::vector<Observer>& observers = i->second;
-                for (std::vector<Observer>::iterator j = observers.begin(); j != observers.end();)
+                const bool           isLambda      = std::get<0>(*j);
+                const Command::Call& receivingFunc = std::get<2>(*j);
+
+                // If the receiver or receiving function is nullptr, cleanup
+                // This would occur on deconstruction of a receiver
+                if ((!isLambda && std::get<1>(*j).expired()) || receivingFunc == nullptr)
                 {
-                    bool                        isLambda      = std::get<0>(*j);
-                    std::function<void(Event*)> receivingFunc = std::get<2>(*j);
-
-                    // If the receiver or receiving function is nullptr, cleanup
-                    // This would occur on deconstruction of a receiver
-                    if ((!isLambda && std::get<1>(*j).expired()) || receivingFunc == nullptr)
-                    {
-                        j = i->second.erase(j);
-                    }
-                    else
-                    {
-                        // Queue the command
-                        std::shared_ptr<EventObject> receivingObj = std::get<1>(*j).lock();
-                        receivingObj->eventQueueLock.lock();
-                        receivingObj->eventQueue.push_back(Command(receivingFunc, ePtr));
-                        receivingObj->eventQueueLock.unlock();
-                        j++;
-                    }
+                    j = queueds->erase(j);
+                }
+                else
+                {
+                    // Queue the command
+                    std::shared_ptr<EventObject> receivingObj = std::get<1>(*j).lock();
+                    receivingObj->eventQueue.push(Command(receivingFunc, event));
+                    j++;
                 }
             }
         }
@@ -192,16 +325,14 @@ public:
     template<typename T>
     void queueEvent(const T& e)
     {
-        std::shared_ptr<T> ePtr = std::make_shared<T>(e);
+        T event = e;
         // Don't overwrite the sender if the user provided one
-        if (ePtr->m_sender == nullptr)
+        if (event.m_sender == nullptr)
         {
-            ePtr->m_sender = this;
+            event.m_sender = this;
         }
 
-        eventQueueLock.lock();
-        eventQueue.push_back(Command(nullptr, ePtr));
-        eventQueueLock.unlock();
+        eventQueue.push(Command(nullptr, event));
     }
 
     ///
@@ -209,21 +340,12 @@ public:
     ///
     void doEvent()
     {
-        // Avoid calling the function within the lock
-        eventQueueLock.lock();
-        if (eventQueue.empty())
+        Command command;
+        if (eventQueue.pop(command))
         {
-            eventQueueLock.unlock();
-            return;
+            // Do the calls
+            command.invoke();
         }
-
-        Command command = eventQueue.front();
-        eventQueue.pop_front();
-
-        eventQueueLock.unlock();
-
-        // Do the calls
-        command.invoke();
     }
 
     ///
@@ -231,59 +353,42 @@ public:
     ///
     void doAllEvents()
     {
-        // Avoid calling the function within the lock
-        std::list<Command> cmds;
-        eventQueueLock.lock();
-        {
-            while (!eventQueue.empty())
-            {
-                cmds.push_back(eventQueue.front());
-                eventQueue.pop_front();
-            }
-        }
-        eventQueueLock.unlock();
-
-        // Do the calls
-        for (auto i : cmds)
+        // Only the events queued up to now, calls may queue more
+        std::vector<Command> events;
+        popAllEvents(events);
+        for (Command& cmd : events)
         {
-            i.invoke();
+            cmd.invoke();
         }
+        releaseEvents(events);
     }
 
     ///
-    /// \brief Thread safe loop over all event commands, one can implement a custom handler
+    /// \brief Loop over all event commands, one can implement a custom handler
     ///
     void foreachEvent(std::function<void(Command cmd)> func)
     {
-        eventQueueLock.lock();
-        for (std::deque<Command>::iterator i = eventQueue.begin(); i != eventQueue.end(); i++)
+        std::vector<Command> events;
+        popAllEvents(events);
+        for (std::vector<Command>::iterator i = events.begin(); i != events.end(); i++)
         {
             func(*i);
         }
-        while (!eventQueue.empty())
-        {
-            Command command = eventQueue.back();
-            eventQueue.pop_back();
-        }
-        eventQueueLock.unlock();
+        releaseEvents(events);
     }
 
     ///
-    /// \brief thread safe reverse loop over all event commands, one can implement a custom handler
+    /// \brief Reverse loop over all event commands, one can implement a custom handler
     ///
     void rforeachEvent(std::function<void(Command cmd)> func)
     {
-        eventQueueLock.lock();
-        for (std::deque<Command>::reverse_iterator i = eventQueue.rbegin(); i != eventQueue.rend(); i++)
+        std::vector<Command> events;
+        popAllEvents(events);
+        for (std::vector<Command>::reverse_iterator i = events.rbegin(); i != events.rend(); i++)
         {
             func(*i);
         }
-        while (!eventQueue.empty())
-        {
-            Command command = eventQueue.back();
-            eventQueue.pop_back();
-        }
-        eventQueueLock.unlock();
+        releaseEvents(events);
     }
 
     ///
@@ -292,80 +397,93 @@ public:
     ///
     void clearEvents()
     {
-        eventQueueLock.lock();
-        {
-            while (!eventQueue.empty())
-            {
-                Command command = eventQueue.back();
-                eventQueue.pop_back();
-            }
-        }
-        eventQueueLock.unlock();
+        Command command;
+        while (eventQueue.pop(command)) { }
     }
 
 public:
     template<class T, class RecieverType>
-    friend void connect(std::shared_ptr<EventObject>, std::string (*)(),
+    friend void connect(std::shared_ptr<EventObject>, Signal (*)(),
                         std::shared_ptr<RecieverType>, void (RecieverType::*)(T*));
     template<typename T>
     friend void connect(std::shared_ptr<EventObject>,
-                        std::string (*)(), std::function<void(T*)>);
+                        Signal (*)(), std::function<void(T*)>);
 
     template<typename T, class RecieverType>
-    friend void queueConnect(std::shared_ptr<EventObject>, std::string (*)(),
+    friend void queueConnect(std::shared_ptr<EventObject>, Signal (*)(),
                              std::shared_ptr<RecieverType>, void (RecieverType::*)(T*));
     template<class T>
-    friend void queueConnect(std::shared_ptr<EventObject>, std::string (*)(),
+    friend void queueConnect(std::shared_ptr<EventObject>, Signal (*)(),
                              std::shared_ptr<EventObject>, std::function<void(T*)>);
 
     friend void disconnect(std::shared_ptr<EventObject>,
-                           std::shared_ptr<EventObject>, std::string (*)());
+                           std::shared_ptr<EventObject>, Signal (*)());
 
 // Use the connect functions
 private:
-    void addDirectObserver(std::string eventType, Observer observer)
+    using ObserverList = std::vector<std::pair<SignalId, std::vector<Observer>>>;
+
+    static std::vector<Observer>* findObservers(ObserverList& observers, const SignalId eventType)
     {
-        std::vector<std::pair<std::string, std::vector<Observer>>>::iterator i =
-            std::find_if(directObservers.begin(), directObservers.end(),
-                [eventType](const std::pair<std::string, std::vector<Observer>>& j)
-                { return j.first == eventType; });
-        if (i == directObservers.end())
+        for (auto& i : observers)
         {
-            std::pair<std::string, std::vector<Observer>> test = std::pair<std::string, std::vector<Observer>>(eventType, std::vector<Observer>());
-            test.second.push_back(observer);
-            directObservers.push_back(test);
+            if (i.first == eventType)
+            {
+                return &i.second;
+            }
         }
-        else
+        return nullptr;
+    }
+
+    static void addObserver(ObserverList& observers, const SignalId eventType, Observer observer)
+    {
+        std::vector<Observer>* signalObservers = findObservers(observers, eventType);
+        if (signalObservers == nullptr)
         {
-            i->second.push_back(observer);
+            observers.push_back(std::pair<SignalId, std::vector<Observer>>(eventType, std::vector<Observer>()));
+            signalObservers = &observers.back().second;
         }
+        signalObservers->push_back(observer);
     }
 
-    void addQueuedObserver(std::string eventType, Observer observer)
+    void addDirectObserver(const Signal eventType, Observer observer) { addObserver(directObservers, eventType.m_id, observer); }
+
+    void addQueuedObserver(const Signal eventType, Observer observer) { addObserver(queuedObservers, eventType.m_id, observer); }
+
+    ///
+    /// \brief Pop all events queued so far into \p events, a local list so handlers
+    /// may process the events of this object again. The capacity of eventBuffer is reused
+    ///
+    void popAllEvents(std::vector<Command>& events)
     {
-        std::vector<std::pair<std::string, std::vector<Observer>>>::iterator i =
-            std::find_if(queuedObservers.begin(), queuedObservers.end(),
-                [eventType](const std::pair<std::string, std::vector<Observer>>& j)
-                { return j.first == eventType; });
-        if (i == queuedObservers.end())
+        events.swap(eventBuffer);
+        Command command;
+        while (eventQueue.pop(command))
         {
-            std::pair<std::string, std::vector<Observer>> test = std::pair<std::string, std::vector<Observer>>(eventType, std::vector<Observer>());
-            test.second.push_back(observer);
-            queuedObservers.push_back(test);
+            events.push_back(std::move(command));
         }
-        else
+    }
+
+    ///
+    /// \brief Clear the processed \p events and keep their capacity for the next call
+    ///
+    void releaseEvents(std::vector<Command>& events)
+    {
+        events.clear();
+        if (events.capacity() > eventBuffer.capacity())
         {
-            i->second.push_back(observer);
+            eventBuffer.swap(events);
         }
     }
 
 protected:
-    ParallelUtils::SpinLock eventQueueLock; // Data lock for the event queue
-    std::deque<Command>     eventQueue;
+    // Pushed to by any thread, consumed by the thread processing the events of this object
+    ParallelUtils::MpscQueue<Command> eventQueue;
+    std::vector<Command> eventBuffer; ///< Empty, only keeps its capacity between calls processing the events
 
     // Vectors used as size is generally small
-    std::vector<std::pair<std::string, std::vector<Observer>>> queuedObservers;
-    std::vector<std::pair<std::string, std::vector<Observer>>> directObservers;
+    ObserverList queuedObservers;
+    ObserverList directObservers;
 };
 
 #ifdef WIN32
@@ -383,13 +501,14 @@ protected:
 ///
 template<class T, class ReceiverType>
 static void
-connect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
+connect(std::shared_ptr<EventObject> sender, Signal (* senderFunc)(),
         std::shared_ptr<ReceiverType> receiver, void (ReceiverType::* receiverFunc)(T*))
 {
     static_assert(std::is_base_of<EventObject, ReceiverType>::value, "receiver not derived from EventObject");
 
     std::function<void(T*)> receiverStdFunc = std::bind(receiverFunc, receiver.get(), std::placeholders::_1);
-    sender->addDirectObserver(senderFunc(), EventObject::Observer(false, receiver, [ = ](Event* e) { receiverStdFunc(static_cast<T*>(e)); }));
+    sender->addDirectObserver(senderFunc(), EventObject::Observer(false, receiver,
+        std::make_shared<const std::function<void(Event*)>>([ = ](Event* e) { receiverStdFunc(static_cast<T*>(e)); })));
 }
 
 ///
@@ -404,11 +523,11 @@ connect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
 ///
 template<class T>
 static void
-connect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
+connect(std::shared_ptr<EventObject> sender, Signal (* senderFunc)(),
         std::function<void(T*)> receiverFunc)
 {
     sender->addDirectObserver(senderFunc(), EventObject::Observer(true,
-        std::weak_ptr<EventObject>(), [ = ](Event* e) { receiverFunc(static_cast<T*>(e)); }));
+        std::weak_ptr<EventObject>(), std::make_shared<const std::function<void(Event*)>>([ = ](Event* e) { receiverFunc(static_cast<T*>(e)); })));
 }
 
 ///
@@ -423,14 +542,15 @@ connect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
 ///
 template<class T, class ReceiverType>
 static void
-queueConnect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
+queueConnect(std::shared_ptr<EventObject> sender, Signal (* senderFunc)(),
              std::shared_ptr<ReceiverType> receiver, void (ReceiverType::* recieverFunc)(T*))
 {
     // Ensure sender and reciever are EventObjects
     static_assert(std::is_base_of<EventObject, ReceiverType>::value, "receiver not derived from EventObject");
 
     std::function<void(T*)> recieverStdFunc = std::bind(recieverFunc, receiver.get(), std::placeholders::_1);
-    sender->addQueuedObserver(senderFunc(), EventObject::Observer(false, receiver, [ = ](Event* e) { recieverStdFunc(static_cast<T*>(e)); }));
+    sender->addQueuedObserver(senderFunc(), EventObject::Observer(false, receiver,
+        std::make_shared<const std::function<void(Event*)>>([ = ](Event* e) { recieverStdFunc(static_cast<T*>(e)); })));
 }
 
 ///
@@ -448,10 +568,11 @@ queueConnect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
 ///
 template<class T>
 static void
-queueConnect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
+queueConnect(std::shared_ptr<EventObject> sender, Signal (* senderFunc)(),
              std::shared_ptr<EventObject> receiver, std::function<void(T*)> recieverFunc)
 {
-    sender->addQueuedObserver(senderFunc(), EventObject::Observer(true, receiver, [ = ](Event* e) { recieverFunc(static_cast<T*>(e)); }));
+    sender->addQueuedObserver(senderFunc(), EventObject::Observer(true, receiver,
+        std::make_shared<const std::function<void(Event*)>>([ = ](Event* e) { recieverFunc(static_cast<T*>(e)); })));
 }
 
 ///
@@ -467,24 +588,22 @@ queueConnect(std::shared_ptr<EventObject> sender, std::string (* senderFunc)(),
 ///
 static void
 disconnect(std::shared_ptr<EventObject> sender,
-           std::shared_ptr<EventObject> reciever, std::string (* senderFunc)())
+           std::shared_ptr<EventObject> reciever, Signal (* senderFunc)())
 {
-    const std::string eventType = senderFunc();
+    const SignalId eventType = senderFunc().m_id;
 
-    auto i1 = std::find_if(sender->directObservers.begin(), sender->directObservers.end(),
-        [eventType](const std::pair<std::string, std::vector<EventObject::Observer>>& j) { return j.first == eventType; });
-    if (i1 != sender->directObservers.end())
+    std::vector<EventObject::Observer>* i1 = EventObject::findObservers(sender->directObservers, eventType);
+    if (i1 != nullptr)
     {
-        auto j = std::find_if(i1->second.begin(), i1->second.end(), [reciever](const EventObject::Observer& k) { return std::get<1>(k).lock() == reciever; });
-        i1->second.erase(j);
+        auto j = std::find_if(i1->begin(), i1->end(), [reciever](const EventObject::Observer& k) { return std::get<1>(k).lock() == reciever; });
+        i1->erase(j);
     }
 
-    auto i2 = std::find_if(sender->queuedObservers.begin(), sender->queuedObservers.end(),
-        [eventType](const std::pair<std::string, std::vector<EventObject::Observer>>& j) { return j.first == eventType; });
-    if (i2 != sender->queuedObservers.end())
+    std::vector<EventObject::Observer>* i2 = EventObject::findObservers(sender->queuedObservers, eventType);
+    if (i2 != nullptr)
     {
-        auto j = std::find_if(i2->second.begin(), i2->second.end(), [reciever](const EventObject::Observer& k) { return std::get<1>(k).lock() == reciever; });
-        i2->second.erase(j);
+        auto j = std::find_if(i2->begin(), i2->end(), [reciever](const EventObject::Observer& k) { return std::get<1>(k).lock() == reciever; });
+        i2->erase(j);
     }
 }
 
@@ -0,0 +1,36 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPbdConstraintArena.h"
+
+namespace imstk
+{
+void
+PbdConstraintArena::reset()
+{
+    for (auto& pool : m_pools)
+    {
+        pool.second.numUsed = 0;
+    }
+}
+
+void
+PbdConstraintArena::clear()
+{
+    m_pools.clear();
+}
+
+size_t
+PbdConstraintArena::getHighWaterMark() const
+{
+    size_t highWaterMark = 0;
+    for (const auto& pool : m_pools)
+    {
+        highWaterMark += pool.second.highWaterMark;
+    }
+    return highWaterMark;
+}
+} // namespace imstk
@@ -0,0 +1,135 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkPbdConstraint.h"
+
+#include <algorithm>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace imstk
+{
+///
+/// \class PbdConstraintArena
+///
+/// \brief Typed pools of constraints that live for a frame. Interactions acquire the
+/// constraints they generate every frame from it instead of allocating them, the arena
+/// is reset at the start of the next frame after which the same constraints are handed
+/// out again. Constraints are only allocated when a pool grows past its high-water mark,
+/// so memory stays flat once the scene has seen its busiest frame.
+///
+/// The i'th constraint acquired of a type in a frame is the i'th of its pool, indices
+/// and pointers are stable until reset. Constraints are never freed before the arena
+/// so pointers held past a reset stay valid, but may be reinitialized by another user.
+/// Acquisition is not thread safe, acquire a range and fill it in parallel instead.
+///
+class PbdConstraintArena
+{
+public:
+    PbdConstraintArena() = default;
+    virtual ~PbdConstraintArena() = default;
+
+    ///
+    /// \brief Acquire a constraint of type T, it keeps the values of its last use so
+    /// it must be initialized. Allocates only if the pool is exhausted
+    ///
+    template<class T>
+    T* acquire()
+    {
+        return get<T>(acquire<T>(1));
+    }
+
+    ///
+    /// \brief Acquire count constraints of type T
+    /// \return Index of the first one, see get
+    ///
+    template<class T>
+    size_t acquire(const size_t count)
+    {
+        Pool&        pool  = getPool<T>();
+        const size_t start = pool.numUsed;
+        pool.numUsed += count;
+        while (pool.constraints.size() < pool.numUsed)
+        {
+            pool.constraints.push_back(std::make_unique<T>());
+            m_numAllocations++;
+        }
+        pool.highWaterMark = std::max(pool.highWaterMark, pool.numUsed);
+        m_numAcquisitions += count;
+        return start;
+    }
+
+    ///
+    /// \brief Get the constraint of type T at index, acquired this frame
+    ///
+    template<class T>
+    T* get(const size_t index)
+    {
+        return static_cast<T*>(getPool<T>().constraints[index].get());
+    }
+
+    ///
+    /// \brief Get the number of constraints of type T acquired this frame
+    ///
+    template<class T>
+    size_t getNumAcquired() const
+    {
+        auto iter = m_pools.find(std::type_index(typeid(T)));
+        return (iter == m_pools.end()) ? 0 : iter->second.numUsed;
+    }
+
+    ///
+    /// \brief Release all constraints, they are handed out again from the start
+    ///
+    void reset();
+
+    ///
+    /// \brief Free all constraints, the next frame allocates every constraint it acquires.
+    /// Only call this between frames, pointers acquired before are no longer valid
+    ///
+    void clear();
+
+    ///
+    /// \brief Get the high-water mark, the most constraints of a type acquired in a
+    /// frame summed over the types. This is the number of constraints held
+    ///
+    size_t getHighWaterMark() const;
+
+    ///
+    /// \brief Get the number of constraints allocated, this only grows when a frame
+    /// uses more constraints of a type than any frame before
+    ///
+    size_t getNumAllocations() const { return m_numAllocations; }
+
+    ///
+    /// \brief Get the number of constraints acquired since construction, what
+    /// would have been allocated without the arena
+    ///
+    size_t getNumAcquisitions() const { return m_numAcquisitions; }
+
+protected:
+    struct Pool
+    {
+        std::vector<std::unique_ptr<PbdConstraint>> constraints;
+        size_t numUsed       = 0; ///< Number acquired this frame
+        size_t highWaterMark = 0; ///< Most acquired in a frame
+    };
+
+    template<class T>
+    Pool& getPool()
+    {
+        return m_pools[std::type_index(typeid(T))];
+    }
+
+    std::unordered_map<std::type_index, Pool> m_pools;
+    size_t m_numAllocations  = 0;
+    size_t m_numAcquisitions = 0;
+};
+} // namespace imstk
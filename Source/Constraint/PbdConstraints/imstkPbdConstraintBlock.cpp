@@ -0,0 +1,298 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPbdConstraintBlock.h"
+#include "imstkCsrGraph.h"
+#include "imstkPbdDihedralConstraint.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdFemTetConstraint.h"
+#include "imstkPbdVolumeConstraint.h"
+
+namespace imstk
+{
+void
+PbdConstraintBlock::reserve(const size_t n)
+{
+    m_particles.reserve(n * m_numParticles);
+    m_restValues.reserve(n);
+    m_stiffnesses.reserve(n);
+    m_compliances.reserve(n);
+    m_lambdas.reserve(n);
+    m_C.reserve(n);
+}
+
+void
+PbdConstraintBlock::resize(const size_t n)
+{
+    m_particles.resize(n * m_numParticles);
+    m_restValues.resize(n, 0.0);
+    m_stiffnesses.resize(n, 1.0);
+    m_compliances.resize(n, 1e-7);
+    m_lambdas.resize(n, 0.0);
+    m_C.resize(n, 0.0);
+    clearPartitions();
+}
+
+void
+PbdConstraintBlock::setStiffness(const size_t i, const double stiffness)
+{
+    CHECK(stiffness != 0.0) << "0 stiffness is invalid";
+    m_stiffnesses[i] = stiffness;
+    m_compliances[i] = 1.0 / stiffness;
+}
+
+void
+PbdConstraintBlock::setCompliance(const size_t i, const double compliance)
+{
+    m_compliances[i] = compliance;
+    m_stiffnesses[i] = (compliance == 0.0) ? 1.0 : 1.0 / compliance;
+}
+
+void
+PbdConstraintBlock::zeroOutLambdas()
+{
+    std::fill(m_lambdas.begin(), m_lambdas.end(), 0.0);
+}
+
+size_t
+PbdConstraintBlock::addConstraint(const PbdParticleId* particles, const double restValue,
+                                  const double stiffness, const double compliance)
+{
+    m_particles.insert(m_particles.end(), particles, particles + m_numParticles);
+    m_restValues.push_back(restValue);
+    m_stiffnesses.push_back(stiffness);
+    m_compliances.push_back(compliance);
+    m_lambdas.push_back(0.0);
+    m_C.push_back(0.0);
+    return m_lambdas.size() - 1;
+}
+
+void
+PbdConstraintBlock::setConstraint(const size_t i, const PbdParticleId* particles, const double restValue,
+                                  const double stiffness, const double compliance)
+{
+    std::copy(particles, particles + m_numParticles, &m_particles[i * m_numParticles]);
+    m_restValues[i]  = restValue;
+    m_stiffnesses[i] = stiffness;
+    m_compliances[i] = compliance;
+    m_lambdas[i]     = 0.0;
+    m_C[i] = 0.0;
+}
+
+void
+PbdConstraintBlock::gather(const std::vector<size_t>& ids)
+{
+    gatherArray(m_particles, ids, static_cast<size_t>(m_numParticles));
+    gatherArray(m_restValues, ids);
+    gatherArray(m_stiffnesses, ids);
+    gatherArray(m_compliances, ids);
+    gatherArray(m_lambdas, ids);
+    gatherArray(m_C, ids);
+}
+
+void
+PbdConstraintBlock::removeConstraints(const std::unordered_set<size_t>& vertices, const int bodyId)
+{
+    std::vector<size_t> keepIds;
+    keepIds.reserve(size());
+    for (size_t i = 0; i < size(); i++)
+    {
+        const PbdParticleId* pids   = getParticles(i);
+        bool                 remove = false;
+        for (int j = 0; j < m_numParticles; j++)
+        {
+            if (pids[j].first == bodyId && vertices.find(pids[j].second) != vertices.end())
+            {
+                remove = true;
+                break;
+            }
+        }
+        if (!remove)
+        {
+            keepIds.push_back(i);
+        }
+    }
+
+    if (keepIds.size() != size())
+    {
+        gather(keepIds);
+    }
+    clearPartitions();
+}
+
+void
+PbdConstraintBlock::partitionConstraints(const int partitionThreshold)
+{
+    // Constraints are adjacent in the constraint graph when they share a (body, particle)
+    std::vector<size_t> keyOffsets(size() + 1);
+    std::vector<size_t> keys(size() * m_numParticles);
+    for (size_t i = 0; i < size(); i++)
+    {
+        const PbdParticleId* pids = getParticles(i);
+        for (int j = 0; j < m_numParticles; j++)
+        {
+            keys[i * m_numParticles + j] = (static_cast<size_t>(pids[j].first) << 32) | static_cast<size_t>(static_cast<unsigned int>(pids[j].second));
+        }
+        keyOffsets[i + 1] = (i + 1) * m_numParticles;
+    }
+
+    CsrGraph constraintGraph;
+    constraintGraph.buildFromSharedKeys(keyOffsets, keys);
+
+    const auto coloring = constraintGraph.doColoring();
+    const std::vector<unsigned short>& colors = coloring.first;
+    const size_t                       numColors = static_cast<size_t>(coloring.second);
+
+    std::vector<std::vector<size_t>> partitions(numColors);
+    for (size_t i = 0; i < colors.size(); i++)
+    {
+        partitions[colors[i]].push_back(i);
+    }
+
+    // Partitions under the threshold are moved to the end and processed sequentially
+    std::vector<size_t> order;
+    std::vector<size_t> sequentialIds;
+    order.reserve(size());
+    m_partitionOffsets.assign(1, 0);
+    for (const std::vector<size_t>& partition : partitions)
+    {
+        if (partition.size() < static_cast<size_t>(partitionThreshold))
+        {
+            sequentialIds.insert(sequentialIds.end(), partition.begin(), partition.end());
+        }
+        else
+        {
+            order.insert(order.end(), partition.begin(), partition.end());
+            m_partitionOffsets.push_back(order.size());
+        }
+    }
+    // The last offset marks the start of the sequential range
+    order.insert(order.end(), sequentialIds.begin(), sequentialIds.end());
+
+    gather(order);
+}
+
+void
+PbdConstraintBlock::updateBodyData(PbdState& bodies)
+{
+    m_bodyData.resize(bodies.m_bodies.size());
+    for (size_t i = 0; i < bodies.m_bodies.size(); i++)
+    {
+        const PbdBody& body = *bodies.m_bodies[i];
+        m_bodyData[i].positions = (body.vertices == nullptr) ? nullptr : body.vertices->getPointer();
+        m_bodyData[i].invMasses = (body.invMasses == nullptr) ? nullptr : body.invMasses->getPointer();
+    }
+}
+
+size_t
+PbdDistanceConstraintBlock::addConstraint(PbdDistanceConstraint& constraint)
+{
+    return PbdConstraintBlock::addConstraint(constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+void
+PbdDistanceConstraintBlock::setConstraint(const size_t i, PbdDistanceConstraint& constraint)
+{
+    PbdConstraintBlock::setConstraint(i, constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+size_t
+PbdVolumeConstraintBlock::addConstraint(PbdVolumeConstraint& constraint)
+{
+    return PbdConstraintBlock::addConstraint(constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+void
+PbdVolumeConstraintBlock::setConstraint(const size_t i, PbdVolumeConstraint& constraint)
+{
+    PbdConstraintBlock::setConstraint(i, constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+size_t
+PbdDihedralConstraintBlock::addConstraint(PbdDihedralConstraint& constraint)
+{
+    return PbdConstraintBlock::addConstraint(constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+void
+PbdDihedralConstraintBlock::setConstraint(const size_t i, PbdDihedralConstraint& constraint)
+{
+    PbdConstraintBlock::setConstraint(i, constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+void
+PbdFemTetConstraintBlock::reserve(const size_t n)
+{
+    PbdConstraintBlock::reserve(n);
+    m_invRestMats.reserve(n);
+    m_restVolumes.reserve(n);
+    m_materials.reserve(n);
+    m_configs.reserve(n);
+    m_handleInversions.reserve(n);
+}
+
+void
+PbdFemTetConstraintBlock::resize(const size_t n)
+{
+    PbdConstraintBlock::resize(n);
+    m_invRestMats.resize(n, Mat3d::Identity());
+    m_restVolumes.resize(n, 0.0);
+    m_materials.resize(n, PbdFemConstraint::MaterialType::StVK);
+    m_configs.resize(n);
+    m_handleInversions.resize(n, 1);
+}
+
+size_t
+PbdFemTetConstraintBlock::addConstraint(PbdFemTetConstraint& constraint)
+{
+    m_invRestMats.push_back(constraint.m_invRestMat);
+    m_restVolumes.push_back(constraint.m_initialElementVolume);
+    m_materials.push_back(constraint.m_material);
+    m_configs.push_back(constraint.m_config);
+    m_handleInversions.push_back(static_cast<char>(constraint.getInverstionHandling()));
+    return PbdConstraintBlock::addConstraint(constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+void
+PbdFemTetConstraintBlock::setConstraint(const size_t i, PbdFemTetConstraint& constraint)
+{
+    m_invRestMats[i]      = constraint.m_invRestMat;
+    m_restVolumes[i]      = constraint.m_initialElementVolume;
+    m_materials[i]        = constraint.m_material;
+    m_configs[i]          = constraint.m_config;
+    m_handleInversions[i] = static_cast<char>(constraint.getInverstionHandling());
+    PbdConstraintBlock::setConstraint(i, constraint.getParticles().data(),
+        constraint.getRestValue(), constraint.getStiffness(), constraint.getCompliance());
+}
+
+bool
+PbdFemTetConstraintBlock::computeValueAndGradient(const size_t i, const Vec3d* x, double& c, Vec3d* dcdx) const
+{
+    return PbdFemTetConstraint::computeElementValueAndGradient(
+        x[0], x[1], x[2], x[3],
+        m_invRestMats[i], m_restVolumes[i], m_materials[i], m_configs[i],
+        m_handleInversions[i] != 0,
+        c, dcdx);
+}
+
+void
+PbdFemTetConstraintBlock::gather(const std::vector<size_t>& ids)
+{
+    PbdConstraintBlock::gather(ids);
+    gatherArray(m_invRestMats, ids);
+    gatherArray(m_restVolumes, ids);
+    gatherArray(m_materials, ids);
+    gatherArray(m_configs, ids);
+    gatherArray(m_handleInversions, ids);
+}
+} // namespace imstk
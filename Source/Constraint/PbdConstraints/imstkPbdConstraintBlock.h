@@ -0,0 +1,467 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkParallelFor.h"
+#include "imstkPbdConstraint.h"
+#include "imstkPbdFemConstraint.h"
+
+#include <unordered_set>
+
+namespace imstk
+{
+class PbdDihedralConstraint;
+class PbdDistanceConstraint;
+class PbdFemTetConstraint;
+class PbdVolumeConstraint;
+
+///
+/// \class PbdConstraintBlock
+///
+/// \brief Structure-of-arrays storage for a set of constraints of the same type.
+/// Every constraint in the block refers to the same number of particles. Particle
+/// ids, rest values, stiffness, compliance and lagrange multipliers are stored in
+/// flat arrays so that a block is projected with a single non-virtual loop instead
+/// of a virtual PbdConstraint::projectConstraint call per constraint.
+///
+/// Blocks are an alternative storage for the standard constraint types, custom
+/// constraints should continue to derive PbdConstraint. Constraints in blocks
+/// are not visible through PbdConstraintContainer::getConstraints.
+///
+class PbdConstraintBlock
+{
+public:
+    virtual ~PbdConstraintBlock() = default;
+
+    virtual const std::string getTypeName() const = 0;
+
+    ///
+    /// \brief Returns the number of constraints in the block
+    ///
+    size_t size() const { return m_lambdas.size(); }
+
+    ///
+    /// \brief Returns if there are no constraints in the block
+    ///
+    bool empty() const { return m_lambdas.empty(); }
+
+    ///
+    /// \brief Returns the number of particles every constraint of the block uses
+    ///
+    int getNumParticlesPerConstraint() const { return m_numParticles; }
+
+    ///
+    /// \brief Reserve storage for n constraints
+    ///
+    virtual void reserve(const size_t n);
+
+    ///
+    /// \brief Resize the block to n constraints, new constraints are left
+    /// uninitialized and should be set before solving. Clears partitions
+    ///
+    virtual void resize(const size_t n);
+
+    ///
+    /// \brief Get the flat particle array, getNumParticlesPerConstraint entries per constraint
+    ///
+    const std::vector<PbdParticleId>& getParticles() const { return m_particles; }
+
+    ///
+    /// \brief Get the particles of the i'th constraint
+    ///
+    const PbdParticleId* getParticles(const size_t i) const { return &m_particles[i * m_numParticles]; }
+
+    ///
+    /// \brief Get the per constraint values
+    ///@{
+    double getRestValue(const size_t i) const { return m_restValues[i]; }
+    double getStiffness(const size_t i) const { return m_stiffnesses[i]; }
+    double getCompliance(const size_t i) const { return m_compliances[i]; }
+    double getLambda(const size_t i) const { return m_lambdas[i]; }
+    double getConstraintC(const size_t i) const { return m_C[i]; }
+    ///@}
+
+    ///
+    /// \brief Set the stiffness/compliance of the i'th constraint, follows
+    /// the conventions of PbdConstraint::setStiffness/setCompliance
+    ///@{
+    void setStiffness(const size_t i, const double stiffness);
+    void setCompliance(const size_t i, const double compliance);
+    ///@}
+
+    ///
+    /// \brief Zero's out all lagrange multipliers of the block, must be called
+    /// before solving
+    ///
+    void zeroOutLambdas();
+
+    ///
+    /// \brief Project every constraint of the block once. Partitions, if computed,
+    /// are projected in parallel, the remaining constraints sequentially
+    ///
+    virtual void projectConstraints(PbdState& bodies, const double dt,
+                                    const PbdConstraint::SolverType& solverType) = 0;
+
+    ///
+    /// \brief Removes all constraints of the block that use any of the given
+    /// vertices of the body. Clears partitions
+    ///
+    void removeConstraints(const std::unordered_set<size_t>& vertices, const int bodyId);
+
+    ///
+    /// \brief Reorders the block by graph coloring such that each partition can
+    /// be projected in parallel
+    /// \param Minimum number of constraints in a partition, any under are projected
+    /// sequentially after the partitions
+    ///
+    void partitionConstraints(const int partitionThreshold);
+
+    ///
+    /// \brief Clear the partitions, all constraints will be projected sequentially
+    ///
+    void clearPartitions() { m_partitionOffsets.assign(1, 0); }
+
+    ///
+    /// \brief Get the number of parallel partitions
+    ///
+    size_t getNumPartitions() const { return m_partitionOffsets.size() - 1; }
+
+    ///
+    /// \brief Get the range of the parallel partitions, partition i is
+    /// [offsets[i], offsets[i + 1]), constraints at or after offsets.back()
+    /// are projected sequentially
+    ///
+    const std::vector<size_t>& getPartitionOffsets() const { return m_partitionOffsets; }
+
+protected:
+    PbdConstraintBlock(const int numParticles) : m_numParticles(numParticles) { }
+
+    ///
+    /// \brief Appends a constraint with the common values, returns its index
+    ///
+    size_t addConstraint(const PbdParticleId* particles, const double restValue,
+                         const double stiffness, const double compliance);
+
+    ///
+    /// \brief Set the common values of the i'th constraint
+    ///
+    void setConstraint(const size_t i, const PbdParticleId* particles, const double restValue,
+                       const double stiffness, const double compliance);
+
+    ///
+    /// \brief Keep only the constraints at the given indices, in the given order.
+    /// Subclasses storing additional per constraint data must extend this
+    ///
+    virtual void gather(const std::vector<size_t>& ids);
+
+    ///
+    /// \brief Reorders an array according to ids
+    ///
+    template<typename T, typename Alloc>
+    static void gatherArray(std::vector<T, Alloc>& arr, const std::vector<size_t>& ids, const size_t stride = 1)
+    {
+        std::vector<T, Alloc> result(ids.size() * stride);
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            for (size_t j = 0; j < stride; j++)
+            {
+                result[i * stride + j] = arr[ids[i] * stride + j];
+            }
+        }
+        arr.swap(result);
+    }
+
+    ///
+    /// \brief Raw pointers into the bodies, resolved once per projection
+    ///
+    struct BodyData
+    {
+        Vec3d* positions = nullptr;
+        const double* invMasses = nullptr;
+    };
+
+    ///
+    /// \brief Resolve raw pointers of every body in the state
+    ///
+    void updateBodyData(PbdState& bodies);
+
+    const int m_numParticles;
+
+    std::vector<PbdParticleId> m_particles;    ///< body, particle index, m_numParticles per constraint
+    std::vector<double>        m_restValues;   ///< Rest value per constraint
+    std::vector<double>        m_stiffnesses;  ///< used in PBD, [0, 1]
+    std::vector<double>        m_compliances;  ///< used in xPBD, inverse of stiffness
+    std::vector<double>        m_lambdas;      ///< Lagrange multiplier per constraint
+    std::vector<double>        m_C;            ///< Constraint value per constraint
+
+    std::vector<size_t>   m_partitionOffsets = { 0 }; ///< Start of every parallel partition
+    std::vector<BodyData> m_bodyData;
+};
+
+///
+/// \class PbdConstraintBlockBase
+///
+/// \brief Implements the projection of a PbdConstraintBlock for a constraint
+/// type with N particles. Derived must provide
+/// bool computeValueAndGradient(const size_t i, const Vec3d* x, double& c, Vec3d* dcdx) const
+/// which is inlined into the projection loop
+///
+template<class Derived, int N>
+class PbdConstraintBlockBase : public PbdConstraintBlock
+{
+public:
+    ~PbdConstraintBlockBase() override = default;
+
+    void projectConstraints(PbdState& bodies, const double dt,
+                            const PbdConstraint::SolverType& solverType) override
+    {
+        if (dt == 0.0 || empty())
+        {
+            return;
+        }
+
+        updateBodyData(bodies);
+
+        const double dt2 = dt * dt;
+        for (size_t i = 0; i + 1 < m_partitionOffsets.size(); i++)
+        {
+            ParallelUtils::parallelFor(m_partitionOffsets[i], m_partitionOffsets[i + 1],
+                [&](const size_t j)
+                {
+                    projectConstraint(j, dt2, solverType);
+                });
+        }
+        for (size_t j = m_partitionOffsets.back(); j < size(); j++)
+        {
+            projectConstraint(j, dt2, solverType);
+        }
+    }
+
+protected:
+    PbdConstraintBlockBase() : PbdConstraintBlock(N) { }
+
+    ///
+    /// \brief Project the i'th constraint
+    ///
+    inline void projectConstraint(const size_t i, const double dt2,
+                                  const PbdConstraint::SolverType& solverType)
+    {
+        const PbdParticleId* pids = &m_particles[i * N];
+
+        Vec3d  x[N];
+        double invMasses[N];
+        for (int j = 0; j < N; j++)
+        {
+            const BodyData& body = m_bodyData[pids[j].first];
+            x[j]         = body.positions[pids[j].second];
+            invMasses[j] = body.invMasses[pids[j].second];
+        }
+
+        double c = 0.0;
+        Vec3d  dcdx[N];
+        if (!static_cast<const Derived*>(this)->computeValueAndGradient(i, x, c, dcdx))
+        {
+            return;
+        }
+
+        // Save constraint value
+        m_C[i] = c;
+
+        double w = 0.0;
+        for (int j = 0; j < N; j++)
+        {
+            w += invMasses[j] * dcdx[j].squaredNorm();
+        }
+        if (w == 0.0)
+        {
+            return;
+        }
+
+        double dlambda = 0.0;
+        switch (solverType)
+        {
+        case (PbdConstraint::SolverType::PBD):
+            dlambda = -c * m_stiffnesses[i] / w;
+            break;
+        case (PbdConstraint::SolverType::xPBD):
+        default:
+        {
+            const double alpha = m_compliances[i] / dt2;
+            dlambda = -(c + alpha * m_lambdas[i]) / (w + alpha);
+            break;
+        }
+        }
+        m_lambdas[i] += dlambda;
+
+        for (int j = 0; j < N; j++)
+        {
+            if (invMasses[j] > 0.0)
+            {
+                m_bodyData[pids[j].first].positions[pids[j].second] += invMasses[j] * dlambda * dcdx[j];
+            }
+        }
+    }
+};
+
+///
+/// \class PbdDistanceConstraintBlock
+///
+/// \brief Block of distance constraints, see PbdDistanceConstraint
+///
+class PbdDistanceConstraintBlock : public PbdConstraintBlockBase<PbdDistanceConstraintBlock, 2>
+{
+public:
+    PbdDistanceConstraintBlock() = default;
+    ~PbdDistanceConstraintBlock() override = default;
+
+    IMSTK_TYPE_NAME(PbdDistanceConstraintBlock)
+
+    ///
+    /// \brief Append/set a constraint from an initialized PbdDistanceConstraint
+    ///@{
+    size_t addConstraint(PbdDistanceConstraint& constraint);
+    void setConstraint(const size_t i, PbdDistanceConstraint& constraint);
+    ///@}
+
+    inline bool computeValueAndGradient(const size_t i, const Vec3d* x, double& c, Vec3d* dcdx) const
+    {
+        dcdx[0] = x[0] - x[1];
+        const double len = dcdx[0].norm();
+        if (len < 1.0e-16)
+        {
+            return false;
+        }
+        dcdx[0] /= len;
+        dcdx[1]  = -dcdx[0];
+        c        = len - m_restValues[i];
+        return true;
+    }
+};
+
+///
+/// \class PbdVolumeConstraintBlock
+///
+/// \brief Block of tetrahedral volume constraints, see PbdVolumeConstraint
+///
+class PbdVolumeConstraintBlock : public PbdConstraintBlockBase<PbdVolumeConstraintBlock, 4>
+{
+public:
+    PbdVolumeConstraintBlock() = default;
+    ~PbdVolumeConstraintBlock() override = default;
+
+    IMSTK_TYPE_NAME(PbdVolumeConstraintBlock)
+
+    ///
+    /// \brief Append/set a constraint from an initialized PbdVolumeConstraint
+    ///@{
+    size_t addConstraint(PbdVolumeConstraint& constraint);
+    void setConstraint(const size_t i, PbdVolumeConstraint& constraint);
+    ///@}
+
+    inline bool computeValueAndGradient(const size_t i, const Vec3d* x, double& c, Vec3d* dcdx) const
+    {
+        const double onesixth = 1.0 / 6.0;
+
+        dcdx[0] = onesixth * (x[1] - x[2]).cross(x[3] - x[1]);
+        dcdx[1] = onesixth * (x[2] - x[0]).cross(x[3] - x[0]);
+        dcdx[2] = onesixth * (x[3] - x[0]).cross(x[1] - x[0]);
+        dcdx[3] = onesixth * (x[1] - x[0]).cross(x[2] - x[0]);
+
+        const double volume = dcdx[3].dot(x[3] - x[0]);
+        c = volume - m_restValues[i];
+        return true;
+    }
+};
+
+///
+/// \class PbdDihedralConstraintBlock
+///
+/// \brief Block of dihedral angle constraints, see PbdDihedralConstraint
+///
+class PbdDihedralConstraintBlock : public PbdConstraintBlockBase<PbdDihedralConstraintBlock, 4>
+{
+public:
+    PbdDihedralConstraintBlock() = default;
+    ~PbdDihedralConstraintBlock() override = default;
+
+    IMSTK_TYPE_NAME(PbdDihedralConstraintBlock)
+
+    ///
+    /// \brief Append/set a constraint from an initialized PbdDihedralConstraint
+    ///@{
+    size_t addConstraint(PbdDihedralConstraint& constraint);
+    void setConstraint(const size_t i, PbdDihedralConstraint& constraint);
+    ///@}
+
+    inline bool computeValueAndGradient(const size_t i, const Vec3d* x, double& c, Vec3d* dcdx) const
+    {
+        const Vec3d e  = x[3] - x[2];
+        const Vec3d e1 = x[3] - x[0];
+        const Vec3d e2 = x[0] - x[2];
+        const Vec3d e3 = x[3] - x[1];
+        const Vec3d e4 = x[1] - x[2];
+
+        Vec3d        n1 = e1.cross(e);
+        Vec3d        n2 = e.cross(e3);
+        const double A1 = n1.norm();
+        const double A2 = n2.norm();
+        n1 /= A1;
+        n2 /= A2;
+
+        const double l = e.norm();
+        if (l < 1.0e-16)
+        {
+            return false;
+        }
+
+        dcdx[0] = -(l / A1) * n1;
+        dcdx[1] = -(l / A2) * n2;
+        dcdx[2] = (e.dot(e1) / (A1 * l)) * n1 + (e.dot(e3) / (A2 * l)) * n2;
+        dcdx[3] = (e.dot(e2) / (A1 * l)) * n1 + (e.dot(e4) / (A2 * l)) * n2;
+
+        c = atan2(n1.cross(n2).dot(e), l * n1.dot(n2)) - m_restValues[i];
+        return true;
+    }
+};
+
+///
+/// \class PbdFemTetConstraintBlock
+///
+/// \brief Block of FEM tetrahedral constraints, see PbdFemTetConstraint.
+/// Additionally stores the inverse rest matrix, rest volume, material and
+/// fem parameters per constraint
+///
+class PbdFemTetConstraintBlock : public PbdConstraintBlockBase<PbdFemTetConstraintBlock, 4>
+{
+public:
+    PbdFemTetConstraintBlock() = default;
+    ~PbdFemTetConstraintBlock() override = default;
+
+    IMSTK_TYPE_NAME(PbdFemTetConstraintBlock)
+
+    void reserve(const size_t n) override;
+    void resize(const size_t n) override;
+
+    ///
+    /// \brief Append/set a constraint from an initialized PbdFemTetConstraint
+    ///@{
+    size_t addConstraint(PbdFemTetConstraint& constraint);
+    void setConstraint(const size_t i, PbdFemTetConstraint& constraint);
+    ///@}
+
+    bool computeValueAndGradient(const size_t i, const Vec3d* x, double& c, Vec3d* dcdx) const;
+
+protected:
+    void gather(const std::vector<size_t>& ids) override;
+
+    StdVectorOfMat3d    m_invRestMats;
+    std::vector<double> m_restVolumes;
+    std::vector<PbdFemConstraint::MaterialType> m_materials;
+    std::vector<PbdFemConstraintConfig>         m_configs;
+    std::vector<char> m_handleInversions;
+};
+} // namespace imstk
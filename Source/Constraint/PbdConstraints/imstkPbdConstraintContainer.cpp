@@ -5,9 +5,8 @@
 */
 
 #include "imstkPbdConstraintContainer.h"
-#include "imstkGraph.h"
-
-#include <unordered_map>
+#include "imstkCsrGraph.h"
+#include "imstkParallelUtils.h"
 
 namespace imstk
 {
@@ -16,6 +15,16 @@ PbdConstraintContainer::addConstraint(std::shared_ptr<PbdConstraint> constraint)
 {
     m_constraintLock.lock();
     m_constraints.push_back(constraint);
+    m_version++;
+    m_constraintLock.unlock();
+}
+
+void
+PbdConstraintContainer::addConstraintBlock(std::shared_ptr<PbdConstraintBlock> block)
+{
+    m_constraintLock.lock();
+    m_constraintBlocks.push_back(block);
+    m_version++;
     m_constraintLock.unlock();
 }
 
@@ -28,6 +37,7 @@ PbdConstraintContainer::removeConstraint(std::shared_ptr<PbdConstraint> constrai
     {
         m_constraints.erase(i);
     }
+    m_version++;
     m_constraintLock.unlock();
 }
 
@@ -51,12 +61,30 @@ PbdConstraintContainer::removeConstraints(std::shared_ptr<std::unordered_set<siz
     m_constraints.erase(std::remove_if(m_constraints.begin(), m_constraints.end(), removeConstraintFunc),
         m_constraints.end());
 
-    // Also remove partitioned constraints
-    for (auto& pc : m_partitionedConstraints)
+    // Also remove partitioned constraints, releasing their particles from the partition
+    for (size_t i = 0; i < m_partitionedConstraints.size(); i++)
+    {
+        std::vector<std::shared_ptr<PbdConstraint>>& pc = m_partitionedConstraints[i];
+        auto                                         removedBegin = std::stable_partition(pc.begin(), pc.end(),
+            [&](const std::shared_ptr<PbdConstraint>& constraint) { return !removeConstraintFunc(constraint); });
+        for (auto iter = removedBegin; iter != pc.end(); iter++)
+        {
+            for (const PbdParticleId& pid : (*iter)->getParticles())
+            {
+                std::vector<int>& partitions = m_particlePartitions[getParticleKey(pid)];
+                partitions.erase(std::find(partitions.begin(), partitions.end(), static_cast<int>(i)));
+            }
+        }
+        pc.erase(removedBegin, pc.end());
+    }
+
+    // Also remove constraints stored in blocks
+    for (auto& block : m_constraintBlocks)
     {
-        pc.erase(std::remove_if(pc.begin(), pc.end(), removeConstraintFunc), pc.end());
+        block->removeConstraints(*vertices, bodyId);
     }
 
+    m_version++;
     m_constraintLock.unlock();
 }
 
@@ -65,6 +93,7 @@ PbdConstraintContainer::eraseConstraint(iterator iter)
 {
     m_constraintLock.lock();
     iterator newIter = m_constraints.erase(iter);
+    m_version++;
     m_constraintLock.unlock();
     return newIter;
 }
@@ -74,47 +103,52 @@ PbdConstraintContainer::eraseConstraint(const_iterator iter)
 {
     m_constraintLock.lock();
     const_iterator newIter = m_constraints.erase(iter);
+    m_version++;
     m_constraintLock.unlock();
     return newIter;
 }
 
+void
+PbdConstraintContainer::clearPartitions()
+{
+    m_partitionedConstraints.clear();
+    m_particlePartitions.clear();
+    m_version++;
+    for (auto& block : m_constraintBlocks)
+    {
+        block->clearPartitions();
+    }
+}
+
 void
 PbdConstraintContainer::partitionConstraints(const int partitionedThreshold)
 {
-    // Form the map { vertex : list_of_constraints_involve_vertex }
     std::vector<std::shared_ptr<PbdConstraint>>& allConstraints = m_constraints;
 
-    //std::cout << "---------partitionConstraints: " << allConstraints.size() << std::endl;
-
-    std::unordered_map<size_t, std::vector<size_t>> vertexConstraints;
+    // Constraints are adjacent in the constraint graph when they share a (body, particle)
+    std::vector<size_t> keyOffsets(allConstraints.size() + 1, 0);
     for (size_t constrIdx = 0; constrIdx < allConstraints.size(); ++constrIdx)
     {
-        const auto& constr = allConstraints[constrIdx];
-        for (const auto& vIds : constr->getParticles())
-        {
-            vertexConstraints[vIds.second].push_back(constrIdx);
-        }
+        keyOffsets[constrIdx + 1] = keyOffsets[constrIdx] + allConstraints[constrIdx]->getParticles().size();
     }
-
-    // Add edges to the constraint graph
-    // Each edge represent a shared vertex between two constraints
-    Graph constraintGraph(allConstraints.size());
-    for (const auto& kv : vertexConstraints)
-    {
-        const auto& constraints = kv.second;     // the list of constraints for a vertex
-        for (size_t i = 0; i < constraints.size(); ++i)
+    std::vector<size_t> keys(keyOffsets.back());
+    ParallelUtils::parallelFor(allConstraints.size(),
+        [&](const size_t constrIdx)
         {
-            for (size_t j = i + 1; j < constraints.size(); ++j)
+            size_t keyIdx = keyOffsets[constrIdx];
+            for (const PbdParticleId& pid : allConstraints[constrIdx]->getParticles())
             {
-                constraintGraph.addEdge(constraints[i], constraints[j]);
+                keys[keyIdx++] = getParticleKey(pid);
             }
-        }
-    }
-    vertexConstraints.clear();
+        });
+
+    CsrGraph constraintGraph;
+    constraintGraph.buildFromSharedKeys(keyOffsets, keys);
+    keyOffsets.clear();
+    keys.clear();
 
     // do graph coloring for the constraint graph
-    const auto coloring = constraintGraph.doColoring(Graph::ColoringMethod::WelshPowell);
-    // const auto  coloring = constraintGraph.doColoring(Graph::ColoringMethod::Greedy);
+    const auto coloring = constraintGraph.doColoring();
     const auto& partitionIndices = coloring.first;
     const auto  numPartitions    = coloring.second;
     assert(partitionIndices.size() == allConstraints.size());
@@ -159,6 +193,26 @@ PbdConstraintContainer::partitionConstraints(const int partitionedThreshold)
     }
     partitionedConstraints.resize(writeIdx);
 
+    // Record the partitions every particle is used in for updatePartitions
+    m_particlePartitions.clear();
+    for (size_t i = 0; i < partitionedConstraints.size(); i++)
+    {
+        for (const auto& constraint : partitionedConstraints[i])
+        {
+            for (const PbdParticleId& pid : constraint->getParticles())
+            {
+                m_particlePartitions[getParticleKey(pid)].push_back(static_cast<int>(i));
+            }
+        }
+    }
+
+    // Blocks hold their own partitions
+    for (auto& block : m_constraintBlocks)
+    {
+        block->partitionConstraints(partitionedThreshold);
+    }
+    m_version++;
+
     // Print
     /*if (print)
     {
@@ -175,4 +229,63 @@ PbdConstraintContainer::partitionConstraints(const int partitionedThreshold)
             << constraintGraph.size() << std::endl;
     }*/
 }
+
+void
+PbdConstraintContainer::updatePartitions()
+{
+    m_constraintLock.lock();
+    const int        numPartitions = static_cast<int>(m_partitionedConstraints.size());
+    std::vector<int> usedPartitions;
+    size_t           writeIdx = 0;
+    for (size_t readIdx = 0; readIdx < m_constraints.size(); ++readIdx)
+    {
+        std::shared_ptr<PbdConstraint>& constraint = m_constraints[readIdx];
+
+        // Gather the partitions any of its particles are used in
+        usedPartitions.clear();
+        for (const PbdParticleId& pid : constraint->getParticles())
+        {
+            auto iter = m_particlePartitions.find(getParticleKey(pid));
+            if (iter != m_particlePartitions.end())
+            {
+                usedPartitions.insert(usedPartitions.end(), iter->second.begin(), iter->second.end());
+            }
+        }
+        std::sort(usedPartitions.begin(), usedPartitions.end());
+
+        // Find the first partition that isn't
+        int partition = 0;
+        for (const int usedPartition : usedPartitions)
+        {
+            if (usedPartition == partition)
+            {
+                partition++;
+            }
+            else if (usedPartition > partition)
+            {
+                break;
+            }
+        }
+
+        if (partition < numPartitions)
+        {
+            for (const PbdParticleId& pid : constraint->getParticles())
+            {
+                m_particlePartitions[getParticleKey(pid)].push_back(partition);
+            }
+            m_partitionedConstraints[partition].push_back(std::move(constraint));
+        }
+        else
+        {
+            if (readIdx != writeIdx)
+            {
+                m_constraints[writeIdx] = std::move(constraint);
+            }
+            ++writeIdx;
+        }
+    }
+    m_constraints.resize(writeIdx);
+    m_version++;
+    m_constraintLock.unlock();
+}
 } // namespace imstk
\ No newline at end of file
@@ -7,7 +7,9 @@
 #pragma once
 
 #include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBlock.h"
 
+#include <unordered_map>
 #include <unordered_set>
 
 namespace imstk
@@ -38,6 +40,11 @@ public:
     ///
     virtual void removeConstraint(std::shared_ptr<PbdConstraint> constraint);
 
+    ///
+    /// \brief Adds a structure-of-arrays block of constraints to the system, thread safe
+    ///
+    virtual void addConstraintBlock(std::shared_ptr<PbdConstraintBlock> block);
+
     ///
     /// \brief Removes all constraints associated with vertex ids
     ///
@@ -60,33 +67,70 @@ public:
     ///
     /// \brief Returns if there are no constraints
     ///
-    const bool empty() const { return m_constraints.empty() && m_partitionedConstraints.empty(); }
+    const bool empty() const { return m_constraints.empty() && m_partitionedConstraints.empty() && m_constraintBlocks.empty(); }
 
     ///
-    /// \brief Get the underlying container
+    /// \brief Get the underlying container. The non-const version may be used to
+    /// modify the constraints so it counts as a change of the container
     ///
     const std::vector<std::shared_ptr<PbdConstraint>>& getConstraints() const { return m_constraints; }
-    std::vector<std::shared_ptr<PbdConstraint>>& getConstraints() { return m_constraints; }
+    std::vector<std::shared_ptr<PbdConstraint>>& getConstraints()
+    {
+        m_version++;
+        return m_constraints;
+    }
+
+    ///
+    /// \brief Get the constraint blocks
+    ///
+    const std::vector<std::shared_ptr<PbdConstraintBlock>>& getConstraintBlocks() const { return m_constraintBlocks; }
 
     ///
     /// \brief Get the partitioned constraints
     ///
-    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>> getPartitionedConstraints() const { return m_partitionedConstraints; }
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& getPartitionedConstraints() const { return m_partitionedConstraints; }
+
+    ///
+    /// \brief Get the version of the container, incremented whenever constraints
+    /// are added, removed or repartitioned. Lets users such as the solver cache
+    /// data derived from the constraints and only rebuild it when this changes
+    ///
+    size_t getVersion() const { return m_version; }
 
     ///
     /// \brief Partitions pbd constraints into separate vectors via graph coloring
+    /// Constraint blocks are partitioned within themselves
     /// \param Minimum number of constraints in groups, any under will be dumped back into m_constraints
     ///
     void partitionConstraints(const int partitionThreshold);
 
+    ///
+    /// \brief Incrementally moves the constraints that aren't partitioned (ie: added since
+    /// the last partitionConstraints) into the first existing partition they share no
+    /// particle with. The rest stay to be processed sequentially. Removed constraints
+    /// never invalidate the partitions, so topology changes only need this, thread safe
+    ///
+    void updatePartitions();
+
     ///
     /// \brief Clear the parition vectors
     ///
-    void clearPartitions() { m_partitionedConstraints.clear(); }
+    void clearPartitions();
+
+    ///
+    /// \brief Returns a key unique to the (body, particle)
+    ///
+    static size_t getParticleKey(const PbdParticleId& pid)
+    {
+        return (static_cast<size_t>(pid.first) << 32) | static_cast<size_t>(static_cast<unsigned int>(pid.second));
+    }
 
 protected:
     std::vector<std::shared_ptr<PbdConstraint>> m_constraints;                         ///< Not partitioned constraints
     std::vector<std::vector<std::shared_ptr<PbdConstraint>>> m_partitionedConstraints; ///< Partitioned pbd constraints
+    std::vector<std::shared_ptr<PbdConstraintBlock>>         m_constraintBlocks;       ///< Structure-of-arrays constraint blocks
+    std::unordered_map<size_t, std::vector<int>> m_particlePartitions;                 ///< Partitions using every (body, particle) key
     ParallelUtils::SpinLock m_constraintLock;                                          ///< Used to deal with concurrent addition/removal of constraints
+    size_t m_version = 0;                                                              ///< Incremented on every change of the constraints
 };
 } // namespace imstk
\ No newline at end of file
@@ -43,18 +43,28 @@ bool
 PbdFemTetConstraint::computeValueAndGradient(PbdState& bodies,
                                              double& c, std::vector<Vec3d>& dcdx)
 {
-    const Vec3d& p0 = bodies.getPosition(m_particles[0]);
-    const Vec3d& p1 = bodies.getPosition(m_particles[1]);
-    const Vec3d& p2 = bodies.getPosition(m_particles[2]);
-    const Vec3d& p3 = bodies.getPosition(m_particles[3]);
+    return computeElementValueAndGradient(
+        bodies.getPosition(m_particles[0]), bodies.getPosition(m_particles[1]),
+        bodies.getPosition(m_particles[2]), bodies.getPosition(m_particles[3]),
+        m_invRestMat, m_initialElementVolume, m_material, m_config, m_handleInversions,
+        c, dcdx.data());
+}
 
+bool
+PbdFemTetConstraint::computeElementValueAndGradient(
+    const Vec3d& p0, const Vec3d& p1, const Vec3d& p2, const Vec3d& p3,
+    const Mat3d& invRestMat, const double restVolume,
+    const MaterialType material, const PbdFemConstraintConfig& config,
+    const bool doHandleInversions,
+    double& c, Vec3d* dcdx)
+{
     Mat3d m;
     m.col(0) = p0 - p3;
     m.col(1) = p1 - p3;
     m.col(2) = p2 - p3;
 
     // deformation gradient (F)
-    Mat3d defgrad = m * m_invRestMat;
+    Mat3d defgrad = m * invRestMat;
 
     // SVD matrices
     Mat3d U    = Mat3d::Identity();
@@ -64,7 +74,7 @@ PbdFemTetConstraint::computeValueAndGradient(PbdState& bodies,
     Mat3d F = defgrad;
 
     // If inverted, handle if flag set to true
-    if (m_handleInversions && defgrad.determinant() <= 1E-8)
+    if (doHandleInversions && defgrad.determinant() <= 1E-8)
     {
         handleInversions(defgrad, U, Fhat, VT);
         F = Fhat; // diagonalized deformation gradient
@@ -75,10 +85,10 @@ PbdFemTetConstraint::computeValueAndGradient(PbdState& bodies,
     // energy constraint
     double C = 0;
 
-    const double mu     = m_config.m_mu;
-    const double lambda = m_config.m_lambda;
+    const double mu     = config.m_mu;
+    const double lambda = config.m_lambda;
 
-    switch (m_material)
+    switch (material)
     {
     // P(F) = F*(2*mu*E + lambda*tr(E)*I)
     // E = (F^T*F - I)/2
@@ -158,9 +168,9 @@ PbdFemTetConstraint::computeValueAndGradient(PbdState& bodies,
     // Rotate P back here. P = U\hat{P}V^{T}
     P = U * P * VT;
 
-    Mat3d gradC = m_initialElementVolume * P * m_invRestMat.transpose();
+    Mat3d gradC = restVolume * P * invRestMat.transpose();
     c       = C;
-    c      *= m_initialElementVolume;
+    c      *= restVolume;
     dcdx[0] = gradC.col(0);
     dcdx[1] = gradC.col(1);
     dcdx[2] = gradC.col(2);
@@ -174,7 +184,7 @@ PbdFemTetConstraint::handleInversions(
     Mat3d& F,
     Mat3d& U,
     Mat3d& Fhat,
-    Mat3d& VT) const
+    Mat3d& VT)
 {
     // Compute SVD of F and return U and VT. Modify to handle inversions. F = U\hat{F} V^{T}
     Eigen::JacobiSVD<Mat3d> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
@@ -42,16 +42,31 @@ public:
     bool computeValueAndGradient(PbdState& bodies,
                                  double& c, std::vector<Vec3d>& dcdx) override;
 
+    ///
+    /// \brief Compute the strain energy and its gradient for a single tetrahedron
+    /// given its rest configuration. Shared with PbdFemTetConstraintBlock
+    /// \param p0-p3 current positions of the tet
+    /// \param invRestMat inverse of the rest shape matrix
+    /// \param restVolume volume of the tet at rest
+    /// \param[out] c constraint value
+    /// \param[out] dcdx constraint gradient, 4 entries
+    ///
+    static bool computeElementValueAndGradient(
+        const Vec3d& p0, const Vec3d& p1, const Vec3d& p2, const Vec3d& p3,
+        const Mat3d& invRestMat, const double restVolume,
+        const MaterialType material, const PbdFemConstraintConfig& config,
+        const bool doHandleInversions,
+        double& c, Vec3d* dcdx);
+
     ///
     /// \brief Handle inverted tets with the method described by Irving et. al. in
     /// "Invertible Finite Elements For Robust Simulation of Large Deformation"
     ///
-    void handleInversions(
+    static void handleInversions(
         Mat3d& F,
         Mat3d& U,
         Mat3d& Fhat,
-        Mat3d& VT
-        ) const;
+        Mat3d& VT);
 
     ///
     /// \brief Set/Get Inversion Handling
@@ -119,6 +119,10 @@ public:
     // by default (0, inf) so bodies may only be pushed apart
     double range[2] = { 0.0, std::numeric_limits<double>::max() };
 
+    // Id of the constraint that persists across frames, used to warm start the
+    // solve with the previous impulse. 0 if it has none
+    size_t m_id = 0;
+
     // Objects involved
     std::shared_ptr<RigidBody> m_obj1 = nullptr;
     std::shared_ptr<RigidBody> m_obj2 = nullptr;
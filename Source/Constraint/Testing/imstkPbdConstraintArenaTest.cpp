@@ -0,0 +1,84 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPbdConstraintArena.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdPointPointConstraint.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+///
+/// \brief Test that constraints are handed out again after a reset, allocating only
+/// when a frame needs more than any frame before
+///
+TEST(imstkPbdConstraintArenaTest, Reuse)
+{
+    PbdConstraintArena arena;
+
+    std::vector<PbdDistanceConstraint*> firstFrame;
+    for (int i = 0; i < 10; i++)
+    {
+        firstFrame.push_back(arena.acquire<PbdDistanceConstraint>());
+    }
+    EXPECT_EQ(arena.getNumAcquired<PbdDistanceConstraint>(), 10);
+    EXPECT_EQ(arena.getNumAllocations(), 10);
+
+    arena.reset();
+    EXPECT_EQ(arena.getNumAcquired<PbdDistanceConstraint>(), 0);
+
+    // The same constraints in the same order
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_EQ(arena.acquire<PbdDistanceConstraint>(), firstFrame[i]);
+    }
+    EXPECT_EQ(arena.getNumAllocations(), 10);
+
+    arena.reset();
+    for (int i = 0; i < 12; i++)
+    {
+        arena.acquire<PbdDistanceConstraint>();
+    }
+    EXPECT_EQ(arena.getNumAllocations(), 12);
+    EXPECT_EQ(arena.getNumAcquisitions(), 27);
+    EXPECT_EQ(arena.getHighWaterMark(), 12);
+}
+
+///
+/// \brief Test that types are pooled separately and ranges are contiguous
+///
+TEST(imstkPbdConstraintArenaTest, TypesAndRanges)
+{
+    PbdConstraintArena arena;
+
+    arena.acquire<PbdDistanceConstraint>();
+    const size_t start = arena.acquire<PbdPointPointConstraint>(4);
+    EXPECT_EQ(start, 0);
+    EXPECT_EQ(arena.acquire<PbdPointPointConstraint>(2), 4);
+    EXPECT_EQ(arena.getNumAcquired<PbdDistanceConstraint>(), 1);
+    EXPECT_EQ(arena.getNumAcquired<PbdPointPointConstraint>(), 6);
+    EXPECT_NE(arena.get<PbdPointPointConstraint>(0), arena.get<PbdPointPointConstraint>(5));
+    EXPECT_EQ(arena.getHighWaterMark(), 7);
+}
+
+///
+/// \brief Test that clearing frees the constraints so the next frame allocates again
+///
+TEST(imstkPbdConstraintArenaTest, Clear)
+{
+    PbdConstraintArena arena;
+
+    arena.acquire<PbdDistanceConstraint>(3);
+    arena.clear();
+    EXPECT_EQ(arena.getNumAcquired<PbdDistanceConstraint>(), 0);
+    EXPECT_EQ(arena.getHighWaterMark(), 0);
+
+    arena.acquire<PbdDistanceConstraint>(2);
+    EXPECT_EQ(arena.getNumAllocations(), 5);
+    EXPECT_EQ(arena.getNumAcquisitions(), 5);
+    EXPECT_EQ(arena.getHighWaterMark(), 2);
+}
@@ -0,0 +1,167 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPbdConstraintBlock.h"
+#include "imstkPbdConstraintTest.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdVolumeConstraint.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+///
+/// \brief Test that a block of distance constraints produces the same
+/// result as projecting the individual constraints
+///
+TEST_F(MultiBodyPbdConstraintTest, DistanceConstraintBlock_TestMatchesConstraint)
+{
+    setNumBodies(2);
+    setNumParticles(*m_state.m_bodies[0], 3, false);
+    setNumParticles(*m_state.m_bodies[1], 3, false);
+    for (int i = 0; i < 2; i++)
+    {
+        VecDataArray<double, 3>& vertices = *m_state.m_bodies[i]->vertices;
+        vertices[0] = Vec3d(0.0, 0.0, 0.0);
+        vertices[1] = Vec3d(1.0, 0.0, 0.0);
+        vertices[2] = Vec3d(1.0, 1.0, 0.0);
+        m_state.m_bodies[i]->invMasses->fill(1.0);
+    }
+
+    // Body 0 is solved with individual constraints, body 1 with a block
+    PbdDistanceConstraint c0;
+    c0.initConstraint(Vec3d(0.0, 0.0, 0.0), Vec3d(0.5, 0.0, 0.0), { 0, 0 }, { 0, 1 }, 1.0e4);
+    PbdDistanceConstraint c1;
+    c1.initConstraint(Vec3d(0.5, 0.0, 0.0), Vec3d(0.5, 0.5, 0.0), { 0, 1 }, { 0, 2 }, 1.0e4);
+
+    PbdDistanceConstraintBlock block;
+    PbdDistanceConstraint      bc0;
+    bc0.initConstraint(Vec3d(0.0, 0.0, 0.0), Vec3d(0.5, 0.0, 0.0), { 1, 0 }, { 1, 1 }, 1.0e4);
+    PbdDistanceConstraint bc1;
+    bc1.initConstraint(Vec3d(0.5, 0.0, 0.0), Vec3d(0.5, 0.5, 0.0), { 1, 1 }, { 1, 2 }, 1.0e4);
+    block.addConstraint(bc0);
+    block.addConstraint(bc1);
+    ASSERT_EQ(block.size(), 2);
+
+    for (int i = 0; i < 10; i++)
+    {
+        c0.projectConstraint(m_state, 0.01, PbdConstraint::SolverType::xPBD);
+        c1.projectConstraint(m_state, 0.01, PbdConstraint::SolverType::xPBD);
+        block.projectConstraints(m_state, 0.01, PbdConstraint::SolverType::xPBD);
+    }
+
+    const VecDataArray<double, 3>& vertices0 = *m_state.m_bodies[0]->vertices;
+    const VecDataArray<double, 3>& vertices1 = *m_state.m_bodies[1]->vertices;
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_NEAR(vertices0[i][0], vertices1[i][0], IMSTK_DOUBLE_EPS);
+        EXPECT_NEAR(vertices0[i][1], vertices1[i][1], IMSTK_DOUBLE_EPS);
+        EXPECT_NEAR(vertices0[i][2], vertices1[i][2], IMSTK_DOUBLE_EPS);
+    }
+    EXPECT_NEAR(c0.getLambda(), block.getLambda(0), IMSTK_DOUBLE_EPS);
+    EXPECT_NEAR(c1.getLambda(), block.getLambda(1), IMSTK_DOUBLE_EPS);
+}
+
+///
+/// \brief Test that a volume block restores the volume of a compressed tet
+///
+TEST_F(MultiBodyPbdConstraintTest, VolumeConstraintBlock_TestConvergence)
+{
+    setNumBodies(1);
+    setNumParticles(*m_state.m_bodies[0], 4, false);
+    VecDataArray<double, 3>& vertices = *m_state.m_bodies[0]->vertices;
+    vertices[0] = Vec3d(0.0, 0.0, 0.0);
+    vertices[1] = Vec3d(1.0, 0.0, 0.0);
+    vertices[2] = Vec3d(0.0, 1.0, 0.0);
+    vertices[3] = Vec3d(0.0, 0.0, 1.0);
+    m_state.m_bodies[0]->invMasses->fill(1.0);
+    (*m_state.m_bodies[0]->invMasses)[0] = 0.0;
+
+    PbdVolumeConstraint c;
+    c.initConstraint(vertices[0], vertices[1], vertices[2], vertices[3],
+        { 0, 0 }, { 0, 1 }, { 0, 2 }, { 0, 3 }, 1.0e20);
+    PbdVolumeConstraintBlock block;
+    block.addConstraint(c);
+
+    // Squash the tet
+    vertices[3][2] = 0.5;
+    for (int i = 0; i < 100; i++)
+    {
+        block.projectConstraints(m_state, 0.01, PbdConstraint::SolverType::xPBD);
+    }
+
+    const double volume = (vertices[1] - vertices[0]).cross(vertices[2] - vertices[0]).dot(vertices[3] - vertices[0]) / 6.0;
+    EXPECT_NEAR(volume, 1.0 / 6.0, 1.0e-8);
+}
+
+///
+/// \brief Test that partitions of a block do not share particles and that
+/// every constraint is kept
+///
+TEST_F(MultiBodyPbdConstraintTest, DistanceConstraintBlock_TestPartition)
+{
+    const int numParticles = 11;
+    setNumBodies(1);
+    setNumParticles(*m_state.m_bodies[0], numParticles, false);
+
+    // Chain of distance constraints, colorable with 2 colors
+    PbdDistanceConstraintBlock block;
+    for (int i = 0; i < numParticles - 1; i++)
+    {
+        PbdDistanceConstraint c;
+        c.initConstraint(Vec3d(i, 0.0, 0.0), Vec3d(i + 1, 0.0, 0.0), { 0, i }, { 0, i + 1 }, 1.0e4);
+        block.addConstraint(c);
+    }
+
+    block.partitionConstraints(1);
+    EXPECT_EQ(block.size(), numParticles - 1);
+    EXPECT_EQ(block.getNumPartitions(), 2);
+
+    const std::vector<size_t>& offsets = block.getPartitionOffsets();
+    EXPECT_EQ(offsets.back(), block.size());
+    for (size_t i = 0; i < block.getNumPartitions(); i++)
+    {
+        std::unordered_set<int> particles;
+        for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+        {
+            const PbdParticleId* pids = block.getParticles(j);
+            EXPECT_TRUE(particles.insert(pids[0].second).second);
+            EXPECT_TRUE(particles.insert(pids[1].second).second);
+        }
+    }
+
+    // Partitions under the threshold are solved sequentially
+    block.partitionConstraints(numParticles);
+    EXPECT_EQ(block.getNumPartitions(), 0);
+    EXPECT_EQ(block.size(), numParticles - 1);
+}
+
+///
+/// \brief Test removal of constraints connected to a vertex
+///
+TEST_F(MultiBodyPbdConstraintTest, DistanceConstraintBlock_TestRemove)
+{
+    setNumBodies(1);
+    setNumParticles(*m_state.m_bodies[0], 4, false);
+
+    PbdDistanceConstraintBlock block;
+    for (int i = 0; i < 3; i++)
+    {
+        PbdDistanceConstraint c;
+        c.initConstraint(Vec3d(i, 0.0, 0.0), Vec3d(i + 1, 0.0, 0.0), { 0, i }, { 0, i + 1 }, 1.0e4);
+        block.addConstraint(c);
+    }
+
+    // Different body id, nothing is removed
+    block.removeConstraints({ 1 }, 1);
+    EXPECT_EQ(block.size(), 3);
+
+    block.removeConstraints({ 1 }, 0);
+    ASSERT_EQ(block.size(), 1);
+    EXPECT_EQ(block.getParticles(0)[0].second, 2);
+    EXPECT_EQ(block.getParticles(0)[1].second, 3);
+    EXPECT_NEAR(block.getRestValue(0), 1.0, IMSTK_DOUBLE_EPS);
+}
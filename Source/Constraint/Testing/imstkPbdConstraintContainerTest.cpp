@@ -0,0 +1,149 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPbdConstraintContainer.h"
+#include "imstkPbdDistanceConstraint.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Checks no two constraints of a partition share a (body, particle)
+///
+void
+expectPartitionsIndependent(const PbdConstraintContainer& container)
+{
+    for (const auto& partition : container.getPartitionedConstraints())
+    {
+        std::set<PbdParticleId> particles;
+        for (const auto& constraint : partition)
+        {
+            for (const PbdParticleId& pid : constraint->getParticles())
+            {
+                EXPECT_TRUE(particles.insert(pid).second);
+            }
+        }
+    }
+}
+
+size_t
+countConstraints(const PbdConstraintContainer& container)
+{
+    size_t count = container.getConstraints().size();
+    for (const auto& partition : container.getPartitionedConstraints())
+    {
+        count += partition.size();
+    }
+    return count;
+}
+
+std::shared_ptr<PbdDistanceConstraint>
+makeDistanceConstraint(const int bodyId, const int i, const int j)
+{
+    auto c = std::make_shared<PbdDistanceConstraint>();
+    c->initConstraint(Vec3d(i, 0.0, 0.0), Vec3d(j, 0.0, 0.0), { bodyId, i }, { bodyId, j }, 1.0e4);
+    return c;
+}
+} // namespace
+
+///
+/// \brief Test that particles of different bodies with the same index don't
+/// constrain the partitioning
+///
+TEST(imstkPbdConstraintContainerTest, PartitionByBodyAndParticle)
+{
+    // Same chain on two bodies, each chain needs 2 colors
+    PbdConstraintContainer container;
+    for (int bodyId = 0; bodyId < 2; bodyId++)
+    {
+        for (int i = 0; i < 10; i++)
+        {
+            container.addConstraint(makeDistanceConstraint(bodyId, i, i + 1));
+        }
+    }
+
+    container.partitionConstraints(1);
+    EXPECT_EQ(container.getPartitionedConstraints().size(), 2);
+    EXPECT_EQ(container.getConstraints().size(), 0);
+    EXPECT_EQ(countConstraints(container), 20);
+    expectPartitionsIndependent(container);
+}
+
+///
+/// \brief Test constraints added or removed after partitioning keep the
+/// partitions independent
+///
+TEST(imstkPbdConstraintContainerTest, UpdatePartitions)
+{
+    PbdConstraintContainer container;
+    for (int i = 0; i < 10; i += 2)
+    {
+        container.addConstraint(makeDistanceConstraint(0, i, i + 1));
+    }
+    container.partitionConstraints(1);
+    ASSERT_EQ(container.getPartitionedConstraints().size(), 1);
+
+    // Links in between the existing ones, they can't join the only partition
+    for (int i = 1; i < 9; i += 2)
+    {
+        container.addConstraint(makeDistanceConstraint(0, i, i + 1));
+    }
+    container.updatePartitions();
+    EXPECT_EQ(container.getConstraints().size(), 4);
+    EXPECT_EQ(countConstraints(container), 9);
+
+    // Removing vertices 4 and 5 removes (3, 4), (4, 5) and (5, 6), freeing particles
+    // 4 and 5 so a new (4, 5) can join the partition
+    container.removeConstraints(std::make_shared<std::unordered_set<size_t>>(std::unordered_set<size_t>{ 4, 5 }), 0);
+    EXPECT_EQ(countConstraints(container), 6);
+    container.addConstraint(makeDistanceConstraint(0, 4, 5));
+    container.updatePartitions();
+    EXPECT_EQ(container.getConstraints().size(), 2);
+    EXPECT_EQ(container.getPartitionedConstraints()[0].size(), 5);
+    expectPartitionsIndependent(container);
+}
+
+///
+/// \brief Test every change of the constraints increments the version
+///
+TEST(imstkPbdConstraintContainerTest, Version)
+{
+    PbdConstraintContainer        container;
+    const PbdConstraintContainer& constContainer = container;
+
+    size_t version = constContainer.getVersion();
+    auto   checkIncremented = [&]()
+                              {
+                                  EXPECT_GT(constContainer.getVersion(), version);
+                                  version = constContainer.getVersion();
+                              };
+
+    auto constraint = makeDistanceConstraint(0, 0, 1);
+    container.addConstraint(constraint);
+    checkIncremented();
+    container.addConstraint(makeDistanceConstraint(0, 2, 3));
+    checkIncremented();
+    container.removeConstraint(constraint);
+    checkIncremented();
+    container.partitionConstraints(1);
+    checkIncremented();
+    container.updatePartitions();
+    checkIncremented();
+    container.removeConstraints(std::make_shared<std::unordered_set<size_t>>(std::unordered_set<size_t>{ 2 }), 0);
+    checkIncremented();
+    container.clearPartitions();
+    checkIncremented();
+
+    // Reading doesn't
+    constContainer.getConstraints();
+    constContainer.getPartitionedConstraints();
+    EXPECT_EQ(constContainer.getVersion(), version);
+}
@@ -0,0 +1,211 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkAabbTree.h"
+#include "imstkVecDataArray.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Generate a grid of dim x dim quads (2 triangles each) on the xz plane
+///
+void
+generateTriangleGrid(const int dim, const Vec3d& shift,
+                     VecDataArray<double, 3>& vertices, VecDataArray<int, 3>& cells)
+{
+    vertices.resize(0);
+    cells.resize(0);
+    for (int i = 0; i <= dim; i++)
+    {
+        for (int j = 0; j <= dim; j++)
+        {
+            vertices.push_back(Vec3d(static_cast<double>(i) / dim, 0.0, static_cast<double>(j) / dim) + shift);
+        }
+    }
+    for (int i = 0; i < dim; i++)
+    {
+        for (int j = 0; j < dim; j++)
+        {
+            const int v0 = i * (dim + 1) + j;
+            const int v1 = v0 + 1;
+            const int v2 = v0 + dim + 1;
+            const int v3 = v2 + 1;
+            cells.push_back(Vec3i(v0, v1, v2));
+            cells.push_back(Vec3i(v1, v3, v2));
+        }
+    }
+}
+
+bool
+overlaps(const Vec3d& lowerA, const Vec3d& upperA, const Vec3d& lowerB, const Vec3d& upperB)
+{
+    return (lowerA.array() <= upperB.array()).all() && (lowerB.array() <= upperA.array()).all();
+}
+
+void
+computeBounds(const VecDataArray<double, 3>& vertices, const VecDataArray<int, 3>& cells,
+              StdVectorOfVec3d& lowerCorners, StdVectorOfVec3d& upperCorners)
+{
+    lowerCorners.resize(cells.size());
+    upperCorners.resize(cells.size());
+    for (int i = 0; i < cells.size(); i++)
+    {
+        const Vec3i& cell = cells[i];
+        lowerCorners[i] = vertices[cell[0]].cwiseMin(vertices[cell[1]]).cwiseMin(vertices[cell[2]]);
+        upperCorners[i] = vertices[cell[0]].cwiseMax(vertices[cell[1]]).cwiseMax(vertices[cell[2]]);
+    }
+}
+} // namespace
+
+///
+/// \brief Test that every node bounds its children and primitives
+///
+TEST(imstkAabbTreeTest, TestBuild)
+{
+    VecDataArray<double, 3> vertices;
+    VecDataArray<int, 3>    cells;
+    generateTriangleGrid(10, Vec3d::Zero(), vertices, cells);
+
+    AabbTree tree;
+    EXPECT_FALSE(tree.isBuilt());
+    tree.build(vertices, cells);
+    ASSERT_TRUE(tree.isBuilt());
+    EXPECT_EQ(tree.getNumPrimitives(), static_cast<size_t>(cells.size()));
+
+    StdVectorOfVec3d lowerCorners;
+    StdVectorOfVec3d upperCorners;
+    computeBounds(vertices, cells, lowerCorners, upperCorners);
+
+    // Every primitive is found when querying the root bounds
+    const AabbTree::Node& root = tree.getNodes()[0];
+    std::vector<int>      results;
+    tree.getOverlappingPrimitives(root.lowerCorner, root.upperCorner, results);
+    EXPECT_EQ(results.size(), static_cast<size_t>(cells.size()));
+
+    int numLeafPrimitives = 0;
+    for (const AabbTree::Node& node : tree.getNodes())
+    {
+        if (node.isLeaf())
+        {
+            EXPECT_LE(node.count, tree.getMaxLeafSize());
+            numLeafPrimitives += node.count;
+        }
+        else
+        {
+            const AabbTree::Node& left  = tree.getNodes()[node.left];
+            const AabbTree::Node& right = tree.getNodes()[node.right];
+            EXPECT_TRUE((node.lowerCorner.array() <= left.lowerCorner.array()).all());
+            EXPECT_TRUE((node.lowerCorner.array() <= right.lowerCorner.array()).all());
+            EXPECT_TRUE((node.upperCorner.array() >= left.upperCorner.array()).all());
+            EXPECT_TRUE((node.upperCorner.array() >= right.upperCorner.array()).all());
+        }
+    }
+    EXPECT_EQ(numLeafPrimitives, cells.size());
+}
+
+///
+/// \brief Test box queries against brute force, before and after refit
+///
+TEST(imstkAabbTreeTest, TestBoxQueryAndRefit)
+{
+    VecDataArray<double, 3> vertices;
+    VecDataArray<int, 3>    cells;
+    generateTriangleGrid(12, Vec3d::Zero(), vertices, cells);
+
+    AabbTree tree;
+    tree.build(vertices, cells);
+
+    auto checkQuery = [&](const Vec3d& lower, const Vec3d& upper)
+                      {
+                          StdVectorOfVec3d lowerCorners;
+                          StdVectorOfVec3d upperCorners;
+                          computeBounds(vertices, cells, lowerCorners, upperCorners);
+
+                          std::vector<int> expected;
+                          for (int i = 0; i < cells.size(); i++)
+                          {
+                              if (overlaps(lowerCorners[i], upperCorners[i], lower, upper))
+                              {
+                                  expected.push_back(i);
+                              }
+                          }
+
+                          std::vector<int> results;
+                          tree.getOverlappingPrimitives(lower, upper, results);
+                          std::sort(results.begin(), results.end());
+                          EXPECT_EQ(results, expected);
+                      };
+
+    checkQuery(Vec3d(0.2, -0.1, 0.2), Vec3d(0.4, 0.1, 0.5));
+    checkQuery(Vec3d(2.0, 2.0, 2.0), Vec3d(3.0, 3.0, 3.0));
+
+    // Move the vertices up, the old region should no longer be hit
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        vertices[i][1] += static_cast<double>(i % 3) * 0.5;
+    }
+    tree.refit(vertices, cells);
+    checkQuery(Vec3d(0.2, -0.1, 0.2), Vec3d(0.4, 0.1, 0.5));
+    checkQuery(Vec3d(0.0, 0.4, 0.0), Vec3d(1.0, 0.6, 1.0));
+}
+
+///
+/// \brief Test pair queries between two trees against brute force
+///
+TEST(imstkAabbTreeTest, TestOverlappingPairs)
+{
+    VecDataArray<double, 3> verticesA;
+    VecDataArray<int, 3>    cellsA;
+    generateTriangleGrid(8, Vec3d::Zero(), verticesA, cellsA);
+    VecDataArray<double, 3> verticesB;
+    VecDataArray<int, 3>    cellsB;
+    generateTriangleGrid(6, Vec3d(0.5, 0.0, 0.25), verticesB, cellsB);
+
+    AabbTree treeA;
+    treeA.build(verticesA, cellsA);
+    AabbTree treeB;
+    treeB.setMaxLeafSize(2);
+    treeB.build(verticesB, cellsB);
+
+    StdVectorOfVec3d lowerA, upperA, lowerB, upperB;
+    computeBounds(verticesA, cellsA, lowerA, upperA);
+    computeBounds(verticesB, cellsB, lowerB, upperB);
+
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < cellsA.size(); i++)
+    {
+        for (int j = 0; j < cellsB.size(); j++)
+        {
+            if (overlaps(lowerA[i], upperA[i], lowerB[j], upperB[j]))
+            {
+                expected.push_back({ i, j });
+            }
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    std::vector<std::pair<int, int>> results;
+    AabbTree::getOverlappingPairs(treeA, treeB, results);
+    std::sort(results.begin(), results.end());
+    EXPECT_EQ(results, expected);
+
+    // Separate the meshes, no pairs
+    treeB.setPadding(0.01);
+    for (int i = 0; i < verticesB.size(); i++)
+    {
+        verticesB[i][1] += 1.0;
+    }
+    treeB.refit(verticesB, cellsB);
+    results.clear();
+    AabbTree::getOverlappingPairs(treeA, treeB, results);
+    EXPECT_TRUE(results.empty());
+}
@@ -0,0 +1,101 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "gtest/gtest.h"
+
+#include "imstkCsrGraph.h"
+
+using namespace imstk;
+
+namespace
+{
+bool
+verifyColoring(const CsrGraph& graph, const std::vector<unsigned short>& colors, const unsigned short numColors)
+{
+    for (size_t i = 0; i < graph.size(); ++i)
+    {
+        if (colors[i] >= numColors)
+        {
+            return false;
+        }
+        for (size_t j = 0; j < graph.getNumNeighbors(i); j++)
+        {
+            if (colors[i] == colors[graph.getNeighbors(i)[j]])
+            {
+                std::cout << "edge(" << i << "," << graph.getNeighbors(i)[j] << "): same color!" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+///
+/// \brief Test that nodes sharing a key become adjacent, once
+///
+TEST(imstkCsrGraphTest, BuildFromSharedKeys)
+{
+    // Chain of 4 edges over 5 vertices, node i has keys (i, i + 1)
+    std::vector<size_t> keyOffsets = { 0, 2, 4, 6, 8 };
+    std::vector<size_t> keys       = { 0, 1, 1, 2, 2, 3, 3, 4 };
+
+    CsrGraph graph;
+    graph.buildFromSharedKeys(keyOffsets, keys);
+    ASSERT_EQ(graph.size(), 4);
+    EXPECT_EQ(graph.getNumNeighbors(0), 1);
+    EXPECT_EQ(graph.getNeighbors(0)[0], 1);
+    EXPECT_EQ(graph.getNumNeighbors(1), 2);
+    EXPECT_EQ(graph.getNeighbors(1)[0], 0);
+    EXPECT_EQ(graph.getNeighbors(1)[1], 2);
+    EXPECT_EQ(graph.getNumNeighbors(3), 1);
+
+    // Two nodes sharing two keys are still only adjacent once
+    keyOffsets = { 0, 2, 4 };
+    keys       = { 5, 7, 7, 5 };
+    graph.buildFromSharedKeys(keyOffsets, keys);
+    ASSERT_EQ(graph.size(), 2);
+    EXPECT_EQ(graph.getNumNeighbors(0), 1);
+    EXPECT_EQ(graph.getNumNeighbors(1), 1);
+}
+
+///
+/// \brief Test the parallel coloring of a large grid of triangles
+///
+TEST(imstkCsrGraphTest, JonesPlassmannColoring)
+{
+    // Triangles of a 100x100 vertex grid, adjacent when they share a vertex
+    const size_t        dim = 100;
+    std::vector<size_t> keyOffsets = { 0 };
+    std::vector<size_t> keys;
+    for (size_t i = 0; i < dim - 1; i++)
+    {
+        for (size_t j = 0; j < dim - 1; j++)
+        {
+            const size_t v0 = i * dim + j;
+            keys.insert(keys.end(), { v0, v0 + 1, v0 + dim });
+            keyOffsets.push_back(keys.size());
+            keys.insert(keys.end(), { v0 + 1, v0 + dim + 1, v0 + dim });
+            keyOffsets.push_back(keys.size());
+        }
+    }
+
+    CsrGraph graph;
+    graph.buildFromSharedKeys(keyOffsets, keys);
+    const auto coloring = graph.doColoring();
+    EXPECT_TRUE(verifyColoring(graph, coloring.first, coloring.second));
+
+    // Never more than max degree + 1 colors
+    size_t maxDegree = 0;
+    for (size_t i = 0; i < graph.size(); i++)
+    {
+        maxDegree = std::max(maxDegree, graph.getNumNeighbors(i));
+    }
+    EXPECT_LE(coloring.second, maxDegree + 1);
+
+    // Deterministic
+    EXPECT_EQ(graph.doColoring().first, coloring.first);
+}
@@ -8,6 +8,8 @@
 
 #include "imstkSpatialHashTableSeparateChaining.h"
 #include "imstkGridBasedNeighborSearch.h"
+#include "imstkNeighborSearch.h"
+#include "imstkSpatialHashTableCompact.h"
 #include "imstkVecDataArray.h"
 
 using namespace imstk;
@@ -290,3 +292,90 @@ TEST(imstkNeighborSearchTest, TestGridSearchFromDifferentPointSet)
         EXPECT_EQ(verify(neighbors1, neighbors0), true);
     }
 }
+
+///
+/// \brief Generate a sphere-shape particles and compare the neighbors found by the
+/// compact spatial hash, through NeighborSearch, to brute force
+///
+TEST(imstkNeighborSearchTest, CompareCompactSpatialHashing)
+{
+    const Vec3d sphereCenter    = SPHERE_CENTER;
+    const auto  sphereRadiusSqr = SPHERE_RADIUS * SPHERE_RADIUS;
+    const auto  spacing = 2.0 * PARTICLE_RADIUS;
+    const int   N       = int(2 * SPHERE_RADIUS / spacing);
+
+    VecDataArray<double, 3> particles;
+    particles.reserve(N * N * N);
+    const Vec3d corner = sphereCenter - Vec3d(SPHERE_RADIUS, SPHERE_RADIUS, SPHERE_RADIUS);
+
+    for (int i = 0; i < N; ++i)
+    {
+        for (int j = 0; j < N; ++j)
+        {
+            for (int k = 0; k < N; ++k)
+            {
+                const Vec3d ppos = corner + Vec3d(spacing * static_cast<double>(i), spacing * static_cast<double>(j), spacing * static_cast<double>(k));
+                const Vec3d d    = ppos - sphereCenter;
+                if (d.squaredNorm() < sphereRadiusSqr)
+                {
+                    particles.push_back(ppos);
+                }
+            }
+        }
+    }
+
+    NeighborSearch                   compactSearch(NeighborSearch::Method::CompactSpatialHashing, 4.000000000000001 * PARTICLE_RADIUS);
+    std::vector<std::vector<size_t>> neighbors0;
+    std::vector<std::vector<size_t>> neighbors1;
+
+    for (int iter = 0; iter < ITERATIONS; ++iter)
+    {
+        neighborSearchBruteForce(particles, neighbors0);
+        compactSearch.getNeighbors(neighbors1, particles);
+
+        EXPECT_EQ(verify(neighbors1, neighbors0), true);
+        advancePositions(particles);
+    }
+}
+
+///
+/// \brief Test points in AABBs of the compact spatial hash against brute force,
+/// including boxes spanning more cells than there are points
+///
+TEST(imstkNeighborSearchTest, CompactSpatialHashingAABB)
+{
+    VecDataArray<double, 3> points;
+    for (int i = 0; i < 500; i++)
+    {
+        points.push_back(Vec3d(std::sin(i * 0.37), std::cos(i * 0.71), std::sin(i * 1.13)) * 2.0);
+    }
+
+    SpatialHashTableCompact hashTable;
+    hashTable.setCellSize(0.3, 0.3, 0.3);
+    hashTable.insertPoints(points);
+    EXPECT_EQ(hashTable.size(), 500);
+
+    std::vector<size_t> result;
+    const Vec3d         boxes[3][2] = {
+        { Vec3d(-0.5, -0.5, -0.5), Vec3d(0.5, 0.5, 0.5) },
+        { Vec3d(1.0, 2.0, 0.2), Vec3d(-0.3, -1.0, 1.5) },
+        { Vec3d(-10.0, -10.0, -10.0), Vec3d(10.0, 10.0, 10.0) } };
+    for (const auto& box : boxes)
+    {
+        const Vec3d min = box[0].cwiseMin(box[1]);
+        const Vec3d max = box[0].cwiseMax(box[1]);
+
+        std::vector<size_t> expected;
+        for (int i = 0; i < points.size(); i++)
+        {
+            if ((points[i].array() >= min.array()).all() && (points[i].array() <= max.array()).all())
+            {
+                expected.push_back(i);
+            }
+        }
+
+        hashTable.getPointsInAABB(result, box[0], box[1]);
+        std::sort(result.begin(), result.end());
+        EXPECT_EQ(result, expected);
+    }
+}
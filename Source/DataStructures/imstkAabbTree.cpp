@@ -0,0 +1,233 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkAabbTree.h"
+#include "imstkLogger.h"
+
+#include <algorithm>
+
+namespace imstk
+{
+void
+AabbTree::build(const StdVectorOfVec3d& lowerCorners, const StdVectorOfVec3d& upperCorners)
+{
+    CHECK(lowerCorners.size() == upperCorners.size()) << "Number of lower and upper corners must match";
+    m_primLowerCorners = lowerCorners;
+    m_primUpperCorners = upperCorners;
+    buildTree();
+}
+
+void
+AabbTree::refit(const StdVectorOfVec3d& lowerCorners, const StdVectorOfVec3d& upperCorners)
+{
+    CHECK(lowerCorners.size() == m_primitiveIds.size() && upperCorners.size() == m_primitiveIds.size())
+        << "Refit requires the same number of primitives as the tree was built with";
+    m_primLowerCorners = lowerCorners;
+    m_primUpperCorners = upperCorners;
+    refitTree();
+}
+
+void
+AabbTree::clear()
+{
+    m_nodes.clear();
+    m_primitiveIds.clear();
+    m_primLowerCorners.clear();
+    m_primUpperCorners.clear();
+}
+
+void
+AabbTree::buildTree()
+{
+    const int numPrimitives = static_cast<int>(m_primLowerCorners.size());
+    m_nodes.clear();
+    m_primitiveIds.resize(numPrimitives);
+    if (numPrimitives == 0)
+    {
+        return;
+    }
+    for (int i = 0; i < numPrimitives; i++)
+    {
+        m_primitiveIds[i] = i;
+    }
+
+    StdVectorOfVec3d centroids(numPrimitives);
+    for (int i = 0; i < numPrimitives; i++)
+    {
+        centroids[i] = (m_primLowerCorners[i] + m_primUpperCorners[i]) * 0.5;
+    }
+
+    // A binary tree with leaves of at least one primitive has at most 2n-1 nodes
+    m_nodes.reserve(2 * numPrimitives - 1);
+    buildNode(0, numPrimitives, centroids);
+}
+
+int
+AabbTree::buildNode(const int start, const int end, const StdVectorOfVec3d& centroids)
+{
+    const int nodeIndex = static_cast<int>(m_nodes.size());
+    m_nodes.push_back(Node());
+
+    // Bounds of the primitive centroids, used to pick the split axis
+    Vec3d centroidMin = centroids[m_primitiveIds[start]];
+    Vec3d centroidMax = centroidMin;
+    for (int i = start + 1; i < end; i++)
+    {
+        centroidMin = centroidMin.cwiseMin(centroids[m_primitiveIds[i]]);
+        centroidMax = centroidMax.cwiseMax(centroids[m_primitiveIds[i]]);
+    }
+
+    const int count = end - start;
+    if (count <= m_maxLeafSize || (centroidMax - centroidMin).maxCoeff() == 0.0)
+    {
+        Node& node = m_nodes[nodeIndex];
+        node.start = start;
+        node.count = count;
+        computeLeafBounds(node);
+        return nodeIndex;
+    }
+
+    // Median split along the longest axis
+    int axis = 0;
+    (centroidMax - centroidMin).maxCoeff(&axis);
+    const int mid = start + count / 2;
+    std::nth_element(m_primitiveIds.begin() + start, m_primitiveIds.begin() + mid, m_primitiveIds.begin() + end,
+        [&](const int a, const int b) { return centroids[a][axis] < centroids[b][axis]; });
+
+    const int left  = buildNode(start, mid, centroids);
+    const int right = buildNode(mid, end, centroids);
+
+    // m_nodes may have been reallocated
+    Node& node = m_nodes[nodeIndex];
+    node.left        = left;
+    node.right       = right;
+    node.lowerCorner = m_nodes[left].lowerCorner.cwiseMin(m_nodes[right].lowerCorner);
+    node.upperCorner = m_nodes[left].upperCorner.cwiseMax(m_nodes[right].upperCorner);
+    return nodeIndex;
+}
+
+void
+AabbTree::computeLeafBounds(Node& node) const
+{
+    node.lowerCorner = m_primLowerCorners[m_primitiveIds[node.start]];
+    node.upperCorner = m_primUpperCorners[m_primitiveIds[node.start]];
+    for (int i = node.start + 1; i < node.start + node.count; i++)
+    {
+        node.lowerCorner = node.lowerCorner.cwiseMin(m_primLowerCorners[m_primitiveIds[i]]);
+        node.upperCorner = node.upperCorner.cwiseMax(m_primUpperCorners[m_primitiveIds[i]]);
+    }
+}
+
+void
+AabbTree::refitTree()
+{
+    // Children always come after their parent, a reverse sweep visits children first
+    for (int i = static_cast<int>(m_nodes.size()) - 1; i >= 0; i--)
+    {
+        Node& node = m_nodes[i];
+        if (node.isLeaf())
+        {
+            computeLeafBounds(node);
+        }
+        else
+        {
+            node.lowerCorner = m_nodes[node.left].lowerCorner.cwiseMin(m_nodes[node.right].lowerCorner);
+            node.upperCorner = m_nodes[node.left].upperCorner.cwiseMax(m_nodes[node.right].upperCorner);
+        }
+    }
+}
+
+void
+AabbTree::getOverlappingPrimitives(const Vec3d& lowerCorner, const Vec3d& upperCorner, std::vector<int>& results) const
+{
+    if (m_nodes.empty())
+    {
+        return;
+    }
+
+    std::vector<int> nodeStack;
+    nodeStack.push_back(0);
+    while (!nodeStack.empty())
+    {
+        const Node& node = m_nodes[nodeStack.back()];
+        nodeStack.pop_back();
+        if (!overlaps(node.lowerCorner, node.upperCorner, lowerCorner, upperCorner))
+        {
+            continue;
+        }
+        if (node.isLeaf())
+        {
+            for (int i = node.start; i < node.start + node.count; i++)
+            {
+                const int primId = m_primitiveIds[i];
+                if (overlaps(m_primLowerCorners[primId], m_primUpperCorners[primId], lowerCorner, upperCorner))
+                {
+                    results.push_back(primId);
+                }
+            }
+        }
+        else
+        {
+            nodeStack.push_back(node.left);
+            nodeStack.push_back(node.right);
+        }
+    }
+}
+
+void
+AabbTree::getOverlappingPairs(const AabbTree& treeA, const AabbTree& treeB, std::vector<std::pair<int, int>>& results)
+{
+    if (treeA.m_nodes.empty() || treeB.m_nodes.empty())
+    {
+        return;
+    }
+
+    // Simultaneous descent of both trees
+    std::vector<std::pair<int, int>> nodeStack;
+    nodeStack.push_back({ 0, 0 });
+    while (!nodeStack.empty())
+    {
+        const std::pair<int, int> nodePair = nodeStack.back();
+        nodeStack.pop_back();
+
+        const Node& nodeA = treeA.m_nodes[nodePair.first];
+        const Node& nodeB = treeB.m_nodes[nodePair.second];
+        if (!overlaps(nodeA.lowerCorner, nodeA.upperCorner, nodeB.lowerCorner, nodeB.upperCorner))
+        {
+            continue;
+        }
+
+        if (nodeA.isLeaf() && nodeB.isLeaf())
+        {
+            for (int i = nodeA.start; i < nodeA.start + nodeA.count; i++)
+            {
+                const int primA = treeA.m_primitiveIds[i];
+                for (int j = nodeB.start; j < nodeB.start + nodeB.count; j++)
+                {
+                    const int primB = treeB.m_primitiveIds[j];
+                    if (overlaps(treeA.m_primLowerCorners[primA], treeA.m_primUpperCorners[primA],
+                        treeB.m_primLowerCorners[primB], treeB.m_primUpperCorners[primB]))
+                    {
+                        results.push_back({ primA, primB });
+                    }
+                }
+            }
+        }
+        // Descend the larger node, or the only non-leaf one
+        else if (nodeB.isLeaf()
+                 || (!nodeA.isLeaf() && (nodeA.upperCorner - nodeA.lowerCorner).squaredNorm() >= (nodeB.upperCorner - nodeB.lowerCorner).squaredNorm()))
+        {
+            nodeStack.push_back({ nodeA.left, nodePair.second });
+            nodeStack.push_back({ nodeA.right, nodePair.second });
+        }
+        else
+        {
+            nodeStack.push_back({ nodePair.first, nodeB.left });
+            nodeStack.push_back({ nodePair.first, nodeB.right });
+        }
+    }
+}
+} // namespace imstk
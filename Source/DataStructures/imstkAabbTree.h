@@ -0,0 +1,245 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkParallelFor.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+///
+/// \class AabbTree
+///
+/// \brief Bounding volume hierarchy of axis aligned bounding boxes over the
+/// cells of a mesh. The tree is built once (top down, median split along the
+/// longest axis) and refit every frame from the vertex positions. Refitting
+/// keeps the topology of the tree so it is only valid as long as the cells of
+/// the mesh don't change, call build again otherwise.
+///
+/// Used as broad phase by the mesh to mesh collision detection algorithms
+///
+class AabbTree
+{
+public:
+    struct Node
+    {
+        Vec3d lowerCorner = Vec3d::Zero();
+        Vec3d upperCorner = Vec3d::Zero();
+        int left  = -1; ///< Index of the left child, -1 if leaf
+        int right = -1; ///< Index of the right child, -1 if leaf
+        int start = 0;  ///< Leaf only, start of the leaf primitives in the primitive list
+        int count = 0;  ///< Leaf only, number of primitives in the leaf
+
+        bool isLeaf() const { return left == -1; }
+    };
+
+public:
+    AabbTree() = default;
+    virtual ~AabbTree() = default;
+
+    ///
+    /// \brief Build the tree over the cells of a mesh
+    ///
+    template<int N>
+    void build(const VecDataArray<double, 3>& vertices, const VecDataArray<int, N>& cells)
+    {
+        computeCellBounds(vertices, cells);
+        buildTree();
+    }
+
+    ///
+    /// \brief Recompute the bounds of the tree from the current vertex positions.
+    /// cells must be the same as given on build
+    ///
+    template<int N>
+    void refit(const VecDataArray<double, 3>& vertices, const VecDataArray<int, N>& cells)
+    {
+        computeCellBounds(vertices, cells);
+        refitTree();
+    }
+
+    ///
+    /// \brief Build the tree over the given primitive bounds
+    ///
+    void build(const StdVectorOfVec3d& lowerCorners, const StdVectorOfVec3d& upperCorners);
+
+    ///
+    /// \brief Refit the tree with new primitive bounds, same count and order as given on build
+    ///
+    void refit(const StdVectorOfVec3d& lowerCorners, const StdVectorOfVec3d& upperCorners);
+
+    ///
+    /// \brief Returns the ids of all primitives whose bounds overlap the box
+    ///
+    void getOverlappingPrimitives(const Vec3d& lowerCorner, const Vec3d& upperCorner, std::vector<int>& results) const;
+
+    ///
+    /// \brief Returns all pairs of primitives (primitive of treeA, primitive of treeB)
+    /// whose bounds overlap
+    ///
+    static void getOverlappingPairs(const AabbTree& treeA, const AabbTree& treeB, std::vector<std::pair<int, int>>& results);
+
+    ///
+    /// \brief Visits the primitives nearest first for closest feature queries.
+    /// nodeSqrDistFunc(lowerCorner, upperCorner) gives a lower bound of the squared
+    /// distance to anything within the box, nodes further than minSqrDist are skipped.
+    /// primitiveFunc(primitiveId, minSqrDist) is called for every primitive of the
+    /// remaining leaves and may lower minSqrDist to prune the search
+    ///
+    template<typename NodeSqrDistFunc, typename PrimitiveFunc>
+    void visitNearest(NodeSqrDistFunc nodeSqrDistFunc, PrimitiveFunc primitiveFunc, double& minSqrDist) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        // The tree is balanced by the median split, its depth can't exceed the stack
+        std::pair<double, int> nodeStack[128];
+        int                    stackSize = 0;
+        nodeStack[stackSize++] = { nodeSqrDistFunc(m_nodes[0].lowerCorner, m_nodes[0].upperCorner), 0 };
+        while (stackSize > 0)
+        {
+            const std::pair<double, int> entry = nodeStack[--stackSize];
+            if (entry.first > minSqrDist)
+            {
+                continue;
+            }
+
+            const Node& node = m_nodes[entry.second];
+            if (node.isLeaf())
+            {
+                for (int i = node.start; i < node.start + node.count; i++)
+                {
+                    primitiveFunc(m_primitiveIds[i], minSqrDist);
+                }
+            }
+            else
+            {
+                // Push the nearer child last so it's visited first
+                const Node&  left      = m_nodes[node.left];
+                const Node&  right     = m_nodes[node.right];
+                const double leftDist  = nodeSqrDistFunc(left.lowerCorner, left.upperCorner);
+                const double rightDist = nodeSqrDistFunc(right.lowerCorner, right.upperCorner);
+                if (leftDist < rightDist)
+                {
+                    nodeStack[stackSize++] = { rightDist, node.right };
+                    nodeStack[stackSize++] = { leftDist, node.left };
+                }
+                else
+                {
+                    nodeStack[stackSize++] = { leftDist, node.left };
+                    nodeStack[stackSize++] = { rightDist, node.right };
+                }
+            }
+        }
+    }
+
+    ///
+    /// \brief Squared distance from a point to a box, 0 if inside
+    ///
+    static double pointToBoxSqrDist(const Vec3d& pt, const Vec3d& lowerCorner, const Vec3d& upperCorner)
+    {
+        return (lowerCorner - pt).cwiseMax(pt - upperCorner).cwiseMax(0.0).squaredNorm();
+    }
+
+    ///
+    /// \brief Squared distance between two boxes, 0 if they overlap
+    ///
+    static double boxToBoxSqrDist(const Vec3d& lowerA, const Vec3d& upperA, const Vec3d& lowerB, const Vec3d& upperB)
+    {
+        return (lowerA - upperB).cwiseMax(lowerB - upperA).cwiseMax(0.0).squaredNorm();
+    }
+
+    ///
+    /// \brief Get/Set the padding added on every side of the primitive bounds
+    ///@{
+    void setPadding(const double padding) { m_padding = padding; }
+    double getPadding() const { return m_padding; }
+    ///@}
+
+    ///
+    /// \brief Get/Set the maximum number of primitives in a leaf
+    ///@{
+    void setMaxLeafSize(const int maxLeafSize) { m_maxLeafSize = maxLeafSize; }
+    int getMaxLeafSize() const { return m_maxLeafSize; }
+    ///@}
+
+    ///
+    /// \brief Returns the number of primitives the tree was built with
+    ///
+    size_t getNumPrimitives() const { return m_primitiveIds.size(); }
+
+    ///
+    /// \brief Returns if the tree was built
+    ///
+    bool isBuilt() const { return !m_nodes.empty(); }
+
+    ///
+    /// \brief Returns the nodes of the tree, root first. Children always
+    /// come after their parent
+    ///
+    const std::vector<Node>& getNodes() const { return m_nodes; }
+
+    ///
+    /// \brief Clear the tree
+    ///
+    void clear();
+
+protected:
+    ///
+    /// \brief Compute the padded bounds of every cell
+    ///
+    template<int N>
+    void computeCellBounds(const VecDataArray<double, 3>& vertices, const VecDataArray<int, N>& cells)
+    {
+        m_primLowerCorners.resize(cells.size());
+        m_primUpperCorners.resize(cells.size());
+        ParallelUtils::parallelFor(cells.size(),
+            [&](const int i)
+            {
+                const Eigen::Matrix<int, N, 1>& cell = cells[i];
+                Vec3d lowerCorner = vertices[cell[0]];
+                Vec3d upperCorner = lowerCorner;
+                for (int j = 1; j < N; j++)
+                {
+                    lowerCorner = lowerCorner.cwiseMin(vertices[cell[j]]);
+                    upperCorner = upperCorner.cwiseMax(vertices[cell[j]]);
+                }
+                m_primLowerCorners[i] = lowerCorner - Vec3d::Constant(m_padding);
+                m_primUpperCorners[i] = upperCorner + Vec3d::Constant(m_padding);
+            }, cells.size() > 1000);
+    }
+
+    void buildTree();
+    void refitTree();
+
+    ///
+    /// \brief Recursively split primitives [start, end) into a subtree, returns its node index
+    ///
+    int buildNode(const int start, const int end, const StdVectorOfVec3d& centroids);
+
+    ///
+    /// \brief Recompute the bounds of a leaf from its primitives
+    ///
+    void computeLeafBounds(Node& node) const;
+
+    static bool overlaps(const Vec3d& lowerA, const Vec3d& upperA, const Vec3d& lowerB, const Vec3d& upperB)
+    {
+        return (lowerA.array() <= upperB.array()).all() && (lowerB.array() <= upperA.array()).all();
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<int>  m_primitiveIds;  ///< Primitive ids ordered such that every leaf references a contiguous range
+    StdVectorOfVec3d  m_primLowerCorners;
+    StdVectorOfVec3d  m_primUpperCorners;
+
+    double m_padding     = 0.0;
+    int    m_maxLeafSize = 4;
+};
+} // namespace imstk
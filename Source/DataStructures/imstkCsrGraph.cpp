@@ -0,0 +1,194 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCsrGraph.h"
+#include "imstkParallelUtils.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace imstk
+{
+namespace
+{
+///
+/// \brief Scrambles a node id into a priority
+///
+size_t
+hashNodeId(size_t x)
+{
+    x ^= x >> 16;
+    x *= static_cast<size_t>(0x45d9f3b);
+    x ^= x >> 16;
+    x *= static_cast<size_t>(0x45d9f3b);
+    x ^= x >> 16;
+    return x;
+}
+} // namespace
+
+void
+CsrGraph::buildFromSharedKeys(const std::vector<size_t>& keyOffsets, const std::vector<size_t>& keys)
+{
+    const size_t numNodes = keyOffsets.empty() ? 0 : keyOffsets.size() - 1;
+
+    // Sort (key, node) pairs by key so the nodes of a key are contiguous
+    std::vector<std::pair<size_t, size_t>> keyNodes(keys.size());
+    ParallelUtils::parallelFor(numNodes,
+        [&](const size_t i)
+        {
+            for (size_t j = keyOffsets[i]; j < keyOffsets[i + 1]; j++)
+            {
+                keyNodes[j] = { keys[j], i };
+            }
+        }, numNodes > 1000);
+    tbb::parallel_sort(keyNodes.begin(), keyNodes.end());
+
+    // The neighbors of a node are the nodes of all its keys, less itself and duplicates
+    tbb::enumerable_thread_specific<std::vector<size_t>> scratchBuffers;
+    auto                                                 gatherNeighbors =
+        [&](const size_t i, std::vector<size_t>& neighbors)
+        {
+            neighbors.clear();
+            for (size_t j = keyOffsets[i]; j < keyOffsets[i + 1]; j++)
+            {
+                auto range = std::equal_range(keyNodes.begin(), keyNodes.end(), std::make_pair(keys[j], size_t(0)),
+                    [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) { return a.first < b.first; });
+                for (auto iter = range.first; iter != range.second; iter++)
+                {
+                    if (iter->second != i)
+                    {
+                        neighbors.push_back(iter->second);
+                    }
+                }
+            }
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        };
+
+    // First count, then fill, to write straight into the flat array
+    m_offsets.assign(numNodes + 1, 0);
+    ParallelUtils::parallelFor(numNodes,
+        [&](const size_t i)
+        {
+            std::vector<size_t>& neighbors = scratchBuffers.local();
+            gatherNeighbors(i, neighbors);
+            m_offsets[i + 1] = neighbors.size();
+        }, numNodes > 1000);
+    for (size_t i = 0; i < numNodes; i++)
+    {
+        m_offsets[i + 1] += m_offsets[i];
+    }
+
+    m_adjacency.resize(m_offsets[numNodes]);
+    ParallelUtils::parallelFor(numNodes,
+        [&](const size_t i)
+        {
+            std::vector<size_t>& neighbors = scratchBuffers.local();
+            gatherNeighbors(i, neighbors);
+            std::copy(neighbors.begin(), neighbors.end(), m_adjacency.begin() + m_offsets[i]);
+        }, numNodes > 1000);
+}
+
+CsrGraph::graphColorsType
+CsrGraph::doColoring() const
+{
+    using ColorType = unsigned short;
+    const ColorType INVALID  = std::numeric_limits<ColorType>::max();
+    const size_t    numNodes = size();
+
+    std::vector<ColorType> colors(numNodes, INVALID);
+    if (numNodes == 0)
+    {
+        return std::make_pair(colors, ColorType(0));
+    }
+
+    // Higher degree first, then the scrambled id, then the id so no two nodes tie
+    auto hasPriority = [&](const size_t a, const size_t b)
+                       {
+                           const size_t degreeA = getNumNeighbors(a);
+                           const size_t degreeB = getNumNeighbors(b);
+                           if (degreeA != degreeB)
+                           {
+                               return degreeA > degreeB;
+                           }
+                           const size_t hashA = hashNodeId(a);
+                           const size_t hashB = hashNodeId(b);
+                           return (hashA != hashB) ? (hashA > hashB) : (a > b);
+                       };
+
+    std::vector<size_t> uncolored(numNodes);
+    for (size_t i = 0; i < numNodes; i++)
+    {
+        uncolored[i] = i;
+    }
+    std::vector<char> isLocalMax(numNodes, 0);
+
+    tbb::enumerable_thread_specific<std::vector<ColorType>> scratchBuffers;
+    while (!uncolored.empty())
+    {
+        // Find the nodes of highest priority among their uncolored neighbors, no two
+        // of them are adjacent so they can be colored at the same time
+        ParallelUtils::parallelFor(uncolored.size(),
+            [&](const size_t k)
+            {
+                const size_t  i = uncolored[k];
+                const size_t* neighbors = getNeighbors(i);
+                bool          localMax  = true;
+                for (size_t j = 0; j < getNumNeighbors(i) && localMax; j++)
+                {
+                    localMax = (colors[neighbors[j]] != INVALID) || hasPriority(i, neighbors[j]);
+                }
+                isLocalMax[i] = localMax;
+            }, uncolored.size() > 1000);
+
+        // Give them the smallest color their neighbors don't use
+        ParallelUtils::parallelFor(uncolored.size(),
+            [&](const size_t k)
+            {
+                const size_t i = uncolored[k];
+                if (!isLocalMax[i])
+                {
+                    return;
+                }
+                std::vector<ColorType>& neighborColors = scratchBuffers.local();
+                neighborColors.clear();
+                const size_t* neighbors = getNeighbors(i);
+                for (size_t j = 0; j < getNumNeighbors(i); j++)
+                {
+                    if (colors[neighbors[j]] != INVALID)
+                    {
+                        neighborColors.push_back(colors[neighbors[j]]);
+                    }
+                }
+                std::sort(neighborColors.begin(), neighborColors.end());
+                ColorType color = 0;
+                for (const ColorType neighborColor : neighborColors)
+                {
+                    if (neighborColor == color)
+                    {
+                        color++;
+                    }
+                    else if (neighborColor > color)
+                    {
+                        break;
+                    }
+                }
+                colors[i] = color;
+            }, uncolored.size() > 1000);
+
+        // Remove colored nodes
+        uncolored.erase(std::remove_if(uncolored.begin(), uncolored.end(),
+            [&](const size_t i) { return colors[i] != INVALID; }), uncolored.end());
+    }
+
+    ColorType numColors = 0;
+    for (const ColorType color : colors)
+    {
+        numColors = std::max(numColors, static_cast<ColorType>(color + 1));
+    }
+    return std::make_pair(colors, numColors);
+}
+} // namespace imstk
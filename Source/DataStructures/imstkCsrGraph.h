@@ -0,0 +1,67 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace imstk
+{
+///
+/// \class CsrGraph
+///
+/// \brief Undirected graph stored in compressed sparse row form, the neighbors
+/// of node i are m_adjacency[m_offsets[i], m_offsets[i + 1]). Unlike Graph it is
+/// built in one pass and colored in parallel, meant for large graphs such as the
+/// constraint graph of a mesh where two constraints are adjacent when they share
+/// a particle
+///
+class CsrGraph
+{
+public:
+    using graphColorsType = std::pair<std::vector<unsigned short>, unsigned short>;
+
+public:
+    CsrGraph() = default;
+    virtual ~CsrGraph() = default;
+
+    ///
+    /// \brief Build the graph such that nodes sharing a key are adjacent. The keys of
+    /// node i are keys[keyOffsets[i], keyOffsets[i + 1]), keyOffsets has size numNodes + 1
+    ///
+    void buildFromSharedKeys(const std::vector<size_t>& keyOffsets, const std::vector<size_t>& keys);
+
+    ///
+    /// \brief Get number of nodes of the graph
+    ///
+    size_t size() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+
+    ///
+    /// \brief Get number of neighbors of node i
+    ///
+    size_t getNumNeighbors(const size_t i) const { return m_offsets[i + 1] - m_offsets[i]; }
+
+    ///
+    /// \brief Get the neighbors of node i, getNumNeighbors(i) long
+    ///
+    const size_t* getNeighbors(const size_t i) const { return m_adjacency.data() + m_offsets[i]; }
+
+    ///
+    /// \brief Colorize with the Jones-Plassmann algorithm. Every round the uncolored
+    /// nodes of highest priority among their uncolored neighbors take the smallest
+    /// color not used by their neighbors, all in parallel. Priority is given by degree
+    /// first (like Welsh-Powell) then a hash of the node id so the result is deterministic
+    /// \return Node colors and number of colors
+    ///
+    graphColorsType doColoring() const;
+
+protected:
+    std::vector<size_t> m_offsets;   ///< Start of the neighbors of every node, size()+1 long
+    std::vector<size_t> m_adjacency; ///< Neighbors of all nodes
+};
+} // namespace imstk
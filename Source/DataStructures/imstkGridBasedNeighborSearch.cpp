@@ -16,6 +16,51 @@ GridBasedNeighborSearch::setSearchRadius(const double radius)
     m_SearchRadiusSqr = radius * radius;
 }
 
+template<typename Func>
+void
+GridBasedNeighborSearch::visitNeighbors(const Vec3d& ppos, Func func) const
+{
+    const VecDataArray<double, 3>& points  = *m_Points;
+    const auto                     cellIdx = m_Grid.template getCell3DIndices<int>(ppos);
+
+    for (int k = -1; k <= 1; ++k)
+    {
+        int cellZ = cellIdx[2] + k;
+        if (!m_Grid.template isValidCellIndex<2>(cellZ))
+        {
+            continue;
+        }
+        for (int j = -1; j <= 1; ++j)
+        {
+            int cellY = cellIdx[1] + j;
+            if (!m_Grid.template isValidCellIndex<1>(cellY))
+            {
+                continue;
+            }
+            for (int i = -1; i <= 1; ++i)
+            {
+                int cellX = cellIdx[0] + i;
+                if (!m_Grid.template isValidCellIndex<0>(cellX))
+                {
+                    continue;
+                }
+
+                // get index q of the point
+                for (auto q : m_Grid.getCellData(cellX, cellY, cellZ).particleIndices)
+                {
+                    const auto qpos  = points[q];
+                    const Vec3d diff = ppos - qpos;
+                    const auto d2    = diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2];
+                    if (d2 < m_SearchRadiusSqr)
+                    {
+                        func(q);
+                    }
+                }
+            }
+        }
+    }
+}
+
 std::vector<std::vector<size_t>>
 GridBasedNeighborSearch::getNeighbors(const VecDataArray<double, 3>& points)
 {
@@ -32,18 +77,36 @@ GridBasedNeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result,
 
 void
 GridBasedNeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB)
+{
+    setPoints(setB);
+
+    // for each point in setA, collect setB neighbors within the search radius
+    result.resize(setA.size());
+    ParallelUtils::parallelFor(setA.size(),
+        [&](const size_t p)
+        {
+            auto& pneighbors = result[p];
+
+            // important: must clear the old result (if applicable)
+            pneighbors.resize(0);
+            visitNeighbors(setA[p], [&](const size_t q) { pneighbors.push_back(q); });
+        });
+}
+
+void
+GridBasedNeighborSearch::setPoints(const VecDataArray<double, 3>& points)
 {
     LOG_IF(FATAL, (std::abs(m_SearchRadius) < 1e-8)) << "Neighbor search radius is zero";
 
-    // firstly compute the bounding box of points in setB
+    // firstly compute the bounding box of the points
     Vec3d lowerCorner;
     Vec3d upperCorner;
-    ParallelUtils::findAABB(setB, lowerCorner, upperCorner);
+    ParallelUtils::findAABB(points, lowerCorner, upperCorner);
 
     // the upper corner need to be expanded a bit, to avoid round-off error during computation
     upperCorner += Vec3d(m_SearchRadius, m_SearchRadius, m_SearchRadius) * 0.1;
 
-    // resize grid to fit the bounding box covering setB
+    // resize grid to fit the bounding box covering the points
     m_Grid.initialize(lowerCorner, upperCorner, m_SearchRadius);
 
     // clear all particle lists in each grid cell
@@ -53,65 +116,31 @@ GridBasedNeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result,
             m_Grid.getCellData(cellIdx).particleIndices.resize(0);
         });
 
-    // collect particle indices of points in setB into their corresponding cells
-    ParallelUtils::parallelFor(setB.size(),
+    // collect particle indices of the points into their corresponding cells
+    ParallelUtils::parallelFor(points.size(),
         [&](const size_t p)
         {
-            auto& cellData = m_Grid.getCellData(setB[p]);
+            auto& cellData = m_Grid.getCellData(points[p]);
             cellData.lock.lock();
             cellData.particleIndices.push_back(p);
             cellData.lock.unlock();
         });
+    m_Points = &points;
+}
 
-    // for each point in setA, collect setB neighbors within the search radius
-    result.resize(setA.size());
-    ParallelUtils::parallelFor(setA.size(),
-        [&](const size_t p)
-        {
-            auto& pneighbors = result[p];
-
-            // important: must clear the old result (if applicable)
-            pneighbors.resize(0);
-
-            const auto ppos    = setA[p];
-            const auto cellIdx = m_Grid.template getCell3DIndices<int>(ppos);
+size_t
+GridBasedNeighborSearch::countNeighbors(const Vec3d& pos) const
+{
+    size_t count = 0;
+    visitNeighbors(pos, [&](const size_t) { count++; });
+    return count;
+}
 
-            for (int k = -1; k <= 1; ++k)
-            {
-                int cellZ = cellIdx[2] + k;
-                if (!m_Grid.template isValidCellIndex<2>(cellZ))
-                {
-                    continue;
-                }
-                for (int j = -1; j <= 1; ++j)
-                {
-                    int cellY = cellIdx[1] + j;
-                    if (!m_Grid.template isValidCellIndex<1>(cellY))
-                    {
-                        continue;
-                    }
-                    for (int i = -1; i <= 1; ++i)
-                    {
-                        int cellX = cellIdx[0] + i;
-                        if (!m_Grid.template isValidCellIndex<0>(cellX))
-                        {
-                            continue;
-                        }
-
-                        // get index q of point in setB
-                        for (auto q : m_Grid.getCellData(cellX, cellY, cellZ).particleIndices)
-                        {
-                            const auto qpos  = setB[q];
-                            const Vec3d diff = ppos - qpos;
-                            const auto d2    = diff[0] * diff[0] + diff[1] * diff[1] + diff[2] * diff[2];
-                            if (d2 < m_SearchRadiusSqr)
-                            {
-                                pneighbors.push_back(q);
-                            }
-                        }
-                    }
-                }
-            }
-    });
+size_t
+GridBasedNeighborSearch::getNeighbors(const Vec3d& pos, size_t* neighbors) const
+{
+    size_t count = 0;
+    visitNeighbors(pos, [&](const size_t q) { neighbors[count++] = q; });
+    return count;
 }
 } // namespace imstk
\ No newline at end of file
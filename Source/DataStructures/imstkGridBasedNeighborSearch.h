@@ -59,9 +59,36 @@ public:
     ///
     void getNeighbors(std::vector<std::vector<size_t>>& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB);
 
+    ///
+    /// \brief Bin the points to search neighbors in, for the point queries below.
+    /// The points must outlive the queries
+    ///
+    void setPoints(const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Count the set points within the search radius of pos
+    ///
+    size_t countNeighbors(const Vec3d& pos) const;
+
+    ///
+    /// \brief Write the ids of the set points within the search radius of pos, in the
+    /// same order on every call until the points are set again
+    /// \param pos The position to search around
+    /// \param neighbors Buffer of at least countNeighbors(pos) ids
+    /// \return The number of ids written
+    ///
+    size_t getNeighbors(const Vec3d& pos, size_t* neighbors) const;
+
 private:
+    ///
+    /// \brief Calls func(id) for every set point within the search radius of pos
+    ///
+    template<typename Func>
+    void visitNeighbors(const Vec3d& pos, Func func) const;
+
     double m_SearchRadius    = 0.0;
     double m_SearchRadiusSqr = 0.0;
+    const VecDataArray<double, 3>* m_Points = nullptr; ///< Points binned in the grid
 
     // Data store in each grid cell
     // This entire struct can be replaced by tbb::concurrent_vector<size_t>, however, with lower performance
@@ -5,6 +5,7 @@
 */
 
 #include "imstkGridBasedNeighborSearch.h"
+#include "imstkSpatialHashTableCompact.h"
 #include "imstkSpatialHashTableSeparateChaining.h"
 #include "imstkNeighborSearch.h"
 #include "imstkParallelUtils.h"
@@ -19,6 +20,11 @@ NeighborSearch::NeighborSearch(NeighborSearch::Method searchMethod, double searc
         m_GridBasedSearcher = std::make_shared<GridBasedNeighborSearch>();
         m_GridBasedSearcher->setSearchRadius(m_SearchRadius);
     }
+    else if (m_Method == Method::CompactSpatialHashing)
+    {
+        m_CompactHashSearcher = std::make_shared<SpatialHashTableCompact>();
+        m_CompactHashSearcher->setCellSize(m_SearchRadius, m_SearchRadius, m_SearchRadius);
+    }
     else
     {
         m_SpatialHashSearcher = std::make_shared<SpatialHashTableSeparateChaining>();
@@ -34,6 +40,10 @@ NeighborSearch::setSearchRadius(const double searchRadius)
     {
         m_GridBasedSearcher->setSearchRadius(m_SearchRadius);
     }
+    else if (m_Method == Method::CompactSpatialHashing)
+    {
+        m_CompactHashSearcher->setCellSize(m_SearchRadius, m_SearchRadius, m_SearchRadius);
+    }
     else
     {
         m_SpatialHashSearcher->setCellSize(m_SearchRadius, m_SearchRadius, m_SearchRadius);
@@ -61,6 +71,18 @@ NeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result, const Vec
     {
         m_GridBasedSearcher->getNeighbors(result, setA, setB);
     }
+    else if (m_Method == Method::CompactSpatialHashing)
+    {
+        m_CompactHashSearcher->clear();
+        m_CompactHashSearcher->insertPoints(setB);
+
+        result.resize(setA.size());
+        ParallelUtils::parallelFor(setA.size(),
+            [&](const size_t p) {
+                // For each point in setA, find neighbors in setB
+                m_CompactHashSearcher->getPointsInSphere(result[p], setA[p], m_SearchRadius);
+            });
+    }
     else
     {
         m_SpatialHashSearcher->clear();
@@ -73,4 +95,60 @@ NeighborSearch::getNeighbors(std::vector<std::vector<size_t>>& result, const Vec
             });
     }
 }
+
+void
+NeighborSearch::setPoints(const VecDataArray<double, 3>& points)
+{
+    if (m_Method == Method::UniformGridBasedSearch)
+    {
+        m_GridBasedSearcher->setPoints(points);
+    }
+    else if (m_Method == Method::CompactSpatialHashing)
+    {
+        m_CompactHashSearcher->clear();
+        m_CompactHashSearcher->insertPoints(points);
+    }
+    else
+    {
+        m_SpatialHashSearcher->clear();
+        m_SpatialHashSearcher->insertPoints(points);
+    }
+}
+
+size_t
+NeighborSearch::countNeighbors(const Vec3d& pos) const
+{
+    if (m_Method == Method::UniformGridBasedSearch)
+    {
+        return m_GridBasedSearcher->countNeighbors(pos);
+    }
+    else if (m_Method == Method::CompactSpatialHashing)
+    {
+        return m_CompactHashSearcher->countPointsInSphere(pos, m_SearchRadius);
+    }
+    else
+    {
+        return m_SpatialHashSearcher->getPointsInSphere(pos, m_SearchRadius).size();
+    }
+}
+
+size_t
+NeighborSearch::getNeighbors(const Vec3d& pos, size_t* neighbors) const
+{
+    if (m_Method == Method::UniformGridBasedSearch)
+    {
+        return m_GridBasedSearcher->getNeighbors(pos, neighbors);
+    }
+    else if (m_Method == Method::CompactSpatialHashing)
+    {
+        return m_CompactHashSearcher->getPointsInSphere(neighbors, pos, m_SearchRadius);
+    }
+    else
+    {
+        // The chained table only gathers into lists
+        const std::vector<size_t> result = m_SpatialHashSearcher->getPointsInSphere(pos, m_SearchRadius);
+        std::copy(result.begin(), result.end(), neighbors);
+        return result.size();
+    }
+}
 } // namespace imstk
\ No newline at end of file
@@ -12,6 +12,7 @@
 namespace imstk
 {
 class GridBasedNeighborSearch;
+class SpatialHashTableCompact;
 class SpatialHashTableSeparateChaining;
 
 ///
@@ -24,7 +25,8 @@ public:
     enum class Method
     {
         UniformGridBasedSearch,
-        SpatialHashing
+        SpatialHashing,
+        CompactSpatialHashing
     };
 
     ///
@@ -65,11 +67,32 @@ public:
     ///
     void getNeighbors(std::vector<std::vector<size_t>>& result, const VecDataArray<double, 3>& setA, const VecDataArray<double, 3>& setB);
 
+    ///
+    /// \brief Set the points to search neighbors in, for the point queries below. With
+    /// a count then a write per point, neighbors can be written straight into packed
+    /// (CSR) arrays. The points must outlive the queries
+    ///
+    void setPoints(const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Count the set points within the search radius of pos
+    ///
+    size_t countNeighbors(const Vec3d& pos) const;
+
+    ///
+    /// \brief Write the ids of the set points within the search radius of pos
+    /// \param pos The position to search around
+    /// \param neighbors Buffer of at least countNeighbors(pos) ids
+    /// \return The number of ids written, countNeighbors(pos)
+    ///
+    size_t getNeighbors(const Vec3d& pos, size_t* neighbors) const;
+
 private:
     Method m_Method;
     double m_SearchRadius = 0.0;
 
     std::shared_ptr<GridBasedNeighborSearch> m_GridBasedSearcher;
     std::shared_ptr<SpatialHashTableSeparateChaining> m_SpatialHashSearcher;
+    std::shared_ptr<SpatialHashTableCompact> m_CompactHashSearcher;
 };
 } // namespace imstk
\ No newline at end of file
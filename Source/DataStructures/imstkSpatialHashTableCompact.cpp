@@ -0,0 +1,214 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkSpatialHashTableCompact.h"
+#include "imstkParallelUtils.h"
+
+namespace imstk
+{
+void
+SpatialHashTableCompact::insertPoints(const VecDataArray<double, 3>& points)
+{
+    m_points.reserve(m_points.size() + points.size());
+    for (int i = 0; i < points.size(); i++)
+    {
+        m_points.push_back(points[i]);
+    }
+    rehash();
+}
+
+void
+SpatialHashTableCompact::clear()
+{
+    m_points.resize(0);
+    m_pointSlots.resize(0);
+    m_slotStarts.resize(0);
+    m_sortedIds.resize(0);
+    m_sortedPoints.resize(0);
+    m_sortedCells.resize(0);
+}
+
+void
+SpatialHashTableCompact::setCellSize(double x, double y, double z)
+{
+    m_cellSize[0] = x;
+    m_cellSize[1] = y;
+    m_cellSize[2] = z;
+
+    rehash();
+}
+
+void
+SpatialHashTableCompact::rehash()
+{
+    const size_t numPoints = m_points.size();
+    if (numPoints == 0)
+    {
+        m_slotStarts.resize(0);
+        return;
+    }
+
+    // Power of two number of slots, about two per point
+    size_t numSlots = 1;
+    while (numSlots < 2 * numPoints)
+    {
+        numSlots <<= 1;
+    }
+    m_slotStarts.assign(numSlots + 1, 0);
+
+    const bool doParallel = numPoints > 1000;
+    m_pointSlots.resize(numPoints);
+    ParallelUtils::parallelFor(numPoints,
+        [&](const size_t i)
+        {
+            m_pointSlots[i] = getSlot(getCell(m_points[i]));
+        }, doParallel);
+
+    // Counting sort of the point ids by slot
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        m_slotStarts[m_pointSlots[i] + 1]++;
+    }
+    for (size_t i = 0; i < numSlots; i++)
+    {
+        m_slotStarts[i + 1] += m_slotStarts[i];
+    }
+    std::vector<size_t> writeIds(m_slotStarts.begin(), m_slotStarts.end() - 1);
+    m_sortedIds.resize(numPoints);
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        m_sortedIds[writeIds[m_pointSlots[i]]++] = i;
+    }
+
+    // Gather the positions so the points of a slot are contiguous in memory
+    m_sortedPoints.resize(numPoints);
+    m_sortedCells.resize(numPoints);
+    ParallelUtils::parallelFor(numPoints,
+        [&](const size_t i)
+        {
+            m_sortedPoints[i] = m_points[m_sortedIds[i]];
+            m_sortedCells[i]  = getCell(m_sortedPoints[i]);
+        }, doParallel);
+}
+
+template<typename Func>
+void
+SpatialHashTableCompact::visitCells(const Vec3i& minCell, const Vec3i& maxCell, Func func) const
+{
+    if (m_slotStarts.empty())
+    {
+        return;
+    }
+
+    // When the range covers more cells than there are points, test all points instead
+    const Vec3d numCells = (maxCell - minCell).cast<double>() + Vec3d::Ones();
+    if (numCells[0] * numCells[1] * numCells[2] > static_cast<double>(m_sortedIds.size()))
+    {
+        for (size_t i = 0; i < m_sortedIds.size(); i++)
+        {
+            const Vec3i& cell = m_sortedCells[i];
+            if (cell[0] >= minCell[0] && cell[1] >= minCell[1] && cell[2] >= minCell[2]
+                && cell[0] <= maxCell[0] && cell[1] <= maxCell[1] && cell[2] <= maxCell[2])
+            {
+                func(m_sortedIds[i], m_sortedPoints[i]);
+            }
+        }
+        return;
+    }
+
+    for (int x = minCell[0]; x <= maxCell[0]; x++)
+    {
+        for (int y = minCell[1]; y <= maxCell[1]; y++)
+        {
+            for (int z = minCell[2]; z <= maxCell[2]; z++)
+            {
+                const Vec3i  cell(x, y, z);
+                const size_t slot = getSlot(cell);
+                for (size_t i = m_slotStarts[slot]; i < m_slotStarts[slot + 1]; i++)
+                {
+                    // Other cells may share the slot
+                    if (m_sortedCells[i] == cell)
+                    {
+                        func(m_sortedIds[i], m_sortedPoints[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+SpatialHashTableCompact::getPointsInAABB(std::vector<size_t>& result, const Vec3d& corner1, const Vec3d& corner2) const
+{
+    const Vec3d min = corner1.cwiseMin(corner2);
+    const Vec3d max = corner1.cwiseMax(corner2);
+
+    result.resize(0);
+    visitCells(getCell(min), getCell(max),
+        [&](const size_t id, const Vec3d& pos)
+        {
+            if (pos.x() >= min.x() && pos.x() <= max.x()
+                && pos.y() >= min.y() && pos.y() <= max.y()
+                && pos.z() >= min.z() && pos.z() <= max.z())
+            {
+                result.push_back(id);
+            }
+        });
+}
+
+void
+SpatialHashTableCompact::getPointsInSphere(std::vector<size_t>& result, const Vec3d& ppos, const double radius) const
+{
+    const Vec3d  extent(radius, radius, radius);
+    const double radiusSqr = radius * radius;
+
+    result.resize(0);
+    visitCells(getCell(ppos - extent), getCell(ppos + extent),
+        [&](const size_t id, const Vec3d& pos)
+        {
+            if ((ppos - pos).squaredNorm() < radiusSqr)
+            {
+                result.push_back(id);
+            }
+        });
+}
+
+size_t
+SpatialHashTableCompact::getPointsInSphere(size_t* result, const Vec3d& ppos, const double radius) const
+{
+    const Vec3d  extent(radius, radius, radius);
+    const double radiusSqr = radius * radius;
+
+    size_t count = 0;
+    visitCells(getCell(ppos - extent), getCell(ppos + extent),
+        [&](const size_t id, const Vec3d& pos)
+        {
+            if ((ppos - pos).squaredNorm() < radiusSqr)
+            {
+                result[count++] = id;
+            }
+        });
+    return count;
+}
+
+size_t
+SpatialHashTableCompact::countPointsInSphere(const Vec3d& ppos, const double radius) const
+{
+    const Vec3d  extent(radius, radius, radius);
+    const double radiusSqr = radius * radius;
+
+    size_t count = 0;
+    visitCells(getCell(ppos - extent), getCell(ppos + extent),
+        [&](const size_t, const Vec3d& pos)
+        {
+            if ((ppos - pos).squaredNorm() < radiusSqr)
+            {
+                count++;
+            }
+        });
+    return count;
+}
+} // namespace imstk
@@ -0,0 +1,124 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkSpatialHashTable.h"
+#include "imstkMath.h"
+#include "imstkVecDataArray.h"
+
+namespace imstk
+{
+///
+/// \class SpatialHashTableCompact
+///
+/// \brief Implementation of SpatialHashTable as a hashed grid stored in flat arrays.
+/// Points are counting sorted by the hash of their cell so the points of a hash
+/// slot are contiguous, the table is rebuilt entirely (in parallel) on insertion
+/// which suits point sets that move every frame. Queries are const, thread safe and
+/// write into caller provided buffers to avoid allocations.
+///
+class SpatialHashTableCompact : public SpatialHashTable
+{
+public:
+    SpatialHashTableCompact() = default;
+    virtual ~SpatialHashTableCompact() = default;
+
+    ///
+    /// \brief Insert an array of points, ids continue from the points already inserted
+    /// \param points An array of point
+    ///
+    void insertPoints(const VecDataArray<double, 3>& points);
+
+    ///
+    /// \brief Finds IDs of all points in an AABB
+    /// \param result The list to contain search result, cleared first
+    /// \param corner1 One corner to the box
+    /// \param corner2 The other corner to the box
+    ///
+    void getPointsInAABB(std::vector<size_t>& result, const Vec3d& corner1, const Vec3d& corner2) const;
+
+    ///
+    /// \brief Find IDs of all points in a sphere centered at ppos and having given radius
+    /// \param result The list to contain search result, cleared first
+    /// \param pos Postision of the given point
+    /// \param radius The search radius
+    ///
+    void getPointsInSphere(std::vector<size_t>& result, const Vec3d& ppos, const double radius) const;
+
+    ///
+    /// \brief Find IDs of all points in a sphere centered at ppos and having given radius
+    /// \param result Buffer of at least countPointsInSphere(ppos, radius) IDs to write to
+    /// \param pos Postision of the given point
+    /// \param radius The search radius
+    /// \return The number of IDs written
+    ///
+    size_t getPointsInSphere(size_t* result, const Vec3d& ppos, const double radius) const;
+
+    ///
+    /// \brief Count the points in a sphere centered at ppos and having given radius
+    /// \param pos Postision of the given point
+    /// \param radius The search radius
+    ///
+    size_t countPointsInSphere(const Vec3d& ppos, const double radius) const;
+
+    ///
+    /// \brief Clears the table
+    ///
+    void clear();
+
+    ///
+    /// \brief Set the dimensions of each cell, rehashes the points
+    /// \param x,y,z Dimensions for each cell
+    ///
+    void setCellSize(double x, double y, double z) override;
+
+    ///
+    /// \brief Get the number of points in the table
+    ///
+    size_t size() const { return m_points.size(); }
+
+protected:
+    ///
+    /// \brief Rebuild the table from m_points
+    ///
+    void rehash() override;
+
+    ///
+    /// \brief Get the cell of a position
+    ///
+    Vec3i getCell(const Vec3d& pos) const
+    {
+        return Vec3i(static_cast<int>(std::floor(pos[0] / m_cellSize[0])),
+            static_cast<int>(std::floor(pos[1] / m_cellSize[1])),
+            static_cast<int>(std::floor(pos[2] / m_cellSize[2])));
+    }
+
+    ///
+    /// \brief Get the hash slot of a cell
+    ///
+    size_t getSlot(const Vec3i& cell) const
+    {
+        return ((static_cast<size_t>(cell[0]) * 73856093) ^
+                (static_cast<size_t>(cell[1]) * 19349663) ^
+                (static_cast<size_t>(cell[2]) * 83492791)) & (m_slotStarts.size() - 2);
+    }
+
+    ///
+    /// \brief Calls func(id, position) for every point whose cell is in [minCell, maxCell]
+    ///
+    template<typename Func>
+    void visitCells(const Vec3i& minCell, const Vec3i& maxCell, Func func) const;
+
+    StdVectorOfVec3d    m_points;       ///< Inserted points, in id order
+    std::vector<size_t> m_pointSlots;   ///< Slot of every point, in id order
+
+    std::vector<size_t> m_slotStarts;   ///< Start of every slot in the sorted arrays, numSlots+1 long
+    std::vector<size_t> m_sortedIds;    ///< Point ids sorted by slot
+    StdVectorOfVec3d    m_sortedPoints; ///< Point positions sorted by slot
+    std::vector<Vec3i>  m_sortedCells;  ///< Point cells sorted by slot, separates cells sharing a slot
+};
+} // namespace imstk
@@ -30,7 +30,7 @@ using ButtonStateType = int;
 class ButtonEvent : public Event
 {
 public:
-    ButtonEvent(std::string type, const int button, const ButtonStateType keyPressType) : Event(type),
+    ButtonEvent(const Signal type, const int button, const ButtonStateType keyPressType) : Event(type),
         m_buttonState(keyPressType),
         m_button(button)
     {
@@ -24,7 +24,7 @@ using KeyStateType = int;
 class KeyEvent : public Event
 {
 public:
-    KeyEvent(const std::string type, const char key, const KeyStateType keyPressType) : Event(type), m_keyPressType(keyPressType), m_key(key) { }
+    KeyEvent(const Signal type, const char key, const KeyStateType keyPressType) : Event(type), m_keyPressType(keyPressType), m_key(key) { }
     ~KeyEvent() override = default;
 
 public:
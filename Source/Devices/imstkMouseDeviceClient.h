@@ -30,17 +30,17 @@ using MouseButtonType = int;
 class MouseEvent : public Event
 {
 public:
-    MouseEvent(const std::string type, const MouseButtonType buttonId) :
+    MouseEvent(const Signal type, const MouseButtonType buttonId) :
         Event(type), m_scrollDx(0.0), m_buttonId(buttonId)
     {
     }
 
-    MouseEvent(std::string type, const double scrollDx) :
+    MouseEvent(const Signal type, const double scrollDx) :
         Event(type), m_scrollDx(scrollDx), m_buttonId(0)
     {
     }
 
-    MouseEvent(std::string type) :
+    MouseEvent(const Signal type) :
         Event(type), m_scrollDx(0.0), m_buttonId(0)
     {
     }
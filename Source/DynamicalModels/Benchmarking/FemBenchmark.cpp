@@ -0,0 +1,117 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCorotationalFemForceModel.h"
+#include "imstkFemDeformableBodyModel.h"
+#include "imstkGeometryUtilities.h"
+#include "imstkLinearFemForceModel.h"
+#include "imstkNativeFemForceModel.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+#include "imstkVegaMeshIO.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace imstk;
+
+///
+/// \brief Tetrahedral grid of dim^3 vertices, 5 (dim - 1)^3 tetrahedra
+///
+static std::shared_ptr<TetrahedralMesh>
+makeTetGrid(const int dim)
+{
+    return GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(dim, dim, dim));
+}
+
+///
+/// \brief Displacement twisting the mesh about the z axis, so the elements rotate
+///
+static Vectord
+makeTwist(std::shared_ptr<TetrahedralMesh> mesh)
+{
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    Vectord                        u(vertices.size() * 3);
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        const Mat3d R = Rotd(vertices[i][2] * PI_2, Vec3d(0.0, 0.0, 1.0)).toRotationMatrix();
+        u.segment<3>(3 * i) = R * vertices[i] - vertices[i];
+    }
+    return u;
+}
+
+///
+/// \brief Sets up the Eigen tangent stiffness with the pattern of \p forceModel
+///
+static void
+initTangentStiffness(InternalForceModel& forceModel, SparseMatrixd& K, std::shared_ptr<vega::SparseMatrix>& vegaK)
+{
+    vega::SparseMatrix* matrix = nullptr;
+    forceModel.getTangentStiffnessMatrixTopology(&matrix);
+    vegaK.reset(matrix);
+    FemDeformableBodyModel::initializeEigenMatrixFromVegaMatrix(*matrix, K);
+    forceModel.setTangentStiffness(vegaK);
+}
+
+///
+/// \brief Force and tangent stiffness of a vega force model
+///
+static void
+benchmarkForceAndMatrix(benchmark::State& state, std::shared_ptr<TetrahedralMesh> mesh, InternalForceModel& forceModel)
+{
+    SparseMatrixd                       K;
+    std::shared_ptr<vega::SparseMatrix> vegaK;
+    initTangentStiffness(forceModel, K, vegaK);
+
+    const Vectord u = makeTwist(mesh);
+    Vectord       f(u.size());
+    for (auto _ : state)
+    {
+        forceModel.getForceAndMatrix(u, f, K);
+        benchmark::DoNotOptimize(K.valuePtr());
+    }
+    state.counters["Tets"] = static_cast<double>(mesh->getNumTetrahedra());
+}
+
+static void
+BM_VegaCorotational(benchmark::State& state)
+{
+    auto                      mesh = makeTetGrid(static_cast<int>(state.range(0)));
+    CorotationalFemForceModel forceModel(VegaMeshIO::convertVolumetricMeshToVegaMesh(mesh));
+    benchmarkForceAndMatrix(state, mesh, forceModel);
+}
+
+static void
+BM_NativeCorotational(benchmark::State& state)
+{
+    auto                mesh = makeTetGrid(static_cast<int>(state.range(0)));
+    NativeFemForceModel forceModel(mesh, 1.0e7, 0.4, FeMethodType::Corotational);
+    benchmarkForceAndMatrix(state, mesh, forceModel);
+}
+
+static void
+BM_VegaLinear(benchmark::State& state)
+{
+    auto                mesh = makeTetGrid(static_cast<int>(state.range(0)));
+    LinearFemForceModel forceModel(VegaMeshIO::convertVolumetricMeshToVegaMesh(mesh), false);
+    benchmarkForceAndMatrix(state, mesh, forceModel);
+}
+
+static void
+BM_NativeLinear(benchmark::State& state)
+{
+    auto                mesh = makeTetGrid(static_cast<int>(state.range(0)));
+    NativeFemForceModel forceModel(mesh, 1.0e7, 0.4, FeMethodType::Linear);
+    benchmarkForceAndMatrix(state, mesh, forceModel);
+}
+
+// About 10k, 50k and 100k tetrahedra
+BENCHMARK(BM_VegaCorotational)->Unit(benchmark::kMillisecond)->Arg(14)->Arg(23)->Arg(28);
+BENCHMARK(BM_NativeCorotational)->Unit(benchmark::kMillisecond)->Arg(14)->Arg(23)->Arg(28);
+BENCHMARK(BM_VegaLinear)->Unit(benchmark::kMillisecond)->Arg(14)->Arg(23)->Arg(28);
+BENCHMARK(BM_NativeLinear)->Unit(benchmark::kMillisecond)->Arg(14)->Arg(23)->Arg(28);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -9,10 +9,13 @@
 #include "imstkGeometry.h"
 #include "imstkMath.h"
 #include "imstkMeshIO.h"
+#include "imstkPbdConstraintContainer.h"
 #include "imstkPbdModel.h"
 #include "imstkPbdModelConfig.h"
 #include "imstkPbdObject.h"
 #include "imstkPbdObjectCollision.h"
+#include "imstkPbdObjectGrasping.h"
+#include "imstkPbdSolver.h"
 #include "imstkPointSetToCapsuleCD.h"
 #include "imstkPointwiseMap.h"
 #include "imstkRbdConstraint.h"
@@ -24,8 +27,42 @@
 
 #include <benchmark/benchmark.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <set>
+
 using namespace imstk;
 
+///
+/// \brief Number of heap allocations made through operator new by the whole program,
+/// sampled around the timed loop of a benchmark to count its allocations per frame
+///
+static std::atomic<size_t> s_numHeapAllocations(0);
+
+void*
+operator new(std::size_t size)
+{
+    s_numHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
 ///
 /// \brief Creates a tetraheral grid
 /// \param size physical dimension of domain
@@ -152,7 +189,8 @@ BM_DistanceVolume(benchmark::State& state)
     pbdParams->m_gravity    = Vec3d(0.0, -1.0, 0.0);
     pbdParams->m_dt         = dt;
     pbdParams->m_iterations = state.range(1);
-    pbdParams->m_linearDampingCoeff = 0.03;
+    pbdParams->m_linearDampingCoeff  = 0.03;
+    pbdParams->m_useConstraintBlocks = state.range(2);
 
     // Setup the Model
     auto pbdModel = std::make_shared<PbdModel>();
@@ -185,6 +223,7 @@ BM_DistanceVolume(benchmark::State& state)
     state.counters["DOFs"]       = state.range(0) * state.range(0) * state.range(0);
     state.counters["Tets"]       = prismMesh->getNumTetrahedra();
     state.counters["Iterations"] = state.range(1);
+    state.counters["Blocks"]     = state.range(2);
 
     // This loop gets timed
     for (auto _ : state)
@@ -196,7 +235,7 @@ BM_DistanceVolume(benchmark::State& state)
 BENCHMARK(BM_DistanceVolume)
 ->Unit(benchmark::kMillisecond)
 ->Name("Distance and Volume Constraints: Tet Mesh")
-->ArgsProduct({ { 4, 6, 8, 10, 16, 20 }, { 2, 5, 8 } });
+->ArgsProduct({ { 4, 6, 8, 10, 16, 20 }, { 2, 5, 8 }, { 0, 1 } });
 
 ///
 /// \brief Time evolution step of PBD using distance+dihedral constraint on surface mesh
@@ -298,7 +337,8 @@ BM_PbdFemStVK(benchmark::State& state)
     pbdParams->m_gravity    = Vec3d(0.0, -1.0, 0.0);
     pbdParams->m_dt         = dt;
     pbdParams->m_iterations = state.range(1);
-    pbdParams->m_linearDampingCoeff = 0.03;
+    pbdParams->m_linearDampingCoeff  = 0.03;
+    pbdParams->m_useConstraintBlocks = state.range(2);
 
     // Setup the Model
     auto pbdModel = std::make_shared<PbdModel>();
@@ -332,6 +372,7 @@ BM_PbdFemStVK(benchmark::State& state)
     state.counters["DOFs"]       = prismMesh->getNumVertices();
     state.counters["Tets"]       = prismMesh->getNumTetrahedra();
     state.counters["Iterations"] = state.range(1);
+    state.counters["Blocks"]     = state.range(2);
 
     // This loop gets timed
     for (auto _ : state)
@@ -343,7 +384,7 @@ BM_PbdFemStVK(benchmark::State& state)
 BENCHMARK(BM_PbdFemStVK)
 ->Unit(benchmark::kMillisecond)
 ->Name("FEM StVK Constraints: Tet Mesh")
-->ArgsProduct({ { 4, 6, 8, 10, 16, 20 }, { 2, 5, 8 } });
+->ArgsProduct({ { 4, 6, 8, 10, 16, 20 }, { 2, 5, 8 }, { 0, 1 } });
 
 ///
 /// \brief Time evolution step of PBD using FEM constraints (Corotation) on volume mesh
@@ -885,5 +926,409 @@ BENCHMARK(BM_PbdFemContact)
 ->Name("FEM Constraints with contact: Tet Mesh")
 ->ArgsProduct({ { 4, 6, 8, 10, 16, 20 }, { 2, 5, 8 } });
 
+///
+/// \brief Time of the PbdSolver alone on a partitioned body of ~50k distance+volume
+/// constraints. The second argument additionally deep copies the partitions every
+/// step as the solver did before it kept a snapshot of raw pointers to them, so
+/// the difference of the two is the time saved per step
+///
+static void
+BM_PbdSolvePartitioned(benchmark::State& state)
+{
+    // Setup simulation
+    auto scene = std::make_shared<Scene>("PbdBenchmark");
+
+    double dt = 0.05;
+
+    // Create PBD object
+    auto prismObj = std::make_shared<PbdObject>("Prism");
+
+    // Setup the Geometry
+    std::shared_ptr<TetrahedralMesh> prismMesh = makeTetGrid(
+        Vec3d(4.0, 4.0, 4.0),
+        Vec3i(state.range(0), state.range(0), state.range(0)),
+        Vec3d(0.0, 0.0, 0.0));
+
+    // Setup the Parameters
+    auto pbdParams = std::make_shared<PbdModelConfig>();
+    pbdParams->enableConstraint(PbdModelConfig::ConstraintGenType::Volume, 1.0);
+    pbdParams->enableConstraint(PbdModelConfig::ConstraintGenType::Distance, 1.0);
+    pbdParams->m_doPartitioning = true;
+    pbdParams->m_gravity    = Vec3d(0.0, -1.0, 0.0);
+    pbdParams->m_dt         = dt;
+    pbdParams->m_iterations = state.range(1);
+    pbdParams->m_linearDampingCoeff = 0.03;
+
+    // Setup the Model
+    auto pbdModel = std::make_shared<PbdModel>();
+    pbdModel->configure(pbdParams);
+
+    // Setup the Object
+    prismObj->setPhysicsGeometry(prismMesh);
+    prismObj->setDynamicalModel(pbdModel);
+    prismObj->getPbdBody()->uniformMassValue = 0.05;
+
+    // Create the scene
+    scene->addSceneObject(prismObj);
+    scene->initialize();
+
+    // Advance once so the solver is setup
+    scene->advance(dt);
+
+    std::shared_ptr<PbdConstraintContainer> constraints      = pbdModel->getConstraints();
+    const PbdConstraintContainer&           constConstraints = *constraints;
+    size_t                                  numConstraints   = constConstraints.getConstraints().size();
+    for (const auto& constraintPartition : constConstraints.getPartitionedConstraints())
+    {
+        numConstraints += constraintPartition.size();
+    }
+
+    // Setup outputs for results
+    state.counters["Constraints"]    = numConstraints;
+    state.counters["Partitions"]     = constConstraints.getPartitionedConstraints().size();
+    state.counters["Iterations"]     = state.range(1);
+    state.counters["CopyPartitions"] = state.range(2);
+
+    std::shared_ptr<PbdSolver> solver = pbdModel->getSolver();
+
+    // This loop gets timed
+    for (auto _ : state)
+    {
+        if (state.range(2))
+        {
+            std::vector<std::vector<std::shared_ptr<PbdConstraint>>> partitionsCopy = constConstraints.getPartitionedConstraints();
+            benchmark::DoNotOptimize(partitionsCopy.data());
+        }
+        solver->solve();
+    }
+}
+
+BENCHMARK(BM_PbdSolvePartitioned)
+->Unit(benchmark::kMillisecond)
+->Name("Solve Partitioned Distance and Volume Constraints: Tet Mesh")
+->ArgsProduct({ { 17 }, { 1, 5 }, { 0, 1 } });
+
+///
+/// \brief Distance and volume constraints of a tet mesh projected with xPBD in the precision
+/// of Scalar. This is a benchmark only experiment, the constraint blocks of the solver
+/// are double precision
+///
+template<typename Scalar>
+struct DistanceVolumePrecisionExperiment
+{
+    using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+
+    ///
+    /// \brief Constrain the edges and tetrahedra of \p mesh at the rest shape of \p restVertices
+    ///
+    DistanceVolumePrecisionExperiment(const TetrahedralMesh& mesh, const VecDataArray<double, 3>& restVertices,
+                                      const double stiffness)
+    {
+        std::set<std::pair<int, int>> edgeSet;
+        for (const Vec4i& tet : *mesh.getTetrahedraIndices())
+        {
+            for (int a = 0; a < 4; a++)
+            {
+                for (int b = a + 1; b < 4; b++)
+                {
+                    edgeSet.insert({ std::min(tet[a], tet[b]), std::max(tet[a], tet[b]) });
+                }
+            }
+            tets.push_back(tet);
+            const Vec3d& x0 = restVertices[tet[0]];
+            restVolumes.push_back(static_cast<Scalar>((restVertices[tet[1]] - x0).cross(restVertices[tet[2]] - x0).dot(restVertices[tet[3]] - x0) / 6.0));
+        }
+        for (const auto& edge : edgeSet)
+        {
+            edges.push_back(edge);
+            restLengths.push_back(static_cast<Scalar>((restVertices[edge.first] - restVertices[edge.second]).norm()));
+        }
+        lambdas.resize(edges.size() + tets.size(), 0);
+        compliance = static_cast<Scalar>(1.0 / stiffness);
+    }
+
+    ///
+    /// \brief Set the positions and inverse masses, converted to Scalar
+    ///
+    void
+    setState(const VecDataArray<double, 3>& vertices, const DataArray<double>& vertexInvMasses)
+    {
+        positions.resize(vertices.size());
+        invMasses.resize(vertices.size());
+        for (int i = 0; i < vertices.size(); i++)
+        {
+            positions[i] = vertices[i].cast<Scalar>();
+            invMasses[i] = static_cast<Scalar>(vertexInvMasses[i]);
+        }
+    }
+
+    ///
+    /// \brief Project every distance constraint, then every volume constraint once
+    ///
+    void
+    project(const double dt)
+    {
+        const Scalar alpha = compliance / static_cast<Scalar>(dt * dt);
+        for (size_t i = 0; i < edges.size(); i++)
+        {
+            Vec3&        x0  = positions[edges[i].first];
+            Vec3&        x1  = positions[edges[i].second];
+            const Scalar w0  = invMasses[edges[i].first];
+            const Scalar w1  = invMasses[edges[i].second];
+            const Vec3   d   = x0 - x1;
+            const Scalar len = d.norm();
+            if (len < static_cast<Scalar>(1.0e-16) || w0 + w1 == 0)
+            {
+                continue;
+            }
+            const Vec3   n       = d / len;
+            const Scalar c       = len - restLengths[i];
+            const Scalar dlambda = -(c + alpha * lambdas[i]) / (w0 + w1 + alpha);
+            lambdas[i] += dlambda;
+            x0         += w0 * dlambda * n;
+            x1         -= w1 * dlambda * n;
+        }
+
+        const Scalar onesixth = static_cast<Scalar>(1.0 / 6.0);
+        for (size_t i = 0; i < tets.size(); i++)
+        {
+            const Vec4i& tet = tets[i];
+            const Vec3   x[4] = { positions[tet[0]], positions[tet[1]], positions[tet[2]], positions[tet[3]] };
+            const Vec3   dcdx[4] = {
+                onesixth * (x[1] - x[2]).cross(x[3] - x[1]),
+                onesixth * (x[2] - x[0]).cross(x[3] - x[0]),
+                onesixth * (x[3] - x[0]).cross(x[1] - x[0]),
+                onesixth * (x[1] - x[0]).cross(x[2] - x[0])
+            };
+            const Scalar c = dcdx[3].dot(x[3] - x[0]) - restVolumes[i];
+
+            Scalar w = 0;
+            for (int j = 0; j < 4; j++)
+            {
+                w += invMasses[tet[j]] * dcdx[j].squaredNorm();
+            }
+            if (w == 0)
+            {
+                continue;
+            }
+            Scalar&      lambda  = lambdas[edges.size() + i];
+            const Scalar dlambda = -(c + alpha * lambda) / (w + alpha);
+            lambda += dlambda;
+            for (int j = 0; j < 4; j++)
+            {
+                positions[tet[j]] += invMasses[tet[j]] * dlambda * dcdx[j];
+            }
+        }
+    }
+
+    std::vector<std::pair<int, int>> edges;
+    std::vector<Scalar> restLengths;
+    std::vector<Vec4i>  tets;
+    std::vector<Scalar> restVolumes;
+    std::vector<Scalar> lambdas;
+    Scalar compliance = 0;
+
+    std::vector<Vec3>   positions;
+    std::vector<Scalar> invMasses;
+};
+
+///
+/// \brief Time of projecting the distance+volume constraints of a squashed tet mesh in
+/// double or single precision (second argument) with the kernels of
+/// DistanceVolumePrecisionExperiment. The error is the largest distance of the single
+/// precision vertices to the vertices projected in double the same number of times
+///
+static void
+BM_PbdBlockPrecision(benchmark::State& state)
+{
+    std::shared_ptr<TetrahedralMesh> prismMesh = makeTetGrid(
+        Vec3d(4.0, 4.0, 4.0),
+        Vec3i(state.range(0), state.range(0), state.range(0)),
+        Vec3d(0.0, 0.0, 0.0));
+    const int    numVertices = prismMesh->getNumVertices();
+    const double dt          = 0.01;
+
+    // Squashed with the top fixed
+    VecDataArray<double, 3> vertices = *prismMesh->getVertexPositions();
+    DataArray<double>       invMasses(numVertices);
+    for (int i = 0; i < numVertices; i++)
+    {
+        invMasses[i]   = (vertices[i][1] == 2.0) ? 0.0 : 1.0;
+        vertices[i][1] = 2.0 + (vertices[i][1] - 2.0) * 0.8;
+    }
+
+    DistanceVolumePrecisionExperiment<double> doubleExperiment(*prismMesh, *prismMesh->getVertexPositions(), 1.0e4);
+    DistanceVolumePrecisionExperiment<float>  floatExperiment(*prismMesh, *prismMesh->getVertexPositions(), 1.0e4);
+    doubleExperiment.setState(vertices, invMasses);
+    floatExperiment.setState(vertices, invMasses);
+
+    // Setup outputs for results
+    state.counters["DOFs"]            = numVertices;
+    state.counters["Constraints"]     = static_cast<double>(doubleExperiment.lambdas.size());
+    state.counters["SinglePrecision"] = state.range(1);
+
+    // This loop gets timed
+    for (auto _ : state)
+    {
+        if (state.range(1))
+        {
+            floatExperiment.project(dt);
+        }
+        else
+        {
+            doubleExperiment.project(dt);
+        }
+    }
+
+    if (state.range(1))
+    {
+        // Project in double as many times to compare
+        for (benchmark::IterationCount i = 0; i < state.iterations(); i++)
+        {
+            doubleExperiment.project(dt);
+        }
+        double maxError = 0.0;
+        for (int i = 0; i < numVertices; i++)
+        {
+            maxError = std::max(maxError, (floatExperiment.positions[i].cast<double>() - doubleExperiment.positions[i]).norm());
+        }
+        state.counters["MaxError"] = maxError;
+    }
+}
+
+BENCHMARK(BM_PbdBlockPrecision)
+->Unit(benchmark::kMillisecond)
+->Name("Distance and Volume Constraints in Double and Single Precision: Tet Mesh")
+->ArgsProduct({ { 8, 16, 24 }, { 0, 1 } });
+
+///
+/// \brief Time evolution step of PBD using distance+volume constraint on volume mesh
+/// in contact with a capsule whilst a moving sphere grasps it. Reports the heap
+/// allocations per frame of the whole step, with the contact constraints pooled in
+/// the arena of the model or, to compare against allocating them every frame as before
+/// the arena, with the arena cleared before every frame. The grasp constraints are
+/// allocated once when the grasp begins and are not pooled, they only add contacts
+///
+static void
+BM_PbdGraspContactArena(benchmark::State& state)
+{
+    // Setup simulation
+    auto scene = std::make_shared<Scene>("PbdBenchmark");
+
+    double dt = 0.05;
+
+    // Create PBD object
+    auto prismObj = std::make_shared<PbdObject>("Prism");
+
+    // Setup the mesh Geometry
+    std::shared_ptr<TetrahedralMesh> prismMesh = makeTetGrid(
+        Vec3d(4.0, 4.0, 4.0),
+        Vec3i(state.range(0), state.range(0), state.range(0)),
+        Vec3d(0.0, 0.0, 0.0));
+
+    // Create surface mesh for contact
+    std::shared_ptr<SurfaceMesh> surfMesh = prismMesh->extractSurfaceMesh();
+    prismObj->setCollidingGeometry(surfMesh);
+    prismObj->setPhysicsToCollidingMap(std::make_shared<PointwiseMap>(prismMesh, surfMesh));
+
+    // Setup the Parameters
+    auto pbdParams = std::make_shared<PbdModelConfig>();
+    pbdParams->enableConstraint(PbdModelConfig::ConstraintGenType::Volume, 0.9);
+    pbdParams->enableConstraint(PbdModelConfig::ConstraintGenType::Distance, 0.9);
+    pbdParams->m_doPartitioning = false;
+    pbdParams->m_gravity    = Vec3d(0.0, -1.0 / (double)state.range(0), 0.0);
+    pbdParams->m_dt         = dt;
+    pbdParams->m_iterations = state.range(1);
+    pbdParams->m_linearDampingCoeff = 0.03;
+
+    // Setup the Model
+    auto pbdModel = std::make_shared<PbdModel>();
+    pbdModel->configure(pbdParams);
+
+    // Setup the Object
+    prismObj->setPhysicsGeometry(prismMesh);
+    prismObj->setDynamicalModel(pbdModel);
+    prismObj->getPbdBody()->uniformMassValue = 0.05;
+    // Fix the borders
+    for (int z = 0; z < state.range(0); z++)
+    {
+        for (int y = 0; y < state.range(0); y++)
+        {
+            for (int x = 0; x < state.range(0); x++)
+            {
+                if (y == state.range(0) - 1)
+                {
+                    prismObj->getPbdBody()->fixedNodeIds.push_back(x + state.range(0) * (y + state.range(0) * z));
+                }
+            }
+        }
+    }
+
+    // Add Capsule for collision
+    auto capsule = std::make_shared<Capsule>();
+    capsule->setRadius(0.5);
+    capsule->setLength(2);
+    capsule->setPosition(Vec3d(0.0, -2.6, 0.0));
+    capsule->setOrientation(Quatd(0.707, 0.0, 0.0, 0.707));
+
+    std::shared_ptr<CollidingObject> collisionObj = std::make_shared<CollidingObject>("CollidingObject");
+    collisionObj->setCollidingGeometry(capsule);
+    collisionObj->setVisualGeometry(capsule);
+    scene->addSceneObject(collisionObj);
+
+    auto pbdCollision = std::make_shared<PbdObjectCollision>(prismObj, collisionObj, "SurfaceMeshToCapsuleCD");
+    pbdCollision->setFriction(0.0);
+    pbdCollision->setRestitution(0.0);
+    scene->addInteraction(pbdCollision);
+
+    // Grasp a corner of the prism with a sphere
+    auto grasperSphere = std::make_shared<Sphere>(Vec3d(2.0, -2.0, 2.0), 1.0);
+    auto pbdGrasping   = std::make_shared<PbdObjectGrasping>(prismObj);
+    scene->addInteraction(pbdGrasping);
+
+    // Create the scene
+    scene->addSceneObject(prismObj);
+    scene->initialize();
+
+    pbdGrasping->beginVertexGrasp(grasperSphere);
+
+    const bool          pooled = state.range(2);
+    PbdConstraintArena& arena  = pbdModel->getConstraintArena();
+
+    // This loop gets timed
+    int    frame              = 0;
+    size_t numHeapAllocations = 0;
+    for (auto _ : state)
+    {
+        if (!pooled)
+        {
+            state.PauseTiming();
+            arena.clear();
+            state.ResumeTiming();
+        }
+
+        // Drag the grasped corner up and down, in and out of contact
+        grasperSphere->setPosition(Vec3d(2.0, -2.0 + 0.5 * std::sin(0.1 * frame), 2.0));
+        const size_t numHeapAllocationsBefore = s_numHeapAllocations.load(std::memory_order_relaxed);
+        scene->advance(dt);
+        numHeapAllocations += s_numHeapAllocations.load(std::memory_order_relaxed) - numHeapAllocationsBefore;
+        frame++;
+    }
+
+    // Set output results
+    state.counters["DOFs"]               = prismMesh->getNumVertices();
+    state.counters["Iterations"]         = state.range(1);
+    state.counters["Pooled"]             = pooled;
+    state.counters["HeapAllocsPerFrame"] = static_cast<double>(numHeapAllocations) / std::max(frame, 1);
+    state.counters["AcquiredPerFrame"]   = static_cast<double>(arena.getNumAcquisitions()) / std::max(frame, 1);
+    state.counters["Allocated"]          = static_cast<double>(arena.getNumAllocations());
+    state.counters["HighWaterMark"]      = static_cast<double>(arena.getHighWaterMark());
+}
+
+BENCHMARK(BM_PbdGraspContactArena)
+->Unit(benchmark::kMillisecond)
+->Name("Contact Constraint Arena with a Grasp: Tet Mesh")
+->ArgsProduct({ { 6, 10, 16 }, { 5 }, { 1, 0 } });
+
 // Run the benchmark
 BENCHMARK_MAIN();
@@ -0,0 +1,70 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPointSet.h"
+#include "imstkSphModel.h"
+#include "imstkVecDataArray.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+using namespace imstk;
+
+///
+/// \brief Time evolution step of SPH for a block of dim^3 particles stored in
+/// a random order, as particles emitted over time are. Arg 1 is the period of
+/// the z-order sort of the particles, 0 doesn't sort
+///
+static void
+BM_SphStep(benchmark::State& state)
+{
+    const int    dim     = static_cast<int>(state.range(0));
+    const double radius  = 0.01;
+    const double spacing = 2.0 * radius;
+
+    std::vector<int> order(dim * dim * dim);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(0));
+
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(dim * dim * dim);
+    for (int i = 0; i < vertices->size(); i++)
+    {
+        const int index = order[i];
+        (*vertices)[i] = Vec3d(index % dim, (index / dim) % dim, index / (dim * dim)) * spacing;
+    }
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(vertices);
+
+    auto config = std::make_shared<SphModelConfig>(radius);
+    config->m_zOrderSortPeriod = static_cast<int>(state.range(1));
+
+    auto model = std::make_shared<SphModel>();
+    model->setModelGeometry(pointSet);
+    model->configure(config);
+    model->setDefaultTimeStep(1.0e-3);
+    model->initialize();
+
+    // This loop gets timed
+    for (auto _ : state)
+    {
+        model->advance(1.0e-3);
+    }
+
+    // Set output results
+    const std::shared_ptr<SphState>& sphState = model->getCurrentState();
+    state.counters["Particles"] = static_cast<double>(sphState->getNumParticles());
+    state.counters["Neighbors"] = static_cast<double>(sphState->getNeighborIds().size()) / sphState->getNumParticles();
+}
+
+BENCHMARK(BM_SphStep)
+->Unit(benchmark::kMillisecond)
+->Name("SPH step of a block of particles, z-order sort period")
+->ArgsProduct({ { 16, 32, 48 }, { 0, 10 } });
+
+BENCHMARK_MAIN();
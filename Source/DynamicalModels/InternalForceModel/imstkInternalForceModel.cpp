@@ -5,6 +5,7 @@
 */
 
 #include "imstkInternalForceModel.h"
+#include "imstkLogger.h"
 
 namespace imstk
 {
@@ -36,4 +37,16 @@ InternalForceModel::getForceAndMatrix(const Vectord& u, Vectord& internalForce,
     this->getInternalForce(u, internalForce);
     this->getTangentStiffnessMatrix(u, tangentStiffnessMatrix);
 }
-} // namespace imstk
\ No newline at end of file
+
+void
+InternalForceModel::getTangentStiffnessProduct(const Vectord&, Vectord&)
+{
+    LOG(FATAL) << "Matrix free tangent stiffness is not supported by this force model";
+}
+
+void
+InternalForceModel::getTangentStiffnessBlockDiagonal(StdVectorOfMat3d&)
+{
+    LOG(FATAL) << "Matrix free tangent stiffness is not supported by this force model";
+}
+} // namespace imstk
@@ -54,6 +54,24 @@ public:
     ///
     virtual void getForceAndMatrix(const Vectord& u, Vectord& internalForce, SparseMatrixd& tangentStiffnessMatrix);
 
+    ///
+    /// \brief Returns true if the model can apply its tangent stiffness without forming it,
+    /// see \ref getTangentStiffnessProduct
+    ///
+    virtual bool isMatrixFree() const { return false; }
+
+    ///
+    /// \brief Compute \p y = K x for the tangent stiffness K at the state of the last
+    /// internal force computed, without forming K
+    ///
+    virtual void getTangentStiffnessProduct(const Vectord& x, Vectord& y);
+
+    ///
+    /// \brief Compute the 3x3 diagonal blocks of the tangent stiffness at the state of
+    /// the last internal force computed, one per node
+    ///
+    virtual void getTangentStiffnessBlockDiagonal(StdVectorOfMat3d& blocks);
+
     ///
     /// \brief Update the values of the Eigen sparse matrix given the linearized array of data from the Vega matrix
     ///
@@ -0,0 +1,405 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkNativeFemForceModel.h"
+#include "imstkLogger.h"
+#include "imstkMacros.h"
+#include "imstkParallelUtils.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+
+DISABLE_WARNING_PUSH
+    DISABLE_WARNING_HIDES_CLASS_MEMBER
+
+#include <sparseMatrix.h>
+
+DISABLE_WARNING_POP
+
+#include <Eigen/SVD>
+
+#include <algorithm>
+
+namespace imstk
+{
+NativeFemForceModel::NativeFemForceModel(std::shared_ptr<TetrahedralMesh> mesh,
+                                         const double youngsModulus, const double poissonRatio,
+                                         const FeMethodType method) :
+    NativeFemForceModel(mesh,
+        std::vector<double>(mesh == nullptr ? 0 : mesh->getNumTetrahedra(), youngsModulus),
+        std::vector<double>(mesh == nullptr ? 0 : mesh->getNumTetrahedra(), poissonRatio), method)
+{
+}
+
+NativeFemForceModel::NativeFemForceModel(std::shared_ptr<TetrahedralMesh> mesh,
+                                         const std::vector<double>& youngsModuli, const std::vector<double>& poissonRatios,
+                                         const FeMethodType method) : InternalForceModel(), m_method(method)
+{
+    CHECK(mesh != nullptr) << "NativeFemForceModel requires a TetrahedralMesh";
+    CHECK(method == FeMethodType::Linear || method == FeMethodType::Corotational)
+        << "NativeFemForceModel only supports the linear and corotational methods";
+
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    const VecDataArray<int, 4>&    elements = *mesh->getTetrahedraIndices();
+
+    m_restPositions.resize(vertices.size());
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        m_restPositions[i] = vertices[i];
+    }
+    m_elements.resize(elements.size());
+    for (int i = 0; i < elements.size(); i++)
+    {
+        m_elements[i] = elements[i];
+    }
+
+    CHECK(youngsModuli.size() == m_elements.size() && poissonRatios.size() == m_elements.size())
+        << "NativeFemForceModel requires a material per tetrahedron";
+
+    computeElementStiffness(youngsModuli, poissonRatios);
+    computeColors();
+    if (m_method == FeMethodType::Corotational)
+    {
+        m_rotations.resize(m_elements.size(), Mat3d::Identity());
+    }
+}
+
+void
+NativeFemForceModel::computeElementStiffness(const std::vector<double>& youngsModuli, const std::vector<double>& poissonRatios)
+{
+    m_restShapeInverse.resize(m_elements.size());
+    m_K0.resize(m_elements.size());
+    ParallelUtils::parallelFor(m_elements.size(),
+        [&](const size_t elementId)
+        {
+            const double E      = youngsModuli[elementId];
+            const double nu     = poissonRatios[elementId];
+            const double lambda = E * nu / ((1.0 + nu) * (1.0 - 2.0 * nu));
+            const double mu     = E / (2.0 * (1.0 + nu));
+
+            const Vec4i& element = m_elements[elementId];
+            const Vec3d& x0      = m_restPositions[element[0]];
+            Mat3d        restShape;
+            restShape.col(0) = m_restPositions[element[1]] - x0;
+            restShape.col(1) = m_restPositions[element[2]] - x0;
+            restShape.col(2) = m_restPositions[element[3]] - x0;
+            const double volume = std::abs(restShape.determinant()) / 6.0;
+            m_restShapeInverse[elementId] = restShape.inverse();
+
+            // Gradients of the linear shape functions
+            Vec3d grad[4];
+            for (int i = 0; i < 3; i++)
+            {
+                grad[i + 1] = m_restShapeInverse[elementId].row(i).transpose();
+            }
+            grad[0] = -(grad[1] + grad[2] + grad[3]);
+
+            // K_ab = V (lambda g_a g_b^T + mu g_b g_a^T + mu (g_a . g_b) I)
+            Mat12d& K0 = m_K0[elementId];
+            for (int a = 0; a < 4; a++)
+            {
+                for (int b = 0; b < 4; b++)
+                {
+                    K0.block<3, 3>(3 * a, 3 * b) = volume * (lambda * grad[a] * grad[b].transpose()
+                                                             + mu * grad[b] * grad[a].transpose()
+                                                             + mu * grad[a].dot(grad[b]) * Mat3d::Identity());
+                }
+            }
+        }, m_elements.size() > 1000);
+}
+
+void
+NativeFemForceModel::computeColors()
+{
+    std::vector<std::vector<int>> vertexColors(m_restPositions.size());
+    std::vector<bool>             usedColors;
+    m_colors.clear();
+    for (int elementId = 0; elementId < static_cast<int>(m_elements.size()); elementId++)
+    {
+        const Vec4i& element = m_elements[elementId];
+        usedColors.assign(m_colors.size() + 1, false);
+        for (int i = 0; i < 4; i++)
+        {
+            for (const int color : vertexColors[element[i]])
+            {
+                usedColors[color] = true;
+            }
+        }
+
+        const int color = static_cast<int>(std::find(usedColors.begin(), usedColors.end(), false) - usedColors.begin());
+        if (color == static_cast<int>(m_colors.size()))
+        {
+            m_colors.push_back(std::vector<int>());
+        }
+        m_colors[color].push_back(elementId);
+        for (int i = 0; i < 4; i++)
+        {
+            vertexColors[element[i]].push_back(color);
+        }
+    }
+}
+
+void
+NativeFemForceModel::updateScatterMap(const SparseMatrixd& matrix)
+{
+    CHECK(matrix.isCompressed()) << "NativeFemForceModel requires a compressed tangent stiffness matrix";
+    CHECK(matrix.rows() == static_cast<Eigen::Index>(3 * m_restPositions.size()))
+        << "Tangent stiffness matrix size does not match the mesh";
+
+    // Compare the pattern itself, a matrix may be reused or reallocated at the same address
+    const int* outerIndex = matrix.outerIndexPtr();
+    const int* innerIndex = matrix.innerIndexPtr();
+    if (m_scatterOuterIndex.size() == static_cast<size_t>(matrix.outerSize() + 1)
+        && m_scatterInnerIndex.size() == static_cast<size_t>(matrix.nonZeros())
+        && std::equal(m_scatterOuterIndex.begin(), m_scatterOuterIndex.end(), outerIndex)
+        && std::equal(m_scatterInnerIndex.begin(), m_scatterInnerIndex.end(), innerIndex))
+    {
+        return;
+    }
+
+    m_scatterMap.resize(m_elements.size() * 48);
+    ParallelUtils::parallelFor(m_elements.size(),
+        [&](const size_t elementId)
+        {
+            const Vec4i& element = m_elements[elementId];
+            int*         scatter = &m_scatterMap[elementId * 48];
+            for (int a = 0; a < 4; a++)
+            {
+                for (int r = 0; r < 3; r++)
+                {
+                    const int  row   = 3 * element[a] + r;
+                    const int* begin = innerIndex + outerIndex[row];
+                    const int* end   = innerIndex + outerIndex[row + 1];
+                    for (int b = 0; b < 4; b++)
+                    {
+                        // Columns are sorted, the 3 columns of a vertex block are adjacent
+                        const int* col = std::lower_bound(begin, end, 3 * element[b]);
+                        CHECK(col != end && *col == 3 * element[b])
+                            << "Tangent stiffness matrix pattern is missing an element block";
+                        scatter[(a * 4 + b) * 3 + r] = static_cast<int>(col - innerIndex);
+                    }
+                }
+            }
+        }, m_elements.size() > 1000);
+
+    m_scatterOuterIndex.assign(outerIndex, outerIndex + matrix.outerSize() + 1);
+    m_scatterInnerIndex.assign(innerIndex, innerIndex + matrix.nonZeros());
+    m_linearValues.clear();
+}
+
+Mat3d
+NativeFemForceModel::computeRotation(const Vectord& u, const int elementId) const
+{
+    const Vec4i& element = m_elements[elementId];
+    const Vec3d  x0      = m_restPositions[element[0]] + u.segment<3>(3 * element[0]);
+    Mat3d        deformedShape;
+    for (int i = 0; i < 3; i++)
+    {
+        deformedShape.col(i) = m_restPositions[element[i + 1]] + u.segment<3>(3 * element[i + 1]) - x0;
+    }
+    const Mat3d F = deformedShape * m_restShapeInverse[elementId];
+
+    // Polar decomposition by Newton iteration, converges quadratically for
+    // non inverted elements
+    if (F.determinant() > 1.0e-12 * F.squaredNorm() * F.norm())
+    {
+        Mat3d R = F;
+        for (int iter = 0; iter < 20; iter++)
+        {
+            const Mat3d next = 0.5 * (R + R.inverse().transpose());
+            const bool  done = (next - R).squaredNorm() < 1.0e-20;
+            R = next;
+            if (done)
+            {
+                break;
+            }
+        }
+        return R;
+    }
+
+    // Inverted or degenerate, closest rotation from the SVD
+    Eigen::JacobiSVD<Mat3d> svd(F, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Mat3d                   U = svd.matrixU();
+    const Mat3d&            V = svd.matrixV();
+    if ((U * V.transpose()).determinant() < 0.0)
+    {
+        U.col(2) = -U.col(2);
+    }
+    return U * V.transpose();
+}
+
+void
+NativeFemForceModel::assemble(const Vectord& u, Vectord* internalForce, SparseMatrixd* tangentStiffnessMatrix)
+{
+    const bool corotational = (m_method == FeMethodType::Corotational);
+
+    // The linear stiffness is constant, assembled once and copied after
+    bool assembleMatrix = (tangentStiffnessMatrix != nullptr);
+    if (assembleMatrix)
+    {
+        updateScatterMap(*tangentStiffnessMatrix);
+        if (!corotational && !m_linearValues.empty())
+        {
+            std::copy(m_linearValues.begin(), m_linearValues.end(), tangentStiffnessMatrix->valuePtr());
+            assembleMatrix = false;
+        }
+        else
+        {
+            std::fill_n(tangentStiffnessMatrix->valuePtr(), tangentStiffnessMatrix->nonZeros(), 0.0);
+        }
+    }
+    if (internalForce != nullptr)
+    {
+        internalForce->setZero();
+    }
+    if (!assembleMatrix && internalForce == nullptr)
+    {
+        return;
+    }
+    double* values = assembleMatrix ? tangentStiffnessMatrix->valuePtr() : nullptr;
+
+    for (const std::vector<int>& color : m_colors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int     elementId = color[i];
+                const Vec4i&  element   = m_elements[elementId];
+                const Mat12d& K0        = m_K0[elementId];
+                const Mat3d   R         = corotational ? computeRotation(u, elementId) : Mat3d::Identity();
+                if (corotational)
+                {
+                    m_rotations[elementId] = R;
+                }
+
+                if (internalForce != nullptr)
+                {
+                    // f = R K0 (R^T x - X), reduces to K0 u for R = I
+                    Vec12d y;
+                    for (int a = 0; a < 4; a++)
+                    {
+                        const Vec3d& X = m_restPositions[element[a]];
+                        y.segment<3>(3 * a) = R.transpose() * (X + u.segment<3>(3 * element[a])) - X;
+                    }
+                    const Vec12d f = K0 * y;
+                    for (int a = 0; a < 4; a++)
+                    {
+                        internalForce->segment<3>(3 * element[a]) += R * f.segment<3>(3 * a);
+                    }
+                }
+
+                if (values != nullptr)
+                {
+                    // K = R K0 R^T, written through the scatter map
+                    const int* scatter = &m_scatterMap[elementId * 48];
+                    for (int a = 0; a < 4; a++)
+                    {
+                        for (int b = 0; b < 4; b++)
+                        {
+                            const Mat3d block = R * K0.block<3, 3>(3 * a, 3 * b) * R.transpose();
+                            for (int r = 0; r < 3; r++)
+                            {
+                                double* entry = values + scatter[(a * 4 + b) * 3 + r];
+                                entry[0] += block(r, 0);
+                                entry[1] += block(r, 1);
+                                entry[2] += block(r, 2);
+                            }
+                        }
+                    }
+                }
+            }, color.size() > 100);
+    }
+
+    if (assembleMatrix && !corotational)
+    {
+        m_linearValues.assign(values, values + tangentStiffnessMatrix->nonZeros());
+    }
+}
+
+void
+NativeFemForceModel::getInternalForce(const Vectord& u, Vectord& internalForce)
+{
+    assemble(u, &internalForce, nullptr);
+}
+
+void
+NativeFemForceModel::getTangentStiffnessMatrix(const Vectord& u, SparseMatrixd& tangentStiffnessMatrix)
+{
+    assemble(u, nullptr, &tangentStiffnessMatrix);
+}
+
+void
+NativeFemForceModel::getTangentStiffnessProduct(const Vectord& x, Vectord& y)
+{
+    const bool corotational = (m_method == FeMethodType::Corotational);
+    y.setZero(x.size());
+    for (const std::vector<int>& color : m_colors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int    elementId = color[i];
+                const Vec4i& element   = m_elements[elementId];
+                const Mat3d  R         = corotational ? m_rotations[elementId] : Mat3d::Identity();
+
+                // y = R K0 R^T x
+                Vec12d xLocal;
+                for (int a = 0; a < 4; a++)
+                {
+                    xLocal.segment<3>(3 * a) = R.transpose() * x.segment<3>(3 * element[a]);
+                }
+                const Vec12d yLocal = m_K0[elementId] * xLocal;
+                for (int a = 0; a < 4; a++)
+                {
+                    y.segment<3>(3 * element[a]) += R * yLocal.segment<3>(3 * a);
+                }
+            }, color.size() > 100);
+    }
+}
+
+void
+NativeFemForceModel::getTangentStiffnessBlockDiagonal(StdVectorOfMat3d& blocks)
+{
+    const bool corotational = (m_method == FeMethodType::Corotational);
+    blocks.assign(m_restPositions.size(), Mat3d::Zero());
+    for (const std::vector<int>& color : m_colors)
+    {
+        ParallelUtils::parallelFor(color.size(),
+            [&](const size_t i)
+            {
+                const int    elementId = color[i];
+                const Vec4i& element   = m_elements[elementId];
+                const Mat3d  R         = corotational ? m_rotations[elementId] : Mat3d::Identity();
+                for (int a = 0; a < 4; a++)
+                {
+                    blocks[element[a]] += R * m_K0[elementId].block<3, 3>(3 * a, 3 * a) * R.transpose();
+                }
+            }, color.size() > 100);
+    }
+}
+
+void
+NativeFemForceModel::getTangentStiffnessMatrixTopology(vega::SparseMatrix** tangentStiffnessMatrix)
+{
+    vega::SparseMatrixOutline outline(3 * static_cast<int>(m_restPositions.size()));
+    for (const Vec4i& element : m_elements)
+    {
+        for (int a = 0; a < 4; a++)
+        {
+            for (int b = 0; b < 4; b++)
+            {
+                outline.AddBlock3x3Entry(element[a], element[b]);
+            }
+        }
+    }
+    *tangentStiffnessMatrix = new vega::SparseMatrix(&outline);
+}
+
+void
+NativeFemForceModel::getForceAndMatrix(const Vectord& u, Vectord& internalForce, SparseMatrixd& tangentStiffnessMatrix)
+{
+    assemble(u, &internalForce, &tangentStiffnessMatrix);
+}
+} // namespace imstk
@@ -0,0 +1,152 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkInternalForceModel.h"
+
+#include <memory>
+#include <vector>
+
+namespace imstk
+{
+class TetrahedralMesh;
+
+///
+/// \class NativeFemForceModel
+///
+/// \brief Linear and corotational finite element force model assembled without
+/// vega. Elements are computed in parallel and written straight into the Eigen
+/// tangent stiffness, every element entry has its index in the matrix values
+/// precomputed (the scatter map). Elements are colored so that no two elements of
+/// a color share a vertex, colors are processed one after the other and the
+/// elements of a color in parallel without locking.
+///
+/// The scatter map is built on the first assembly into a matrix with the pattern
+/// given by \ref getTangentStiffnessMatrixTopology, and rebuilt if given a matrix
+/// with a different pattern. The pattern it was built for is kept to tell.
+///
+class NativeFemForceModel : public InternalForceModel
+{
+public:
+    using Mat12d = Eigen::Matrix<double, 12, 12>;
+    using Vec12d = Eigen::Matrix<double, 12, 1>;
+
+public:
+    ///
+    /// \brief Constructor using the rest configuration of \p mesh
+    /// \param Young's modulus of the material
+    /// \param Poisson's ratio of the material
+    /// \param method either FeMethodType::Linear or FeMethodType::Corotational
+    ///
+    NativeFemForceModel(std::shared_ptr<TetrahedralMesh> mesh,
+                        const double youngsModulus, const double poissonRatio,
+                        const FeMethodType method = FeMethodType::Corotational);
+
+    ///
+    /// \brief Constructor using the rest configuration of \p mesh and a material per element
+    /// \param Young's modulus of every tetrahedron of the mesh
+    /// \param Poisson's ratio of every tetrahedron of the mesh
+    /// \param method either FeMethodType::Linear or FeMethodType::Corotational
+    ///
+    NativeFemForceModel(std::shared_ptr<TetrahedralMesh> mesh,
+                        const std::vector<double>& youngsModuli, const std::vector<double>& poissonRatios,
+                        const FeMethodType method = FeMethodType::Corotational);
+    NativeFemForceModel() = delete;
+    ~NativeFemForceModel() override = default;
+
+    ///
+    /// \brief Compute internal force \p internalForce at state \p u
+    ///
+    void getInternalForce(const Vectord& u, Vectord& internalForce) override;
+
+    ///
+    /// \brief Compute stiffness matrix \p tangentStiffnessMatrix at state \u
+    ///
+    void getTangentStiffnessMatrix(const Vectord& u, SparseMatrixd& tangentStiffnessMatrix) override;
+
+    ///
+    /// \brief Build the sparsity pattern for stiffness matrix, a 3x3 block for
+    /// every pair of vertices sharing an element
+    ///
+    void getTangentStiffnessMatrixTopology(vega::SparseMatrix** tangentStiffnessMatrix) override;
+
+    ///
+    /// \brief Compute internal force \p internalForce and stiffness matrix \p tangentStiffnessMatrix at state \u
+    /// in one pass over the elements
+    ///
+    void getForceAndMatrix(const Vectord& u, Vectord& internalForce, SparseMatrixd& tangentStiffnessMatrix) override;
+
+    ///
+    /// \brief The tangent stiffness can be applied element by element without forming it
+    ///
+    bool isMatrixFree() const override { return true; }
+
+    ///
+    /// \brief Compute \p y = K x element by element, using the element rotations of the
+    /// last internal force computed
+    ///
+    void getTangentStiffnessProduct(const Vectord& x, Vectord& y) override;
+
+    ///
+    /// \brief Compute the 3x3 diagonal blocks of the tangent stiffness, using the element
+    /// rotations of the last internal force computed
+    ///
+    void getTangentStiffnessBlockDiagonal(StdVectorOfMat3d& blocks) override;
+
+    ///
+    /// \brief The vega tangent stiffness is not used, assembly goes directly into the Eigen matrix
+    ///
+    void setTangentStiffness(std::shared_ptr<vega::SparseMatrix>) override { }
+
+    ///
+    /// \brief Get the number of element colors
+    ///
+    size_t getNumColors() const { return m_colors.size(); }
+
+protected:
+    ///
+    /// \brief Compute the undeformed element stiffness matrices, from the material of every element
+    ///
+    void computeElementStiffness(const std::vector<double>& youngsModuli, const std::vector<double>& poissonRatios);
+
+    ///
+    /// \brief Greedy coloring of the elements, no two elements of a color share a vertex
+    ///
+    void computeColors();
+
+    ///
+    /// \brief Build the index into the values of \p matrix of every element entry,
+    /// if not yet built for the pattern of \p matrix
+    ///
+    void updateScatterMap(const SparseMatrixd& matrix);
+
+    ///
+    /// \brief Assemble the force and/or tangent stiffness, either may be null
+    ///
+    void assemble(const Vectord& u, Vectord* internalForce, SparseMatrixd* tangentStiffnessMatrix);
+
+    ///
+    /// \brief Rotation of the deformation gradient of element \p elementId
+    ///
+    Mat3d computeRotation(const Vectord& u, const int elementId) const;
+
+    FeMethodType m_method;
+
+    StdVectorOfVec3d m_restPositions;                          ///< Undeformed vertex positions
+    std::vector<Vec4i> m_elements;                             ///< Vertex ids of the tetrahedra
+    StdVectorOfMat3d   m_restShapeInverse;                     ///< Inverse of the rest edge matrix of every element
+    StdVectorOfMat3d   m_rotations;                            ///< Rotation of every element at the last assembly, corotational only
+    std::vector<Mat12d, Eigen::aligned_allocator<Mat12d>> m_K0; ///< Undeformed stiffness of every element
+
+    std::vector<std::vector<int>> m_colors;                    ///< Element ids of each color
+
+    std::vector<int>    m_scatterMap;                          ///< First value index of the 3 entries of every element row and vertex block
+    std::vector<int>    m_scatterOuterIndex;                   ///< Outer index of the pattern the scatter map was built for
+    std::vector<int>    m_scatterInnerIndex;                   ///< Inner index of the pattern the scatter map was built for
+    std::vector<double> m_linearValues;                        ///< Constant stiffness values of the linear method
+};
+} // namespace imstk
@@ -5,14 +5,17 @@
 */
 
 #include "imstkFemDeformableBodyModel.h"
+#include "imstkBlockJacobiPreconditioner.h"
 #include "imstkConjugateGradient.h"
 #include "imstkCorotationalFemForceModel.h"
 #include "imstkIsotropicHyperelasticFeForceModel.h"
 #include "imstkLinearFemForceModel.h"
 #include "imstkLogger.h"
+#include "imstkNativeFemForceModel.h"
 #include "imstkNewtonSolver.h"
 #include "imstkPointSet.h"
 #include "imstkTaskGraph.h"
+#include "imstkTetrahedralMesh.h"
 #include "imstkTimeIntegrator.h"
 #include "imstkTypes.h"
 #include "imstkVecDataArray.h"
@@ -71,6 +74,7 @@ FemDeformableBodyModel::configure(const std::string& configFileName)
     vegaConfigFileOptions.addOptionOptional("compressionResistance", &m_FEModelConfig->m_compressionResistance, m_FEModelConfig->m_compressionResistance);
     vegaConfigFileOptions.addOptionOptional("inversionThreshold", &m_FEModelConfig->m_inversionThreshold, m_FEModelConfig->m_inversionThreshold);
     vegaConfigFileOptions.addOptionOptional("gravity", &m_FEModelConfig->m_gravity, m_FEModelConfig->m_gravity);
+    vegaConfigFileOptions.addOptionOptional("nativeAssembly", &m_FEModelConfig->m_nativeAssembly, m_FEModelConfig->m_nativeAssembly);
 
     // Parse the configuration file
     CHECK(vegaConfigFileOptions.parseOptions(configFileName.data()) == 0)
@@ -175,6 +179,16 @@ FemDeformableBodyModel::initialize()
         nlSolver->setSystem(nlSystem);
         setSolver(nlSolver);
     }
+    if (m_FEModelConfig->m_warmStart)
+    {
+        auto nlSolver = std::dynamic_pointer_cast<NewtonSolver<SparseMatrixd>>(m_solver);
+        auto cgSolver = (nlSolver != nullptr) ? std::dynamic_pointer_cast<ConjugateGradient>(nlSolver->getLinearSolver()) : nullptr;
+        LOG_IF(WARNING, cgSolver == nullptr) << "Warm start requires a Newton solver with a conjugate gradient linear solver";
+        if (cgSolver != nullptr)
+        {
+            cgSolver->setWarmStart(true);
+        }
+    }
 
     auto physicsMesh = std::dynamic_pointer_cast<AbstractCellMesh>(this->getModelGeometry());
     m_vegaPhysicsMesh = VegaMeshIO::convertVolumetricMeshToVegaMesh(physicsMesh);
@@ -185,7 +199,8 @@ FemDeformableBodyModel::initialize()
         || !this->initializeTangentStiffness()
         || !this->loadBoundaryConditions()
         || !this->initializeGravityForce()
-        || !this->initializeExplicitExternalForces())
+        || !this->initializeExplicitExternalForces()
+        || !this->initializeMatrixFree())
     {
         return false;
     }
@@ -279,6 +294,29 @@ FemDeformableBodyModel::initializeForceModel()
 
     m_numDof = (size_t)m_vegaPhysicsMesh->getNumVertices() * 3;
 
+    if (m_FEModelConfig->m_nativeAssembly
+        && (m_FEModelConfig->m_femMethod == FeMethodType::Linear || m_FEModelConfig->m_femMethod == FeMethodType::Corotational))
+    {
+        auto tetMesh = std::dynamic_pointer_cast<TetrahedralMesh>(m_geometry);
+        CHECK(tetMesh != nullptr) << "Native assembly requires a TetrahedralMesh";
+
+        // Use the materials the vega mesh was given, element by element
+        const int           numElements = m_vegaPhysicsMesh->getNumElements();
+        std::vector<double> youngsModuli(numElements);
+        std::vector<double> poissonRatios(numElements);
+        for (int i = 0; i < numElements; i++)
+        {
+            vega::VolumetricMesh::ENuMaterial* material = vega::downcastENuMaterial(m_vegaPhysicsMesh->getElementMaterial(i));
+            CHECK(material != nullptr) << "Native assembly requires E, nu materials";
+            youngsModuli[i]  = material->getE();
+            poissonRatios[i] = material->getNu();
+        }
+
+        m_internalForceModel = std::make_shared<NativeFemForceModel>(tetMesh,
+            youngsModuli, poissonRatios, m_FEModelConfig->m_femMethod);
+        return true;
+    }
+
     switch (m_FEModelConfig->m_femMethod)
     {
     case FeMethodType::StVK:
@@ -547,24 +585,40 @@ FemDeformableBodyModel::computeSemiImplicitSystemRHSAndLHS(kinematicState&
     switch (updateType)
     {
     case StateUpdateType::DeltaVelocity:
-        // LHS
         this->updateMassMatrix();
-        m_internalForceModel->getForceAndMatrix(newState.getQ(), m_Finternal, m_K);
-        this->updateDampingMatrix();
-
-        m_Keff = m_M;
-        if (m_damped)
+        if (m_matrixFree)
         {
-            m_Keff += dT * m_C;
+            // The linear solver applies the effective stiffness, only the RHS is formed
+            m_internalForceModel->getInternalForce(newState.getQ(), m_Finternal);
+            m_internalForceModel->getTangentStiffnessProduct(vPrev, m_Kx);
+            m_Feff = m_Kx * -dT;
+
+            if (m_damped)
+            {
+                applyDampingMatrix(vPrev, m_Kx, m_Cx);
+                m_Feff -= m_Cx;
+            }
         }
-        m_Keff += (dT * dT) * m_K;
+        else
+        {
+            // LHS
+            m_internalForceModel->getForceAndMatrix(newState.getQ(), m_Finternal, m_K);
+            this->updateDampingMatrix();
 
-        // RHS
-        m_Feff = m_K * (vPrev * -dT);
+            m_Keff = m_M;
+            if (m_damped)
+            {
+                m_Keff += dT * m_C;
+            }
+            m_Keff += (dT * dT) * m_K;
 
-        if (m_damped)
-        {
-            m_Feff -= m_C * vPrev;
+            // RHS
+            m_Feff = m_K * (vPrev * -dT);
+
+            if (m_damped)
+            {
+                m_Feff -= m_C * vPrev;
+            }
         }
 
         m_Feff -= m_Finternal;
@@ -594,24 +648,41 @@ FemDeformableBodyModel::computeImplicitSystemRHSAndLHS(kinematicState&       sta
     switch (updateType)
     {
     case StateUpdateType::DeltaVelocity:
-        // LHS
         this->updateMassMatrix();
-        m_internalForceModel->getForceAndMatrix(u, m_Finternal, m_K);
-        this->updateDampingMatrix();
-
-        m_Keff = m_M;
-        if (m_damped)
+        if (m_matrixFree)
         {
-            m_Keff += dT * m_C;
+            // The linear solver applies the effective stiffness, only the RHS is formed
+            m_internalForceModel->getInternalForce(u, m_Finternal);
+            m_xFree = -(uPrev - u + v * dT);
+            m_internalForceModel->getTangentStiffnessProduct(m_xFree, m_Feff);
+
+            if (m_damped)
+            {
+                m_internalForceModel->getTangentStiffnessProduct(v, m_Kx);
+                applyDampingMatrix(v, m_Kx, m_Cx);
+                m_Feff -= m_Cx;
+            }
         }
-        m_Keff += (dT * dT) * m_K;
+        else
+        {
+            // LHS
+            m_internalForceModel->getForceAndMatrix(u, m_Finternal, m_K);
+            this->updateDampingMatrix();
 
-        // RHS
-        m_Feff = m_K * -(uPrev - u + v * dT);
+            m_Keff = m_M;
+            if (m_damped)
+            {
+                m_Keff += dT * m_C;
+            }
+            m_Keff += (dT * dT) * m_K;
 
-        if (m_damped)
-        {
-            m_Feff -= m_C * v;
+            // RHS
+            m_Feff = m_K * -(uPrev - u + v * dT);
+
+            if (m_damped)
+            {
+                m_Feff -= m_C * v;
+            }
         }
 
         m_Feff -= m_Finternal;
@@ -660,6 +731,138 @@ FemDeformableBodyModel::updateDampingMatrix()
     }
 }
 
+bool
+FemDeformableBodyModel::initializeMatrixFree()
+{
+    m_matrixFree = false;
+    if (!m_FEModelConfig->m_matrixFree)
+    {
+        return true;
+    }
+
+    if (!m_internalForceModel->isMatrixFree())
+    {
+        LOG(WARNING) << "Force model does not support matrix free, see FemModelConfig::m_nativeAssembly. "
+                     << "The effective stiffness will be formed";
+        return true;
+    }
+    auto nlSolver = std::dynamic_pointer_cast<NewtonSolver<SparseMatrixd>>(m_solver);
+    auto cgSolver = (nlSolver != nullptr) ? std::dynamic_pointer_cast<ConjugateGradient>(nlSolver->getLinearSolver()) : nullptr;
+    if (cgSolver == nullptr)
+    {
+        LOG(WARNING) << "Matrix free requires a Newton solver with a conjugate gradient linear solver. "
+                     << "The effective stiffness will be formed";
+        return true;
+    }
+
+    BlockJacobiPreconditioner::getBlockDiagonal(m_M, m_massBlocks);
+    if (m_damped)
+    {
+        BlockJacobiPreconditioner::getBlockDiagonal(m_C, m_dampingBlocks);
+    }
+
+    cgSolver->setMatrixFreeOperator(
+        [this](const Vectord& x, Vectord& y) { applyEffectiveStiffness(x, y); },
+        [this](StdVectorOfMat3d& blocks) { computeEffectiveStiffnessBlockDiagonal(blocks); });
+
+    // The linear system only carries the RHS, the effective stiffness is left empty
+    m_Keff.resize(m_numDof, m_numDof);
+    m_matrixFree = true;
+
+    return true;
+}
+
+void
+FemDeformableBodyModel::applyDampingMatrix(const Vectord& x, const Vectord& Kx, Vectord& y)
+{
+    const double dampingStiffnessCoefficient = m_FEModelConfig->m_dampingStiffnessCoefficient;
+    const double dampingMassCoefficient      = m_FEModelConfig->m_dampingMassCoefficient;
+
+    // Same damping as updateDampingMatrix
+    if (dampingMassCoefficient > 0)
+    {
+        y = dampingMassCoefficient * (m_M * x);
+
+        if (dampingStiffnessCoefficient > 0)
+        {
+            y += dampingStiffnessCoefficient * Kx;
+        }
+    }
+    else if (dampingStiffnessCoefficient > 0)
+    {
+        y = dampingStiffnessCoefficient * Kx;
+    }
+    else
+    {
+        y = m_C * x;
+    }
+}
+
+void
+FemDeformableBodyModel::applyEffectiveStiffness(const Vectord& x, Vectord& y)
+{
+    const double dT = m_timeIntegrator->getTimestepSize();
+
+    m_xFree = x;
+    if (m_implementFixedBC)
+    {
+        applyBoundaryConditions(m_xFree);
+    }
+
+    m_internalForceModel->getTangentStiffnessProduct(m_xFree, m_Kx);
+    y = m_M * m_xFree;
+    if (m_damped)
+    {
+        applyDampingMatrix(m_xFree, m_Kx, m_Cx);
+        y += dT * m_Cx;
+    }
+    y += (dT * dT) * m_Kx;
+
+    // Identity rows for the fixed nodes keep the operator positive definite, their
+    // RHS is zero so they stay zero
+    if (m_implementFixedBC)
+    {
+        for (auto& index : m_fixedNodeIds)
+        {
+            y.segment<3>(3 * index) = x.segment<3>(3 * index);
+        }
+    }
+}
+
+void
+FemDeformableBodyModel::computeEffectiveStiffnessBlockDiagonal(StdVectorOfMat3d& blocks)
+{
+    const double dT = m_timeIntegrator->getTimestepSize();
+    const double dampingStiffnessCoefficient = m_FEModelConfig->m_dampingStiffnessCoefficient;
+    const double dampingMassCoefficient      = m_FEModelConfig->m_dampingMassCoefficient;
+
+    m_internalForceModel->getTangentStiffnessBlockDiagonal(m_stiffnessBlocks);
+    blocks.resize(m_massBlocks.size());
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        const Mat3d& M = m_massBlocks[i];
+        const Mat3d& K = m_stiffnessBlocks[i];
+        blocks[i] = M + (dT * dT) * K;
+        if (m_damped)
+        {
+            Mat3d C = m_dampingBlocks[i];
+            if (dampingMassCoefficient > 0 || dampingStiffnessCoefficient > 0)
+            {
+                C = std::max(dampingMassCoefficient, 0.0) * M + std::max(dampingStiffnessCoefficient, 0.0) * K;
+            }
+            blocks[i] += dT * C;
+        }
+    }
+
+    if (m_implementFixedBC)
+    {
+        for (auto& index : m_fixedNodeIds)
+        {
+            blocks[index] = Mat3d::Identity();
+        }
+    }
+}
+
 void
 FemDeformableBodyModel::applyBoundaryConditions(SparseMatrixd& M, const bool withCompliance) const
 {
@@ -806,7 +1009,8 @@ FemDeformableBodyModel::getFunctionGradient()
            {
                this->computeImplicitSystemLHS(*m_previousState.get(), *m_currentState.get(), m_updateType);
 
-               if (this->m_implementFixedBC)
+               // Matrix free the effective stiffness is empty, applyEffectiveStiffness filters the fixed nodes
+               if (this->m_implementFixedBC && !m_matrixFree)
                {
                    applyBoundaryConditions(m_Keff);
                }
@@ -835,7 +1039,10 @@ FemDeformableBodyModel::getFunctionAndGradient()
                if (this->m_implementFixedBC)
                {
                    applyBoundaryConditions(m_Feff);
-                   applyBoundaryConditions(m_Keff);
+                   if (!m_matrixFree)
+                   {
+                       applyBoundaryConditions(m_Keff);
+                   }
                }
                return std::make_pair(&m_Feff, &m_Keff);
            };
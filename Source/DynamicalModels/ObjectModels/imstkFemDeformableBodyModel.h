@@ -47,6 +47,17 @@ struct FemModelConfig
     double m_compressionResistance       = 500.0;
     double m_inversionThreshold = -std::numeric_limits<double>::max();
     double m_gravity = 9.81;
+
+    /// Assemble the linear and corotational methods in parallel without vega, see NativeFemForceModel
+    bool m_nativeAssembly = false;
+
+    /// Solve with the effective stiffness applied by the model instead of formed, requires
+    /// native assembly and a conjugate gradient linear solver
+    bool m_matrixFree = false;
+
+    /// Start every conjugate gradient solve from the update of the last Newton iteration
+    /// instead of zero, requires a conjugate gradient linear solver
+    bool m_warmStart = false;
 };
 
 ///
@@ -139,6 +150,11 @@ public:
     ///
     bool initializeExplicitExternalForces();
 
+    ///
+    /// \brief Hand the effective stiffness operator to the linear solver when matrix free
+    ///
+    bool initializeMatrixFree();
+
     ///
     /// \brief Initialize the Eigen matrix with data inside vega sparse matrix
     ///
@@ -174,6 +190,23 @@ public:
     ///
     void updateDampingMatrix();
 
+    ///
+    /// \brief Compute \p y = C x without forming the damping matrix, given \p Kx the tangent
+    /// stiffness times x
+    ///
+    void applyDampingMatrix(const Vectord& x, const Vectord& Kx, Vectord& y);
+
+    ///
+    /// \brief Compute \p y = (M + dt C + dt^2 K) x, the product with the effective stiffness
+    /// with the fixed boundary conditions, without forming it
+    ///
+    void applyEffectiveStiffness(const Vectord& x, Vectord& y);
+
+    ///
+    /// \brief Compute the 3x3 diagonal blocks of the effective stiffness without forming it
+    ///
+    void computeEffectiveStiffnessBlockDiagonal(StdVectorOfMat3d& blocks);
+
     ///
     /// \brief Applies boundary conditions to matrix and a vector
     ///
@@ -314,6 +347,15 @@ protected:
     StateUpdateType m_updateType = StateUpdateType::DeltaVelocity;                ///< Update type of the model
 
     bool m_damped = false;                                                        ///< Viscous or structurally damped system
+    bool m_matrixFree = false;                                                    ///< Effective stiffness applied by the model, not formed
+
+    // Storage of the matrix free products
+    StdVectorOfMat3d m_massBlocks;
+    StdVectorOfMat3d m_dampingBlocks;
+    StdVectorOfMat3d m_stiffnessBlocks;
+    Vectord          m_xFree;
+    Vectord          m_Kx;
+    Vectord          m_Cx;
 
     // If this is true, the tangent stiffness and force vector will be modified to
     // accommodate (the rows and columns will be nullified) the fixed boundary conditions
@@ -13,6 +13,7 @@
 #include "imstkPbdBendConstraint.h"
 #include "imstkPbdConstantDensityConstraint.h"
 #include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintBlock.h"
 #include "imstkPbdDihedralConstraint.h"
 #include "imstkPbdDistanceConstraint.h"
 #include "imstkPbdFemConstraint.h"
@@ -91,8 +92,18 @@ struct PbdBodyConstraintFunctor : public PbdConstraintFunctor
 
         void setBodyIndex(const int bodyIndex) { m_bodyIndex = bodyIndex; }
 
+        ///
+        /// \brief Get/Set whether to generate constraints into a structure-of-arrays
+        /// PbdConstraintBlock instead of individual constraints. Only used by the
+        /// distance, volume, dihedral and fem tet functors
+        ///@{
+        void setUseConstraintBlocks(const bool useConstraintBlocks) { m_useConstraintBlocks = useConstraintBlocks; }
+        bool getUseConstraintBlocks() const { return m_useConstraintBlocks; }
+        ///@}
+
         int m_bodyIndex = 1;
         std::shared_ptr<PointSet> m_geom = nullptr;
+        bool m_useConstraintBlocks       = false;
 };
 
 ///
@@ -126,6 +137,9 @@ struct PbdDistanceConstraintFunctor : public PbdBodyConstraintFunctor
             std::shared_ptr<VecDataArray<double, 3>> verticesPtr = m_geom->getVertexPositions();
             const VecDataArray<double, 3>&           vertices    = *verticesPtr;
 
+            std::shared_ptr<PbdDistanceConstraintBlock> block =
+                m_useConstraintBlocks ? std::make_shared<PbdDistanceConstraintBlock>() : nullptr;
+
             auto addDistConstraint = [&](
                 std::vector<std::vector<bool>>& E, int i1, int i2)
                                      {
@@ -139,7 +153,14 @@ struct PbdDistanceConstraintFunctor : public PbdBodyConstraintFunctor
                                              E[i1][i2] = 0;
 
                                              auto c = makeDistConstraint(vertices, i1, i2);
-                                             constraints.addConstraint(c);
+                                             if (block != nullptr)
+                                             {
+                                                 block->addConstraint(*c);
+                                             }
+                                             else
+                                             {
+                                                 constraints.addConstraint(c);
+                                             }
                                          }
                                      };
 
@@ -193,6 +214,11 @@ struct PbdDistanceConstraintFunctor : public PbdBodyConstraintFunctor
             {
                 LOG(WARNING) << "PbdDistanceConstraint can only be generated with a TetrahedralMesh, SurfaceMesh, or LineMesh";
             }
+
+            if (block != nullptr && !block->empty())
+            {
+                constraints.addConstraintBlock(block);
+            }
         }
 
         ///
@@ -340,6 +366,13 @@ struct PbdFemTetConstraintFunctor : public PbdBodyConstraintFunctor
                 strainParameters = tetMesh->getStrainParameters();
             }
 
+            std::shared_ptr<PbdFemTetConstraintBlock> block = nullptr;
+            if (m_useConstraintBlocks)
+            {
+                block = std::make_shared<PbdFemTetConstraintBlock>();
+                block->resize(elements.size());
+            }
+
             ParallelUtils::parallelFor(elements.size(),
                 [&](const size_t k)
                 {
@@ -360,8 +393,20 @@ struct PbdFemTetConstraintFunctor : public PbdBodyConstraintFunctor
                         { m_bodyIndex, tet[0] }, { m_bodyIndex, tet[1] },
                         { m_bodyIndex, tet[2] }, { m_bodyIndex, tet[3] },
                         config);
-                    constraints.addConstraint(c);
+                    if (block != nullptr)
+                    {
+                        block->setConstraint(k, *c);
+                    }
+                    else
+                    {
+                        constraints.addConstraint(c);
+                    }
             }, elements.size() > 100);
+
+            if (block != nullptr)
+            {
+                constraints.addConstraintBlock(block);
+            }
         }
 
         void setMaterialType(const PbdFemTetConstraint::MaterialType materialType) { m_matType = materialType; }
@@ -399,6 +444,13 @@ struct PbdVolumeConstraintFunctor : public PbdBodyConstraintFunctor
             std::shared_ptr<VecDataArray<int, 4>>    elementsPtr = tetMesh->getCells();
             const VecDataArray<int, 4>&              elements    = *elementsPtr;
 
+            std::shared_ptr<PbdVolumeConstraintBlock> block = nullptr;
+            if (m_useConstraintBlocks)
+            {
+                block = std::make_shared<PbdVolumeConstraintBlock>();
+                block->resize(elements.size());
+            }
+
             ParallelUtils::parallelFor(elements.size(),
                 [&](const size_t k)
                 {
@@ -409,8 +461,20 @@ struct PbdVolumeConstraintFunctor : public PbdBodyConstraintFunctor
                         { m_bodyIndex, tet[0] }, { m_bodyIndex, tet[1] },
                         { m_bodyIndex, tet[2] }, { m_bodyIndex, tet[3] },
                         m_stiffness);
-                    constraints.addConstraint(c);
+                    if (block != nullptr)
+                    {
+                        block->setConstraint(k, *c);
+                    }
+                    else
+                    {
+                        constraints.addConstraint(c);
+                    }
             });
+
+            if (block != nullptr)
+            {
+                constraints.addConstraintBlock(block);
+            }
         }
 
         ///
@@ -656,6 +720,9 @@ struct PbdDihedralConstraintFunctor : public PbdBodyConstraintFunctor
             // Used to resolve duplicates
             std::vector<std::vector<bool>> E(nV, std::vector<bool>(nV, 1));
 
+            std::shared_ptr<PbdDihedralConstraintBlock> block =
+                m_useConstraintBlocks ? std::make_shared<PbdDihedralConstraintBlock>() : nullptr;
+
             auto addDihedralConstraint =
                 [&](const std::vector<int>& r1, const std::vector<int>& r2,
                     const int k, int i1, int i2)
@@ -694,7 +761,14 @@ struct PbdDihedralConstraintFunctor : public PbdBodyConstraintFunctor
                             c->initConstraint(vertices[idx0], vertices[idx1], vertices[i1], vertices[i2],
                                 { m_bodyIndex, idx0 }, { m_bodyIndex, idx1 },
                                 { m_bodyIndex, i1 }, { m_bodyIndex, i2 }, m_stiffness);
-                            constraints.addConstraint(c);
+                            if (block != nullptr)
+                            {
+                                block->addConstraint(*c);
+                            }
+                            else
+                            {
+                                constraints.addConstraint(c);
+                            }
                         }
                     }
                 };
@@ -719,6 +793,11 @@ struct PbdDihedralConstraintFunctor : public PbdBodyConstraintFunctor
                 addDihedralConstraint(neighborTriangles0, neighborTriangles2, k, tri[0], tri[2]);
                 addDihedralConstraint(neighborTriangles1, neighborTriangles2, k, tri[1], tri[2]);
             }
+
+            if (block != nullptr && !block->empty())
+            {
+                constraints.addConstraintBlock(block);
+            }
         }
 
         void addConstraints(PbdConstraintContainer&                     constraints,
@@ -76,6 +76,7 @@ void
 PbdModel::resetToInitialState()
 {
     m_state.deepCopy(m_initialState);
+    buildIslands();
 
     // Set previous particle positions, orientations to current to avoid a jump
     for (auto bodyIter = m_state.m_bodies.begin();
@@ -181,6 +182,22 @@ PbdModel::clearVirtualParticles()
     resizeBodyParticles(*m_state.m_bodies[0], 0);
 }
 
+void
+PbdModel::setVirtualParticle(const PbdParticleId& pid, const Vec3d& pos, const double mass)
+{
+    PbdBody& body = *m_state.m_bodies[pid.first];
+    (*body.prevVertices)[pid.second]      = pos;
+    (*body.vertices)[pid.second]          = pos;
+    (*body.prevOrientations)[pid.second]  = Quatd::Identity();
+    (*body.orientations)[pid.second]      = Quatd::Identity();
+    (*body.velocities)[pid.second]        = Vec3d::Zero();
+    (*body.angularVelocities)[pid.second] = Vec3d::Zero();
+    (*body.masses)[pid.second]      = mass;
+    (*body.invMasses)[pid.second]   = (mass == 0.0) ? 0.0 : 1.0 / mass;
+    (*body.inertias)[pid.second]    = Mat3d::Identity();
+    (*body.invInertias)[pid.second] = Mat3d::Identity();
+}
+
 std::shared_ptr<PbdModelConfig>
 PbdModel::getConfig() const
 {
@@ -203,6 +220,10 @@ PbdModel::initialize()
         {
             for (const auto& functor : functorVec.second)
             {
+                if (auto bodyFunctor = std::dynamic_pointer_cast<PbdBodyConstraintFunctor>(functor))
+                {
+                    bodyFunctor->setUseConstraintBlocks(m_config->m_useConstraintBlocks);
+                }
                 (*functor)(*m_constraints);
             }
         }
@@ -223,6 +244,7 @@ PbdModel::initialize()
     {
         m_pbdSolver = std::make_shared<PbdSolver>();
     }
+    buildIslands();
 
     if (m_config->m_dataTracker)
     {
@@ -230,6 +252,7 @@ PbdModel::initialize()
         m_config->m_dataTracker->configureProbe(DataTracker::Physics::SolverTime_ms, DataTracker::ePhysics::SolverTime_ms);
         m_config->m_dataTracker->configureProbe(DataTracker::Physics::NumConstraints, DataTracker::ePhysics::NumConstraints);
         m_config->m_dataTracker->configureProbe(DataTracker::Physics::AverageC, DataTracker::ePhysics::AverageC);
+        m_config->m_dataTracker->configureProbe(DataTracker::Physics::SubstepTime_ms, DataTracker::ePhysics::SubstepTime_ms);
     }
 
     return true;
@@ -261,6 +284,12 @@ PbdModel::addConstraints(std::shared_ptr<std::unordered_set<size_t>> vertices, c
             }
         }
     }
+
+    // Fit the new constraints into the existing partitions
+    if (m_config->m_doPartitioning)
+    {
+        m_constraints->updatePartitions();
+    }
 }
 
 void
@@ -275,17 +304,55 @@ PbdModel::getTimeStep() const
     return m_config->m_dt;
 }
 
+double
+PbdModel::getSubstepTimeStep() const
+{
+    return m_config->m_dt / std::max(m_config->m_substeps, 1u);
+}
+
 void
 PbdModel::integratePosition()
 {
+    if (m_config->m_dataTracker)
+    {
+        m_config->m_dataTracker->getStopWatch(DataTracker::ePhysics::SubstepTime_ms).start();
+    }
+
     // resize 0 virtual particles (avoids reallocation)
     clearVirtualParticles();
+    // Constraints of the last frame are handed out again
+    m_constraintArena.reset();
+
+    // Bodies or constraints may have been added/removed since
+    if (m_islandsVersion != m_constraints->getVersion() || m_bodyIslands.size() != m_state.m_bodies.size())
+    {
+        buildIslands();
+    }
+    // External forces wake their island before integration
+    for (size_t i = 2; i < m_state.m_bodies.size(); i++)
+    {
+        const PbdBody& body = *m_state.m_bodies[i];
+        if (m_sleepingBodies[i] && (!body.externalForce.isZero() || !body.externalTorque.isZero()))
+        {
+            wakeIsland(m_bodyIslands[i]);
+        }
+    }
+
+    integrateBodyPositions();
+}
+
+void
+PbdModel::integrateBodyPositions()
+{
     int bodyCount = m_state.m_bodies.size() - 2;
 
     // There are two virtual particles buffer, skip the first two
     ParallelUtils::parallelFor(bodyCount,
         [&](const int i) {
-            integratePosition(*m_state.m_bodies[i + 2]);
+            if (!m_sleepingBodies[i + 2])
+            {
+                integratePosition(*m_state.m_bodies[i + 2]);
+            }
             });
 }
 
@@ -303,7 +370,7 @@ PbdModel::integratePosition(PbdBody& body)
     CHECK(numParticles == vel.size()) << "PbdModel data corrupt";
     CHECK(numParticles == invMasses.size()) << "PbdModel data corrupt";
 
-    const double dt = m_config->m_dt;
+    const double dt = getSubstepTimeStep();
     const double linearVelocityDamp = 1.0 - m_config->getLinearDamping(body.bodyHandle);
     ParallelUtils::parallelFor(numParticles,
         [&](const int i)
@@ -373,23 +440,59 @@ PbdModel::integratePosition(PbdBody& body)
 
 void
 PbdModel::updateVelocity()
+{
+    wakePushedIslands();
+    updateBodyVelocities();
+    correctCollisionVelocities();
+    probeSubstepTime();
+    m_pbdSolver->clearConstraintLists();
+    updateIslandSleep();
+
+    // External forces apply over all the sub-steps of the step
+    for (const auto& body : m_state.m_bodies)
+    {
+        body->externalForce  = Vec3d::Zero();
+        body->externalTorque = Vec3d::Zero();
+    }
+
+}
+
+void
+PbdModel::probeSubstepTime()
+{
+    if (m_config->m_dataTracker)
+    {
+        // A sub-step includes the collision run between its integration and its solve
+        m_config->m_dataTracker->probeElapsedTime_s(DataTracker::ePhysics::SubstepTime_ms);
+        m_config->m_dataTracker->getStopWatch(DataTracker::ePhysics::SubstepTime_ms).start();
+    }
+}
+
+void
+PbdModel::updateBodyVelocities()
 {
     int bodyCount = m_state.m_bodies.size() - 2;
     ParallelUtils::parallelFor(bodyCount,
         [&](const int i) {
-            updateVelocity(*m_state.m_bodies[i + 2]);
+            if (!m_sleepingBodies[i + 2])
+            {
+                updateVelocity(*m_state.m_bodies[i + 2]);
+            }
                 });
+}
 
+void
+PbdModel::correctCollisionVelocities()
+{
     // Correctly velocities for friction and restitution
     // Unfortunately the constraint would be clear after a solve
     for (const auto& colConstraintList : m_pbdSolver->getConstraintLists())
     {
         for (auto& colConstraint : *colConstraintList)
         {
-            colConstraint->correctVelocity(m_state, m_config->m_dt);
+            colConstraint->correctVelocity(m_state, getSubstepTimeStep());
         }
     }
-    m_pbdSolver->clearConstraintLists();
 }
 
 void
@@ -408,7 +511,7 @@ PbdModel::updateVelocity(PbdBody& body)
         CHECK(numParticles == vel.size()) << "PbdModel data corrupt";
         CHECK(numParticles == invMasses.size()) << "PbdModel data corrupt";
 
-        const double invDt = 1.0 / m_config->m_dt;
+        const double invDt = 1.0 / getSubstepTimeStep();
         ParallelUtils::parallelFor(numParticles,
             [&](const int i)
             {
@@ -444,9 +547,6 @@ PbdModel::updateVelocity(PbdBody& body)
                 }, numParticles > 50);
         }
     }
-
-    body.externalForce  = Vec3d::Zero();
-    body.externalTorque = Vec3d::Zero();
 }
 
 void
@@ -454,10 +554,367 @@ PbdModel::solveConstraints()
 {
     m_pbdSolver->setPbdBodies(&m_state);
     m_pbdSolver->setConstraints(getConstraints());
-    m_pbdSolver->setTimeStep(m_config->m_dt);
+    m_pbdSolver->setTimeStep(getSubstepTimeStep());
     m_pbdSolver->setIterations(m_config->m_iterations);
     m_pbdSolver->setSolverType(m_config->m_solverType);
+    wakeTouchedIslands();
     m_pbdSolver->solve();
+
+    // The first sub-step is split over the task graph, run the remaining ones here.
+    // Every solve starts from zero lambdas as every sub-step is a step of its own
+    for (unsigned int i = 1; i < m_config->m_substeps; i++)
+    {
+        updateBodyVelocities();
+        correctCollisionVelocities();
+        probeSubstepTime();
+
+        integrateBodyPositions();
+        if (m_config->m_collisionPerSubstep && !m_substepCollisionFuncs.empty())
+        {
+            // Handling adds the collision constraints and virtual particles again
+            m_pbdSolver->clearConstraintLists();
+            clearVirtualParticles();
+            for (const auto& func : m_substepCollisionFuncs)
+            {
+                func.second();
+            }
+            wakeTouchedIslands();
+        }
+
+        m_pbdSolver->solve();
+    }
+}
+
+bool
+PbdModel::getBodySleeping(const int bodyId) const
+{
+    return static_cast<size_t>(bodyId) < m_sleepingBodies.size() && m_sleepingBodies[bodyId];
+}
+
+void
+PbdModel::wakeBody(const int bodyId)
+{
+    if (getBodySleeping(bodyId))
+    {
+        wakeIsland(m_bodyIslands[bodyId]);
+        m_pbdSolver->setSleepingBodies(m_sleepingBodies);
+    }
+}
+
+void
+PbdModel::buildIslands()
+{
+    // Islands that may keep their sleep state if the change didn't touch them
+    std::map<std::vector<int>, Island> previousIslands;
+    for (const Island& island : m_islands)
+    {
+        if (island.sleeping || island.numStillSteps > 0)
+        {
+            previousIslands[island.bodyIds] = island;
+        }
+    }
+
+    // Union-find of the bodies over the particles of every constraint
+    const int        numBodies = static_cast<int>(m_state.m_bodies.size());
+    std::vector<int> parents(numBodies);
+    for (int i = 0; i < numBodies; i++)
+    {
+        parents[i] = i;
+    }
+    auto findRoot = [&](int i)
+                    {
+                        while (parents[i] != i)
+                        {
+                            parents[i] = parents[parents[i]];
+                            i = parents[i];
+                        }
+                        return i;
+                    };
+    auto connect = [&](const PbdParticleId* particles, const size_t numParticles)
+                   {
+                       for (size_t i = 1; i < numParticles; i++)
+                       {
+                           parents[findRoot(particles[i].first)] = findRoot(particles[0].first);
+                       }
+                   };
+    const PbdConstraintContainer& container = *m_constraints;
+    for (const auto& constraint : container.getConstraints())
+    {
+        connect(constraint->getParticles().data(), constraint->getParticles().size());
+    }
+    for (const auto& constraintPartition : container.getPartitionedConstraints())
+    {
+        for (const auto& constraint : constraintPartition)
+        {
+            connect(constraint->getParticles().data(), constraint->getParticles().size());
+        }
+    }
+    // The solver skips a block by its first particle, keep a block in one island
+    for (const auto& block : container.getConstraintBlocks())
+    {
+        connect(block->getParticles().data(), block->getParticles().size());
+    }
+
+    // One island per root, virtual bodies don't belong to any
+    m_islands.clear();
+    m_bodyIslands.assign(numBodies, -1);
+    m_sleepingBodies.assign(numBodies, false);
+    std::vector<int> rootIslands(numBodies, -1);
+    for (int i = 2; i < numBodies; i++)
+    {
+        const int root = findRoot(i);
+        if (rootIslands[root] == -1)
+        {
+            rootIslands[root] = static_cast<int>(m_islands.size());
+            m_islands.push_back(Island());
+            m_islands.back().sleepThreshold = m_config->getSleepThreshold(m_state.m_bodies[i]->bodyHandle);
+        }
+        Island& island = m_islands[rootIslands[root]];
+        island.bodyIds.push_back(i);
+        island.sleepThreshold = std::min(island.sleepThreshold, m_config->getSleepThreshold(m_state.m_bodies[i]->bodyHandle));
+        m_bodyIslands[i]      = rootIslands[root];
+    }
+    // Islands constrained to virtual particles stay awake
+    for (int i = 0; i < std::min(numBodies, 2); i++)
+    {
+        const int islandId = rootIslands[findRoot(i)];
+        if (islandId != -1)
+        {
+            m_islands[islandId].sleepThreshold = 0.0;
+        }
+    }
+
+    // Signature of the constraints and particle counts of every island, order independent
+    auto addSignature = [&](const PbdParticleId* particles, const size_t numParticles)
+                        {
+                            size_t hash     = 0;
+                            int    islandId = -1;
+                            for (size_t i = 0; i < numParticles; i++)
+                            {
+                                hash = hash * 1000003 ^ PbdConstraintContainer::getParticleKey(particles[i]);
+                                if (islandId == -1)
+                                {
+                                    islandId = m_bodyIslands[particles[i].first];
+                                }
+                            }
+                            if (islandId != -1)
+                            {
+                                m_islands[islandId].signature += hash;
+                            }
+                        };
+    for (const auto& constraint : container.getConstraints())
+    {
+        addSignature(constraint->getParticles().data(), constraint->getParticles().size());
+    }
+    for (const auto& constraintPartition : container.getPartitionedConstraints())
+    {
+        for (const auto& constraint : constraintPartition)
+        {
+            addSignature(constraint->getParticles().data(), constraint->getParticles().size());
+        }
+    }
+    for (const auto& block : container.getConstraintBlocks())
+    {
+        addSignature(block->getParticles().data(), block->getParticles().size());
+    }
+    for (Island& island : m_islands)
+    {
+        for (const int bodyId : island.bodyIds)
+        {
+            island.signature += std::hash<int>()(m_state.m_bodies[bodyId]->vertices->size()) * 31 + bodyId;
+        }
+    }
+
+    // Islands with the same bodies and constraints as before keep sleeping, ie: a cut
+    // only wakes the island it is made in
+    for (Island& island : m_islands)
+    {
+        auto previous = previousIslands.find(island.bodyIds);
+        if (previous != previousIslands.end() && previous->second.signature == island.signature
+            && previous->second.sleepThreshold == island.sleepThreshold)
+        {
+            island.numStillSteps = previous->second.numStillSteps;
+            island.sleeping      = previous->second.sleeping;
+            for (const int bodyId : island.bodyIds)
+            {
+                m_sleepingBodies[bodyId] = island.sleeping;
+            }
+        }
+    }
+
+    m_islandsVersion = m_constraints->getVersion();
+    if (m_pbdSolver != nullptr)
+    {
+        m_pbdSolver->setSleepingBodies(m_sleepingBodies);
+    }
+}
+
+void
+PbdModel::wakeTouchedIslands()
+{
+    // A constraint between a sleeping island and another body (a tool, a grasp, another island)
+    // wakes it. One that only involves the island and particles that can't move (static
+    // obstacles) is checked after the solve
+    for (const auto& constraintList : m_pbdSolver->getConstraintLists())
+    {
+        for (PbdConstraint* constraint : *constraintList)
+        {
+            const std::vector<PbdParticleId>& particles = constraint->getParticles();
+            for (const PbdParticleId& pid : particles)
+            {
+                if (!m_sleepingBodies[pid.first])
+                {
+                    continue;
+                }
+                const int islandId = m_bodyIslands[pid.first];
+                const bool oneSided = std::all_of(particles.begin(), particles.end(),
+                    [&](const PbdParticleId& otherPid)
+                    {
+                        return m_bodyIslands[otherPid.first] == islandId || m_state.getInvMass(otherPid) == 0.0;
+                    });
+                if (oneSided)
+                {
+                    m_islands[islandId].touched = true;
+                }
+                else
+                {
+                    wakeIsland(islandId);
+                }
+            }
+        }
+    }
+    m_pbdSolver->setSleepingBodies(m_sleepingBodies);
+}
+
+void
+PbdModel::wakePushedIslands()
+{
+    // Sleeping bodies aren't integrated so any displacement from their previous
+    // positions comes from the constraint lists
+    const double invDt = 1.0 / getSubstepTimeStep();
+    for (Island& island : m_islands)
+    {
+        if (!island.sleeping || !island.touched)
+        {
+            continue;
+        }
+        island.touched = false;
+
+        bool pushed = false;
+        for (size_t j = 0; j < island.bodyIds.size() && !pushed; j++)
+        {
+            const PbdBody&                 body    = *m_state.m_bodies[island.bodyIds[j]];
+            const VecDataArray<double, 3>& pos     = *body.vertices;
+            const VecDataArray<double, 3>& prevPos = *body.prevVertices;
+            for (int i = 0; i < pos.size() && !pushed; i++)
+            {
+                pushed = 0.5 * ((pos[i] - prevPos[i]) * invDt).squaredNorm() > island.sleepThreshold;
+            }
+        }
+
+        if (pushed)
+        {
+            // Velocities follow from the displacement in updateVelocity
+            wakeIsland(static_cast<int>(&island - m_islands.data()));
+        }
+        else
+        {
+            // Stay exactly at rest, ie: lying on a static obstacle
+            for (const int bodyId : island.bodyIds)
+            {
+                PbdBody& body = *m_state.m_bodies[bodyId];
+                *body.vertices = *body.prevVertices;
+                if (body.getOriented())
+                {
+                    *body.orientations = *body.prevOrientations;
+                }
+            }
+        }
+    }
+}
+
+void
+PbdModel::updateIslandSleep()
+{
+    for (int islandId = 0; islandId < static_cast<int>(m_islands.size()); islandId++)
+    {
+        Island& island = m_islands[islandId];
+        if (island.sleeping || island.sleepThreshold <= 0.0)
+        {
+            continue;
+        }
+
+        // Kinetic energy per unit mass, so the threshold doesn't depend on the size of the island
+        double energy = 0.0;
+        double mass   = 0.0;
+        for (const int bodyId : island.bodyIds)
+        {
+            const PbdBody&                 body      = *m_state.m_bodies[bodyId];
+            const VecDataArray<double, 3>& vel       = *body.velocities;
+            const DataArray<double>&       invMasses = *body.invMasses;
+            for (int i = 0; i < vel.size(); i++)
+            {
+                if (invMasses[i] > 0.0)
+                {
+                    const double particleMass = 1.0 / invMasses[i];
+                    energy += 0.5 * particleMass * vel[i].squaredNorm();
+                    mass   += particleMass;
+                    if (body.getOriented())
+                    {
+                        const Vec3d& w = (*body.angularVelocities)[i];
+                        energy += 0.5 * w.dot((*body.inertias)[i] * w);
+                    }
+                }
+            }
+        }
+
+        if (mass == 0.0 || energy / mass < island.sleepThreshold)
+        {
+            island.numStillSteps++;
+            if (island.numStillSteps >= m_config->m_sleepSteps)
+            {
+                sleepIsland(islandId);
+            }
+        }
+        else
+        {
+            island.numStillSteps = 0;
+        }
+    }
+}
+
+void
+PbdModel::sleepIsland(const int islandId)
+{
+    Island& island = m_islands[islandId];
+    island.sleeping = true;
+    island.touched  = false;
+    for (const int bodyId : island.bodyIds)
+    {
+        // Previous positions hold the rest pose while sleeping
+        PbdBody& body = *m_state.m_bodies[bodyId];
+        *body.prevVertices = *body.vertices;
+        body.velocities->fill(Vec3d::Zero());
+        if (body.getOriented())
+        {
+            *body.prevOrientations = *body.orientations;
+            body.angularVelocities->fill(Vec3d::Zero());
+        }
+        m_sleepingBodies[bodyId] = true;
+    }
+}
+
+void
+PbdModel::wakeIsland(const int islandId)
+{
+    Island& island = m_islands[islandId];
+    island.sleeping      = false;
+    island.touched       = false;
+    island.numStillSteps = 0;
+    for (const int bodyId : island.bodyIds)
+    {
+        m_sleepingBodies[bodyId] = false;
+    }
 }
 
 void
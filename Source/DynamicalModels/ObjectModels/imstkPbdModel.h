@@ -9,7 +9,9 @@
 #include "imstkAbstractDynamicalModel.h"
 #include "imstkPbdBody.h"
 #include "imstkPbdConstraint.h"
+#include "imstkPbdConstraintArena.h"
 
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -32,6 +34,15 @@ class PbdSolver;
 /// of the model are computed after positions are solved. Velocities from the
 /// previous iteration are applied at the start of the update.
 ///
+/// With PbdModelConfig::m_substeps > 1 the step is split into sub-steps that each
+/// integrate, solve and update velocities (small steps, usually with 1 iteration).
+/// The first sub-step runs in the task graph nodes, the remaining ones in the solve node.
+///
+/// With PbdModelConfig::m_sleepThreshold > 0 bodies are grouped in islands, the connected
+/// components of the bodies and the constraints between them. An island whose kinetic energy
+/// stays under the threshold is put to sleep, its bodies are no longer integrated nor solved
+/// until an external force or a constraint list of the solver (collision, grasping) wakes it.
+///
 /// References:
 /// Matthias Muller, Bruno Heidelberger, Marcus Hennix, and John Ratcliff. 2007. Position based dynamics.
 /// Miles Macklin, Matthias Muller, and Nuttapong Chentanez 1. XPBD: position-based simulation of compliant constrained dynamics.
@@ -89,6 +100,18 @@ public:
     ///
     void clearVirtualParticles();
 
+    ///
+    /// \brief Resize the virtual particles cleared every frame, new particles should be
+    /// set with setVirtualParticle. Allows to fill reserved particles from multiple threads
+    ///
+    void resizeVirtualParticles(const int particleCount) { resizeBodyParticles(*m_state.m_bodies[0], particleCount); }
+
+    ///
+    /// \brief Set a virtual particle previously added or reserved with resizeVirtualParticles
+    /// to the given position and mass, at rest, unit inertia
+    ///
+    void setVirtualParticle(const PbdParticleId& pid, const Vec3d& pos, const double mass);
+
     ///
     /// \brief Get the simulation parameters
     ///
@@ -105,6 +128,30 @@ public:
     void setTimeStep(const double timeStep) override;
     double getTimeStep() const override;
 
+    ///
+    /// \brief Get the time step of a sub-step, m_dt / m_substeps
+    ///
+    double getSubstepTimeStep() const;
+
+    ///
+    /// \brief Set/Remove a function that redoes collision detection and handling, run after
+    /// integrating every sub-step but the first when PbdModelConfig::m_collisionPerSubstep is on.
+    /// Keyed by a unique id of the owner, such as its EntityID, such that it may be replaced
+    ///@{
+    void setSubstepCollisionFunction(const std::size_t id, std::function<void()> func) { m_substepCollisionFuncs[id] = func; }
+    void removeSubstepCollisionFunction(const std::size_t id) { m_substepCollisionFuncs.erase(id); }
+    ///@}
+
+    ///
+    /// \brief Returns if the body at the given index sleeps
+    ///
+    bool getBodySleeping(const int bodyId) const;
+
+    ///
+    /// \brief Wakes up the island of the body at the given index
+    ///
+    void wakeBody(const int bodyId);
+
     ///
     /// \brief Set/Get filter value for velocity, default is 10 in meters/second
     ///@{
@@ -156,6 +203,12 @@ public:
     ///
     void setSolver(std::shared_ptr<PbdSolver> solver) { this->m_pbdSolver = solver; }
 
+    ///
+    /// \brief Returns the arena interactions acquire their per frame constraints from,
+    /// it is reset with the virtual particles at the start of every frame
+    ///
+    PbdConstraintArena& getConstraintArena() { return m_constraintArena; }
+
     std::shared_ptr<TaskNode> getIntegratePositionNode() const { return m_integrationPositionNode; }
     std::shared_ptr<TaskNode> getSolveNode() const { return m_solveConstraintsNode; }
     std::shared_ptr<TaskNode> getUpdateVelocityNode() const { return m_updateVelocityNode; }
@@ -169,6 +222,53 @@ protected:
     ///
     void resizeBodyParticles(PbdBody& body, const int particleCount);
 
+    ///
+    /// \brief Integrate the positions/update the velocities of all the non virtual bodies
+    ///@{
+    void integrateBodyPositions();
+    void updateBodyVelocities();
+    ///@}
+
+    ///
+    /// \brief Correct velocities for friction and restitution of the collision constraints
+    ///
+    void correctCollisionVelocities();
+
+    ///
+    /// \brief Probe the time of the sub-step that ends here and time the next one
+    ///
+    void probeSubstepTime();
+
+    ///
+    /// \brief Groups the bodies in islands connected by the constraints of the container,
+    /// all awake
+    ///
+    void buildIslands();
+
+    ///
+    /// \brief Wakes the islands constrained to other bodies by the constraint lists of
+    /// the solver, then tells the solver which bodies sleep
+    ///
+    void wakeTouchedIslands();
+
+    ///
+    /// \brief Wakes the sleeping islands the constraint lists moved enough, the others
+    /// are put back at rest
+    ///
+    void wakePushedIslands();
+
+    ///
+    /// \brief Puts to sleep the islands that stayed still for PbdModelConfig::m_sleepSteps
+    ///
+    void updateIslandSleep();
+
+    ///
+    /// \brief Sleep/Wake an island
+    ///@{
+    void sleepIsland(const int islandId);
+    void wakeIsland(const int islandId);
+    ///@}
+
     ///
     /// \brief Setup the computational graph of Pbd
     ///
@@ -185,6 +285,28 @@ protected:
     std::shared_ptr<PbdSolver>      m_pbdSolver = nullptr;     ///< PBD solver
     std::shared_ptr<PbdModelConfig> m_config    = nullptr;     ///< Model parameters, must be set before simulation
     std::shared_ptr<PbdConstraintContainer> m_constraints;     ///< The set of constraints to update/use
+    PbdConstraintArena m_constraintArena;                      ///< Per frame constraints of the interactions
+
+    std::map<std::size_t, std::function<void()>> m_substepCollisionFuncs; ///< Redo collision for a sub-step, by owner id
+
+    ///
+    /// \struct Island
+    ///
+    /// \brief Bodies connected by constraints, they sleep and wake together
+    ///
+    struct Island
+    {
+        std::vector<int> bodyIds;
+        double       sleepThreshold = 0.0; ///< Kinetic energy per unit mass under which it may sleep
+        unsigned int numStillSteps  = 0;   ///< Consecutive steps under the threshold
+        bool         sleeping       = false;
+        bool         touched        = false; ///< Touched by a constraint list while sleeping
+        size_t       signature      = 0;     ///< Hash of the constraints and particle counts of its bodies
+    };
+    std::vector<Island> m_islands;
+    std::vector<int>    m_bodyIslands;    ///< Island of every body, by index in m_state, -1 for virtual bodies
+    std::vector<bool>   m_sleepingBodies; ///< If the body sleeps, by index in m_state
+    size_t m_islandsVersion = 0;          ///< Version of m_constraints the islands were built with
 
     ///< Computational Nodes
     ///@{
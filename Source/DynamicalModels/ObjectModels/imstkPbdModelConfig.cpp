@@ -244,4 +244,11 @@ PbdModelConfig::getAngularDamping(const int bodyId)
         return m_angularDampingCoeff;
     }
 }
+
+double
+PbdModelConfig::getSleepThreshold(const int bodyId) const
+{
+    auto iter = m_bodySleepThreshold.find(bodyId);
+    return (iter != m_bodySleepThreshold.end()) ? iter->second : m_sleepThreshold;
+}
 } // namespace imstk
\ No newline at end of file
@@ -140,13 +140,31 @@ public:
     double getAngularDamping(const int bodyId);
 ///@}
 
+    ///
+    /// \brief Set the sleep threshold for a specific body, overriding m_sleepThreshold
+    /// An island sleeps under the smallest threshold of its bodies, 0 keeps it awake
+    /// \param bodyId Body handle
+    /// \param threshold Kinetic energy per unit mass
+    ///
+    void setBodySleepThreshold(const int bodyId, const double threshold) { m_bodySleepThreshold[bodyId] = threshold; }
+
+    ///
+    /// \brief Returns the sleep threshold of a body
+    ///
+    double getSleepThreshold(const int bodyId) const;
+
 public:
     double m_linearDampingCoeff  = 0.01;      ///< Damping coefficient applied to linear velocity [0, 1]
     double m_angularDampingCoeff = 0.01;      ///< Damping coefficient applied to angular velcoity [0, 1]
 
     unsigned int m_iterations = 10;           ///< Internal constraints pbd solver iterations
     double       m_dt     = 0.01;             ///< Time step size
+    unsigned int m_substeps = 1;              ///< Integrate/solve/velocity update cycles per step, each of m_dt / m_substeps
+    bool m_collisionPerSubstep = false;       ///< Redo collision detection & handling every sub-step, otherwise collision constraints are reused
     bool m_doPartitioning = true;             ///< Does graph coloring to solve in parallel
+    bool m_useConstraintBlocks = false;       ///< Stores generated distance, volume, dihedral & fem tet constraints in structure-of-arrays blocks
+    double m_sleepThreshold = 0.0;            ///< Kinetic energy per unit mass of an island of bodies under which it may sleep, 0 never sleeps
+    unsigned int m_sleepSteps = 30;           ///< Consecutive steps an island must stay under its threshold before sleeping
 
     Vec3d m_gravity = Vec3d(0.0, -9.81, 0.0); ///< Gravity acceleration
 
@@ -163,6 +181,7 @@ public:
 
     std::unordered_map<int, double> m_bodyLinearDampingCoeff;  ///< Per body linear damping, Body id -> linear damping for given body [0, 1]
     std::unordered_map<int, double> m_bodyAngularDampingCoeff; ///< Per body angular damping, Body id -> angular damping for given body [0, 1]
+    std::unordered_map<int, double> m_bodySleepThreshold;      ///< Per body sleep threshold, Body id -> kinetic energy per unit mass
 
     std::shared_ptr<DataTracker> m_dataTracker;
 
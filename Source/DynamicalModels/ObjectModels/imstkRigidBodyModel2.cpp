@@ -70,9 +70,6 @@ RigidBodyModel2::initialize()
     StdVectorOfVec3d&    forces  = state->getForces();
     StdVectorOfVec3d&    torques = state->getTorques();
 
-    m_Minv = Eigen::SparseMatrix<double>(m_bodies.size() * 6, m_bodies.size() * 6);
-    std::vector<Eigen::Triplet<double>> mInvTriplets;
-    mInvTriplets.reserve((9 + 3) * m_bodies.size());
     for (size_t i = 0; i < m_bodies.size(); i++)
     {
         RigidBody& body = *m_bodies[i];
@@ -103,29 +100,7 @@ RigidBodyModel2::initialize()
         body.m_force  = &forces[i];
         body.m_torque = &torques[i];
         m_locations[m_bodies[i].get()] = static_cast<StorageIndex>(i);
-
-        if (!body.m_isStatic)
-        {
-            // invMass expanded to 3x3 matrix
-            const double invMass     = invMasses[i];
-            const Mat3d& invInvertia = invInteriaTensors[i];
-            int          index       = static_cast<int>(i * 6);
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            for (unsigned int c = 0; c < 3; c++)
-            {
-                for (unsigned int r = 0; r < 3; r++)
-                {
-                    mInvTriplets.push_back(Eigen::Triplet<double>(index + r, index + c, invInvertia(c, r)));
-                }
-            }
-        }
     }
-    m_Minv.setFromTriplets(mInvTriplets.begin(), mInvTriplets.end());
 
     // Copy to initial state
     m_initialState  = std::make_shared<RigidBodyState2>(*state);
@@ -145,9 +120,6 @@ RigidBodyModel2::updateMass()
     std::vector<double>& invMasses = state->getInvMasses();
     StdVectorOfMat3d&    invInteriaTensors = state->getInvIntertiaTensors();
 
-    m_Minv = Eigen::SparseMatrix<double>(m_bodies.size() * 6, m_bodies.size() * 6);
-    std::vector<Eigen::Triplet<double>> mInvTriplets;
-    mInvTriplets.reserve((9 + 3) * m_bodies.size());
     for (size_t i = 0; i < m_bodies.size(); i++)
     {
         RigidBody& body = *m_bodies[i];
@@ -161,29 +133,7 @@ RigidBodyModel2::updateMass()
         {
             invInteriaTensors[i] = body.m_intertiaTensor.inverse();
         }
-
-        if (!body.m_isStatic)
-        {
-            // invMass expanded to 3x3 matrix
-            const double invMass     = invMasses[i];
-            const Mat3d& invInvertia = invInteriaTensors[i];
-            int          index       = static_cast<int>(i * 6);
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            mInvTriplets.push_back(Eigen::Triplet<double>(index, index, invMass));
-            index++;
-            for (unsigned int c = 0; c < 3; c++)
-            {
-                for (unsigned int r = 0; r < 3; r++)
-                {
-                    mInvTriplets.push_back(Eigen::Triplet<double>(index + r, index + c, invInvertia(c, r)));
-                }
-            }
-        }
     }
-    m_Minv.setFromTriplets(mInvTriplets.begin(), mInvTriplets.end());
 }
 
 void
@@ -214,15 +164,35 @@ RigidBodyModel2::computeTentativeVelocities()
         }, tentativeVelocities.size() > m_maxBodiesParallel);
 }
 
+size_t
+RigidBodyModel2::computeContactId(const RigidBody& body1, const RigidBody* body2, const Vec3d& contactPt, const int type) const
+{
+    // Quantize the contact point in the frame of body1 so it follows the body
+    const Vec3d localPt = body1.getOrientation().conjugate() * (contactPt - body1.getPosition());
+    const Vec3i cell    = (localPt / m_config->m_warmStartResolution).array().floor().cast<int>();
+
+    size_t id = std::hash<const RigidBody*>()(&body1);
+    auto   hashCombine = [&id](const size_t value)
+                         {
+                             id ^= value + static_cast<size_t>(0x9e3779b9) + (id << 6) + (id >> 2);
+                         };
+    hashCombine(std::hash<const RigidBody*>()(body2));
+    hashCombine(std::hash<int>()(type));
+    hashCombine(std::hash<int>()(cell[0]));
+    hashCombine(std::hash<int>()(cell[1]));
+    hashCombine(std::hash<int>()(cell[2]));
+
+    // 0 is reserved for constraints without an id
+    return (id == 0) ? 1 : id;
+}
+
 void
 RigidBodyModel2::solveConstraints()
 {
-    // Clear
-    F = Eigen::VectorXd();
-
     // Solves the current constraints of the system, then discards them
     if (m_constraints.size() == 0)
     {
+        m_prevLambdas.clear();
         return;
     }
     if (m_config->m_maxNumConstraints != -1 && static_cast<int>(m_constraints.size()) > m_config->m_maxNumConstraints * 2)
@@ -230,136 +200,200 @@ RigidBodyModel2::solveConstraints()
         m_constraints.resize(m_config->m_maxNumConstraints * 2);
     }
 
-    //printf("solving\n");
-
     std::shared_ptr<RigidBodyState2> state    = getCurrentState();
     const std::vector<bool>&         isStatic = state->getIsStatic();
+    const std::vector<double>&       invMasses = state->getInvMasses();
+    const StdVectorOfMat3d&          invInteriaTensors   = state->getInvIntertiaTensors();
     const StdVectorOfVec3d&          tentativeVelocities = state->getTentatveVelocities();
     const StdVectorOfVec3d&          tentativeAngularVelocities = state->getTentativeAngularVelocities();
     StdVectorOfVec3d&                forces  = state->getForces();
     StdVectorOfVec3d&                torques = state->getTorques();
-
-    Eigen::VectorXd V    = Eigen::VectorXd(state->size() * 6);
-    Eigen::VectorXd Fext = Eigen::VectorXd(state->size() * 6);
-
-    // Fill the forces and tenative velocities vectors
-    StorageIndex j = 0;
-    for (size_t i = 0; i < state->size(); i++)
+    const double                     dt      = m_config->m_dt;
+    const bool                       warmStart = m_config->m_warmStart;
+
+    const int numConstraints = static_cast<int>(m_constraints.size());
+    const int numBodies      = static_cast<int>(state->size());
+
+    // The sparsity pattern of A only depends on which bodies every constraint acts on
+    bool patternChanged = (m_constraintBodies.size() != static_cast<size_t>(numConstraints))
+                          || (m_bodyConstraintOffsets.size() != static_cast<size_t>(numBodies + 1));
+    m_constraintBodies.resize(numConstraints);
+    m_Jb.resize(numConstraints * 2);
+    m_MJb.resize(numConstraints * 2);
+    m_b.resize(numConstraints);
+    m_cu.resize(numConstraints, 2);
+    m_guess.resize(numConstraints);
+
+    // Gather the 6-DOF jacobian block of every constraint for each of its bodies,
+    // static bodies aren't solved for and are left out of the system
+    int j = 0;
+    for (const std::shared_ptr<RbdConstraint>& constraint : m_constraints)
     {
-        if (!isStatic[i])
+        RigidBody* const bodies[2]   = { constraint->m_obj1.get(), constraint->m_obj2.get() };
+        const bool       solveFor[2] = { constraint->m_side != RbdConstraint::Side::B, constraint->m_side != RbdConstraint::Side::A };
+
+        // b = Vu / dt - J * (V / dt + Minv * Fext)
+        m_b(j) = constraint->vu / dt;
+        Vec2i constraintBodies(-1, -1);
+        for (int k = 0; k < 2; k++)
         {
-            const Vec3d& velocity = tentativeVelocities[i];
-            const Vec3d& angularVelocity = tentativeAngularVelocities[i];
-            const Vec3d& force  = forces[i];
-            const Vec3d& torque = torques[i];
-            Fext(j) = force[0];
-            V(j)    = velocity[0];
-            j++;
-            Fext(j) = force[1];
-            V(j)    = velocity[1];
-            j++;
-            Fext(j) = force[2];
-            V(j)    = velocity[2];
-            j++;
-            Fext(j) = torque[0];
-            V(j)    = angularVelocity[0];
-            j++;
-            Fext(j) = torque[1];
-            V(j)    = angularVelocity[1];
-            j++;
-            Fext(j) = torque[2];
-            V(j)    = angularVelocity[2];
-            j++;
+            if (bodies[k] == nullptr || !solveFor[k])
+            {
+                continue;
+            }
+            const StorageIndex location = m_locations[bodies[k]];
+            if (isStatic[location])
+            {
+                continue;
+            }
+            constraintBodies[k] = location;
+
+            Vec6d& jb = m_Jb[j * 2 + k];
+            jb.head<3>() = constraint->J.col(k * 2);
+            jb.tail<3>() = constraint->J.col(k * 2 + 1);
+
+            const Mat3d invInertia = invInteriaTensors[location].transpose();
+            Vec6d&      mjb        = m_MJb[j * 2 + k];
+            mjb.head<3>() = invMasses[location] * jb.head<3>();
+            mjb.tail<3>() = invInertia * jb.tail<3>();
+
+            m_b(j) -= jb.head<3>().dot(tentativeVelocities[location] / dt + invMasses[location] * forces[location])
+                      + jb.tail<3>().dot(tentativeAngularVelocities[location] / dt + invInertia * torques[location]);
         }
-        else
+        patternChanged |= (m_constraintBodies[j] != constraintBodies);
+        m_constraintBodies[j] = constraintBodies;
+
+        m_cu(j, 0) = constraint->range[0];
+        m_cu(j, 1) = constraint->range[1];
+
+        // Start from the impulse the same contact had last solve
+        m_guess(j) = 0.0;
+        if (warmStart && constraint->m_id != 0)
         {
-            for (StorageIndex k = 0; k < 6; k++)
+            auto iter = m_prevLambdas.find(constraint->m_id);
+            if (iter != m_prevLambdas.end())
             {
-                Fext(j + k) = 0.0;
-                V(j + k)    = 0.0;
+                m_guess(j) = iter->second;
             }
-            j += 6;
         }
+        j++;
     }
 
-    // Now construct the sparse jacobian matrix for every constraint (object vs constraint)
-    Eigen::SparseMatrix<double>         J(m_constraints.size(), state->size() * 6);
-    Eigen::VectorXd                     Vu(m_constraints.size());    // Push Factor
-    Eigen::MatrixXd                     cu(m_constraints.size(), 2); // Mins and maxes
-    std::vector<Eigen::Triplet<double>> JTriplets;
-    JTriplets.reserve(m_constraints.size() * 12);
-    j = 0;
-    for (std::list<std::shared_ptr<RbdConstraint>>::iterator iter = m_constraints.begin(); iter != m_constraints.end(); iter++)
+    // Only constraints sharing a body are coupled in A. Visit the block products
+    // J_r * Minv * J_c^T of every body in a fixed order for the current pattern
+    if (patternChanged)
     {
-        std::shared_ptr<RbdConstraint> constraint = *iter;
-        Vu(j) = constraint->vu;
-
-        // Object 1
-        StorageIndex k = 0;
-        if (constraint->m_obj1 != nullptr)
+        m_bodyConstraintOffsets.assign(numBodies + 1, 0);
+        for (const Vec2i& constraintBodies : m_constraintBodies)
         {
-            const StorageIndex obj1Location = m_locations[constraint->m_obj1.get()];
-            const StorageIndex start1       = obj1Location * 6;
-            for (StorageIndex c = 0; c < 2; c++)
+            for (int k = 0; k < 2; k++)
             {
-                for (StorageIndex r = 0; r < 3; r++)
+                if (constraintBodies[k] != -1)
                 {
-                    JTriplets.push_back(Eigen::Triplet<double>(j, start1 + k, constraint->J(r, c)));
-                    k++;
+                    m_bodyConstraintOffsets[constraintBodies[k] + 1]++;
                 }
             }
         }
-
-        // Object 2
-        if (constraint->m_obj2 != nullptr)
+        for (int i = 0; i < numBodies; i++)
         {
-            const StorageIndex obj2Location = m_locations[constraint->m_obj2.get()];
-            const StorageIndex start2       = obj2Location * 6;
-            k = 0;
-            for (StorageIndex c = 2; c < 4; c++)
+            m_bodyConstraintOffsets[i + 1] += m_bodyConstraintOffsets[i];
+        }
+        m_bodyConstraints.resize(m_bodyConstraintOffsets.back());
+        std::vector<int> fill(m_bodyConstraintOffsets.begin(), m_bodyConstraintOffsets.end() - 1);
+        for (int i = 0; i < numConstraints; i++)
+        {
+            for (int k = 0; k < 2; k++)
             {
-                for (StorageIndex r = 0; r < 3; r++)
+                if (m_constraintBodies[i][k] != -1)
                 {
-                    JTriplets.push_back(Eigen::Triplet<double>(j, start2 + k, constraint->J(r, c)));
-                    k++;
+                    m_bodyConstraints[fill[m_constraintBodies[i][k]]++] = Vec2i(i, i * 2 + k);
                 }
             }
         }
+    }
+    auto forEachBlockProduct = [&](auto&& func)
+                               {
+                                   for (int i = 0; i < numBodies; i++)
+                                   {
+                                       for (int r = m_bodyConstraintOffsets[i]; r < m_bodyConstraintOffsets[i + 1]; r++)
+                                       {
+                                           const Vec2i& row = m_bodyConstraints[r];
+                                           for (int c = m_bodyConstraintOffsets[i]; c < m_bodyConstraintOffsets[i + 1]; c++)
+                                           {
+                                               const Vec2i& col = m_bodyConstraints[c];
+                                               func(row[0], col[0], m_Jb[row[1]].dot(m_MJb[col[1]]));
+                                           }
+                                       }
+                                   }
+                               };
+
+    // Assemble A = J * Minv * J^T directly from the blocks
+    if (patternChanged)
+    {
+        std::vector<Eigen::Triplet<double>> ATriplets;
+        ATriplets.reserve(m_AValueIds.size());
+        forEachBlockProduct([&](const int r, const int c, const double value)
+            {
+                ATriplets.push_back(Eigen::Triplet<double>(r, c, value));
+            });
+        m_A.resize(numConstraints, numConstraints);
+        m_A.setFromTriplets(ATriplets.begin(), ATriplets.end());
+        m_A.makeCompressed();
+
+        // Remember where every product was summed so the next solves with the same
+        // pattern can write into the values directly
+        m_AValueIds.resize(ATriplets.size());
+        const StorageIndex* outerIds = m_A.outerIndexPtr();
+        const StorageIndex* innerIds = m_A.innerIndexPtr();
+        for (size_t i = 0; i < ATriplets.size(); i++)
+        {
+            const Eigen::Triplet<double>& triplet = ATriplets[i];
+            m_AValueIds[i] = static_cast<int>(std::lower_bound(innerIds + outerIds[triplet.col()],
+                innerIds + outerIds[triplet.col() + 1], triplet.row()) - innerIds);
+        }
+    }
+    else
+    {
+        double* values = m_A.valuePtr();
+        std::fill(values, values + m_A.nonZeros(), 0.0);
+        int i = 0;
+        forEachBlockProduct([&](const int, const int, const double value)
+            {
+                values[m_AValueIds[i++]] += value;
+            });
+    }
 
-        cu(j, 0) = constraint->range[0];
-        cu(j, 1) = constraint->range[1];
-        j++;
+    m_pgsSolver->setA(&m_A);
+    if (warmStart)
+    {
+        m_pgsSolver->setGuess(m_guess);
     }
-    J.setFromTriplets(JTriplets.begin(), JTriplets.end());
-
-    const double                dt = m_config->m_dt;
-    Eigen::SparseMatrix<double> A  = J * m_Minv * J.transpose();
-    Eigen::VectorXd             b  = Vu / dt - J * (V / dt + m_Minv * Fext);
-
-    /*std::cout << "Minv: " << std::endl << m_Minv.toDense() << std::endl;
-    std::cout << "J: " << std::endl << J.toDense() << std::endl;
-    std::cout << "A: " << std::endl << A.toDense() << std::endl;
-    std::cout << std::endl;
-    std::cout << "Vu: " << std::endl << Vu << std::endl;
-    std::cout << "V: " << std::endl << V << std::endl;
-    std::cout << "b: " << std::endl << b << std::endl;*/
-
-    m_pgsSolver->setA(&A);
-    //pgsSolver.setGuess(F); // Not using warm starting
     m_pgsSolver->setMaxIterations(m_config->m_maxNumIterations);
     m_pgsSolver->setEpsilon(m_config->m_epsilon);
-    F = J.transpose() * m_pgsSolver->solve(b, cu);   // Reaction force,torque
+    const Eigen::VectorXd& lambdas = m_pgsSolver->solve(m_b, m_cu);
 
-    // Apply reaction impulse
+    // Apply reaction impulse, F = J^T * lambda
+    m_prevLambdas.clear();
     j = 0;
-    for (size_t i = 0; i < state->size(); i++, j += 6)
+    for (const std::shared_ptr<RbdConstraint>& constraint : m_constraints)
     {
-        forces[i]  += Vec3d(F(j), F(j + 1), F(j + 2));
-        torques[i] += Vec3d(F(j + 3), F(j + 4), F(j + 5));
+        for (int k = 0; k < 2; k++)
+        {
+            const int location = m_constraintBodies[j][k];
+            if (location != -1)
+            {
+                const Vec6d& jb = m_Jb[j * 2 + k];
+                forces[location]  += lambdas(j) * jb.head<3>();
+                torques[location] += lambdas(j) * jb.tail<3>();
+            }
+        }
+        if (warmStart && constraint->m_id != 0)
+        {
+            m_prevLambdas[constraint->m_id] = lambdas(j);
+        }
+        j++;
     }
 
-    //std::cout << std::endl << "Forces/Torques: " << F << std::endl;
-
     m_constraints.clear();
 }
 
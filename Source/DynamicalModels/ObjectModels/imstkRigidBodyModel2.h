@@ -28,6 +28,8 @@ struct RigidBodyModel2Config
     double m_angularVelocityDamping = 1.0;
     double m_epsilon = 1e-4;
     int m_maxNumConstraints = -1;
+    bool m_warmStart = false;             ///< Start the solve from the previous frame's impulses of matching contacts, off by default as it changes results
+    double m_warmStartResolution = 0.001; ///< Contacts within this distance in the body frame match across frames
 };
 
 ///
@@ -74,6 +76,17 @@ public:
     ///
     void addConstraint(std::shared_ptr<RbdConstraint> constraint) { m_constraints.push_back(constraint); }
 
+    ///
+    /// \brief Computes an id for a contact on body1 that persists across frames
+    /// so long as the contact point stays in the same cell of size m_warmStartResolution
+    /// in the frame of body1. Give it to RbdConstraint::m_id to warm start the constraint
+    /// \param body1, body the contact point is on
+    /// \param body2, other body of the contact, nullptr if none
+    /// \param contactPt, contact point in world space
+    /// \param type, distinguishes constraints at the same contact (ie: contact and friction)
+    ///
+    size_t computeContactId(const RigidBody& body1, const RigidBody* body2, const Vec3d& contactPt, const int type) const;
+
     ///
     /// \brief Removes a body from the system, must call initialize for changes to effect
     ///
@@ -128,13 +141,23 @@ protected:
     std::shared_ptr<TaskNode> m_integrateNode;
 
     std::shared_ptr<ProjectedGaussSeidelSolver<double>> m_pgsSolver;
-    Eigen::SparseMatrix<double> m_Minv;
     std::list<std::shared_ptr<RbdConstraint>>    m_constraints;
     std::vector<std::shared_ptr<RigidBody>>      m_bodies;
     std::unordered_map<RigidBody*, StorageIndex> m_locations;
     bool   m_modified = true;
     size_t m_maxBodiesParallel = 10; // After 10 bodies, parallel for's are used
 
-    Eigen::VectorXd F;               // Reaction forces
+    // Constraint system, kept between solves so its memory and sparsity pattern are reused
+    std::vector<Vec2i> m_constraintBodies;                     ///< Dynamic bodies of every constraint, -1 if none
+    std::vector<Vec6d, Eigen::aligned_allocator<Vec6d>> m_Jb;  ///< Jacobian blocks, 2 per constraint
+    std::vector<Vec6d, Eigen::aligned_allocator<Vec6d>> m_MJb; ///< Inverse mass times jacobian blocks
+    std::vector<int>            m_bodyConstraintOffsets;       ///< Start of every body in m_bodyConstraints
+    std::vector<Vec2i>          m_bodyConstraints;             ///< (constraint, block) of every body
+    std::vector<int>            m_AValueIds;                   ///< Value index in m_A of every block product
+    Eigen::SparseMatrix<double> m_A;                           ///< J*Minv*J^T
+    Eigen::VectorXd m_b;
+    Eigen::MatrixXd m_cu;                                      ///< Mins and maxes
+    Eigen::VectorXd m_guess;
+    std::unordered_map<size_t, double> m_prevLambdas;          ///< Impulses of the previous solve by constraint id
 };
 } // namespace imstk
@@ -7,11 +7,49 @@
 #include "imstkSphModel.h"
 #include "imstkParallelUtils.h"
 #include "imstkPointSet.h"
+#include "imstkSpinLock.h"
 #include "imstkTaskGraph.h"
 #include "imstkVTKMeshIO.h"
 
 namespace imstk
 {
+namespace
+{
+///
+/// \brief Spreads the lower 10 bits of v so there are two zero bits between each
+///
+unsigned int
+expandBits(unsigned int v)
+{
+    v &= 0x3ff;
+    v  = (v | (v << 16)) & 0x030000FF;
+    v  = (v | (v << 8)) & 0x0300F00F;
+    v  = (v | (v << 4)) & 0x030C30C3;
+    v  = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+///
+/// \brief Reorders data such that data[i] becomes data[order[i]]
+///
+template<typename T, typename ArrayType>
+void
+reorder(ArrayType& data, const std::vector<size_t>& order)
+{
+    std::vector<T> sorted(order.size());
+    ParallelUtils::parallelFor(order.size(),
+        [&](const size_t i)
+        {
+            sorted[i] = data[order[i]];
+        });
+    ParallelUtils::parallelFor(order.size(),
+        [&](const size_t i)
+        {
+            data[i] = sorted[i];
+        });
+}
+} // namespace
+
 SphModelConfig::SphModelConfig(const double particleRadius)
 {
     // \todo Warning in all paths?
@@ -119,6 +157,19 @@ SphModel::SphModel() : DynamicalModel<SphState>(DynamicalModelType::SmoothedPart
                 moveParticles(getTimeStep());
         });
 
+    // Used instead of the above when sub-stepping
+    m_advanceNode =
+        m_taskGraph->addFunction("SPHModel_Advance", [&]()
+            {
+                advance(m_defaultDt);
+        });
+
+    // Used instead of the above when the fluid is stepped on its own thread
+    m_syncParticlesNode =
+        m_taskGraph->addFunction("SPHModel_SyncParticles", std::bind(&SphModel::syncParticles, this));
+
+    m_bufferLock = std::make_shared<ParallelUtils::SpinLock>();
+
     //m_computePositionNode =
     //    m_taskGraph->addFunction("SPHModel_ComputePositions", [&]()
     //    {
@@ -146,8 +197,15 @@ SphModel::initialize()
     // Copy current to initial
     m_initialState->setState(m_currentState);
 
-    // Share geometry and state position arrays
-    m_currentState->setPositions(m_pointSetGeometry->getVertexPositions());
+    // Share geometry and state position arrays, unless stepped on another thread
+    if (m_asyncStepping)
+    {
+        m_currentState->setPositions(std::make_shared<VecDataArray<double, 3>>(*m_pointSetGeometry->getVertexPositions()));
+    }
+    else
+    {
+        m_currentState->setPositions(m_pointSetGeometry->getVertexPositions());
+    }
     m_initialState->setPositions(m_pointSetGeometry->getInitialVertexPositions());
 
     // Initialize simulation dependent parameters and kernel data
@@ -156,6 +214,8 @@ SphModel::initialize()
     // Initialize neighbor searcher
     m_neighborSearcher = std::make_shared<NeighborSearch>(m_modelParameters->m_neighborSearchMethod,
       m_modelParameters->m_kernelRadius);
+    m_boundaryNeighborSearcher = std::make_shared<NeighborSearch>(m_modelParameters->m_neighborSearchMethod,
+      m_modelParameters->m_kernelRadius);
 
     m_pressureAccels = std::make_shared<VecDataArray<double, 3>>(numParticles);
     std::fill_n(m_pressureAccels->getPointer(), m_pressureAccels->size(), Vec3d(0, 0, 0));
@@ -173,22 +233,100 @@ SphModel::initialize()
     m_particleShift = std::make_shared<VecDataArray<double, 3>>(numParticles);
     std::fill_n(m_particleShift->getPointer(), m_particleShift->size(), Vec3d(0, 0, 0));
 
-    // Add all the attributes to the geometry
-    m_pointSetGeometry->setVertexAttribute("Pressure Accels", m_pressureAccels);
-    m_pointSetGeometry->setVertexAttribute("Surface Tension Accels", m_surfaceTensionAccels);
-    m_pointSetGeometry->setVertexAttribute("Viscous Accels", m_viscousAccels);
-    m_pointSetGeometry->setVertexAttribute("Densities", m_currentState->getDensities());
-    m_pointSetGeometry->setVertexAttribute("Velocities", m_currentState->getVelocities());
-    m_pointSetGeometry->setVertexAttribute("Diffuse Velocities", m_currentState->getDiffuseVelocities());
-    m_pointSetGeometry->setVertexAttribute("Normals", m_currentState->getNormals());
-    m_pointSetGeometry->setVertexAttribute("Accels", m_currentState->getAccelerations());
+    m_particleIds.resize(numParticles);
+    for (size_t i = 0; i < m_particleIds.size(); i++)
+    {
+        m_particleIds[i] = i;
+    }
+
+    if (m_asyncStepping)
+    {
+        m_fluidBuffer = std::make_shared<ParticleBuffer>();
+        writeParticleBuffer(*m_fluidBuffer);
+        m_sharedBuffer = std::make_shared<ParticleBuffer>(*m_fluidBuffer);
+        m_sceneBuffer  = std::make_shared<ParticleBuffer>(*m_fluidBuffer);
+        m_sharedBufferModified = false;
+        m_queuedCorrections.clear();
+    }
+
+    // Add all the attributes to the geometry, copies of them when the fluid thread
+    // writes the state, the published attributes are synced into
+    auto geometryAttribute = [this](auto dataArray)
+                             {
+                                 using ArrayType = typename decltype(dataArray)::element_type;
+                                 return m_asyncStepping ? std::make_shared<ArrayType>(*dataArray) : dataArray;
+                             };
+    m_pointSetGeometry->setVertexAttribute("Pressure Accels", geometryAttribute(m_pressureAccels));
+    m_pointSetGeometry->setVertexAttribute("Surface Tension Accels", geometryAttribute(m_surfaceTensionAccels));
+    m_pointSetGeometry->setVertexAttribute("Viscous Accels", geometryAttribute(m_viscousAccels));
+    m_pointSetGeometry->setVertexAttribute("Densities", geometryAttribute(m_currentState->getDensities()));
+    m_pointSetGeometry->setVertexAttribute("Velocities", geometryAttribute(m_currentState->getVelocities()));
+    m_pointSetGeometry->setVertexAttribute("Diffuse Velocities", geometryAttribute(m_currentState->getDiffuseVelocities()));
+    m_pointSetGeometry->setVertexAttribute("Normals", geometryAttribute(m_currentState->getNormals()));
+    m_pointSetGeometry->setVertexAttribute("Accels", geometryAttribute(m_currentState->getAccelerations()));
 
     return true;
 }
 
+void
+SphModel::resetToInitialState()
+{
+    if (m_asyncStepping)
+    {
+        m_resetRequested = true;
+    }
+    else
+    {
+        resetState();
+    }
+}
+
+void
+SphModel::resetState()
+{
+    // The initial state is in the original particle order, so are the boundary conditions
+    if (m_sphBoundaryConditions)
+    {
+        std::vector<SphBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
+        std::vector<SphBoundaryConditions::ParticleType>  originalTypes(particleTypes.size());
+        for (size_t i = 0; i < m_particleIds.size(); i++)
+        {
+            originalTypes[m_particleIds[i]] = particleTypes[i];
+        }
+        particleTypes = originalTypes;
+        for (size_t& bufferIndex : m_sphBoundaryConditions->getBufferIndices())
+        {
+            bufferIndex = m_particleIds[bufferIndex];
+        }
+    }
+    for (size_t i = 0; i < m_particleIds.size(); i++)
+    {
+        m_particleIds[i] = i;
+    }
+
+    this->m_currentState->setState(this->m_initialState);
+    m_remainingTime = 0.0;
+}
+
 void
 SphModel::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared_ptr<TaskNode> sink)
 {
+    // The fluid is stepped elsewhere, only pick up its latest positions
+    if (m_asyncStepping)
+    {
+        m_taskGraph->addEdge(source, m_syncParticlesNode);
+        m_taskGraph->addEdge(m_syncParticlesNode, sink);
+        return;
+    }
+
+    // The sub-steps run in one node
+    if (m_modelParameters->m_maxNumSubsteps > 0)
+    {
+        m_taskGraph->addEdge(source, m_advanceNode);
+        m_taskGraph->addEdge(m_advanceNode, sink);
+        return;
+    }
+
     // Setup graph connectivity
     m_taskGraph->addEdge(source, m_findParticleNeighborsNode);
     m_taskGraph->addEdge(m_findParticleNeighborsNode, m_computeDensityNode);
@@ -240,56 +378,154 @@ SphModel::computeCFLTimeStepSize()
 }
 
 void
-SphModel::findParticleNeighbors()
+SphModel::sortParticles()
 {
-    m_neighborSearcher->getNeighbors(getCurrentState()->getFluidNeighborLists(), *getCurrentState()->getPositions());
+    std::shared_ptr<SphState> state = getCurrentState();
+    const size_t              numParticles = state->getNumParticles();
+    if (numParticles == 0)
+    {
+        return;
+    }
+
+    // Grid of kernel sized cells over the particles, coarsened when 10 bits per axis can't cover it
+    Vec3d lowerCorner, upperCorner;
+    ParallelUtils::findAABB(*state->getPositions(), lowerCorner, upperCorner);
+    const double cellSize = std::max(m_modelParameters->m_kernelRadius, (upperCorner - lowerCorner).maxCoeff() / 1023.0);
+
+    const VecDataArray<double, 3>&              positions = *state->getPositions();
+    std::vector<std::pair<unsigned int, size_t>> mortonCodes(numParticles);
+    ParallelUtils::parallelFor(numParticles,
+        [&](const size_t p)
+        {
+            const Vec3d cell = (positions[p] - lowerCorner) / cellSize;
+            mortonCodes[p] = { (expandBits(static_cast<unsigned int>(cell[0])) << 2)
+                               | (expandBits(static_cast<unsigned int>(cell[1])) << 1)
+                               | expandBits(static_cast<unsigned int>(cell[2])), p };
+        });
+    tbb::parallel_sort(mortonCodes.begin(), mortonCodes.end());
+
+    std::vector<size_t> order(numParticles);
+    std::vector<size_t> newIndices(numParticles);
+    for (size_t i = 0; i < numParticles; i++)
+    {
+        order[i] = mortonCodes[i].second;
+        newIndices[order[i]] = i;
+    }
 
-    if (m_modelParameters->m_bDensityWithBoundary)   // if considering boundary particles for computing fluid density
+    // Per particle data of the state and the model, the arrays are shared with the geometry
+    // unless the fluid is stepped asynchronously
+    reorder<Vec3d>(*state->getPositions(), order);
+    reorder<Vec3d>(*state->getVelocities(), order);
+    reorder<Vec3d>(*state->getHalfStepVelocities(), order);
+    reorder<Vec3d>(*state->getFullStepVelocities(), order);
+    reorder<double>(*state->getDensities(), order);
+    reorder<Vec3d>(*state->getNormals(), order);
+    reorder<Vec3d>(*state->getAccelerations(), order);
+    reorder<Vec3d>(*state->getDiffuseVelocities(), order);
+    reorder<Vec3d>(*m_pressureAccels, order);
+    reorder<Vec3d>(*m_surfaceTensionAccels, order);
+    reorder<Vec3d>(*m_viscousAccels, order);
+    reorder<Vec3d>(*m_neighborVelContr, order);
+    reorder<Vec3d>(*m_particleShift, order);
+    reorder<size_t>(m_particleIds, order);
+
+    if (m_sphBoundaryConditions)
     {
-        m_neighborSearcher->getNeighbors(getCurrentState()->getBoundaryNeighborLists(),
-            *getCurrentState()->getPositions(),
-            *getCurrentState()->getBoundaryParticlePositions());
+        reorder<SphBoundaryConditions::ParticleType>(m_sphBoundaryConditions->getParticleTypes(), order);
+        for (size_t& bufferIndex : m_sphBoundaryConditions->getBufferIndices())
+        {
+            bufferIndex = newIndices[bufferIndex];
+        }
     }
+
+    state->getPositions()->postModified();
 }
 
 void
-SphModel::computeNeighborRelativePositions()
+SphModel::findParticleNeighbors()
 {
-    auto computeRelativePositions = [&](const Vec3d& ppos, const std::vector<size_t>& neighborList,
-                                        const VecDataArray<double, 3>& allPositions, std::vector<NeighborInfo>& neighborInfo)
-                                    {
-                                        for (const size_t q : neighborList)
-                                        {
-                                            const Vec3d& qpos = allPositions[q];
-                                            const Vec3d  r    = ppos - qpos;
-                                            neighborInfo.push_back({ r, m_modelParameters->m_restDensity });
-                                        }
-                                    };
+    std::shared_ptr<SphState> state = getCurrentState();
+    const size_t              numParticles = state->getNumParticles();
 
-    std::shared_ptr<VecDataArray<double, 3>> positionsPtr = getCurrentState()->getPositions();
-    const VecDataArray<double, 3>&           positions = *positionsPtr;
+    if (m_modelParameters->m_zOrderSortPeriod > 0 && m_timeStepCount % m_modelParameters->m_zOrderSortPeriod == 0)
+    {
+        sortParticles();
+    }
+
+    const VecDataArray<double, 3>& positions    = *state->getPositions();
+    const bool                     withBoundary = m_modelParameters->m_bDensityWithBoundary;
+    m_neighborSearcher->setPoints(positions);
+    if (withBoundary)   // if considering boundary particles for computing fluid density
+    {
+        m_boundaryNeighborSearcher->setPoints(*state->getBoundaryParticlePositions());
+    }
 
-    std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
+    // Search the neighbors straight into the packed arrays, count the neighbors of
+    // every particle, prefix sum the counts into offsets then write them in place
+    std::vector<size_t>& offsets   = state->getNeighborOffsets();
+    std::vector<size_t>& fluidEnds = state->getFluidNeighborEnds();
+    offsets.resize(numParticles + 1);
+    fluidEnds.resize(numParticles);
 
-    ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
+    offsets[0] = 0;
+    ParallelUtils::parallelFor(numParticles,
         [&](const size_t p)
         {
             if (m_sphBoundaryConditions
                 && m_sphBoundaryConditions->getParticleTypes()[p] == SphBoundaryConditions::ParticleType::Buffer)
             {
+                offsets[p + 1] = 0;
                 return;
             }
+            offsets[p + 1] = m_neighborSearcher->countNeighbors(positions[p])
+                             + (withBoundary ? m_boundaryNeighborSearcher->countNeighbors(positions[p]) : 0);
+        });
+    ParallelUtils::inclusiveScan(offsets);
 
-            const Vec3d& ppos = positions[p];
-            std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            neighborInfo.resize(0);
-            neighborInfo.reserve(48);
+    std::vector<size_t>& neighborIds = state->getNeighborIds();
+    neighborIds.resize(offsets[numParticles]);
+    state->getNeighborInfo().resize(offsets[numParticles]);
+    ParallelUtils::parallelFor(numParticles,
+        [&](const size_t p)
+        {
+            fluidEnds[p] = offsets[p];
+            if (offsets[p] == offsets[p + 1])
+            {
+                return;
+            }
+            fluidEnds[p] += m_neighborSearcher->getNeighbors(positions[p], neighborIds.data() + offsets[p]);
+            if (withBoundary)
+            {
+                m_boundaryNeighborSearcher->getNeighbors(positions[p], neighborIds.data() + fluidEnds[p]);
+            }
+        });
+}
 
-            computeRelativePositions(ppos, getCurrentState()->getFluidNeighborLists()[p], *getCurrentState()->getPositions(), neighborInfo);
+void
+SphModel::computeNeighborRelativePositions()
+{
+    std::shared_ptr<SphState>      state     = getCurrentState();
+    const VecDataArray<double, 3>& positions = *state->getPositions();
+    const VecDataArray<double, 3>& boundaryPositions = *state->getBoundaryParticlePositions();
+
+    const std::vector<size_t>& offsets     = state->getNeighborOffsets();
+    const std::vector<size_t>& fluidEnds   = state->getFluidNeighborEnds();
+    const std::vector<size_t>& neighborIds = state->getNeighborIds();
+    std::vector<NeighborInfo>& neighborInfo = state->getNeighborInfo();
+
+    // Buffer particles have no neighbors, nothing to skip
+    ParallelUtils::parallelFor(state->getNumParticles(),
+        [&](const size_t p)
+        {
+            const Vec3d& ppos = positions[p];
+            for (size_t i = offsets[p]; i < fluidEnds[p]; i++)
+            {
+                neighborInfo[i] = { ppos - positions[neighborIds[i]], m_modelParameters->m_restDensity };
+            }
             // if considering boundary particles then also cache relative positions with them
-            if (m_modelParameters->m_bDensityWithBoundary)
+            for (size_t i = fluidEnds[p]; i < offsets[p + 1]; i++)
             {
-                computeRelativePositions(ppos, getCurrentState()->getBoundaryNeighborLists()[p], *getCurrentState()->getBoundaryParticlePositions(), neighborInfo);
+                neighborInfo[i] = { ppos - boundaryPositions[neighborIds[i]], m_modelParameters->m_restDensity };
             }
       });
 }
@@ -303,28 +539,22 @@ SphModel::collectNeighborDensity()
     std::shared_ptr<DataArray<double>> densitiesPtr = getCurrentState()->getDensities();
     DataArray<double>&                 densities    = *densitiesPtr;
 
-    const std::vector<std::vector<size_t>>&                 neighborLists = getCurrentState()->getFluidNeighborLists();
-    const std::vector<SphBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
+    const std::vector<size_t>& offsets      = getCurrentState()->getNeighborOffsets();
+    const std::vector<size_t>& fluidEnds    = getCurrentState()->getFluidNeighborEnds();
+    const std::vector<size_t>& neighborIds  = getCurrentState()->getNeighborIds();
+    std::vector<NeighborInfo>& neighborInfo = getCurrentState()->getNeighborInfo();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
         {
-            if (m_sphBoundaryConditions && particleTypes[p] == SphBoundaryConditions::ParticleType::Buffer)
-            {
-                return;
-            }
-
-            auto& neighborInfo = getCurrentState()->getNeighborInfo()[p];
-            if (neighborInfo.size() <= 1)
+            if (offsets[p + 1] - offsets[p] <= 1)
             {
                 return; // the particle has no neighbor
             }
 
-            const auto& fluidNeighborList = neighborLists[p];
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (size_t i = offsets[p]; i < fluidEnds[p]; ++i)
             {
-                auto q = fluidNeighborList[i];
-                neighborInfo[i].density = densities[q];
+                neighborInfo[i].density = densities[neighborIds[i]];
             }
       });
 }
@@ -335,26 +565,21 @@ SphModel::computeDensity()
     std::shared_ptr<DataArray<double>> densitiesPtr = getCurrentState()->getDensities();
     DataArray<double>&                 densities    = *densitiesPtr;
 
-    const std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<size_t>&       offsets      = getCurrentState()->getNeighborOffsets();
+    const std::vector<NeighborInfo>& neighborInfo = getCurrentState()->getNeighborInfo();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
         {
-            if (m_sphBoundaryConditions && m_sphBoundaryConditions->getParticleTypes()[p] == SphBoundaryConditions::ParticleType::Buffer)
-            {
-                return;
-            }
-
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (offsets[p + 1] - offsets[p] <= 1)
             {
                 return; // the particle has no neighbor
             }
 
             double pdensity = 0.0;
-            for (const auto& qInfo : neighborInfo)
+            for (size_t i = offsets[p]; i < offsets[p + 1]; ++i)
             {
-                pdensity += m_kernels.W(qInfo.relativePos);
+                pdensity += m_kernels.W(neighborInfo[i].relativePos);
             }
             pdensity    *= m_modelParameters->m_particleMass;
             densities[p] = pdensity;
@@ -384,33 +609,27 @@ SphModel::normalizeDensity()
     std::shared_ptr<DataArray<double>> densitiesPtr = getCurrentState()->getDensities();
     DataArray<double>&                 densities    = *densitiesPtr;
 
-    const std::vector<std::vector<size_t>>&                 neighborLists = getCurrentState()->getFluidNeighborLists();
-    const std::vector<std::vector<NeighborInfo>>&           neighborInfos = getCurrentState()->getNeighborInfo();
-    const std::vector<SphBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
+    const std::vector<size_t>&       offsets      = getCurrentState()->getNeighborOffsets();
+    const std::vector<size_t>&       fluidEnds    = getCurrentState()->getFluidNeighborEnds();
+    const std::vector<size_t>&       neighborIds  = getCurrentState()->getNeighborIds();
+    const std::vector<NeighborInfo>& neighborInfo = getCurrentState()->getNeighborInfo();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
         {
-            if (m_sphBoundaryConditions && particleTypes[p] == SphBoundaryConditions::ParticleType::Buffer)
-            {
-                return;
-            }
-
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (offsets[p + 1] - offsets[p] <= 1)
             {
                 return; // the particle has no neighbor
             }
 
-            const auto& fluidNeighborList = neighborLists[p];
             double tmp = 0.0;
 
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (size_t i = offsets[p]; i < fluidEnds[p]; ++i)
             {
                 const auto& qInfo = neighborInfo[i];
 
                 // because we're not done with density computation, qInfo does not contain desity of particle q yet
-                const auto q = fluidNeighborList[i];
+                const auto q = neighborIds[i];
                 const auto qdensity = densities[q];
                 tmp += m_kernels.W(qInfo.relativePos) / qdensity;
             }
@@ -426,20 +645,20 @@ SphModel::computePressureAcceleration()
     const DataArray<double>&           densities      = *densitiesPtr;
     VecDataArray<double, 3>&           pressureAccels = *m_pressureAccels;
 
-    const std::vector<std::vector<NeighborInfo>>&           neighborInfos = getCurrentState()->getNeighborInfo();
-    const std::vector<SphBoundaryConditions::ParticleType>& particleTypes = m_sphBoundaryConditions->getParticleTypes();
+    const std::vector<size_t>&       offsets      = getCurrentState()->getNeighborOffsets();
+    const std::vector<NeighborInfo>& neighborInfo = getCurrentState()->getNeighborInfo();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
         {
-            if (m_sphBoundaryConditions && particleTypes[p] == SphBoundaryConditions::ParticleType::Buffer)
+            if (m_sphBoundaryConditions
+                && m_sphBoundaryConditions->getParticleTypes()[p] == SphBoundaryConditions::ParticleType::Buffer)
             {
                 return;
             }
 
             Vec3d accel = Vec3d::Zero();
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (offsets[p + 1] - offsets[p] <= 1)
             {
                 pressureAccels[p] = accel;
                 return;
@@ -448,7 +667,7 @@ SphModel::computePressureAcceleration()
             const auto pdensity  = densities[p];
             const auto ppressure = getParticlePressure(pdensity);
 
-            for (size_t idx = 0; idx < neighborInfo.size(); ++idx)
+            for (size_t idx = offsets[p]; idx < offsets[p + 1]; ++idx)
             {
                 const auto& qInfo    = neighborInfo[idx];
                 const auto r         = qInfo.relativePos;
@@ -473,8 +692,10 @@ SphModel::computeViscosity()
     VecDataArray<double, 3>&       particleShift      = *m_particleShift;
     const VecDataArray<double, 3>& halfStepVelocities = *getCurrentState()->getHalfStepVelocities();
 
-    const std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
-    const std::vector<std::vector<size_t>>&       neighborLists = getCurrentState()->getFluidNeighborLists();
+    const std::vector<size_t>&       offsets      = getCurrentState()->getNeighborOffsets();
+    const std::vector<size_t>&       fluidEnds    = getCurrentState()->getFluidNeighborEnds();
+    const std::vector<size_t>&       neighborIds  = getCurrentState()->getNeighborIds();
+    const std::vector<NeighborInfo>& neighborInfo = getCurrentState()->getNeighborInfo();
 
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
@@ -486,8 +707,7 @@ SphModel::computeViscosity()
                 return;
             }
 
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (offsets[p + 1] - offsets[p] <= 1)
             {
                 neighborVelContr[p] = Vec3d::Zero();
                 viscousAccels[p]    = Vec3d::Zero();
@@ -499,12 +719,11 @@ SphModel::computeViscosity()
             Vec3d particleShifts = Vec3d::Zero();
 
             const Vec3d& pvel = halfStepVelocities[p];
-            const std::vector<size_t>& fluidNeighborList = neighborLists[p];
 
             Vec3d diffuseFluid = Vec3d::Zero();
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (size_t i = offsets[p]; i < fluidEnds[p]; ++i)
             {
-                const auto q        = fluidNeighborList[i];
+                const auto q        = neighborIds[i];
                 const auto& qvel    = halfStepVelocities[q];
                 const auto& qInfo   = neighborInfo[i];
                 const auto r        = qInfo.relativePos;
@@ -532,7 +751,10 @@ SphModel::computeSurfaceTension()
 {
     VecDataArray<double, 3>& surfaceNormals = *getCurrentState()->getNormals();
 
-    const std::vector<std::vector<NeighborInfo>>& neighborInfos = getCurrentState()->getNeighborInfo();
+    const std::vector<size_t>&       offsets      = getCurrentState()->getNeighborOffsets();
+    const std::vector<size_t>&       fluidEnds    = getCurrentState()->getFluidNeighborEnds();
+    const std::vector<size_t>&       neighborIds  = getCurrentState()->getNeighborIds();
+    const std::vector<NeighborInfo>& neighborInfo = getCurrentState()->getNeighborInfo();
 
     // First, compute surface normal for all particles
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
@@ -544,14 +766,13 @@ SphModel::computeSurfaceTension()
             }
 
             Vec3d n(0.0, 0.0, 0.0);
-            const std::vector<NeighborInfo>& neighborInfo = neighborInfos[p];
-            if (neighborInfo.size() <= 1)
+            if (offsets[p + 1] - offsets[p] <= 1)
             {
                 surfaceNormals[p] = n;
                 return;
             }
 
-            for (size_t i = 0; i < neighborInfo.size(); ++i)
+            for (size_t i = offsets[p]; i < offsets[p + 1]; ++i)
             {
                 const auto& qInfo   = neighborInfo[i];
                 const auto r        = qInfo.relativePos;
@@ -566,8 +787,6 @@ SphModel::computeSurfaceTension()
     VecDataArray<double, 3>& surfaceTensionAccels = *m_surfaceTensionAccels;
     const DataArray<double>& densities = *getCurrentState()->getDensities();
 
-    const std::vector<std::vector<size_t>>& neighborLists = getCurrentState()->getFluidNeighborLists();
-
     // Second, compute surface tension acceleration
     ParallelUtils::parallelFor(getCurrentState()->getNumParticles(),
         [&](const size_t p)
@@ -579,20 +798,18 @@ SphModel::computeSurfaceTension()
                 return;
             }
 
-            const std::vector<size_t>& fluidNeighborList = neighborLists[p];
-            if (fluidNeighborList.size() <= 1)
+            if (fluidEnds[p] - offsets[p] <= 1)
             {
                 return; // the particle has no neighbor
             }
 
-            const Vec3d& ni          = surfaceNormals[p];
-            const double pdensity    = densities[p];
-            const auto& neighborInfo = neighborInfos[p];
+            const Vec3d& ni       = surfaceNormals[p];
+            const double pdensity = densities[p];
 
             Vec3d accel = Vec3d::Zero();
-            for (size_t i = 0; i < fluidNeighborList.size(); ++i)
+            for (size_t i = offsets[p]; i < fluidEnds[p]; ++i)
             {
-                const size_t q = fluidNeighborList[i];
+                const size_t q = neighborIds[i];
                 if (p == q)
                 {
                     continue;
@@ -751,6 +968,189 @@ SphModel::moveParticles(const double timestep)
     m_timeStepCount++;
 }
 
+void
+SphModel::step(const double timestep)
+{
+    findParticleNeighbors();
+    computeNeighborRelativePositions();
+    computeDensity();
+    normalizeDensity();
+    collectNeighborDensity();
+    computePressureAcceleration();
+    computeSurfaceTension();
+    computeViscosity();
+    sumAccels();
+    updateVelocity(timestep);
+    moveParticles(timestep);
+}
+
+void
+SphModel::advance(const double dt)
+{
+    applyQueuedCorrections();
+
+    const int maxNumSubsteps = std::max(m_modelParameters->m_maxNumSubsteps, 1);
+    double    remainingTime  = dt;
+    m_numSubsteps = 0;
+    if (m_timeStepSizeType == TimeSteppingType::Fixed)
+    {
+        // Whole sub-steps of the default time step, carry over what is short of one
+        remainingTime += m_remainingTime;
+        for (; m_numSubsteps < maxNumSubsteps && remainingTime >= m_defaultDt * (1.0 - 1.0e-6); m_numSubsteps++)
+        {
+            m_dt = m_defaultDt;
+            step(m_dt);
+            remainingTime -= m_dt;
+        }
+        // Past the cap the time is dropped as with the other stepping
+        m_remainingTime = (remainingTime < m_defaultDt * (1.0 - 1.0e-6)) ? remainingTime : 0.0;
+        remainingTime  -= m_remainingTime;
+    }
+    else
+    {
+        for (; m_numSubsteps < maxNumSubsteps && remainingTime > 0.0; m_numSubsteps++)
+        {
+            // Spread the remaining time evenly over the sub-steps the CFL condition asks for
+            const double numSubsteps = std::max(std::ceil(remainingTime / computeCFLTimeStepSize() - 1.0e-6), 1.0);
+            m_dt = remainingTime / numSubsteps;
+            step(m_dt);
+            remainingTime -= m_dt;
+        }
+    }
+
+    if (remainingTime > 1.0e-12)
+    {
+        LOG_IF(WARNING, m_droppedTime == 0.0) << "SphModel hit its cap of " << maxNumSubsteps
+                                              << " sub-steps, the fluid runs slower than real time";
+        m_droppedTime += remainingTime;
+    }
+
+    if (m_asyncStepping)
+    {
+        if (m_resetRequested)
+        {
+            // Corrections queued before the reset refer to particles that moved since
+            m_bufferLock->lock();
+            m_queuedCorrections.clear();
+            m_bufferLock->unlock();
+
+            resetState();
+            m_resetRequested = false;
+        }
+        publishParticles();
+    }
+}
+
+void
+SphModel::writeParticleBuffer(ParticleBuffer& buffer)
+{
+    std::shared_ptr<SphState> state = getCurrentState();
+    buffer.positions            = *state->getPositions();
+    buffer.velocities           = *state->getVelocities();
+    buffer.diffuseVelocities    = *state->getDiffuseVelocities();
+    buffer.normals              = *state->getNormals();
+    buffer.accelerations        = *state->getAccelerations();
+    buffer.densities            = *state->getDensities();
+    buffer.pressureAccels       = *m_pressureAccels;
+    buffer.surfaceTensionAccels = *m_surfaceTensionAccels;
+    buffer.viscousAccels        = *m_viscousAccels;
+    buffer.particleIds          = m_particleIds;
+}
+
+void
+SphModel::publishParticles()
+{
+    writeParticleBuffer(*m_fluidBuffer);
+
+    m_bufferLock->lock();
+    std::swap(m_fluidBuffer, m_sharedBuffer);
+    m_sharedBufferModified = true;
+    m_bufferLock->unlock();
+}
+
+void
+SphModel::syncParticles()
+{
+    m_bufferLock->lock();
+    const bool modified = m_sharedBufferModified;
+    if (modified)
+    {
+        std::swap(m_sceneBuffer, m_sharedBuffer);
+        m_sharedBufferModified = false;
+    }
+    m_bufferLock->unlock();
+
+    if (modified)
+    {
+        *m_pointSetGeometry->getVertexPositions() = m_sceneBuffer->positions;
+        m_pointSetGeometry->getVertexPositions()->postModified();
+
+        auto syncAttribute = [this](const std::string& name, const auto& publishedArray)
+                             {
+                                 using ArrayType = std::decay_t<decltype(publishedArray)>;
+                                 auto dataArray  = std::dynamic_pointer_cast<ArrayType>(m_pointSetGeometry->getVertexAttribute(name));
+                                 if (dataArray != nullptr)
+                                 {
+                                     *dataArray = publishedArray;
+                                     dataArray->postModified();
+                                 }
+                             };
+        syncAttribute("Pressure Accels", m_sceneBuffer->pressureAccels);
+        syncAttribute("Surface Tension Accels", m_sceneBuffer->surfaceTensionAccels);
+        syncAttribute("Viscous Accels", m_sceneBuffer->viscousAccels);
+        syncAttribute("Densities", m_sceneBuffer->densities);
+        syncAttribute("Velocities", m_sceneBuffer->velocities);
+        syncAttribute("Diffuse Velocities", m_sceneBuffer->diffuseVelocities);
+        syncAttribute("Normals", m_sceneBuffer->normals);
+        syncAttribute("Accels", m_sceneBuffer->accelerations);
+    }
+}
+
+void
+SphModel::queueParticleCorrections(const std::vector<std::pair<size_t, Vec3d>>& corrections, ParticleCorrectionFunc func)
+{
+    // The fluid may have reordered its particles since, keep the initial index
+    std::vector<std::pair<size_t, Vec3d>> queuedCorrections(corrections.size());
+    for (size_t i = 0; i < corrections.size(); i++)
+    {
+        queuedCorrections[i] = { m_sceneBuffer->particleIds[corrections[i].first], corrections[i].second };
+    }
+
+    m_bufferLock->lock();
+    m_queuedCorrections.push_back({ func, std::move(queuedCorrections) });
+    m_bufferLock->unlock();
+}
+
+void
+SphModel::applyQueuedCorrections()
+{
+    std::vector<std::pair<ParticleCorrectionFunc, std::vector<std::pair<size_t, Vec3d>>>> queuedCorrections;
+    m_bufferLock->lock();
+    std::swap(queuedCorrections, m_queuedCorrections);
+    m_bufferLock->unlock();
+    if (queuedCorrections.empty())
+    {
+        return;
+    }
+
+    std::vector<size_t> currentIndices(m_particleIds.size());
+    for (size_t i = 0; i < m_particleIds.size(); i++)
+    {
+        currentIndices[m_particleIds[i]] = i;
+    }
+
+    VecDataArray<double, 3>& positions  = *getCurrentState()->getPositions();
+    VecDataArray<double, 3>& velocities = *getCurrentState()->getVelocities();
+    for (const auto& funcAndCorrections : queuedCorrections)
+    {
+        for (const auto& correction : funcAndCorrections.second)
+        {
+            const size_t p = currentIndices[correction.first];
+            funcAndCorrections.first(positions[p], velocities[p], correction.second);
+        }
+    }
+}
+
 double
 SphModel::getParticlePressure(const double density)
 {
@@ -12,10 +12,14 @@
 #include "imstkNeighborSearch.h"
 #include "imstkSphBoundaryConditions.h"
 
+#include <atomic>
+
 namespace imstk
 {
 class PointSet;
 
+namespace ParallelUtils { class SpinLock; }
+
 ///
 /// \class SphModelConfig
 ///
@@ -35,6 +39,13 @@ public:
     double m_maxTimestep = 1.0e-3;
     double m_cflFactor   = 1.0;
 
+    ///
+    /// When > 0 every step advances the fluid by the default time step in sub-steps, at
+    /// most this many, see SphModel::advance. Time left over once the cap is hit is
+    /// dropped so the fluid stays stable but runs slower than the requested time step
+    ///
+    int m_maxNumSubsteps = 0;
+
     // particle parameters
     double m_particleRadius    = 0.0;
     double m_particleRadiusSqr = 0.0; ///< \note derived quantity
@@ -72,6 +83,13 @@ public:
 
     // neighbor search
     NeighborSearch::Method m_neighborSearchMethod = NeighborSearch::Method::UniformGridBasedSearch;
+
+    ///
+    /// Sort the particles along a Z-order curve every this many steps so that
+    /// neighbors are close in memory, 0 disables sorting. Sorting changes the
+    /// particle indices, see SphModel::getParticleIds
+    ///
+    int m_zOrderSortPeriod = 0;
 };
 
 ///
@@ -80,6 +98,12 @@ public:
 ///
 class SphModel : public DynamicalModel<SphState>
 {
+public:
+    ///
+    /// \brief Applies a correction to the position and velocity of a particle
+    ///
+    using ParticleCorrectionFunc = std::function<void (Vec3d& position, Vec3d& velocity, const Vec3d& correction)>;
+
 public:
     SphModel();
     ~SphModel() override = default;
@@ -95,9 +119,11 @@ public:
     bool initialize() override;
 
     ///
-    /// \brief Reset the current state to the initial state
+    /// \brief Reset the current state to the initial state. When stepping asynchronously
+    /// the reset is only requested, the fluid thread applies it after its step in progress
+    /// so it never races with it
     ///
-    void resetToInitialState() override { this->m_currentState->setState(this->m_initialState); }
+    void resetToInitialState() override;
 
     ///
     /// \brief Get the simulation parameters
@@ -125,6 +151,42 @@ public:
     ///
     double getTimeStep() const override { return m_dt; }
 
+    ///
+    /// \brief Advance the fluid by dt in sub-steps, at most SphModelConfig::m_maxNumSubsteps
+    /// (at least one). With TimeSteppingType::RealTime dt is split evenly in as many sub-steps
+    /// as the CFL condition asks for. With TimeSteppingType::Fixed sub-steps are of the default
+    /// time step, time short of a whole sub-step is carried over to the next call. Time left
+    /// once the cap is hit is dropped, see getDroppedTime. When stepping asynchronously a
+    /// requested reset is then applied and the positions are published to the scene
+    ///
+    void advance(const double dt);
+
+    ///
+    /// \brief Get the number of sub-steps the last advance took
+    ///
+    int getNumSubsteps() const { return m_numSubsteps; }
+
+    ///
+    /// \brief Get the total time advance dropped because of the sub-step cap
+    ///
+    double getDroppedTime() const { return m_droppedTime; }
+
+    ///
+    /// \brief Set/Get whether the fluid is stepped on its own thread (see SphModule)
+    /// instead of in the scene task graph. The state then works on its own copy of the
+    /// positions and per particle attributes, the geometry gets the latest published ones
+    /// once per scene step. Must be set before initialization
+    ///@{
+    void setAsyncStepping(const bool asyncStepping) { m_asyncStepping = asyncStepping; }
+    bool getAsyncStepping() const { return m_asyncStepping; }
+    ///@}
+
+    ///
+    /// \brief Queue corrections of particles when stepping asynchronously, they are applied
+    /// by the fluid thread before its next step. Indices refer to the positions of the geometry
+    ///
+    void queueParticleCorrections(const std::vector<std::pair<size_t, Vec3d>>& corrections, ParticleCorrectionFunc func);
+
     void setInitialVelocities(const size_t numParticles, const Vec3d& initialVelocities);
 
     double getParticlePressure(const double density);
@@ -140,6 +202,12 @@ public:
 
     void setRestDensity(const double restDensity) { m_modelParameters->m_restDensity = restDensity; }
 
+    ///
+    /// \brief Get the initial index of every particle, particles are moved
+    /// around in the arrays when z-order sorting is on
+    ///
+    const std::vector<size_t>& getParticleIds() const { return m_particleIds; }
+
     std::shared_ptr<TaskNode> getFindParticleNeighborsNode() const { return m_findParticleNeighborsNode; }
     std::shared_ptr<TaskNode> getComputeDensityNode() const { return m_computeDensityNode; }
     std::shared_ptr<TaskNode> getComputePressureNode() const { return m_computePressureAccelNode; }
@@ -150,6 +218,8 @@ public:
     std::shared_ptr<TaskNode> getComputeViscosityNode() const { return m_computeViscosityNode; }
     std::shared_ptr<TaskNode> getUpdateVelocityNode() const { return m_updateVelocityNode; }
     std::shared_ptr<TaskNode> getMoveParticlesNode() const { return m_moveParticlesNode; }
+    std::shared_ptr<TaskNode> getAdvanceNode() const { return m_advanceNode; }
+    std::shared_ptr<TaskNode> getSyncParticlesNode() const { return m_syncParticlesNode; }
 
 protected:
     ///
@@ -169,7 +239,13 @@ private:
     double computeCFLTimeStepSize();
 
     ///
-    /// \brief Find the neighbors for each particle
+    /// \brief Reorder all per particle arrays by the Morton code of the particle
+    /// positions so that spatially close particles are close in memory
+    ///
+    void sortParticles();
+
+    ///
+    /// \brief Find the neighbors for each particle and pack them in the state
     ///
     void findParticleNeighbors();
 
@@ -226,6 +302,32 @@ private:
     ///
     void moveParticles(const double timestep);
 
+    ///
+    /// \brief Run all the steps of the model once with the given time step
+    ///
+    void step(const double timestep);
+
+    ///
+    /// \brief Apply the corrections queued by queueParticleCorrections
+    ///
+    void applyQueuedCorrections();
+
+    ///
+    /// \brief Reset the current state, particle order and boundary conditions to the initial ones
+    ///
+    void resetState();
+
+    ///
+    /// \brief Hand the current positions and per particle attributes over to the scene,
+    /// called by the fluid thread after advancing when stepping asynchronously
+    ///
+    void publishParticles();
+
+    ///
+    /// \brief Copy the latest published positions and per particle attributes into the geometry
+    ///
+    void syncParticles();
+
 //void computePressureOutlet();
 
 protected:
@@ -241,16 +343,19 @@ protected:
     std::shared_ptr<TaskNode> m_moveParticlesNode          = nullptr;
     std::shared_ptr<TaskNode> m_normalizeDensityNode       = nullptr;
     std::shared_ptr<TaskNode> m_collectNeighborDensityNode = nullptr;
+    std::shared_ptr<TaskNode> m_advanceNode       = nullptr;
+    std::shared_ptr<TaskNode> m_syncParticlesNode = nullptr;
 
 private:
     std::shared_ptr<PointSet> m_pointSetGeometry;
 
-    double m_dt = 0.0;                                  ///< time step size
-    double m_defaultDt;                                 ///< default time step size
+    double m_dt = 0.0;                                          ///< time step size
+    double m_defaultDt;                                         ///< default time step size
 
-    SphSimulationKernels m_kernels;                     ///< SPH kernels (must be initialized during model initialization)
-    std::shared_ptr<SphModelConfig> m_modelParameters;  ///< SPH Model parameters (must be set before simulation)
-    std::shared_ptr<NeighborSearch> m_neighborSearcher; ///< Neighbor Search (must be initialized during model initialization)
+    SphSimulationKernels m_kernels;                             ///< SPH kernels (must be initialized during model initialization)
+    std::shared_ptr<SphModelConfig> m_modelParameters;          ///< SPH Model parameters (must be set before simulation)
+    std::shared_ptr<NeighborSearch> m_neighborSearcher;         ///< Neighbor Search (must be initialized during model initialization)
+    std::shared_ptr<NeighborSearch> m_boundaryNeighborSearcher; ///< Neighbor Search in the boundary particles
 
     std::shared_ptr<VecDataArray<double, 3>> m_pressureAccels       = nullptr;
     std::shared_ptr<VecDataArray<double, 3>> m_surfaceTensionAccels = nullptr;
@@ -263,6 +368,45 @@ private:
 
     int m_timeStepCount = 0;
 
+    int    m_numSubsteps   = 0;   ///< sub-steps taken by the last advance
+    double m_remainingTime = 0.0; ///< time short of a fixed sub-step, carried over to the next advance
+    double m_droppedTime   = 0.0; ///< time dropped by advance once the sub-step cap was hit
+
+    std::vector<size_t> m_particleIds; ///< initial index of every particle
+
+    ///
+    /// \struct ParticleBuffer
+    ///
+    /// \brief Particle positions and attributes handed from the fluid thread to the scene
+    ///
+    struct ParticleBuffer
+    {
+        VecDataArray<double, 3> positions;
+        VecDataArray<double, 3> velocities;
+        VecDataArray<double, 3> diffuseVelocities;
+        VecDataArray<double, 3> normals;
+        VecDataArray<double, 3> accelerations;
+        DataArray<double>       densities;
+        VecDataArray<double, 3> pressureAccels;
+        VecDataArray<double, 3> surfaceTensionAccels;
+        VecDataArray<double, 3> viscousAccels;
+        std::vector<size_t>     particleIds; ///< initial index of every particle
+    };
+
+    ///
+    /// \brief Copy the current positions and per particle attributes into \p buffer
+    ///
+    void writeParticleBuffer(ParticleBuffer& buffer);
+
+    bool m_asyncStepping = false;
+    std::atomic<bool> m_resetRequested = ATOMIC_VAR_INIT(false);          ///< reset applied by the fluid thread after its step
+    std::shared_ptr<ParallelUtils::SpinLock> m_bufferLock;                ///< guards m_sharedBuffer and m_queuedCorrections
+    std::shared_ptr<ParticleBuffer>          m_fluidBuffer  = nullptr;    ///< written by the fluid thread
+    std::shared_ptr<ParticleBuffer>          m_sharedBuffer = nullptr;    ///< latest published particles, swapped with the others
+    std::shared_ptr<ParticleBuffer>          m_sceneBuffer  = nullptr;    ///< read by the scene thread
+    bool m_sharedBufferModified = false;
+    std::vector<std::pair<ParticleCorrectionFunc, std::vector<std::pair<size_t, Vec3d>>>> m_queuedCorrections; ///< corrections by initial particle index
+
     std::shared_ptr<SphBoundaryConditions> m_sphBoundaryConditions = nullptr;
 
     std::vector<size_t> m_minIndices;
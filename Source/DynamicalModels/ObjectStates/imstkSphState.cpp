@@ -28,8 +28,8 @@ SphState::SphState(const int numElements) :
     std::fill_n(m_halfStepVelocities->getPointer(), m_halfStepVelocities->size(), Vec3d(0.0, 0.0, 0.0));
     std::fill_n(m_fullStepVelocities->getPointer(), m_fullStepVelocities->size(), Vec3d(0.0, 0.0, 0.0));
 
-    m_neighborInfo.resize(static_cast<size_t>(numElements));
-    m_neighborLists.resize(static_cast<size_t>(numElements));
+    m_neighborOffsets.resize(static_cast<size_t>(numElements) + 1, 0);
+    m_fluidNeighborEnds.resize(static_cast<size_t>(numElements), 0);
 }
 
 void
@@ -45,9 +45,10 @@ SphState::setState(std::shared_ptr<SphState> rhs)
     *m_acceleration      = *rhs->getAccelerations();
     *m_diffuseVelocities = *rhs->getDiffuseVelocities();
 
-    m_neighborLists = rhs->getFluidNeighborLists();
-    m_boundaryParticleNeighborLists = rhs->getBoundaryNeighborLists();
-    m_neighborInfo = rhs->getNeighborInfo();
+    m_neighborOffsets   = rhs->getNeighborOffsets();
+    m_fluidNeighborEnds = rhs->getFluidNeighborEnds();
+    m_neighborIds       = rhs->getNeighborIds();
+    m_neighborInfo      = rhs->getNeighborInfo();
 
     m_positions->postModified();
 }
@@ -97,24 +97,34 @@ public:
     std::shared_ptr<VecDataArray<double, 3>> getDiffuseVelocities() const { return m_diffuseVelocities; }
 
     ///
-    /// \brief Returns the vector of neighbor fluid particles
+    /// \brief Returns the start of the neighbors of every particle in the packed neighbor
+    /// arrays, the neighbors of particle p are [offsets[p], offsets[p + 1]). Fluid neighbors
+    /// come first, up to getFluidNeighborEnds()[p], followed by boundary particle neighbors
     ///@{
-    std::vector<std::vector<size_t>>& getFluidNeighborLists() { return m_neighborLists; }
-    const std::vector<std::vector<size_t>>& getFluidNeighborLists() const { return m_neighborLists; }
+    std::vector<size_t>& getNeighborOffsets() { return m_neighborOffsets; }
+    const std::vector<size_t>& getNeighborOffsets() const { return m_neighborOffsets; }
     ///@}
 
     ///
-    /// \brief Returns the vector of neighbor of boundary particles
+    /// \brief Returns the end of the fluid neighbors of every particle in the packed neighbor arrays
     ///@{
-    std::vector<std::vector<size_t>>& getBoundaryNeighborLists() { return m_boundaryParticleNeighborLists; }
-    const std::vector<std::vector<size_t>>& getBoundaryNeighborLists() const { return m_boundaryParticleNeighborLists; }
+    std::vector<size_t>& getFluidNeighborEnds() { return m_fluidNeighborEnds; }
+    const std::vector<size_t>& getFluidNeighborEnds() const { return m_fluidNeighborEnds; }
     ///@}
 
     ///
-    /// \brief Returns the vector of neighbor information ( {relative position, density} ), which is cached for other computation
+    /// \brief Returns the packed neighbor ids of all particles, fluid or boundary particle indices
     ///@{
-    std::vector<std::vector<NeighborInfo>>& getNeighborInfo() { return m_neighborInfo; }
-    const std::vector<std::vector<NeighborInfo>>& getNeighborInfo() const { return m_neighborInfo; }
+    std::vector<size_t>& getNeighborIds() { return m_neighborIds; }
+    const std::vector<size_t>& getNeighborIds() const { return m_neighborIds; }
+    ///@}
+
+    ///
+    /// \brief Returns the packed neighbor information ( {relative position, density} ) of all particles,
+    /// which is cached for other computation
+    ///@{
+    std::vector<NeighborInfo>& getNeighborInfo() { return m_neighborInfo; }
+    const std::vector<NeighborInfo>& getNeighborInfo() const { return m_neighborInfo; }
     ///@}
 
     ///
@@ -135,8 +145,9 @@ private:
     std::shared_ptr<VecDataArray<double, 3>> m_acceleration;                ///<  acceleration
     std::shared_ptr<VecDataArray<double, 3>> m_diffuseVelocities;           ///<  velocity diffusion, used for computing viscosity
 
-    std::vector<std::vector<size_t>>       m_neighborLists;                 ///<  store a list of neighbors for each particle, updated each time step
-    std::vector<std::vector<size_t>>       m_boundaryParticleNeighborLists; ///<  store a list of boundary particle neighbors for each particle, updated each time step
-    std::vector<std::vector<NeighborInfo>> m_neighborInfo;                  ///<  store a list of Vec4d(Vec3d(relative position), density) for neighbors, including boundary particle
+    std::vector<size_t>       m_neighborOffsets;                      ///<  start of the neighbors of each particle in the packed arrays, numParticles+1 long
+    std::vector<size_t>       m_fluidNeighborEnds;                    ///<  end of the fluid neighbors of each particle in the packed arrays
+    std::vector<size_t>       m_neighborIds;                          ///<  packed neighbors of all particles, fluid then boundary particles
+    std::vector<NeighborInfo> m_neighborInfo;                         ///<  packed {relative position, density} of all neighbors, including boundary particles
 };
 } // namespace imstk
\ No newline at end of file
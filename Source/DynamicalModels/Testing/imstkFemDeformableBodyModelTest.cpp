@@ -0,0 +1,101 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkBackwardEuler.h"
+#include "imstkConjugateGradient.h"
+#include "imstkFemDeformableBodyModel.h"
+#include "imstkGeometryUtilities.h"
+#include "imstkNewtonSolver.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Corotational model of a block fixed at its bottom face, assembled natively
+///
+std::shared_ptr<FemDeformableBodyModel>
+makeBlockModel(const bool matrixFree, const bool warmStart)
+{
+    auto mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(4, 4, 4));
+
+    auto config = std::make_shared<FemModelConfig>();
+    config->m_femMethod      = FeMethodType::Corotational;
+    config->m_nativeAssembly = true;
+    config->m_matrixFree     = matrixFree;
+    config->m_warmStart      = warmStart;
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        if (vertices[i][1] < -0.49)
+        {
+            config->m_fixedNodeIds.push_back(i);
+        }
+    }
+
+    auto model = std::make_shared<FemDeformableBodyModel>();
+    model->configure(config);
+    model->setTimeStepSizeType(TimeSteppingType::Fixed);
+    model->setModelGeometry(mesh);
+    model->setTimeIntegrator(std::make_shared<BackwardEuler>(0.01));
+    EXPECT_TRUE(model->initialize());
+    return model;
+}
+
+std::shared_ptr<ConjugateGradient>
+getConjugateGradient(FemDeformableBodyModel& model)
+{
+    auto nlSolver = std::dynamic_pointer_cast<NewtonSolver<SparseMatrixd>>(model.getSolver());
+    return (nlSolver != nullptr) ? std::dynamic_pointer_cast<ConjugateGradient>(nlSolver->getLinearSolver()) : nullptr;
+}
+} // namespace
+
+///
+/// \brief Test that solving with the effective stiffness applied matrix free gives
+/// the displacements of solving with it assembled, and keeps the fixed nodes fixed
+///
+TEST(imstkFemDeformableBodyModelTest, MatrixFreeSolve)
+{
+    std::shared_ptr<FemDeformableBodyModel> assembledModel  = makeBlockModel(false, false);
+    std::shared_ptr<FemDeformableBodyModel> matrixFreeModel = makeBlockModel(true, false);
+
+    for (std::shared_ptr<FemDeformableBodyModel> model : { assembledModel, matrixFreeModel })
+    {
+        std::shared_ptr<ConjugateGradient> cgSolver = getConjugateGradient(*model);
+        ASSERT_NE(cgSolver, nullptr);
+        cgSolver->setTolerance(1.0e-12);
+        cgSolver->setMaxNumIterations(1000);
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        assembledModel->getSolver()->solve();
+        matrixFreeModel->getSolver()->solve();
+    }
+
+    const Vectord& u           = assembledModel->getCurrentState()->getQ();
+    const Vectord& uMatrixFree = matrixFreeModel->getCurrentState()->getQ();
+    EXPECT_GT(u.norm(), 0.0);
+    EXPECT_LT((u - uMatrixFree).norm(), 1.0e-6 * u.norm());
+    for (const std::size_t nodeId : assembledModel->getFixNodeIds())
+    {
+        EXPECT_EQ(uMatrixFree.segment<3>(3 * nodeId).norm(), 0.0);
+    }
+}
+
+///
+/// \brief Test that the warm start of the config reaches the conjugate gradient solver
+///
+TEST(imstkFemDeformableBodyModelTest, WarmStartConfig)
+{
+    EXPECT_FALSE(getConjugateGradient(*makeBlockModel(false, false))->getWarmStart());
+    EXPECT_TRUE(getConjugateGradient(*makeBlockModel(false, true))->getWarmStart());
+    EXPECT_TRUE(getConjugateGradient(*makeBlockModel(true, true))->getWarmStart());
+}
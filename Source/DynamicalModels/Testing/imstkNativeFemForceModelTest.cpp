@@ -0,0 +1,314 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "gtest/gtest.h"
+
+#include "imstkCorotationalFemForceModel.h"
+#include "imstkFemDeformableBodyModel.h"
+#include "imstkGeometryUtilities.h"
+#include "imstkLinearFemForceModel.h"
+#include "imstkNativeFemForceModel.h"
+#include "imstkTetrahedralMesh.h"
+#include "imstkVecDataArray.h"
+#include "imstkVegaMeshIO.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Tangent stiffness with a 3x3 block for every pair of vertices sharing an
+/// element, as given by the topology of the force model
+///
+SparseMatrixd
+makeTangentStiffness(std::shared_ptr<TetrahedralMesh> mesh)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (const Vec4i& tet : *mesh->getTetrahedraIndices())
+    {
+        for (int a = 0; a < 4; a++)
+        {
+            for (int b = 0; b < 4; b++)
+            {
+                for (int i = 0; i < 3; i++)
+                {
+                    for (int j = 0; j < 3; j++)
+                    {
+                        triplets.push_back(Eigen::Triplet<double>(3 * tet[a] + i, 3 * tet[b] + j, 0.0));
+                    }
+                }
+            }
+        }
+    }
+    SparseMatrixd K(3 * mesh->getNumVertices(), 3 * mesh->getNumVertices());
+    K.setFromTriplets(triplets.begin(), triplets.end());
+    K.makeCompressed();
+    return K;
+}
+
+///
+/// \brief Displacement moving the mesh rigidly by \p rotation and \p translation
+///
+Vectord
+makeRigidDisplacement(std::shared_ptr<TetrahedralMesh> mesh, const Mat3d& rotation, const Vec3d& translation)
+{
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    Vectord                        u(vertices.size() * 3);
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        u.segment<3>(3 * i) = rotation * vertices[i] + translation - vertices[i];
+    }
+    return u;
+}
+
+///
+/// \brief Displacement twisting the mesh about the z axis, so the elements rotate
+///
+Vectord
+makeTwist(std::shared_ptr<TetrahedralMesh> mesh)
+{
+    const VecDataArray<double, 3>& vertices = *mesh->getVertexPositions();
+    Vectord                        u(vertices.size() * 3);
+    for (int i = 0; i < vertices.size(); i++)
+    {
+        const Mat3d R = Rotd(vertices[i][2] * PI_2, Vec3d(0.0, 0.0, 1.0)).toRotationMatrix();
+        u.segment<3>(3 * i) = R * vertices[i] - vertices[i];
+    }
+    return u;
+}
+
+///
+/// \brief Tangent stiffness of a vega force model, with the pattern it gives
+///
+SparseMatrixd
+makeVegaTangentStiffness(InternalForceModel& forceModel, std::shared_ptr<vega::SparseMatrix>& vegaK)
+{
+    vega::SparseMatrix* matrix = nullptr;
+    forceModel.getTangentStiffnessMatrixTopology(&matrix);
+    vegaK.reset(matrix);
+    SparseMatrixd K;
+    FemDeformableBodyModel::initializeEigenMatrixFromVegaMatrix(*matrix, K);
+    forceModel.setTangentStiffness(vegaK);
+    return K;
+}
+} // namespace
+
+///
+/// \brief Test that the parallel assembly by colors loses no element contributions
+///
+TEST(imstkNativeFemForceModelTest, Coloring)
+{
+    auto                mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(5, 5, 5));
+    NativeFemForceModel forceModel(mesh, 1.0e4, 0.4, FeMethodType::Corotational);
+    EXPECT_GT(forceModel.getNumColors(), 1);
+
+    // A translation is in the null space of the stiffness, which it would not be
+    // if elements sharing a vertex raced on the same entries
+    SparseMatrixd K = makeTangentStiffness(mesh);
+    Vectord       f(3 * mesh->getNumVertices());
+    forceModel.getForceAndMatrix(Vectord::Zero(f.size()), f, K);
+    const Vectord translation = makeRigidDisplacement(mesh, Mat3d::Identity(), Vec3d(0.1, 0.2, 0.3));
+    EXPECT_LT((K * translation).norm(), 1.0e-8 * K.norm());
+}
+
+///
+/// \brief Test that the corotational model gives no force for a rigid motion, and
+/// the stiffness is the rest stiffness rotated
+///
+TEST(imstkNativeFemForceModelTest, CorotationalRigidMotion)
+{
+    auto                mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(4, 4, 4));
+    NativeFemForceModel forceModel(mesh, 1.0e4, 0.4, FeMethodType::Corotational);
+
+    SparseMatrixd K0 = makeTangentStiffness(mesh);
+    Vectord       f(3 * mesh->getNumVertices());
+    forceModel.getTangentStiffnessMatrix(Vectord::Zero(f.size()), K0);
+
+    const Mat3d   R = Rotd(0.7, Vec3d(1.0, 2.0, 3.0).normalized()).toRotationMatrix();
+    const Vectord u = makeRigidDisplacement(mesh, R, Vec3d(0.5, -0.2, 0.1));
+    SparseMatrixd K = makeTangentStiffness(mesh);
+    forceModel.getForceAndMatrix(u, f, K);
+    EXPECT_LT(f.norm(), 1.0e-8 * K0.norm());
+
+    // K = R K0 R^T blockwise
+    SparseMatrixd                       Rhat(f.size(), f.size());
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int v = 0; v < mesh->getNumVertices(); v++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                triplets.push_back(Eigen::Triplet<double>(3 * v + i, 3 * v + j, R(i, j)));
+            }
+        }
+    }
+    Rhat.setFromTriplets(triplets.begin(), triplets.end());
+    const SparseMatrixd expected = Rhat * K0 * SparseMatrixd(Rhat.transpose());
+    EXPECT_LT((K - expected).norm(), 1.0e-8 * K0.norm());
+
+    // Force alone matches force with the matrix
+    Vectord fOnly(f.size());
+    forceModel.getInternalForce(u, fOnly);
+    EXPECT_LT((fOnly - f).norm(), 1.0e-8 * K0.norm());
+}
+
+///
+/// \brief Test that the linear model force is K u and the stiffness symmetric and
+/// the same at any displacement
+///
+TEST(imstkNativeFemForceModelTest, Linear)
+{
+    auto                mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(4, 4, 4));
+    NativeFemForceModel forceModel(mesh, 1.0e4, 0.4, FeMethodType::Linear);
+
+    Vectord u = Vectord::Random(3 * mesh->getNumVertices()) * 0.01;
+    Vectord f(u.size());
+
+    SparseMatrixd K = makeTangentStiffness(mesh);
+    forceModel.getForceAndMatrix(u, f, K);
+    EXPECT_LT((f - K * u).norm(), 1.0e-8 * K.norm());
+    EXPECT_LT((K - SparseMatrixd(K.transpose())).norm(), 1.0e-8 * K.norm());
+
+    // The second assembly copies the values of the first
+    const SparseMatrixd K1 = K;
+    forceModel.getTangentStiffnessMatrix(Vectord::Zero(u.size()), K);
+    EXPECT_EQ((K - K1).norm(), 0.0);
+}
+
+///
+/// \brief Test that the matrix free product and block diagonal match the assembled stiffness
+///
+TEST(imstkNativeFemForceModelTest, MatrixFree)
+{
+    auto                mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(4, 4, 4));
+    NativeFemForceModel forceModel(mesh, 1.0e4, 0.4, FeMethodType::Corotational);
+    EXPECT_TRUE(forceModel.isMatrixFree());
+
+    const Vectord u = makeTwist(mesh);
+    Vectord       f(u.size());
+    SparseMatrixd K = makeTangentStiffness(mesh);
+    forceModel.getForceAndMatrix(u, f, K);
+
+    const Vectord x = Vectord::Random(u.size());
+    Vectord       Kx(u.size());
+    forceModel.getTangentStiffnessProduct(x, Kx);
+    EXPECT_LT((Kx - K * x).norm(), 1.0e-8 * K.norm() * x.norm());
+
+    StdVectorOfMat3d blocks;
+    forceModel.getTangentStiffnessBlockDiagonal(blocks);
+    ASSERT_EQ(blocks.size(), static_cast<size_t>(mesh->getNumVertices()));
+    const Eigen::MatrixXd denseK = K;
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        EXPECT_LT((blocks[i] - denseK.block<3, 3>(3 * i, 3 * i)).norm(), 1.0e-8 * K.norm());
+    }
+}
+
+///
+/// \brief Test that the forces and tangent stiffness match those of the vega linear
+/// and corotational force models on the same mesh
+///
+TEST(imstkNativeFemForceModelTest, VegaParity)
+{
+    auto mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(4, 4, 4));
+    // The vega mesh is given E = 1e7 and nu = 0.4
+    std::shared_ptr<vega::VolumetricMesh> vegaMesh = VegaMeshIO::convertVolumetricMeshToVegaMesh(mesh);
+
+    for (const FeMethodType method : { FeMethodType::Linear, FeMethodType::Corotational })
+    {
+        std::shared_ptr<InternalForceModel> vegaForceModel;
+        if (method == FeMethodType::Linear)
+        {
+            vegaForceModel = std::make_shared<LinearFemForceModel>(vegaMesh, false);
+        }
+        else
+        {
+            vegaForceModel = std::make_shared<CorotationalFemForceModel>(vegaMesh);
+        }
+        NativeFemForceModel nativeForceModel(mesh, 1.0e7, 0.4, method);
+
+        const Vectord                       u = makeTwist(mesh) * 0.1;
+        std::shared_ptr<vega::SparseMatrix> vegaMatrix;
+        SparseMatrixd                       vegaK = makeVegaTangentStiffness(*vegaForceModel, vegaMatrix);
+        Vectord                             vegaF(u.size());
+        vegaForceModel->getForceAndMatrix(u, vegaF, vegaK);
+
+        SparseMatrixd K = makeTangentStiffness(mesh);
+        Vectord       f(u.size());
+        nativeForceModel.getForceAndMatrix(u, f, K);
+
+        EXPECT_LT((f - vegaF).norm(), 1.0e-5 * vegaF.norm());
+        EXPECT_LT((K - vegaK).norm(), 1.0e-5 * vegaK.norm());
+    }
+}
+
+///
+/// \brief Test that every element gets its own material, the stiffness is linear in
+/// the Young's modulus at a given Poisson's ratio
+///
+TEST(imstkNativeFemForceModelTest, PerElementMaterial)
+{
+    auto      mesh        = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(4, 4, 4));
+    const int numElements = mesh->getNumTetrahedra();
+
+    // Stiffer elements every other one, as the sum of a uniform and a masked material
+    std::vector<double> youngsModuli(numElements);
+    std::vector<double> maskedModuli(numElements);
+    for (int i = 0; i < numElements; i++)
+    {
+        maskedModuli[i] = (i % 2 == 0) ? 3.0e4 : 0.0;
+        youngsModuli[i] = 1.0e4 + maskedModuli[i];
+    }
+    const std::vector<double> poissonRatios(numElements, 0.4);
+    NativeFemForceModel       forceModel(mesh, youngsModuli, poissonRatios, FeMethodType::Linear);
+    NativeFemForceModel       uniformForceModel(mesh, 1.0e4, 0.4, FeMethodType::Linear);
+    NativeFemForceModel       maskedForceModel(mesh, maskedModuli, poissonRatios, FeMethodType::Linear);
+
+    const Vectord zero = Vectord::Zero(3 * mesh->getNumVertices());
+    SparseMatrixd K    = makeTangentStiffness(mesh);
+    SparseMatrixd uniformK = makeTangentStiffness(mesh);
+    SparseMatrixd maskedK  = makeTangentStiffness(mesh);
+    forceModel.getTangentStiffnessMatrix(zero, K);
+    uniformForceModel.getTangentStiffnessMatrix(zero, uniformK);
+    maskedForceModel.getTangentStiffnessMatrix(zero, maskedK);
+    EXPECT_GT(maskedK.norm(), 0.0);
+    EXPECT_LT((K - uniformK - maskedK).norm(), 1.0e-10 * K.norm());
+}
+
+///
+/// \brief Test that the scatter map is rebuilt when the pattern of the matrix changes
+/// in place, the matrix keeps its address and number of non zeros
+///
+TEST(imstkNativeFemForceModelTest, ScatterMapPatternChange)
+{
+    auto                mesh = GeometryUtils::toTetGrid(Vec3d::Zero(), Vec3d(1.0, 1.0, 1.0), Vec3i(3, 3, 3));
+    NativeFemForceModel forceModel(mesh, 1.0e4, 0.4, FeMethodType::Corotational);
+    const Vectord       u = makeTwist(mesh);
+    Vectord             f(u.size());
+
+    // Same element blocks plus one entry outside of them, in a different row
+    const Eigen::Index n = u.size();
+    auto               makePattern = [&](const Eigen::Index row, const Eigen::Index col)
+                                     {
+                                         SparseMatrixd K = makeTangentStiffness(mesh);
+                                         K.coeffRef(row, col) = 0.0;
+                                         K.makeCompressed();
+                                         return K;
+                                     };
+    SparseMatrixd       K        = makePattern(0, n - 1);
+    const SparseMatrixd expected = makePattern(n - 1, 0);
+    ASSERT_EQ(K.nonZeros(), expected.nonZeros());
+    forceModel.getForceAndMatrix(u, f, K);
+
+    // Overwrite the pattern in place
+    std::copy_n(expected.outerIndexPtr(), n + 1, K.outerIndexPtr());
+    std::copy_n(expected.innerIndexPtr(), expected.nonZeros(), K.innerIndexPtr());
+    SparseMatrixd reference = expected;
+    forceModel.getForceAndMatrix(u, f, K);
+    NativeFemForceModel(mesh, 1.0e4, 0.4, FeMethodType::Corotational).getForceAndMatrix(u, f, reference);
+    EXPECT_LT((K - reference).norm(), 1.0e-10 * reference.norm());
+}
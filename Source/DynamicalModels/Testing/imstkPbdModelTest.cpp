@@ -0,0 +1,290 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkDataTracker.h"
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdModel.h"
+#include "imstkPbdModelConfig.h"
+#include "imstkPbdSolver.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Adds a body of a single particle of unit mass
+///
+std::shared_ptr<PbdBody>
+addParticleBody(PbdModel& model, const Vec3d& pos, const Vec3d& velocity = Vec3d::Zero())
+{
+    std::shared_ptr<PbdBody> body = model.addBody();
+    body->bodyType     = PbdBody::Type::DEFORMABLE;
+    body->prevVertices = std::make_shared<VecDataArray<double, 3>>(1);
+    body->vertices     = std::make_shared<VecDataArray<double, 3>>(1);
+    body->velocities   = std::make_shared<VecDataArray<double, 3>>(1);
+    body->masses       = std::make_shared<DataArray<double>>(1);
+    body->invMasses    = std::make_shared<DataArray<double>>(1);
+    (*body->prevVertices)[0] = pos;
+    (*body->vertices)[0]     = pos;
+    (*body->velocities)[0]   = velocity;
+    (*body->masses)[0]       = 1.0;
+    (*body->invMasses)[0]    = 1.0;
+    return body;
+}
+
+///
+/// \brief Runs a step of the model
+///
+void
+step(PbdModel& model)
+{
+    model.integratePosition();
+    model.solveConstraints();
+    model.updateVelocity();
+}
+} // namespace
+
+///
+/// \brief Test that a step of a free falling particle is split into sub-steps
+/// of semi-implicit euler
+///
+TEST(imstkPbdModelTest, Substeps)
+{
+    const unsigned int numSubsteps = 4;
+    const double       dt = 0.01;
+
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_dt       = dt;
+    model->getConfig()->m_substeps = numSubsteps;
+    model->getConfig()->m_iterations         = 1;
+    model->getConfig()->m_linearDampingCoeff = 0.0;
+    model->getConfig()->m_doPartitioning     = false;
+
+    std::shared_ptr<PbdBody> body = addParticleBody(*model, Vec3d::Zero());
+
+    model->initialize();
+    step(*model);
+
+    // Every sub-step h adds g * h to the velocity then moves by it
+    const double h = dt / numSubsteps;
+    const Vec3d& g = model->getConfig()->m_gravity;
+    EXPECT_TRUE((*body->velocities)[0].isApprox(g * dt));
+    EXPECT_TRUE((*body->vertices)[0].isApprox(g * h * h * (numSubsteps * (numSubsteps + 1) / 2)));
+}
+
+///
+/// \brief Test that the sub-step time probed is the time of the last sub-step,
+/// not the time of the step averaged over its sub-steps
+///
+TEST(imstkPbdModelTest, SubstepTimeProbe)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_substeps = 4;
+    model->getConfig()->m_collisionPerSubstep = true;
+    model->getConfig()->m_dataTracker = std::make_shared<DataTracker>();
+    addParticleBody(*model, Vec3d::Zero());
+    model->initialize();
+
+    // Collision of the sub-steps after the first takes 5, 10 then 15ms
+    int numCalls = 0;
+    model->setSubstepCollisionFunction(0, [&numCalls]()
+        {
+            numCalls++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5 * numCalls));
+        });
+    step(*model);
+
+    ASSERT_EQ(numCalls, 3);
+    EXPECT_GE(model->getConfig()->m_dataTracker->getValue(DataTracker::ePhysics::SubstepTime_ms), 15.0);
+}
+
+///
+/// \brief Test that the sub-step collision functions are kept per id and can be removed
+///
+TEST(imstkPbdModelTest, SubstepCollisionFunctions)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_substeps = 2;
+    model->getConfig()->m_collisionPerSubstep = true;
+    addParticleBody(*model, Vec3d::Zero());
+    model->initialize();
+
+    int numCalls[2] = { 0, 0 };
+    model->setSubstepCollisionFunction(0, [&numCalls]() { numCalls[0]++; });
+    model->setSubstepCollisionFunction(1, [&numCalls]() { numCalls[1]++; });
+    step(*model);
+    EXPECT_EQ(numCalls[0], 1);
+    EXPECT_EQ(numCalls[1], 1);
+
+    model->removeSubstepCollisionFunction(0);
+    step(*model);
+    EXPECT_EQ(numCalls[0], 1);
+    EXPECT_EQ(numCalls[1], 2);
+}
+
+///
+/// \brief Test that a still body falls asleep while a moving one doesn't, and
+/// that external forces and constraints to other bodies wake it
+///
+TEST(imstkPbdModelTest, Sleep)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_gravity            = Vec3d::Zero();
+    model->getConfig()->m_linearDampingCoeff = 0.0;
+    model->getConfig()->m_sleepThreshold     = 1.0e-4;
+    model->getConfig()->m_sleepSteps         = 3;
+
+    std::shared_ptr<PbdBody> stillBody  = addParticleBody(*model, Vec3d::Zero(), Vec3d(1.0e-3, 0.0, 0.0));
+    std::shared_ptr<PbdBody> movingBody = addParticleBody(*model, Vec3d(1.0, 0.0, 0.0), Vec3d(1.0, 0.0, 0.0));
+    model->initialize();
+
+    for (int i = 0; i < 3; i++)
+    {
+        step(*model);
+    }
+    EXPECT_TRUE(model->getBodySleeping(2));
+    EXPECT_FALSE(model->getBodySleeping(3));
+    EXPECT_EQ((*stillBody->velocities)[0], Vec3d::Zero());
+
+    // Sleeping bodies don't move
+    const Vec3d restPos = (*stillBody->vertices)[0];
+    step(*model);
+    EXPECT_EQ((*stillBody->vertices)[0], restPos);
+
+    // External force
+    stillBody->externalForce = Vec3d(1.0, 0.0, 0.0);
+    step(*model);
+    EXPECT_FALSE(model->getBodySleeping(2));
+    EXPECT_GT((*stillBody->vertices)[0][0], restPos[0]);
+
+    // Constraint to a virtual particle, ie: grasping
+    for (int i = 0; i < 3; i++)
+    {
+        (*stillBody->velocities)[0] = Vec3d::Zero();
+        step(*model);
+    }
+    ASSERT_TRUE(model->getBodySleeping(2));
+
+    model->integratePosition();
+    const Vec3d           graspPos = (*stillBody->vertices)[0] + Vec3d(1.0, 0.0, 0.0);
+    const PbdParticleId   graspPid = model->addVirtualParticle(graspPos, 0.0);
+    PbdDistanceConstraint grasp;
+    grasp.initConstraint(0.0, graspPid, { 2, 0 });
+    std::vector<PbdConstraint*> graspConstraints = { &grasp };
+    model->getSolver()->addConstraints(&graspConstraints);
+    model->solveConstraints();
+    model->updateVelocity();
+    EXPECT_FALSE(model->getBodySleeping(2));
+    EXPECT_GT((*stillBody->vertices)[0][0], restPos[0] + 0.5);
+}
+
+///
+/// \brief Test that a body resting on a static obstacle falls asleep and stays asleep
+/// while the contact is generated every step
+///
+TEST(imstkPbdModelTest, SleepOnStaticObstacle)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_linearDampingCoeff = 0.0;
+    model->getConfig()->m_sleepThreshold     = 1.0e-4;
+    model->getConfig()->m_sleepSteps         = 3;
+
+    std::shared_ptr<PbdBody> body = addParticleBody(*model, Vec3d::Zero());
+    model->initialize();
+
+    // Contact with a static plane at y = 0, a constraint to a virtual particle of zero
+    // inverse mass as collision with static geometry generates
+    PbdDistanceConstraint       contact;
+    std::vector<PbdConstraint*> contactConstraints = { &contact };
+    for (int i = 0; i < 10; i++)
+    {
+        model->integratePosition();
+        const PbdParticleId planePid = model->addVirtualParticle(Vec3d::Zero(), 0.0);
+        contact.initConstraint(0.0, planePid, { 2, 0 }, 1.0e20);
+        model->getSolver()->addConstraints(&contactConstraints);
+        model->solveConstraints();
+        model->updateVelocity();
+
+        if (i >= 3)
+        {
+            EXPECT_TRUE(model->getBodySleeping(2)) << "step " << i;
+        }
+        EXPECT_LT((*body->vertices)[0].norm(), 1.0e-6);
+    }
+}
+
+///
+/// \brief Test that changing the bodies or constraints keeps the sleep state of the
+/// islands the change doesn't touch
+///
+TEST(imstkPbdModelTest, SleepKeptOnChange)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_gravity            = Vec3d::Zero();
+    model->getConfig()->m_linearDampingCoeff = 0.0;
+    model->getConfig()->m_sleepThreshold     = 1.0e-4;
+    model->getConfig()->m_sleepSteps         = 3;
+
+    addParticleBody(*model, Vec3d::Zero());
+    addParticleBody(*model, Vec3d(1.0, 0.0, 0.0));
+    model->initialize();
+    for (int i = 0; i < 3; i++)
+    {
+        step(*model);
+    }
+    ASSERT_TRUE(model->getBodySleeping(2));
+    ASSERT_TRUE(model->getBodySleeping(3));
+
+    // A new body doesn't wake the others
+    addParticleBody(*model, Vec3d(2.0, 0.0, 0.0));
+    step(*model);
+    EXPECT_TRUE(model->getBodySleeping(2));
+    EXPECT_TRUE(model->getBodySleeping(3));
+    EXPECT_FALSE(model->getBodySleeping(4));
+
+    // A constraint between bodies 3 and 4 only wakes them
+    auto constraint = std::make_shared<PbdDistanceConstraint>();
+    constraint->initConstraint(1.0, { 3, 0 }, { 4, 0 });
+    model->getConstraints()->addConstraint(constraint);
+    step(*model);
+    EXPECT_TRUE(model->getBodySleeping(2));
+    EXPECT_FALSE(model->getBodySleeping(3));
+    EXPECT_FALSE(model->getBodySleeping(4));
+}
+
+///
+/// \brief Test that solving the constraints step after step only gathers the
+/// constraints of the container again when it changes
+///
+TEST(imstkPbdModelTest, ConstraintsCompiledOnChange)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_doPartitioning = false;
+
+    addParticleBody(*model, Vec3d::Zero());
+    addParticleBody(*model, Vec3d(1.0, 0.0, 0.0));
+    auto constraint = std::make_shared<PbdDistanceConstraint>();
+    constraint->initConstraint(1.0, { 2, 0 }, { 3, 0 });
+    model->getConstraints()->addConstraint(constraint);
+    model->initialize();
+
+    step(*model);
+    const size_t numCompiles = model->getSolver()->getNumCompiles();
+    EXPECT_GT(numCompiles, 0u);
+    step(*model);
+    step(*model);
+    EXPECT_EQ(model->getSolver()->getNumCompiles(), numCompiles);
+
+    auto constraint2 = std::make_shared<PbdDistanceConstraint>();
+    constraint2->initConstraint(1.0, { 2, 0 }, { 3, 0 });
+    model->getConstraints()->addConstraint(constraint2);
+    step(*model);
+    EXPECT_EQ(model->getSolver()->getNumCompiles(), numCompiles + 1);
+}
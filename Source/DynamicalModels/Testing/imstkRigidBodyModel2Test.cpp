@@ -0,0 +1,117 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "gtest/gtest.h"
+
+#include "imstkRbdContactConstraint.h"
+#include "imstkRigidBodyModel2.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Solve a single body resting on a contact below its center for a number of
+/// frames and return the upwards force applied by the contact in the last frame
+///
+double
+solveRestingContact(const bool warmStart, const int numFrames)
+{
+    auto model = std::make_shared<RigidBodyModel2>();
+    model->getConfig()->m_warmStart = warmStart;
+    std::shared_ptr<RigidBody> body = model->addRigidBody();
+    body->m_mass = 1.0;
+    model->initialize();
+
+    std::shared_ptr<RigidBodyState2> state = model->getCurrentState();
+    double                           contactForce = 0.0;
+    for (int i = 0; i < numFrames; i++)
+    {
+        // Same state every frame
+        state->getForces()[0]  = Vec3d::Zero();
+        state->getTorques()[0] = Vec3d::Zero();
+        state->getTentatveVelocities()[0] = Vec3d::Zero();
+        state->getTentativeAngularVelocities()[0] = Vec3d::Zero();
+        model->computeTentativeVelocities();
+        const double gravityForce = state->getForces()[0][1];
+
+        const Vec3d contactPt = Vec3d(0.0, -0.5, 0.0);
+        auto        contact   = std::make_shared<RbdContactConstraint>(
+            body, nullptr, Vec3d(0.0, 1.0, 0.0), contactPt, 0.0, 0.05, RbdConstraint::Side::A);
+        contact->compute(model->getTimeStep());
+        contact->m_id = model->computeContactId(*body, nullptr, contactPt, 0);
+        model->addConstraint(contact);
+        model->solveConstraints();
+
+        contactForce = state->getForces()[0][1] - gravityForce;
+    }
+    return contactForce;
+}
+} // namespace
+
+///
+/// \brief Test that warm starting carries the impulse of a persistent contact across
+/// frames, converging where a cold start would stop short after the same iterations
+///
+TEST(imstkRigidBodyModel2Test, WarmStartPersistentContact)
+{
+    // The exact impulse removes the tentative velocity and the gravity force
+    const double exactForce = 2.0 * 9.8;
+
+    const double coldForce = solveRestingContact(false, 20);
+    EXPECT_GT(coldForce, 0.0);
+    EXPECT_LT(coldForce, 0.9 * exactForce);
+
+    const double warmForce = solveRestingContact(true, 20);
+    EXPECT_NEAR(warmForce, exactForce, 1.0e-3 * exactForce);
+}
+
+///
+/// \brief Test the assembled system gives the same impulses when the sparsity pattern
+/// is reused as when it's rebuilt
+///
+TEST(imstkRigidBodyModel2Test, ReusedPatternMatchesRebuilt)
+{
+    auto model = std::make_shared<RigidBodyModel2>();
+    model->getConfig()->m_warmStart = false;
+    std::shared_ptr<RigidBody> bodyA = model->addRigidBody();
+    std::shared_ptr<RigidBody> bodyB = model->addRigidBody();
+    bodyB->m_initPos = Vec3d(0.0, 1.0, 0.0);
+    model->initialize();
+
+    std::shared_ptr<RigidBodyState2> state = model->getCurrentState();
+    Vec3d                            forces[2][2];
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            state->getForces()[j]  = Vec3d::Zero();
+            state->getTorques()[j] = Vec3d::Zero();
+            state->getTentatveVelocities()[j] = Vec3d::Zero();
+            state->getTentativeAngularVelocities()[j] = Vec3d::Zero();
+        }
+        model->computeTentativeVelocities();
+
+        // Two contacts on A and one two-way contact between A and B
+        model->addConstraint(std::make_shared<RbdContactConstraint>(
+            bodyA, nullptr, Vec3d(0.0, 1.0, 0.0), Vec3d(0.2, -0.5, 0.0), 0.01, 0.05, RbdConstraint::Side::A));
+        model->addConstraint(std::make_shared<RbdContactConstraint>(
+            bodyA, nullptr, Vec3d(0.0, 1.0, 0.0), Vec3d(-0.2, -0.5, 0.1), 0.01, 0.05, RbdConstraint::Side::A));
+        model->addConstraint(std::make_shared<RbdContactConstraint>(
+            bodyA, bodyB, Vec3d(0.0, -1.0, 0.0), Vec3d(0.0, 0.5, 0.0), 0.01, 0.05, RbdConstraint::Side::AB));
+        for (const std::shared_ptr<RbdConstraint>& constraint : model->getConstraints())
+        {
+            constraint->compute(model->getTimeStep());
+        }
+        model->solveConstraints();
+
+        forces[i][0] = state->getForces()[0];
+        forces[i][1] = state->getForces()[1];
+    }
+
+    EXPECT_TRUE(forces[0][0].isApprox(forces[1][0]));
+    EXPECT_TRUE(forces[0][1].isApprox(forces[1][1]));
+}
@@ -0,0 +1,288 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPointSet.h"
+#include "imstkSphModel.h"
+#include "imstkSphModule.h"
+#include "imstkTaskNode.h"
+#include "imstkVecDataArray.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Creates a model of a dim^3 block of particles, slightly jittered so
+/// the neighbor counts differ
+///
+std::shared_ptr<SphModel>
+makeFluidBlock(const int dim, std::shared_ptr<SphModelConfig> config, const bool asyncStepping = false)
+{
+    const double spacing  = 2.0 * config->m_particleRadius;
+    auto         vertices = std::make_shared<VecDataArray<double, 3>>(dim * dim * dim);
+    int          i        = 0;
+    for (int z = 0; z < dim; z++)
+    {
+        for (int y = 0; y < dim; y++)
+        {
+            for (int x = 0; x < dim; x++, i++)
+            {
+                const Vec3d jitter(std::sin(i * 1.3), std::sin(i * 2.1), std::sin(i * 0.7));
+                (*vertices)[i] = Vec3d(x, y, z) * spacing + jitter * 0.2 * spacing;
+            }
+        }
+    }
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(vertices);
+
+    auto model = std::make_shared<SphModel>();
+    model->setModelGeometry(pointSet);
+    model->configure(config);
+    model->setDefaultTimeStep(1.0e-3);
+    model->setAsyncStepping(asyncStepping);
+    model->initialize();
+    return model;
+}
+
+///
+/// \brief Returns the ids of the points within radius of pos, brute force
+///
+std::set<size_t>
+getNeighborsBruteForce(const Vec3d& pos, const VecDataArray<double, 3>& points, const double radius)
+{
+    std::set<size_t> neighbors;
+    for (int i = 0; i < points.size(); i++)
+    {
+        if ((points[i] - pos).squaredNorm() < radius * radius)
+        {
+            neighbors.insert(i);
+        }
+    }
+    return neighbors;
+}
+} // namespace
+
+///
+/// \brief Test that the neighbors of every particle are packed, fluid then
+/// boundary particles, and are the ones within the kernel radius
+///
+TEST(imstkSphModelTest, PackedNeighbors)
+{
+    for (const NeighborSearch::Method method :
+         { NeighborSearch::Method::UniformGridBasedSearch, NeighborSearch::Method::SpatialHashing,
+           NeighborSearch::Method::CompactSpatialHashing })
+    {
+        auto config = std::make_shared<SphModelConfig>(0.1);
+        config->m_bDensityWithBoundary = true;
+        config->m_neighborSearchMethod = method;
+        std::shared_ptr<SphModel> model = makeFluidBlock(6, config);
+        std::shared_ptr<SphState> state = model->getCurrentState();
+
+        // A floor of boundary particles under the block
+        VecDataArray<double, 3>& boundaryPositions = *state->getBoundaryParticlePositions();
+        for (int z = 0; z < 6; z++)
+        {
+            for (int x = 0; x < 6; x++)
+            {
+                boundaryPositions.push_back(Vec3d(x * 0.2, -0.2, z * 0.2));
+            }
+        }
+
+        const VecDataArray<double, 3> positions = *state->getPositions();
+        model->advance(1.0e-3);
+
+        const std::vector<size_t>& offsets     = state->getNeighborOffsets();
+        const std::vector<size_t>& fluidEnds   = state->getFluidNeighborEnds();
+        const std::vector<size_t>& neighborIds = state->getNeighborIds();
+        ASSERT_EQ(offsets.size(), positions.size() + 1);
+        EXPECT_EQ(offsets[0], 0u);
+        EXPECT_EQ(offsets.back(), neighborIds.size());
+        EXPECT_EQ(state->getNeighborInfo().size(), neighborIds.size());
+        for (int p = 0; p < positions.size(); p++)
+        {
+            ASSERT_LE(offsets[p], fluidEnds[p]);
+            ASSERT_LE(fluidEnds[p], offsets[p + 1]);
+            const std::set<size_t> fluidNeighbors(neighborIds.begin() + offsets[p], neighborIds.begin() + fluidEnds[p]);
+            const std::set<size_t> boundaryNeighbors(neighborIds.begin() + fluidEnds[p], neighborIds.begin() + offsets[p + 1]);
+            EXPECT_EQ(fluidNeighbors.size(), fluidEnds[p] - offsets[p]);
+            EXPECT_EQ(fluidNeighbors, getNeighborsBruteForce(positions[p], positions, config->m_kernelRadius));
+            EXPECT_EQ(boundaryNeighbors, getNeighborsBruteForce(positions[p], boundaryPositions, config->m_kernelRadius));
+        }
+    }
+}
+
+///
+/// \brief Test that sorting the particles along a Z-order curve gives the same
+/// neighbors, densities and positions as not sorting
+///
+TEST(imstkSphModelTest, ZOrderSortEquivalent)
+{
+    auto unsortedConfig = std::make_shared<SphModelConfig>(0.1);
+    auto sortedConfig   = std::make_shared<SphModelConfig>(0.1);
+    sortedConfig->m_zOrderSortPeriod = 1;
+    std::shared_ptr<SphModel> unsortedModel = makeFluidBlock(8, unsortedConfig);
+    std::shared_ptr<SphModel> sortedModel   = makeFluidBlock(8, sortedConfig);
+
+    for (int i = 0; i < 3; i++)
+    {
+        unsortedModel->advance(1.0e-3);
+        sortedModel->advance(1.0e-3);
+    }
+
+    std::shared_ptr<SphState>  unsortedState = unsortedModel->getCurrentState();
+    std::shared_ptr<SphState>  sortedState   = sortedModel->getCurrentState();
+    const std::vector<size_t>& particleIds   = sortedModel->getParticleIds();
+    EXPECT_FALSE(std::is_sorted(particleIds.begin(), particleIds.end()));
+    for (size_t p = 0; p < particleIds.size(); p++)
+    {
+        // Particle p of the sorted model is particle particleIds[p] of the unsorted one
+        const size_t q = particleIds[p];
+
+        const std::vector<size_t>& sortedOffsets   = sortedState->getNeighborOffsets();
+        const std::vector<size_t>& unsortedOffsets = unsortedState->getNeighborOffsets();
+        std::set<size_t>           sortedNeighbors;
+        for (size_t i = sortedOffsets[p]; i < sortedOffsets[p + 1]; i++)
+        {
+            sortedNeighbors.insert(particleIds[sortedState->getNeighborIds()[i]]);
+        }
+        const std::set<size_t> unsortedNeighbors(unsortedState->getNeighborIds().begin() + unsortedOffsets[q],
+            unsortedState->getNeighborIds().begin() + unsortedOffsets[q + 1]);
+        EXPECT_EQ(sortedNeighbors, unsortedNeighbors);
+
+        EXPECT_NEAR((*sortedState->getDensities())[p], (*unsortedState->getDensities())[q],
+            1.0e-9 * (*unsortedState->getDensities())[q]);
+        EXPECT_LT(((*sortedState->getPositions())[p] - (*unsortedState->getPositions())[q]).norm(), 1.0e-9);
+    }
+}
+
+///
+/// \brief Test that advance splits the time in as many sub-steps as the CFL
+/// condition asks for, up to the cap, and reports the time it dropped
+///
+TEST(imstkSphModelTest, CFLSubsteps)
+{
+    auto config = std::make_shared<SphModelConfig>(0.1);
+    config->m_maxNumSubsteps = 10;
+    std::shared_ptr<SphModel> model = makeFluidBlock(4, config);
+    model->setTimeStepSizeType(TimeSteppingType::RealTime);
+
+    // Slow particles, the CFL time step is the max time step
+    model->advance(5.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 5);
+    EXPECT_DOUBLE_EQ(model->getTimeStep(), 1.0e-3);
+
+    config->m_maxTimestep = 5.0e-4;
+    model->advance(5.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 10);
+    EXPECT_DOUBLE_EQ(model->getDroppedTime(), 0.0);
+
+    // Capped, the rest is dropped
+    config->m_maxNumSubsteps = 2;
+    model->advance(5.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 2);
+    EXPECT_NEAR(model->getDroppedTime(), 4.0e-3, 1.0e-12);
+}
+
+///
+/// \brief Test that fixed time stepping takes sub-steps of the default time step
+/// and carries the time short of one over to the next advance
+///
+TEST(imstkSphModelTest, FixedSubsteps)
+{
+    auto config = std::make_shared<SphModelConfig>(0.1);
+    config->m_maxNumSubsteps = 10;
+    std::shared_ptr<SphModel> model = makeFluidBlock(4, config);
+    model->setTimeStepSizeType(TimeSteppingType::Fixed);
+    model->setDefaultTimeStep(2.0e-3);
+
+    model->advance(5.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 2);
+    EXPECT_DOUBLE_EQ(model->getTimeStep(), 2.0e-3);
+    model->advance(1.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 1);
+    model->advance(1.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 0);
+    model->advance(1.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 1);
+    EXPECT_DOUBLE_EQ(model->getDroppedTime(), 0.0);
+
+    config->m_maxNumSubsteps = 1;
+    model->advance(5.0e-3);
+    EXPECT_EQ(model->getNumSubsteps(), 1);
+    EXPECT_NEAR(model->getDroppedTime(), 3.0e-3, 1.0e-12);
+}
+
+///
+/// \brief Test that the fluid steps on its own thread, that the scene picks up its
+/// positions and attributes, and that resetting whilst it steps gives back the initial state
+///
+TEST(imstkSphModelTest, AsyncStepping)
+{
+    auto config = std::make_shared<SphModelConfig>(0.1);
+    config->m_maxNumSubsteps = 1;
+    std::shared_ptr<SphModel>      model    = makeFluidBlock(4, config, true);
+    std::shared_ptr<PointSet>      pointSet = std::dynamic_pointer_cast<PointSet>(model->getModelGeometry());
+    const VecDataArray<double, 3>& initialPositions = *pointSet->getInitialVertexPositions();
+
+    auto module = std::make_shared<SphModule>(model);
+    module->setDt(1.0e-3);
+    module->init();
+    ASSERT_TRUE(module->getInit());
+
+    std::atomic<bool> stop = ATOMIC_VAR_INIT(false);
+    std::thread       fluidThread([&]()
+        {
+            while (!stop)
+            {
+                module->update();
+            }
+        });
+
+    // The scene only picks up published positions and attributes, the fluid thread
+    // doesn't write into the arrays of the geometry
+    VecDataArray<double, 3>& positions = *pointSet->getVertexPositions();
+    auto velocities = std::dynamic_pointer_cast<VecDataArray<double, 3>>(pointSet->getVertexAttribute("Velocities"));
+    auto densities  = std::dynamic_pointer_cast<DataArray<double>>(pointSet->getVertexAttribute("Densities"));
+    ASSERT_NE(velocities, nullptr);
+    ASSERT_NE(densities, nullptr);
+    EXPECT_NE(velocities, model->getCurrentState()->getVelocities());
+    EXPECT_NE(densities, model->getCurrentState()->getDensities());
+    for (int i = 0; i < 100 && positions[0] == initialPositions[0]; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        model->getSyncParticlesNode()->execute();
+    }
+    EXPECT_NE(positions[0], initialPositions[0]);
+    EXPECT_GT((*densities)[0], 0.0);
+
+    for (int i = 0; i < 10; i++)
+    {
+        model->resetToInitialState();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop = true;
+    fluidThread.join();
+
+    // The reset is applied by the fluid thread after its next step
+    model->resetToInitialState();
+    module->update();
+    model->getSyncParticlesNode()->execute();
+    for (int i = 0; i < initialPositions.size(); i++)
+    {
+        EXPECT_EQ(positions[i], initialPositions[i]);
+        EXPECT_EQ((*model->getCurrentState()->getPositions())[i], initialPositions[i]);
+        EXPECT_EQ((*velocities)[i], (*model->getCurrentState()->getVelocities())[i]);
+        EXPECT_EQ((*densities)[i], (*model->getCurrentState()->getDensities())[i]);
+    }
+}
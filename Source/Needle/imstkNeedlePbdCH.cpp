@@ -129,6 +129,9 @@ NeedlePbdCH::addPunctureConstraints()
     auto physMesh    = std::dynamic_pointer_cast<TetrahedralMesh>(m_pbdTissueObj->getPhysicsGeometry());
     auto puncturable = m_pbdTissueObj->getComponent<Puncturable>();
 
+    // Constraints are regenerated every frame, acquire them from the arena
+    PbdConstraintArena& arena = m_pbdTissueObj->getPbdModel()->getConstraintArena();
+
     // Loop over penetration points and find nearest point on the needle
     // Note: Nearest point will likely be the point between two segments,
     // its dualy defined, but thats ok
@@ -217,7 +220,7 @@ NeedlePbdCH::addPunctureConstraints()
         // generate and solve the constraint
         const int bodyId       = m_pbdTissueObj->getPbdBody()->bodyHandle;
         const int needleBodyId = m_needleObj->getPbdBody()->bodyHandle;
-        auto      pointTriangleConstraint = std::make_shared<SurfaceInsertionConstraint>();
+        auto      pointTriangleConstraint = arena.acquire<SurfaceInsertionConstraint>();
         pointTriangleConstraint->initConstraint(puncturePt,
             { needleBodyId, 0 },
             { bodyId, puncture->triVertIds[0] },
@@ -336,7 +339,7 @@ NeedlePbdCH::addPunctureConstraints()
         const int tissueBodyId = m_pbdTissueObj->getPbdBody()->bodyHandle;
         const int threadBodyId = m_threadObj->getPbdBody()->bodyHandle;
 
-        auto threadTriangleConstraint = std::make_shared<ThreadInsertionConstraint>();
+        auto threadTriangleConstraint = arena.acquire<ThreadInsertionConstraint>();
 
         threadTriangleConstraint->initConstraint(
             m_pbdTissueObj->getPbdModel()->getBodies(),
@@ -366,10 +369,11 @@ NeedlePbdCH::handle(
     auto needleBodyId = m_needleObj->getPbdBody()->bodyHandle;
 
     // Add constraint to connect the needle to the thread
-    int numTiedSegments = 1;
+    int                 numTiedSegments = 1;
+    PbdConstraintArena& arena           = m_threadObj->getPbdModel()->getConstraintArena();
     for (int i = 0; i <= numTiedSegments; i++)
     {
-        auto needleThreadConstraint = std::make_shared<PbdVertexToBodyConstraint>();
+        auto needleThreadConstraint = arena.acquire<PbdVertexToBodyConstraint>();
         needleThreadConstraint->initConstraint(
             m_threadObj->getPbdModel()->getBodies(),
             { needleBodyId, 0 },
@@ -382,7 +386,7 @@ NeedlePbdCH::handle(
     // Add constraints for stitched tissue
     for (size_t i = 0; i < m_stitchConstraints.size(); i++)
     {
-        m_constraints.push_back(m_stitchConstraints[i]);
+        m_constraints.push_back(m_stitchConstraints[i].get());
     }
 
     // Handle needle collision normally if no insertion
@@ -423,12 +427,7 @@ NeedlePbdCH::handle(
         }
     }
 
-    m_solverConstraints.resize(m_constraints.size());
-    for (int i = 0; i < m_constraints.size(); i++)
-    {
-        m_solverConstraints[i] = m_constraints[i].get();
-    }
-    m_pbdTissueObj->getPbdModel()->getSolver()->addConstraints(&m_solverConstraints);
+    m_pbdTissueObj->getPbdModel()->getSolver()->addConstraints(&m_constraints);
 }
 
 // Create stitching constraints
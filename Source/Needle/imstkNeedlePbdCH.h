@@ -78,6 +78,11 @@ public:
     void generateNewPunctureData();
     void addPunctureConstraints();
 
+    ///
+    /// \brief The contacts are generated by PbdCollisionHandling, so may be in parallel
+    ///
+    bool getSupportsParallelHandling() const override { return true; }
+
     void setNeedleToSurfaceStiffness(double stiffness) { m_needleToSurfaceStiffness = stiffness; }
     double getNeedleToSurfaceStiffness() { return m_needleToSurfaceStiffness; }
 
@@ -107,9 +112,8 @@ protected:
     // Vector of thread-triangle constraints (one sided, force thread to follow triangle)
     std::vector<std::shared_ptr<PbdBaryPointToPointConstraint>> m_stitchConstraints;
 
-    // All constraints
-    std::vector<std::shared_ptr<PbdConstraint>> m_constraints;
-    std::vector<PbdConstraint*> m_solverConstraints;
+    // All constraints, those generated every frame are acquired from the arena of the model
+    std::vector<PbdConstraint*> m_constraints;
 
     // Penetration data for needle, thread, and stitch
     PunctureData pData;
@@ -0,0 +1,249 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkCollisionData.h"
+#include "imstkCollisionDetectionAlgorithm.h"
+#include "imstkPbdCollisionHandling.h"
+#include "imstkPbdModel.h"
+#include "imstkPbdModelConfig.h"
+#include "imstkPbdObject.h"
+#include "imstkPbdObjectCollision.h"
+#include "imstkPointSet.h"
+#include "imstkSurfaceMesh.h"
+#include "imstkTaskGraph.h"
+#include "imstkVecDataArray.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Closed box mesh with its top face on the plane y = 0
+///
+std::shared_ptr<SurfaceMesh>
+makeBoxMesh()
+{
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(8);
+    (*vertices)[0] = Vec3d(-1.0, -1.0, -1.0);
+    (*vertices)[1] = Vec3d(1.0, -1.0, -1.0);
+    (*vertices)[2] = Vec3d(1.0, 0.0, -1.0);
+    (*vertices)[3] = Vec3d(-1.0, 0.0, -1.0);
+    (*vertices)[4] = Vec3d(-1.0, -1.0, 1.0);
+    (*vertices)[5] = Vec3d(1.0, -1.0, 1.0);
+    (*vertices)[6] = Vec3d(1.0, 0.0, 1.0);
+    (*vertices)[7] = Vec3d(-1.0, 0.0, 1.0);
+
+    auto indices = std::make_shared<VecDataArray<int, 3>>(12);
+    (*indices)[0]  = Vec3i(0, 3, 2);
+    (*indices)[1]  = Vec3i(0, 2, 1);
+    (*indices)[2]  = Vec3i(4, 5, 6);
+    (*indices)[3]  = Vec3i(4, 6, 7);
+    (*indices)[4]  = Vec3i(0, 1, 5);
+    (*indices)[5]  = Vec3i(0, 5, 4);
+    (*indices)[6]  = Vec3i(3, 7, 6);
+    (*indices)[7]  = Vec3i(3, 6, 2);
+    (*indices)[8]  = Vec3i(0, 4, 7);
+    (*indices)[9]  = Vec3i(0, 7, 3);
+    (*indices)[10] = Vec3i(1, 2, 6);
+    (*indices)[11] = Vec3i(1, 6, 5);
+
+    auto surfMesh = std::make_shared<SurfaceMesh>();
+    surfMesh->initialize(vertices, indices);
+    return surfMesh;
+}
+
+///
+/// \brief Collision of a row of points falling onto a box, simulated by \p model if given
+///
+std::shared_ptr<PbdObjectCollision>
+makeFallingPoints(const bool pipelined, std::shared_ptr<PbdModel> model = nullptr)
+{
+    if (model == nullptr)
+    {
+        model = std::make_shared<PbdModel>();
+        model->getConfig()->m_dt = 0.01;
+        model->getConfig()->m_doPartitioning = false;
+    }
+
+    auto vertices = std::make_shared<VecDataArray<double, 3>>(4);
+    for (int i = 0; i < vertices->size(); i++)
+    {
+        (*vertices)[i] = Vec3d(i * 0.1 - 0.15, 0.05, 0.5);
+    }
+    auto pointSet = std::make_shared<PointSet>();
+    pointSet->initialize(vertices);
+
+    auto pbdObj = std::make_shared<PbdObject>("Points");
+    pbdObj->setPhysicsGeometry(pointSet);
+    pbdObj->setCollidingGeometry(pointSet);
+    pbdObj->setDynamicalModel(model);
+    pbdObj->getPbdBody()->uniformMassValue = 1.0;
+
+    auto boxObj = std::make_shared<CollidingObject>("Box");
+    boxObj->setCollidingGeometry(makeBoxMesh());
+
+    auto interaction = std::make_shared<PbdObjectCollision>(pbdObj, boxObj, "ClosedSurfaceMeshToMeshCD");
+    interaction->setPipelined(pipelined);
+    // The vertices of the box are static
+    std::dynamic_pointer_cast<PbdCollisionHandling>(interaction->getCollisionHandlingA())->setEnableBoundaryCollisions(true);
+
+    pbdObj->initialize();
+    boxObj->initialize();
+    model->initialize();
+    interaction->initialize();
+    return interaction;
+}
+
+///
+/// \brief Nests the graphs of the objects and of the interaction as the scene does
+///
+std::shared_ptr<TaskGraph>
+makeSceneGraph(std::shared_ptr<PbdObjectCollision> interaction)
+{
+    auto graph = std::make_shared<TaskGraph>();
+    graph->addEdge(graph->getSource(), graph->getSink());
+    const std::vector<std::shared_ptr<SceneObject>> objects = { interaction->getObjectA(), interaction->getObjectB(), interaction };
+    for (const auto& obj : objects)
+    {
+        obj->initGraphEdges();
+        graph->nestGraph(TaskGraph::removeUnusedNodes(obj->getTaskGraph()), graph->getSource(), graph->getSink());
+    }
+    return graph;
+}
+
+///
+/// \brief Runs a step of the graph
+///
+void
+step(std::shared_ptr<TaskGraph> graph)
+{
+    std::shared_ptr<TaskNodeList> nodes = TaskGraph::topologicalSort(graph);
+    for (const auto& node : *nodes)
+    {
+        node->execute();
+    }
+}
+} // namespace
+
+///
+/// \brief Test that pipelined the detection and the handling aren't ordered, so they
+/// may overlap, and both are done before the swap which is done before the solve
+///
+TEST(imstkPbdObjectCollisionTest, PipelinedGraph)
+{
+    std::shared_ptr<PbdObjectCollision> serial = makeFallingPoints(false);
+    EXPECT_TRUE(makeSceneGraph(serial)->isReachable(serial->getCollisionDetectionNode(), serial->getCollisionHandlingANode()));
+
+    std::shared_ptr<PbdObjectCollision> pipelined = makeFallingPoints(true);
+    std::shared_ptr<TaskGraph>          graph     = makeSceneGraph(pipelined);
+    std::shared_ptr<TaskNode>           cdNode    = pipelined->getCollisionDetectionNode();
+    std::shared_ptr<TaskNode>           chNode    = pipelined->getCollisionHandlingANode();
+    std::shared_ptr<TaskNode>           swapNode  = pipelined->getCollisionDataSwapNode();
+    EXPECT_FALSE(graph->isReachable(cdNode, chNode));
+    EXPECT_FALSE(graph->isReachable(chNode, cdNode));
+    EXPECT_TRUE(graph->isReachable(cdNode, swapNode));
+    EXPECT_TRUE(graph->isReachable(chNode, swapNode));
+    auto pbdObj = std::dynamic_pointer_cast<PbdObject>(pipelined->getObjectA());
+    EXPECT_TRUE(graph->isReachable(swapNode, pbdObj->getPbdModel()->getSolveNode()));
+}
+
+///
+/// \brief Test that pipelined the contacts are handled the step after they are
+/// detected, and the points still come to rest on the box
+///
+TEST(imstkPbdObjectCollisionTest, PipelinedHandlingStepLate)
+{
+    std::shared_ptr<PbdObjectCollision> serial    = makeFallingPoints(false);
+    std::shared_ptr<PbdObjectCollision> pipelined = makeFallingPoints(true);
+    auto serialCH    = std::dynamic_pointer_cast<PbdCollisionHandling>(serial->getCollisionHandlingAB());
+    auto pipelinedCH = std::dynamic_pointer_cast<PbdCollisionHandling>(pipelined->getCollisionHandlingAB());
+    std::shared_ptr<CollisionData> pipelinedData = pipelined->getCollisionDetection()->getCollisionData();
+    std::shared_ptr<TaskGraph>     serialGraph    = makeSceneGraph(serial);
+    std::shared_ptr<TaskGraph>     pipelinedGraph = makeSceneGraph(pipelined);
+
+    // Same motion until the first contact
+    int numSteps = 0;
+    while (serialCH->getConstraints().empty() && numSteps < 100)
+    {
+        step(serialGraph);
+        step(pipelinedGraph);
+        numSteps++;
+        if (serialCH->getConstraints().empty())
+        {
+            EXPECT_TRUE(pipelinedData->elementsA.empty());
+        }
+    }
+    ASSERT_LT(numSteps, 100);
+    EXPECT_FALSE(pipelinedData->elementsA.empty());
+    EXPECT_TRUE(pipelinedCH->getConstraints().empty());
+
+    step(pipelinedGraph);
+    EXPECT_FALSE(pipelinedCH->getConstraints().empty());
+
+    for (int i = 0; i < 100; i++)
+    {
+        step(serialGraph);
+        step(pipelinedGraph);
+    }
+    const VecDataArray<double, 3>& serialVertices    = *std::dynamic_pointer_cast<PointSet>(serial->getObjectA()->getCollidingGeometry())->getVertexPositions();
+    const VecDataArray<double, 3>& pipelinedVertices = *std::dynamic_pointer_cast<PointSet>(pipelined->getObjectA()->getCollidingGeometry())->getVertexPositions();
+    for (int i = 0; i < serialVertices.size(); i++)
+    {
+        EXPECT_NEAR(serialVertices[i][1], 0.0, 1.0e-3);
+        EXPECT_NEAR(pipelinedVertices[i][1], 0.0, 1.0e-3);
+    }
+}
+
+///
+/// \brief Test that the sub-step collision of interactions of the same name on one
+/// model are kept apart, and removed with the interaction
+///
+TEST(imstkPbdObjectCollisionTest, SubstepCollisionSameName)
+{
+    auto model = std::make_shared<PbdModel>();
+    model->getConfig()->m_dt = 0.01;
+    model->getConfig()->m_doPartitioning      = false;
+    model->getConfig()->m_substeps            = 2;
+    model->getConfig()->m_collisionPerSubstep = true;
+    std::shared_ptr<PbdObjectCollision> interactions[2] = { makeFallingPoints(false, model), makeFallingPoints(false, model) };
+    ASSERT_EQ(interactions[0]->getName(), interactions[1]->getName());
+
+    auto moveIntoBox = [](std::shared_ptr<PbdObjectCollision> interaction)
+                       {
+                           std::shared_ptr<PbdBody> body = std::dynamic_pointer_cast<PbdObject>(interaction->getObjectA())->getPbdBody();
+                           for (int i = 0; i < body->vertices->size(); i++)
+                           {
+                               (*body->vertices)[i][1] = -0.5;
+                               (*body->velocities)[i]  = Vec3d::Zero();
+                           }
+                       };
+
+    // Register the sub-step collision
+    for (const auto& interaction : interactions)
+    {
+        makeSceneGraph(interaction);
+        moveIntoBox(interaction);
+    }
+
+    // Only the sub-step collision detects
+    model->integratePosition();
+    model->solveConstraints();
+    EXPECT_FALSE(interactions[0]->getCollisionDetection()->getCollisionData()->elementsA.empty());
+    EXPECT_FALSE(interactions[1]->getCollisionDetection()->getCollisionData()->elementsA.empty());
+
+    model->updateVelocity();
+
+    // Removing one keeps the other
+    std::shared_ptr<CollisionData> data = interactions[1]->getCollisionDetection()->getCollisionData();
+    interactions[0] = nullptr;
+    data->elementsA.clear();
+    moveIntoBox(interactions[1]);
+    model->integratePosition();
+    model->solveConstraints();
+    EXPECT_FALSE(data->elementsA.empty());
+}
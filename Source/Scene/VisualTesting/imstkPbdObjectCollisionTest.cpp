@@ -220,7 +220,9 @@ public:
         m_pbdCollision->setFriction(m_friction);
         m_pbdCollision->setRestitution(m_restitution);
         m_pbdCollision->setDeformableStiffnessA(m_collisionStiffness);
-        std::dynamic_pointer_cast<PbdCollisionHandling>(m_pbdCollision->getCollisionHandlingA())->setEnableBoundaryCollisions(true);
+        auto pbdCH = std::dynamic_pointer_cast<PbdCollisionHandling>(m_pbdCollision->getCollisionHandlingA());
+        pbdCH->setEnableBoundaryCollisions(true);
+        pbdCH->setUseParallelHandling(m_parallelHandling);
         // Debug geometry to visualize collision data
         m_cdDebugModel = m_pbdCollision->addComponent<CollisionDataDebugModel>();
         m_cdDebugModel->setInputCD(m_pbdCollision->getCollisionDetection()->getCollisionData());
@@ -275,6 +277,7 @@ public:
     double      m_friction           = 0.0;
     double      m_restitution        = 0.0;
     double      m_collisionStiffness = 0.5;
+    bool        m_parallelHandling   = false;
     std::shared_ptr<CollisionDataDebugModel> m_cdDebugModel = nullptr;
 
     // For assertions
@@ -501,6 +504,35 @@ TEST_F(PbdObjectCollisionTest, PbdTissue_SurfaceMeshToSphereCD)
     runFor(2.0);
 }
 
+///
+/// \brief Test SurfaceMeshToSphereCD with PbdObjectCollision, generating the
+/// contacts in parallel
+///
+TEST_F(PbdObjectCollisionTest, PbdTissue_SurfaceMeshToSphereCD_ParallelHandling)
+{
+    // Setup the tissue
+    m_pbdObj = makeTriTissueObj("Tissue",
+        Vec2d(0.3, 0.3), Vec2i(9, 9), Vec3d::Zero(),
+        Quatd(Rotd(0.4, Vec3d(0.0, 0.0, 1.0))));
+
+    // Setup the geometry
+    auto implicitGeom = std::make_shared<Sphere>();
+    implicitGeom->setPosition(0.0, -0.3, 0.0);
+    implicitGeom->setRadius(0.2);
+    m_collidingGeometry = implicitGeom;
+
+    m_collisionName    = "SurfaceMeshToSphereCD";
+    m_friction         = 0.0;
+    m_restitution      = 0.0;
+    m_parallelHandling = true;
+
+    m_assertionBoundsMin = Vec3d(-1.0, -0.5, -1.0);
+    m_assertionBoundsMax = Vec3d(1.0, 1.0, 1.0);
+
+    createScene();
+    runFor(2.0);
+}
+
 ///
 /// \brief Test SurfaceMeshToCapsuleCD with PbdObjectCollision
 ///
@@ -7,6 +7,7 @@
 #include "imstkCDObjectFactory.h"
 #include "imstkCollisionInteraction.h"
 #include "imstkCollidingObject.h"
+#include "imstkCollisionData.h"
 #include "imstkCollisionDetectionAlgorithm.h"
 #include "imstkCollisionHandling.h"
 #include "imstkTaskGraph.h"
@@ -89,9 +90,30 @@ CollisionInteraction::updateCD()
 {
     if (m_colDetect != nullptr)
     {
+        m_colDetect->setPipelined(m_pipelined);
         m_colDetect->update();
     }
 
+    // Pipelined, the new elements are only in the front once swapped
+    if (!m_pipelined)
+    {
+        addCollisions();
+    }
+}
+
+void
+CollisionInteraction::swapCollisionData()
+{
+    for (const auto& item : *m_colDetect->getCollisionDataVector())
+    {
+        item->swapBuffers();
+    }
+    addCollisions();
+}
+
+void
+CollisionInteraction::addCollisions()
+{
     auto dataVector = m_colDetect->getCollisionDataVector();
     for (const auto& item : *dataVector)
     {
@@ -152,6 +174,8 @@ CollisionInteraction::setEnabled(const bool enabled)
                 // Clear the data (since CD clear is only run before CD is performed)
                 data->elementsA.resize(0);
                 data->elementsB.resize(0);
+                data->backElementsA.resize(0);
+                data->backElementsB.resize(0);
             }
         }
     }
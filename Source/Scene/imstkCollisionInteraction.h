@@ -49,6 +49,9 @@ public:
     ///
     void setCollisionHandlingAB(std::shared_ptr<CollisionHandling> colHandlingAB);
 
+    std::shared_ptr<CollidingObject> getObjectA() const { return m_objA; }
+    std::shared_ptr<CollidingObject> getObjectB() const { return m_objB; }
+
     std::shared_ptr<CollisionDetectionAlgorithm> getCollisionDetection() const { return m_colDetect; }
     std::shared_ptr<CollisionHandling> getCollisionHandlingA() const { return m_colHandlingA; }
     std::shared_ptr<CollisionHandling> getCollisionHandlingB() const { return m_colHandlingB; }
@@ -57,6 +60,7 @@ public:
     std::shared_ptr<TaskNode> getCollisionDetectionNode() const { return m_collisionDetectionNode; }
     std::shared_ptr<TaskNode> getCollisionHandlingANode() const { return m_collisionHandleANode; }
     std::shared_ptr<TaskNode> getCollisionHandlingBNode() const { return m_collisionHandleBNode; }
+    std::shared_ptr<TaskNode> getCollisionGeometryUpdateNode() const { return m_collisionGeometryUpdateNode; }
 
     void updateCollisionGeometry();
 
@@ -75,6 +79,17 @@ protected:
     ///
     void updateCD();
 
+    ///
+    /// \brief Swap the buffers of the collision data once a pipelined detection and
+    /// the handling of the elements before it are done
+    ///
+    void swapCollisionData();
+
+    ///
+    /// \brief Give the collision data that has elements to both objects
+    ///
+    void addCollisions();
+
     ///
     /// \brief Update handler A
     ///
@@ -98,5 +113,6 @@ protected:
     std::shared_ptr<TaskNode> m_collisionGeometryUpdateNode = nullptr;
 
     bool m_didUpdateThisFrame = false;
+    bool m_pipelined = false; ///< Detection is left in the back buffers until swapCollisionData
 };
 } // namespace imstk
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "imstkCollisionData.h"
 #include "imstkCCDAlgorithm.h"
 #include "imstkCollisionDetectionAlgorithm.h"
+#include "imstkImplicitGeometry.h"
 #include "imstkPbdCollisionHandling.h"
 #include "imstkPbdModel.h"
 #include "imstkPbdObject.h"
@@ -24,6 +25,16 @@ PbdObjectCollision::PbdObjectCollision(std::shared_ptr<PbdObject> obj1, std::sha
     setupConnections(obj1, obj2, cdType);
 }
 
+PbdObjectCollision::~PbdObjectCollision()
+{
+    // The model may outlive the interaction
+    auto pbdObj = std::dynamic_pointer_cast<PbdObject>(m_objA);
+    if (pbdObj != nullptr && pbdObj->getPbdModel() != nullptr)
+    {
+        pbdObj->getPbdModel()->removeSubstepCollisionFunction(getID());
+    }
+}
+
 void
 PbdObjectCollision::setRestitution(const double restitution)
 {
@@ -143,8 +154,24 @@ PbdObjectCollision::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared
     // -------------------------------------------------------------------------
     m_taskGraph->addEdge(pbdObj1->getPbdModel()->getIntegratePositionNode(), m_collisionGeometryUpdateNode);
     m_taskGraph->addEdge(m_collisionGeometryUpdateNode, m_collisionDetectionNode);
-    m_taskGraph->addEdge(m_collisionDetectionNode, chNodeAB); // A=AB=B
-    m_taskGraph->addEdge(chNodeAB, pbdObj1->getPbdModel()->getSolveNode());
+    if (m_pipelined)
+    {
+        // Collision Geometry Update -> (Collision Detection || PbdHandlerAB of the last
+        // detection) -> Swap Collision Data -> Collision Constraint Solve
+        LOG_IF(WARNING, std::dynamic_pointer_cast<ImplicitGeometry>(m_objB->getCollidingGeometry()) != nullptr)
+            << "PbdObjectCollision " << getName() << " is pipelined against implicit geometry, "
+            << "its contacts are resolved by the depth of the step before";
+        m_taskGraph->addNode(m_collisionDataSwapNode);
+        m_taskGraph->addEdge(m_collisionGeometryUpdateNode, chNodeAB);
+        m_taskGraph->addEdge(m_collisionDetectionNode, m_collisionDataSwapNode);
+        m_taskGraph->addEdge(chNodeAB, m_collisionDataSwapNode);
+        m_taskGraph->addEdge(m_collisionDataSwapNode, pbdObj1->getPbdModel()->getSolveNode());
+    }
+    else
+    {
+        m_taskGraph->addEdge(m_collisionDetectionNode, chNodeAB); // A=AB=B
+        m_taskGraph->addEdge(chNodeAB, pbdObj1->getPbdModel()->getSolveNode());
+    }
 
     m_taskGraph->addEdge(pbdObj1->getPbdModel()->getSolveNode(), m_updatePrevGeometryCCDNode);
     m_taskGraph->addEdge(m_updatePrevGeometryCCDNode, pbdObj1->getPbdModel()->getUpdateVelocityNode());
@@ -154,6 +181,23 @@ PbdObjectCollision::initGraphEdges(std::shared_ptr<TaskNode> source, std::shared
         m_taskGraph->addEdge(obj2->getUpdateGeometryNode(), m_collisionGeometryUpdateNode);
         m_taskGraph->addEdge(m_collisionDetectionNode, obj2->getTaskGraph()->getSink());
     }
+
+    // The model may redo collision on its sub-steps, CCD keeps sweeping from the
+    // previous step as its previous geometry is only updated once per step
+    std::weak_ptr<Entity> weakThis = shared_from_this();
+    pbdObj1->getPbdModel()->setSubstepCollisionFunction(getID(), [this, weakThis]()
+        {
+            if (weakThis.lock() != nullptr)
+            {
+                m_collisionGeometryUpdateNode->execute();
+                m_collisionDetectionNode->execute();
+                if (m_pipelined)
+                {
+                    m_collisionDataSwapNode->execute();
+                }
+                m_collisionHandleANode->execute();
+            }
+        });
 }
 
 void
@@ -179,6 +223,9 @@ PbdObjectCollision::setupConnections(std::shared_ptr<PbdObject> obj1, std::share
         });
     m_taskGraph->addNode(m_updatePrevGeometryCCDNode);
 
+    m_collisionDataSwapNode = std::make_shared<TaskNode>(std::bind(&PbdObjectCollision::swapCollisionData, this),
+        obj1->getName() + "_vs_" + obj2->getName() + "_CollisionDataSwap", true);
+
     setCollisionHandlingAB(ch);
 
     m_taskGraph->addNode(obj1->getTaskGraph()->getSource());
@@ -28,7 +28,10 @@ public:
     PbdObjectCollision(std::shared_ptr<PbdObject> obj1, std::shared_ptr<CollidingObject> obj2,
                        std::string cdType = "");
 
-    ~PbdObjectCollision() override = default;
+    ///
+    /// \brief Removes the sub-step collision of the interaction from the model
+    ///
+    ~PbdObjectCollision() override;
 
     IMSTK_TYPE_NAME(PbdObjectCollision)
 
@@ -76,6 +79,20 @@ public:
     double getDeformableStiffnessB() const;
     /// @}
 
+    ///
+    /// \brief Get/Set whether the contacts detected last step are handled at the same
+    /// time as the detection of this step instead of after it, so both overlap. The
+    /// detected contacts are swapped in once both are done and handled a step late.
+    /// Sub-step collision isn't pipelined. Contacts with implicit geometry are resolved by
+    /// the depth they were detected at, which is stale a step later, so pipelining suits
+    /// contacts between meshes. Set before the scene is initialized, defaults to false
+    /// @{
+    void setPipelined(const bool pipelined) { m_pipelined = pipelined; }
+    bool getPipelined() const { return m_pipelined; }
+    /// @}
+
+    std::shared_ptr<TaskNode> getCollisionDataSwapNode() const { return m_collisionDataSwapNode; }
+
     ///
     /// \brief Setup connectivity of task graph
     ///
@@ -83,6 +100,7 @@ public:
 
 protected:
     std::shared_ptr<TaskNode> m_updatePrevGeometryCCDNode = nullptr;
+    std::shared_ptr<TaskNode> m_collisionDataSwapNode     = nullptr;
 
 private:
     /// Called from the constructor
@@ -9,6 +9,8 @@
 #include "imstkDeviceControl.h"
 #include "imstkCameraController.h"
 #include "imstkCollisionDetectionAlgorithm.h"
+#include "imstkCollisionInteraction.h"
+#include "imstkDynamicObject.h"
 #include "imstkFeDeformableObject.h"
 #include "imstkFemDeformableBodyModel.h"
 #include "imstkLight.h"
@@ -171,6 +173,56 @@ Scene::computeBoundingBox(Vec3d& lowerCorner, Vec3d& upperCorner, const double p
     upperCorner = upperCorner + range * (paddingPercent / 100.0);
 }
 
+///
+/// \brief Declares the geometries written by the nodes of the object, used
+/// to check the graph for unordered writes before parallel execution
+///
+static void
+setGeometryWrites(SceneObject& obj)
+{
+    auto addGeometry =
+        [](std::vector<const void*>& writes, std::shared_ptr<Geometry> geom)
+        {
+            if (geom != nullptr && std::find(writes.begin(), writes.end(), geom.get()) == writes.end())
+            {
+                writes.push_back(geom.get());
+            }
+        };
+    auto addObjectGeometries =
+        [&](std::vector<const void*>& writes, SceneObject& sceneObj)
+        {
+            for (const auto& comp : sceneObj.getComponents())
+            {
+                if (auto visualModel = std::dynamic_pointer_cast<VisualModel>(comp))
+                {
+                    addGeometry(writes, visualModel->getGeometry());
+                }
+            }
+            if (auto colObj = dynamic_cast<CollidingObject*>(&sceneObj))
+            {
+                addGeometry(writes, colObj->getCollidingGeometry());
+            }
+            if (auto dynObj = dynamic_cast<DynamicObject*>(&sceneObj))
+            {
+                addGeometry(writes, dynObj->getPhysicsGeometry());
+            }
+        };
+
+    // SceneObject::updateGeometries
+    std::vector<const void*>& writes = obj.getUpdateGeometryNode()->m_writes;
+    writes.clear();
+    addObjectGeometries(writes, obj);
+
+    // CollisionInteraction::updateCollisionGeometry updates the geometries of both objects
+    if (auto interaction = dynamic_cast<CollisionInteraction*>(&obj))
+    {
+        std::vector<const void*>& colWrites = interaction->getCollisionGeometryUpdateNode()->m_writes;
+        colWrites.clear();
+        addObjectGeometries(colWrites, *interaction->getObjectA());
+        addObjectGeometries(colWrites, *interaction->getObjectB());
+    }
+}
+
 void
 Scene::buildTaskGraph()
 {
@@ -187,6 +239,7 @@ Scene::buildTaskGraph()
         if (auto obj = std::dynamic_pointer_cast<SceneObject>(ent))
         {
             obj->initGraphEdges();
+            setGeometryWrites(*obj);
         }
         for (const auto& comp : ent->getComponents())
         {
@@ -236,7 +289,14 @@ Scene::buildTaskGraph()
 void
 Scene::initTaskGraph()
 {
-    m_taskGraphController = std::make_shared<SequentialTaskGraphController>();
+    if (m_config->taskParallelizationEnabled)
+    {
+        m_taskGraphController = std::make_shared<TbbTaskGraphController>();
+    }
+    else
+    {
+        m_taskGraphController = std::make_shared<SequentialTaskGraphController>();
+    }
 
     if (TaskGraph::isCyclic(m_taskGraph))
     {
@@ -262,6 +322,16 @@ Scene::initTaskGraph()
         node->m_enableTiming = m_config->taskTimingEnabled;
     }
 
+    // Nodes writing the same geometry need an ordering to be executed in parallel
+    if (m_config->taskParallelizationEnabled)
+    {
+        for (const auto& nodePair : TaskGraph::getUnorderedWrites(m_taskGraph))
+        {
+            LOG(WARNING) << "TaskNodes \"" << nodePair.first->m_name << "\" and \"" << nodePair.second->m_name
+                         << "\" write the same geometry without an ordering edge, they may run concurrently";
+        }
+    }
+
     // Generate unique names among the nodes
     TaskGraph::getUniqueNodeNames(m_taskGraph, true);
     m_nodeComputeTimes.clear();
@@ -36,7 +36,8 @@ struct SceneConfig
     // Keep track of the fps for the scene
     bool trackFPS = false;
 
-    // If off, tasks will run sequentially
+    // If on, independent tasks of the task graph run in parallel using tbb's work
+    // stealing scheduler. If off, tasks will run sequentially
     bool taskParallelizationEnabled = false;
 
     // If on, elapsed times for computational steps will be reported in map
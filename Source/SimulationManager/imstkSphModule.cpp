@@ -0,0 +1,55 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkSphModule.h"
+#include "imstkLogger.h"
+#include "imstkSphModel.h"
+
+namespace imstk
+{
+SphModule::SphModule(std::shared_ptr<SphModel> sphModel)
+{
+    // Runs on its own thread
+    m_executionType = ExecutionType::PARALLEL;
+    setSphModel(sphModel);
+}
+
+void
+SphModule::setSphModel(std::shared_ptr<SphModel> sphModel)
+{
+    m_sphModel = sphModel;
+    if (m_sphModel != nullptr)
+    {
+        m_sphModel->setAsyncStepping(true);
+    }
+}
+
+bool
+SphModule::initModule()
+{
+    if (m_sphModel == nullptr)
+    {
+        LOG(WARNING) << "SphModule has no SphModel to step";
+        return false;
+    }
+    if (m_sphModel->getCurrentState() == nullptr)
+    {
+        LOG(WARNING) << "SphModule requires its SphModel to be initialized, add its object to the scene";
+        return false;
+    }
+    m_timer.start();
+    return true;
+}
+
+void
+SphModule::updateModule()
+{
+    const double dt = (m_dt > 0.0) ? m_dt : m_timer.getTimeElapsed() * 0.001; // ms->s
+    m_timer.start();
+
+    m_sphModel->advance(dt);
+}
+} // namespace imstk
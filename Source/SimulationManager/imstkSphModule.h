@@ -0,0 +1,55 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkModule.h"
+#include "imstkMacros.h"
+
+namespace imstk
+{
+class SphModel;
+
+///
+/// \class SphModule
+///
+/// \brief Steps a SphModel on its own thread, decoupled from the scene. The model
+/// is switched to asynchronous stepping, the scene then only picks up the latest
+/// published particle positions and the SphCollisionHandling corrections are
+/// applied by this module before its next step. Every update advances the fluid
+/// by the module dt, or by the real time passed since the last update if it is 0.
+/// The SphObject must still be in a scene for it to be initialized and rendered
+///
+class SphModule : public Module
+{
+public:
+    SphModule(std::shared_ptr<SphModel> sphModel = nullptr);
+    ~SphModule() override = default;
+
+    IMSTK_TYPE_NAME(SphModule)
+
+    ///
+    /// \brief Set/Get the model to step, must be set before the scene is initialized
+    ///@{
+    void setSphModel(std::shared_ptr<SphModel> sphModel);
+    std::shared_ptr<SphModel> getSphModel() const { return m_sphModel; }
+    ///@}
+
+    ///
+    /// \brief Initialize the module, the model must have been initialized
+    ///
+    bool initModule() override;
+
+    ///
+    /// \brief Advance the fluid and publish its positions
+    ///
+    void updateModule() override;
+
+protected:
+    std::shared_ptr<SphModel> m_sphModel = nullptr;
+    StopWatch m_timer; ///< measures the real time between updates
+};
+} // namespace imstk
@@ -0,0 +1,104 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkGaussSeidel.h"
+#include "imstkJacobi.h"
+#include "imstkSOR.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace imstk;
+
+///
+/// \brief Diagonally dominant system of a dim^3 grid of nodes with 3 dofs each, 7 point
+/// stencil coupling the same dofs of neighboring nodes
+///
+static SparseMatrixd
+makeSystem(const int dim)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int z = 0; z < dim; z++)
+    {
+        for (int y = 0; y < dim; y++)
+        {
+            for (int x = 0; x < dim; x++)
+            {
+                const int i = x + dim * (y + dim * z);
+                for (const int j : { (x > 0) ? i - 1 : -1, (x + 1 < dim) ? i + 1 : -1,
+                                     (y > 0) ? i - dim : -1, (y + 1 < dim) ? i + dim : -1,
+                                     (z > 0) ? i - dim * dim : -1, (z + 1 < dim) ? i + dim * dim : -1 })
+                {
+                    if (j != -1)
+                    {
+                        for (int r = 0; r < 3; r++)
+                        {
+                            triplets.push_back(Eigen::Triplet<double>(3 * i + r, 3 * j + r, -1.0));
+                        }
+                    }
+                }
+                for (int r = 0; r < 3; r++)
+                {
+                    triplets.push_back(Eigen::Triplet<double>(3 * i + r, 3 * i + r, 7.0));
+                }
+            }
+        }
+    }
+    SparseMatrixd A(3 * dim * dim * dim, 3 * dim * dim * dim);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    A.makeCompressed();
+    return A;
+}
+
+///
+/// \brief A fixed number of iterations of \p solver, serial if state.range(1) is 0
+///
+static void
+benchmarkSolver(benchmark::State& state, IterativeLinearSolver& solver)
+{
+    const SparseMatrixd A = makeSystem(static_cast<int>(state.range(0)));
+    const Vectord       b = Vectord::Ones(A.rows());
+    solver.setParallel(state.range(1) != 0);
+    solver.setTolerance(0.0);
+    solver.setMaxNumIterations(20);
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+    Vectord x;
+    for (auto _ : state)
+    {
+        solver.solve(x);
+        benchmark::DoNotOptimize(x.data());
+    }
+    state.counters["Dofs"] = static_cast<double>(A.rows());
+}
+
+static void
+BM_GaussSeidel(benchmark::State& state)
+{
+    GaussSeidel solver;
+    benchmarkSolver(state, solver);
+}
+
+static void
+BM_SOR(benchmark::State& state)
+{
+    SOR solver(1.5);
+    benchmarkSolver(state, solver);
+}
+
+static void
+BM_Jacobi(benchmark::State& state)
+{
+    Jacobi solver;
+    benchmarkSolver(state, solver);
+}
+
+// Serial and parallel, about 3k, 100k and 300k dofs
+BENCHMARK(BM_GaussSeidel)->Unit(benchmark::kMillisecond)->ArgsProduct({ { 10, 32, 46 }, { 0, 1 } });
+BENCHMARK(BM_SOR)->Unit(benchmark::kMillisecond)->ArgsProduct({ { 10, 32, 46 }, { 0, 1 } });
+BENCHMARK(BM_Jacobi)->Unit(benchmark::kMillisecond)->ArgsProduct({ { 10, 32, 46 }, { 0, 1 } });
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,159 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "gtest/gtest.h"
+
+#include "imstkConjugateGradient.h"
+#include "imstkLinearProjectionConstraint.h"
+#include "imstkLinearSystemTest.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Spd system of a grid of nodes with 3 coupled dofs each
+///
+SparseMatrixd
+makeSystem(const int dim)
+{
+    std::vector<std::pair<int, int>> edges;
+    for (int y = 0; y < dim; y++)
+    {
+        for (int x = 0; x < dim; x++)
+        {
+            const int i = x + dim * y;
+            if (x + 1 < dim)
+            {
+                edges.push_back({ i, i + 1 });
+            }
+            if (y + 1 < dim)
+            {
+                edges.push_back({ i, i + dim });
+            }
+        }
+    }
+    return makeCoupledSystem(dim * dim, edges, 0.01);
+}
+
+///
+/// \brief Solve with the given preconditioner and return the number of iterations
+///
+size_t
+solve(const SparseMatrixd& A, const Vectord& b, Vectord& x, const ConjugateGradient::Preconditioner preconditioner)
+{
+    ConjugateGradient cg;
+    cg.setPreconditioner(preconditioner);
+    cg.setTolerance(1.0e-10);
+    cg.setMaxNumIterations(1000);
+    cg.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+    cg.solve(x);
+    return cg.getNumIterations();
+}
+} // namespace
+
+///
+/// \brief Test that every preconditioner solves the system, incomplete Cholesky and
+/// block Jacobi in fewer iterations than the diagonal
+///
+TEST(imstkConjugateGradientTest, Preconditioners)
+{
+    const SparseMatrixd A = makeSystem(20);
+    const Vectord       b = Vectord::Ones(A.rows());
+
+    Vectord      x;
+    const size_t diagonalIters = solve(A, b, x, ConjugateGradient::Preconditioner::Diagonal);
+    EXPECT_LT((A * x - b).norm(), 1.0e-8 * b.norm());
+
+    const size_t blockJacobiIters = solve(A, b, x, ConjugateGradient::Preconditioner::BlockJacobi);
+    EXPECT_LT((A * x - b).norm(), 1.0e-8 * b.norm());
+
+    const size_t icIters = solve(A, b, x, ConjugateGradient::Preconditioner::IncompleteCholesky);
+    EXPECT_LT((A * x - b).norm(), 1.0e-8 * b.norm());
+
+    EXPECT_LT(blockJacobiIters, diagonalIters);
+    EXPECT_LT(icIters, diagonalIters);
+}
+
+///
+/// \brief Test the modified solve with a fixed node for every preconditioner, and matrix
+/// free with an operator giving the same solution
+///
+TEST(imstkConjugateGradientTest, ModifiedAndMatrixFree)
+{
+    const SparseMatrixd A = makeSystem(10);
+    const Vectord       b = Vectord::Ones(A.rows());
+
+    std::vector<LinearProjectionConstraint> fixed;
+    fixed.push_back(LinearProjectionConstraint(0, true));
+
+    Vectord expected;
+    for (const ConjugateGradient::Preconditioner preconditioner : {
+            ConjugateGradient::Preconditioner::Diagonal,
+            ConjugateGradient::Preconditioner::BlockJacobi,
+            ConjugateGradient::Preconditioner::IncompleteCholesky })
+    {
+        for (const bool matrixFree : { false, true })
+        {
+            ConjugateGradient cg;
+            cg.setPreconditioner(preconditioner);
+            cg.setTolerance(1.0e-10);
+            cg.setMaxNumIterations(1000);
+            cg.setLinearProjectors(&fixed);
+            if (matrixFree)
+            {
+                cg.setMatrixFreeOperator(
+                    [&](const Vectord& x, Vectord& y) { y = A * x; },
+                    [&](StdVectorOfMat3d& blocks) { BlockJacobiPreconditioner::getBlockDiagonal(A, blocks); });
+            }
+
+            // The matrix is not used matrix free
+            const SparseMatrixd empty(A.rows(), A.cols());
+            cg.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(matrixFree ? empty : A, b));
+
+            Vectord x;
+            cg.solve(x);
+            EXPECT_EQ(x.segment<3>(0), Vec3d::Zero());
+
+            Vectord res = b - A * x;
+            res.segment<3>(0).setZero();
+            EXPECT_LT(res.norm(), 1.0e-8 * b.norm());
+            if (expected.size() == 0)
+            {
+                expected = x;
+            }
+            EXPECT_LT((x - expected).norm(), 1.0e-6 * expected.norm());
+        }
+    }
+}
+
+///
+/// \brief Test that a warm start continues from the given solution
+///
+TEST(imstkConjugateGradientTest, WarmStart)
+{
+    const SparseMatrixd A = makeSystem(10);
+    const Vectord       b = Vectord::Ones(A.rows());
+    Vectord             solution;
+    solve(A, b, solution, ConjugateGradient::Preconditioner::Diagonal);
+
+    ConjugateGradient cg;
+    cg.setTolerance(1.0e-6);
+    cg.setMaxNumIterations(1);
+    cg.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+    // One iteration from zero is far off
+    Vectord x = solution;
+    cg.solve(x);
+    EXPECT_GT((A * x - b).norm(), 1.0e-3 * b.norm());
+
+    // Starting at the solution stays there
+    cg.setWarmStart(true);
+    x = solution;
+    cg.solve(x);
+    EXPECT_EQ(cg.getNumIterations(), 0);
+    EXPECT_LT((x - solution).norm(), 1.0e-6 * solution.norm());
+}
@@ -0,0 +1,132 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "gtest/gtest.h"
+
+#include "imstkDirectLinearSolver.h"
+#include "imstkLinearSystemTest.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Spd system of a chain of nodes with 3 coupled dofs each, scaled by \p scale
+///
+SparseMatrixd
+makeSystem(const int numNodes, const double scale = 1.0)
+{
+    std::vector<std::pair<int, int>> edges;
+    for (int i = 0; i + 1 < numNodes; i++)
+    {
+        edges.push_back({ i, i + 1 });
+    }
+    return makeCoupledSystem(numNodes, edges, 0.1, scale);
+}
+
+///
+/// \brief Zero the rows and columns of the dofs of \p node keeping a unit diagonal, as
+/// fixed boundary conditions do
+///
+void
+fixNode(SparseMatrixd& A, const int node)
+{
+    for (int k = 0; k < A.outerSize(); k++)
+    {
+        for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
+        {
+            if (it.row() / 3 == node || it.col() / 3 == node)
+            {
+                it.valueRef() = (it.row() == it.col()) ? 1.0 : 0.0;
+            }
+        }
+    }
+}
+} // namespace
+
+///
+/// \brief Test both factorizations solve and the pattern is only analyzed once while
+/// the values change
+///
+TEST(imstkDirectLinearSolverTest, CachedAnalysis)
+{
+    const Vectord b = Vectord::Ones(3 * 50);
+    for (const auto factorization : { DirectLinearSolver<SparseMatrixd>::Factorization::LU,
+                                      DirectLinearSolver<SparseMatrixd>::Factorization::LDLT })
+    {
+        DirectLinearSolver<SparseMatrixd> solver;
+        solver.setFactorization(factorization);
+        EXPECT_FALSE(solver.isIterative());
+
+        for (int i = 1; i <= 3; i++)
+        {
+            const SparseMatrixd A = makeSystem(50, static_cast<double>(i));
+            solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+            Vectord x;
+            solver.solve(x);
+            EXPECT_LT((A * x - b).norm(), 1.0e-10 * b.norm());
+        }
+        EXPECT_EQ(solver.getNumPatternAnalyses(), 1);
+        EXPECT_EQ(solver.getNumFactorizations(), 3);
+
+        // The same values are not factorized again
+        const SparseMatrixd A3 = makeSystem(50, 3.0);
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A3, b));
+        EXPECT_EQ(solver.getNumFactorizations(), 3);
+        EXPECT_EQ(solver.getType(), (factorization == DirectLinearSolver<SparseMatrixd>::Factorization::LU)
+            ? LinearSolver<SparseMatrixd>::Type::LUFactorization : LinearSolver<SparseMatrixd>::Type::LDLTFactorization);
+
+        // A different pattern is analyzed again
+        const SparseMatrixd A = makeSystem(60);
+        const Vectord       b2 = Vectord::Ones(A.rows());
+        solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b2));
+        Vectord x;
+        solver.solve(x);
+        EXPECT_LT((A * x - b2).norm(), 1.0e-10 * b2.norm());
+        EXPECT_EQ(solver.getNumPatternAnalyses(), 2);
+    }
+}
+
+///
+/// \brief Test that fixing a few nodes is solved by a low rank update of the factorization,
+/// and that fixing many factorizes again
+///
+TEST(imstkDirectLinearSolverTest, LowRankUpdate)
+{
+    const SparseMatrixd A0 = makeSystem(50);
+    const Vectord       b  = Vectord::LinSpaced(A0.rows(), 1.0, 2.0);
+
+    DirectLinearSolver<SparseMatrixd> solver;
+    solver.setFactorization(DirectLinearSolver<SparseMatrixd>::Factorization::LDLT);
+    solver.setLowRankUpdate(true);
+    solver.setMaxUpdateRank(12);
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A0, b));
+    EXPECT_EQ(solver.getNumFactorizations(), 1);
+
+    // Fix two nodes, 6 dofs
+    SparseMatrixd A = A0;
+    fixNode(A, 0);
+    fixNode(A, 20);
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+    EXPECT_EQ(solver.getNumFactorizations(), 1);
+    EXPECT_GT(solver.getUpdateRank(), 0);
+
+    Vectord x;
+    solver.solve(x);
+    EXPECT_LT((A * x - b).norm(), 1.0e-10 * b.norm());
+
+    // Fixing more than the maximum rank covers factorizes again
+    for (int node = 30; node < 40; node++)
+    {
+        fixNode(A, node);
+    }
+    solver.setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+    EXPECT_EQ(solver.getNumFactorizations(), 2);
+    EXPECT_EQ(solver.getUpdateRank(), 0);
+    solver.solve(x);
+    EXPECT_LT((A * x - b).norm(), 1.0e-10 * b.norm());
+    EXPECT_EQ(solver.getNumPatternAnalyses(), 1);
+}
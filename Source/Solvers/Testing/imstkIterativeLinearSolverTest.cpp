@@ -0,0 +1,138 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "gtest/gtest.h"
+
+#include "imstkGaussSeidel.h"
+#include "imstkJacobi.h"
+#include "imstkLinearProjectionConstraint.h"
+#include "imstkSOR.h"
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Diagonally dominant system of a grid of nodes with 3 coupled dofs each
+///
+SparseMatrixd
+makeSystem(const int dim)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int y = 0; y < dim; y++)
+    {
+        for (int x = 0; x < dim; x++)
+        {
+            const int i      = x + dim * y;
+            int       degree = 0;
+            for (const int j : { (x > 0) ? i - 1 : -1, (x + 1 < dim) ? i + 1 : -1, (y > 0) ? i - dim : -1, (y + 1 < dim) ? i + dim : -1 })
+            {
+                if (j != -1)
+                {
+                    degree++;
+                    for (int r = 0; r < 3; r++)
+                    {
+                        triplets.push_back(Eigen::Triplet<double>(3 * i + r, 3 * j + r, -1.0));
+                    }
+                }
+            }
+            for (int r = 0; r < 3; r++)
+            {
+                triplets.push_back(Eigen::Triplet<double>(3 * i + r, 3 * i + r, degree + 1.0));
+            }
+            for (int r = 0; r < 2; r++)
+            {
+                triplets.push_back(Eigen::Triplet<double>(3 * i + r, 3 * i + r + 1, 0.3));
+                triplets.push_back(Eigen::Triplet<double>(3 * i + r + 1, 3 * i + r, 0.3));
+            }
+        }
+    }
+    SparseMatrixd A(3 * dim * dim, 3 * dim * dim);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    A.makeCompressed();
+    return A;
+}
+
+///
+/// \brief Solution of A x = b with the nodes of \p projections within their projection,
+/// (S A S + I - S) y = S (b - A x0) with x = x0 + y, x0 the projected values
+///
+Vectord
+solveProjected(const SparseMatrixd& A, const Vectord& b, const std::vector<LinearProjectionConstraint>& projections)
+{
+    Matrixd S  = Matrixd::Identity(A.rows(), A.cols());
+    Vectord x0 = Vectord::Zero(b.size());
+    for (const LinearProjectionConstraint& projection : projections)
+    {
+        const Eigen::Index row = static_cast<Eigen::Index>(3 * projection.getNodeId());
+        S.block<3, 3>(row, row) = projection.getProjector();
+        x0.segment<3>(row)      = (Mat3d::Identity() - projection.getProjector()) * projection.getValue();
+    }
+    const Matrixd denseA = A;
+    const Matrixd I      = Matrixd::Identity(A.rows(), A.cols());
+    const Vectord y      = (S * denseA * S + I - S).lu().solve(S * (b - denseA * x0));
+    return x0 + y;
+}
+
+///
+/// \brief Solve with every solver, serial and parallel, and check against \p expected
+///
+void
+testSolvers(const SparseMatrixd& A, const Vectord& b, const Vectord& expected,
+            std::vector<LinearProjectionConstraint>* projections)
+{
+    GaussSeidel gs;
+    SOR         sor(1.2);
+    Jacobi      jacobi;
+    gs.setLinearProjectors(projections);
+    sor.setLinearProjectors(projections);
+    jacobi.setLinearProjectors(projections);
+    for (IterativeLinearSolver* solver : std::vector<IterativeLinearSolver*>{ &gs, &sor, &jacobi })
+    {
+        for (const bool parallel : { false, true })
+        {
+            solver->setParallel(parallel);
+            solver->setTolerance(1.0e-12);
+            solver->setMaxNumIterations(10000);
+            solver->setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(A, b));
+
+            Vectord x;
+            solver->solve(x);
+            EXPECT_LT((x - expected).norm(), 1.0e-8 * expected.norm());
+        }
+    }
+    EXPECT_GT(gs.getNumRowColors(), 1);
+}
+} // namespace
+
+///
+/// \brief Test the serial and parallel sweeps of every stationary solver converge
+///
+TEST(imstkIterativeLinearSolverTest, Solve)
+{
+    const SparseMatrixd A        = makeSystem(12);
+    const Vectord       b        = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+    const Vectord       expected = Matrixd(A).lu().solve(b);
+    testSolvers(A, b, expected, nullptr);
+}
+
+///
+/// \brief Test the solvers with a fixed node and a node sliding on a plane
+///
+TEST(imstkIterativeLinearSolverTest, LinearProjections)
+{
+    const SparseMatrixd A = makeSystem(12);
+    const Vectord       b = Vectord::LinSpaced(A.rows(), -1.0, 1.0);
+
+    std::vector<LinearProjectionConstraint> projections(2, LinearProjectionConstraint(0));
+    projections[0].setProjectorToDirichlet(5, Vec3d(0.1, 0.2, 0.3));
+    projections[1].setProjection(40, Vec3d(1.0, 1.0, 0.0).normalized());
+    projections[1].setValue(Vec3d(0.5, 0.5, 0.0));
+
+    const Vectord expected = solveProjected(A, b, projections);
+    EXPECT_LT((expected.segment<3>(15) - Vec3d(0.1, 0.2, 0.3)).norm(), 1.0e-12);
+    testSolvers(A, b, expected, &projections);
+}
@@ -0,0 +1,54 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkMath.h"
+
+#include <utility>
+#include <vector>
+
+///
+/// \brief Spd system of nodes with 3 coupled dofs each, the Laplacian of the graph of
+/// \p edges times a coupling block scaled by \p scale, plus a \p mass on the diagonal
+///
+inline imstk::SparseMatrixd
+makeCoupledSystem(const int numNodes, const std::vector<std::pair<int, int>>& edges,
+                  const double mass, const double scale = 1.0)
+{
+    imstk::Mat3d coupling;
+    coupling << 2.0, 0.8, 0.0,
+        0.8, 2.0, 0.6,
+        0.0, 0.6, 1.0;
+    coupling *= scale;
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    auto                                addBlock = [&](const int i, const int j, const imstk::Mat3d& block)
+                                                   {
+                                                       for (int r = 0; r < 3; r++)
+                                                       {
+                                                           for (int c = 0; c < 3; c++)
+                                                           {
+                                                               triplets.push_back(Eigen::Triplet<double>(3 * i + r, 3 * j + c, block(r, c)));
+                                                           }
+                                                       }
+                                                   };
+    for (int i = 0; i < numNodes; i++)
+    {
+        addBlock(i, i, mass * imstk::Mat3d::Identity());
+    }
+    for (const std::pair<int, int>& edge : edges)
+    {
+        addBlock(edge.first, edge.first, coupling);
+        addBlock(edge.second, edge.second, coupling);
+        addBlock(edge.first, edge.second, -coupling);
+        addBlock(edge.second, edge.first, -coupling);
+    }
+    imstk::SparseMatrixd A(3 * numNodes, 3 * numNodes);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    A.makeCompressed();
+    return A;
+}
@@ -63,3 +63,93 @@ TEST(imstkPGSSolverTest, Solve5x5)
         EXPECT_NEAR(bPrime(i), b(i), 10.0);
     }
 }
+
+///
+/// \brief Tests the parallel (coloured) sweep gives the same solution as the
+/// sequential one for a diagonally dominant tridiagonal matrix
+///
+TEST(imstkPGSSolverTest, SolveParallel)
+{
+    const int                           n = 200;
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < n; i++)
+    {
+        triplets.push_back(Eigen::Triplet<double>(i, i, 4.0));
+        if (i > 0)
+        {
+            triplets.push_back(Eigen::Triplet<double>(i, i - 1, -1.0));
+            triplets.push_back(Eigen::Triplet<double>(i - 1, i, -1.0));
+        }
+    }
+    Eigen::SparseMatrix<double> A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+
+    Eigen::VectorXd b(n);
+    Eigen::MatrixXd cu(n, 2);
+    for (int i = 0; i < n; i++)
+    {
+        b(i)     = static_cast<double>(i % 7) - 3.0;
+        cu(i, 0) = 0.0; // Non-negative solution
+        cu(i, 1) = IMSTK_DOUBLE_MAX;
+    }
+
+    Eigen::VectorXd x[2];
+    for (int i = 0; i < 2; i++)
+    {
+        ProjectedGaussSeidelSolver<double> solver;
+        solver.setA(&A);
+        solver.setMaxIterations(1000);
+        solver.setRelaxation(1.0);
+        solver.setEpsilon(1.0e-12);
+        solver.setParallel(i == 1);
+        x[i] = solver.solve(b, cu);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        EXPECT_GE(x[1](i), 0.0);
+        EXPECT_NEAR(x[0](i), x[1](i), 1.0e-8);
+    }
+}
+
+///
+/// \brief Tests that warm starting from the solution converges immediately
+///
+TEST(imstkPGSSolverTest, SolveWarmStart)
+{
+    Eigen::MatrixXd Ad(3, 3);
+    Ad <<
+        4.0, 1.0, 0.0,
+        1.0, 4.0, 1.0,
+        0.0, 1.0, 4.0;
+    Eigen::SparseMatrix<double> A = Ad.sparseView();
+
+    Eigen::VectorXd b(3);
+    b << 1.0, 2.0, 3.0;
+    Eigen::MatrixXd cu(3, 2);
+    for (int i = 0; i < 3; i++)
+    {
+        cu(i, 0) = IMSTK_DOUBLE_MIN;
+        cu(i, 1) = IMSTK_DOUBLE_MAX;
+    }
+
+    ProjectedGaussSeidelSolver<double> solver;
+    solver.setA(&A);
+    solver.setMaxIterations(1);
+    solver.setRelaxation(1.0);
+    solver.setEpsilon(1.0e-10);
+
+    // From zero a single iteration moves the solution a lot
+    solver.solve(b, cu);
+    EXPECT_GT(solver.getEnergy(), 0.1);
+
+    // From the exact solution it shouldn't move
+    const Eigen::VectorXd xExact = Ad.inverse() * b;
+    solver.setGuess(xExact);
+    const Eigen::VectorXd x = solver.solve(b, cu);
+    EXPECT_LT(solver.getEnergy(), 1.0e-10);
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_NEAR(x(i), xExact(i), 1.0e-10);
+    }
+}
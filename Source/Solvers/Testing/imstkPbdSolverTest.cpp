@@ -0,0 +1,121 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#include "imstkPbdDistanceConstraint.h"
+#include "imstkPbdSolver.h"
+
+#include <gtest/gtest.h>
+
+using namespace imstk;
+
+namespace
+{
+///
+/// \brief Creates a state with a single body, a chain of numParticles stretched
+/// to twice its length, the first particle is fixed
+///
+PbdState
+makeStretchedChain(const int numParticles)
+{
+    auto body = std::make_shared<PbdBody>();
+    body->bodyHandle = 0;
+    body->bodyType   = PbdBody::Type::DEFORMABLE;
+    body->vertices   = std::make_shared<VecDataArray<double, 3>>(numParticles);
+    body->invMasses  = std::make_shared<DataArray<double>>(numParticles);
+    for (int i = 0; i < numParticles; i++)
+    {
+        (*body->vertices)[i]  = Vec3d(2.0 * i, 0.0, 0.0);
+        (*body->invMasses)[i] = (i == 0) ? 0.0 : 1.0;
+    }
+
+    PbdState state;
+    state.m_bodies.push_back(body);
+    return state;
+}
+
+///
+/// \brief Creates distance constraints of rest length 1 between particles i and i + 1
+/// for every i in [start, end) stepping by step
+///
+std::vector<std::shared_ptr<PbdDistanceConstraint>>
+makeLinks(const int start, const int end, const int step)
+{
+    std::vector<std::shared_ptr<PbdDistanceConstraint>> links;
+    for (int i = start; i < end; i += step)
+    {
+        auto link = std::make_shared<PbdDistanceConstraint>();
+        link->initConstraint(Vec3d(i, 0.0, 0.0), Vec3d(i + 1, 0.0, 0.0), { 0, i }, { 0, i + 1 }, 1.0);
+        links.push_back(link);
+    }
+    return links;
+}
+
+///
+/// \brief Solves the links with a list of the given mode
+///
+void
+solveLinks(PbdState& state, const std::vector<std::shared_ptr<PbdDistanceConstraint>>& links,
+           const PbdSolver::ConstraintListMode mode, const size_t iterations)
+{
+    std::vector<PbdConstraint*> constraintList;
+    for (const auto& link : links)
+    {
+        constraintList.push_back(link.get());
+    }
+
+    PbdSolver solver;
+    solver.setPbdBodies(&state);
+    solver.setTimeStep(0.01);
+    solver.setIterations(iterations);
+    solver.setSolverType(PbdConstraint::SolverType::PBD);
+    solver.addConstraints(&constraintList, mode);
+    solver.solve();
+    solver.clearConstraintLists();
+}
+} // namespace
+
+///
+/// \brief Test that a colored list of independent constraints gives exactly the
+/// result of the serial one
+///
+TEST(imstkPbdSolverTest, ColoredIndependentConstraints)
+{
+    const int numParticles = 100;
+    auto      links = makeLinks(0, numParticles - 1, 2);
+
+    PbdState serialState = makeStretchedChain(numParticles);
+    solveLinks(serialState, links, PbdSolver::ConstraintListMode::Serial, 1);
+
+    PbdState coloredState = makeStretchedChain(numParticles);
+    solveLinks(coloredState, links, PbdSolver::ConstraintListMode::Colored, 1);
+
+    const VecDataArray<double, 3>& serialVertices  = *serialState.m_bodies[0]->vertices;
+    const VecDataArray<double, 3>& coloredVertices = *coloredState.m_bodies[0]->vertices;
+    for (int i = 0; i < numParticles; i++)
+    {
+        EXPECT_EQ(serialVertices[i], coloredVertices[i]);
+    }
+}
+
+///
+/// \brief Test that a colored list of constraints sharing particles converges
+/// like the serial one
+///
+TEST(imstkPbdSolverTest, ColoredChain)
+{
+    const int numParticles = 10;
+    auto      links = makeLinks(0, numParticles - 1, 1);
+
+    PbdState state = makeStretchedChain(numParticles);
+    solveLinks(state, links, PbdSolver::ConstraintListMode::Colored, 500);
+
+    const VecDataArray<double, 3>& vertices = *state.m_bodies[0]->vertices;
+    EXPECT_EQ(vertices[0], Vec3d::Zero());
+    for (int i = 0; i < numParticles - 1; i++)
+    {
+        EXPECT_NEAR((vertices[i + 1] - vertices[i]).norm(), 1.0, 1.0e-6);
+    }
+}
@@ -0,0 +1,134 @@
+/*
+** This file is part of the Interactive Medical Simulation Toolkit (iMSTK)
+** iMSTK is distributed under the Apache License, Version 2.0.
+** See accompanying NOTICE for details.
+*/
+
+#pragma once
+
+#include "imstkMath.h"
+#include "imstkParallelUtils.h"
+
+#include <Eigen/LU>
+
+namespace imstk
+{
+///
+/// \class BlockJacobiPreconditioner
+///
+/// \brief Preconditioner inverting the 3x3 diagonal blocks of a matrix, one per
+/// node of a 3 dof per node system. Follows the Eigen preconditioner interface so
+/// it can be given to Eigen's iterative solvers. Singular blocks, such as the
+/// zeroed rows of fixed nodes, are left as identity
+///
+class BlockJacobiPreconditioner
+{
+public:
+    using StorageIndex = Vectord::StorageIndex;
+    enum
+    {
+        ColsAtCompileTime    = Eigen::Dynamic,
+        MaxColsAtCompileTime = Eigen::Dynamic
+    };
+
+public:
+    BlockJacobiPreconditioner() = default;
+
+    template<typename MatType>
+    explicit BlockJacobiPreconditioner(const MatType& mat) { compute(mat); }
+
+    Eigen::Index rows() const { return m_size; }
+    Eigen::Index cols() const { return m_size; }
+
+    template<typename MatType>
+    BlockJacobiPreconditioner& analyzePattern(const MatType&) { return *this; }
+
+    template<typename MatType>
+    BlockJacobiPreconditioner& factorize(const MatType& mat)
+    {
+        getBlockDiagonal(mat, m_blocks);
+        return computeFromBlocks(m_blocks, mat.cols());
+    }
+
+    template<typename MatType>
+    BlockJacobiPreconditioner& compute(const MatType& mat) { return factorize(mat); }
+
+    ///
+    /// \brief Compute from the given diagonal blocks of a matrix of size \p size,
+    /// when the matrix itself is not formed
+    ///
+    BlockJacobiPreconditioner& computeFromBlocks(const StdVectorOfMat3d& blocks, const Eigen::Index size)
+    {
+        m_size = size;
+        m_inverseBlocks.resize(blocks.size());
+        ParallelUtils::parallelFor(blocks.size(),
+            [&](const size_t i)
+            {
+                bool invertible = false;
+                blocks[i].computeInverseWithCheck(m_inverseBlocks[i], invertible);
+                if (!invertible)
+                {
+                    m_inverseBlocks[i] = Mat3d::Identity();
+                }
+            }, blocks.size() > 1000);
+        return *this;
+    }
+
+    ///
+    /// \brief Get the 3x3 diagonal blocks of \p mat
+    ///
+    template<typename MatType>
+    static void getBlockDiagonal(const MatType& mat, StdVectorOfMat3d& blocks)
+    {
+        blocks.resize(static_cast<size_t>(mat.cols() / 3));
+        ParallelUtils::parallelFor(blocks.size(),
+            [&](const size_t i)
+            {
+                const Eigen::Index start = static_cast<Eigen::Index>(3 * i);
+                Mat3d&             block = blocks[i];
+                block.setZero();
+                for (Eigen::Index k = start; k < start + 3; k++)
+                {
+                    for (typename MatType::InnerIterator it(mat, k); it; ++it)
+                    {
+                        if (it.row() >= start && it.row() < start + 3
+                            && it.col() >= start && it.col() < start + 3)
+                        {
+                            block(it.row() - start, it.col() - start) = it.value();
+                        }
+                    }
+                }
+            }, blocks.size() > 1000);
+    }
+
+    template<typename Rhs, typename Dest>
+    void _solve_impl(const Rhs& b, Dest& x) const
+    {
+        x.resize(b.rows());
+        ParallelUtils::parallelFor(m_inverseBlocks.size(),
+            [&](const size_t i)
+            {
+                x.template segment<3>(3 * i) = m_inverseBlocks[i] * b.template segment<3>(3 * i);
+            }, m_inverseBlocks.size() > 1000);
+
+        // Trailing dofs not in a block are left unpreconditioned
+        for (Eigen::Index i = static_cast<Eigen::Index>(3 * m_inverseBlocks.size()); i < b.rows(); i++)
+        {
+            x(i) = b(i);
+        }
+    }
+
+    template<typename Rhs>
+    const Eigen::Solve<BlockJacobiPreconditioner, Rhs> solve(const Eigen::MatrixBase<Rhs>& b) const
+    {
+        return Eigen::Solve<BlockJacobiPreconditioner, Rhs>(*this, b.derived());
+    }
+
+    Eigen::ComputationInfo info() { return Eigen::Success; }
+
+protected:
+    Eigen::Index     m_size = 0;
+    StdVectorOfMat3d m_blocks;        ///< Diagonal blocks of the last matrix computed
+    StdVectorOfMat3d m_inverseBlocks; ///< Inverse of every diagonal block
+};
+} // namespace imstk
@@ -13,8 +13,8 @@ namespace imstk
 ConjugateGradient::ConjugateGradient()
 {
     m_type = Type::ConjugateGradient;
-    m_cgSolver.setMaxIterations(m_maxIterations);
-    m_cgSolver.setTolerance(m_tolerance);
+    setMaxNumIterations(m_maxIterations);
+    setTolerance(m_tolerance);
 }
 
 ConjugateGradient::ConjugateGradient(const SparseMatrixd& A, const Vectord& rhs) : ConjugateGradient()
@@ -41,6 +41,19 @@ ConjugateGradient::applyLinearProjectionFilter(Vectord& x, const std::vector<Lin
     }
 }
 
+void
+ConjugateGradient::applyLinearProjectionFilters(Vectord& x, const bool setVal)
+{
+    if (m_DynamicLinearProjConstraints)
+    {
+        applyLinearProjectionFilter(x, *m_DynamicLinearProjConstraints, setVal);
+    }
+    if (m_FixedLinearProjConstraints)
+    {
+        applyLinearProjectionFilter(x, *m_FixedLinearProjConstraints, setVal);
+    }
+}
+
 void
 ConjugateGradient::solve(Vectord& x)
 {
@@ -50,98 +63,140 @@ ConjugateGradient::solve(Vectord& x)
         return;
     }
 
-    if (!(m_FixedLinearProjConstraints || m_DynamicLinearProjConstraints))
+    const Vectord& b = m_linearSystem->getRHSVector();
+    if (!m_warmStart || x.size() != b.size())
     {
-        x = m_cgSolver.solve(m_linearSystem->getRHSVector());
+        x.setZero(b.size());
     }
-    else
+
+    if (m_matrixFreeOperator || m_FixedLinearProjConstraints || m_DynamicLinearProjConstraints)
     {
         this->modifiedCGSolve(x);
+        return;
+    }
+
+    switch (m_preconditioner)
+    {
+    case Preconditioner::BlockJacobi:
+        x = m_blockJacobiCgSolver.solveWithGuess(b, x);
+        m_numIterations = static_cast<size_t>(m_blockJacobiCgSolver.iterations());
+        break;
+    case Preconditioner::IncompleteCholesky:
+        x = m_icCgSolver.solveWithGuess(b, x);
+        m_numIterations = static_cast<size_t>(m_icCgSolver.iterations());
+        break;
+    default:
+        x = m_cgSolver.solveWithGuess(b, x);
+        m_numIterations = static_cast<size_t>(m_cgSolver.iterations());
+        break;
     }
 }
 
 void
-ConjugateGradient::modifiedCGSolve(Vectord& x)
+ConjugateGradient::applyMatrix(const Vectord& x, Vectord& y)
 {
-    const auto& b = m_linearSystem->getRHSVector();
-    const auto& A = m_linearSystem->getMatrix();
-
-    // Set the initial guess to zero
-    x.setZero();
-    if (m_DynamicLinearProjConstraints)
+    if (m_matrixFreeOperator)
     {
-        applyLinearProjectionFilter(x, *m_DynamicLinearProjConstraints, true);
+        m_matrixFreeOperator(x, y);
     }
-
-    if (m_FixedLinearProjConstraints)
+    else
     {
-        applyLinearProjectionFilter(x, *m_FixedLinearProjConstraints, true);
+        y = m_linearSystem->getMatrix() * x;
     }
+}
 
-    auto res = b;
-    if (m_DynamicLinearProjConstraints)
+void
+ConjugateGradient::applyPreconditioner(const Vectord& r, Vectord& z)
+{
+    if (m_matrixFreeOperator)
     {
-        applyLinearProjectionFilter(res, *m_DynamicLinearProjConstraints, false);
+        z = m_matrixFreePreconditioner.solve(r);
+        return;
     }
-    if (m_FixedLinearProjConstraints)
+
+    switch (m_preconditioner)
     {
-        applyLinearProjectionFilter(res, *m_FixedLinearProjConstraints, false);
+    case Preconditioner::BlockJacobi:
+        z = m_blockJacobiCgSolver.preconditioner().solve(r);
+        break;
+    case Preconditioner::IncompleteCholesky:
+        z = m_icCgSolver.preconditioner().solve(r);
+        break;
+    default:
+        z = m_cgSolver.preconditioner().solve(r);
+        break;
     }
-    auto       c     = res;
-    auto       delta = res.dot(res);
-    const auto eps   = m_tolerance * m_tolerance * delta;
-    double     alpha = 0.0;
-    Vectord    q;
-    size_t     iterNum = 0;
+}
+
+void
+ConjugateGradient::modifiedCGSolve(Vectord& x)
+{
+    const Vectord& b = m_linearSystem->getRHSVector();
+
+    // Constrained values are set on the initial guess, the rest of it is
+    // kept when warm starting
+    applyLinearProjectionFilters(x, true);
+
+    // The tolerance is relative to the filtered rhs so a warm start stops as soon
+    // as it is close enough, not only once it has reduced its initial residual
+    m_res = b;
+    applyLinearProjectionFilters(m_res, false);
+    const double eps = m_tolerance * m_tolerance * m_res.squaredNorm();
+
+    applyMatrix(x, m_q);
+    m_res = b - m_q;
+    applyLinearProjectionFilters(m_res, false);
+    double resNormSqr = m_res.squaredNorm();
 
-    while (delta > eps)
+    applyPreconditioner(m_res, m_z);
+    applyLinearProjectionFilters(m_z, false);
+    m_c = m_z;
+    double delta = m_res.dot(m_z);
+
+    m_numIterations = 0;
+    while (resNormSqr > eps && m_numIterations < m_maxIterations)
     {
-        q = A * c;
-        if (m_DynamicLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(q, *m_DynamicLinearProjConstraints, false);
-        }
-        if (m_FixedLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(q, *m_FixedLinearProjConstraints, false);
-        }
-        double dotval = c.dot(q);
-        if (dotval != 0.0)
-        {
-            alpha = delta / dotval;
-        }
-        else
+        applyMatrix(m_c, m_q);
+        applyLinearProjectionFilters(m_q, false);
+        const double dotval = m_c.dot(m_q);
+        if (dotval == 0.0)
         {
             LOG(WARNING) << "Warning: denominator zero. Terminating MCG iteration!";
-            return;
-        }
-        x   += alpha * c;
-        res -= alpha * q;
-        const double deltaPrev = delta;
-        delta = res.dot(res);
-        c    *= delta / deltaPrev;
-        c    += res;
-        if (m_DynamicLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(c, *m_DynamicLinearProjConstraints, false);
-        }
-        if (m_FixedLinearProjConstraints)
-        {
-            applyLinearProjectionFilter(c, *m_FixedLinearProjConstraints, false);
-        }
-
-        if (++iterNum >= m_maxIterations)
-        {
-            //LOG(WARNING) << "ConjugateGradient::modifiedCGSolve - The solver did not converge after max. iterations";
             break;
         }
+        const double alpha = delta / dotval;
+        x     += alpha * m_c;
+        m_res -= alpha * m_q;
+        resNormSqr = m_res.squaredNorm();
+        m_numIterations++;
+
+        applyPreconditioner(m_res, m_z);
+        applyLinearProjectionFilters(m_z, false);
+        const double deltaPrev = delta;
+        delta = m_res.dot(m_z);
+        m_c  *= delta / deltaPrev;
+        m_c  += m_z;
+        applyLinearProjectionFilters(m_c, false);
     }
+    m_error = (eps > 0.0) ? m_tolerance * std::sqrt(resNormSqr / eps) : 0.0;
 }
 
 double
 ConjugateGradient::getResidual(const Vectord&)
 {
-    return m_cgSolver.error();
+    if (m_matrixFreeOperator || m_FixedLinearProjConstraints || m_DynamicLinearProjConstraints)
+    {
+        return m_error;
+    }
+    switch (m_preconditioner)
+    {
+    case Preconditioner::BlockJacobi:
+        return m_blockJacobiCgSolver.error();
+    case Preconditioner::IncompleteCholesky:
+        return m_icCgSolver.error();
+    default:
+        return m_cgSolver.error();
+    }
 }
 
 void
@@ -149,6 +204,8 @@ ConjugateGradient::setTolerance(const double epsilon)
 {
     IterativeLinearSolver::setTolerance(epsilon);
     m_cgSolver.setTolerance(epsilon);
+    m_blockJacobiCgSolver.setTolerance(epsilon);
+    m_icCgSolver.setTolerance(epsilon);
 }
 
 void
@@ -156,13 +213,55 @@ ConjugateGradient::setMaxNumIterations(const size_t maxIter)
 {
     IterativeLinearSolver::setMaxNumIterations(maxIter);
     m_cgSolver.setMaxIterations(maxIter);
+    m_blockJacobiCgSolver.setMaxIterations(maxIter);
+    m_icCgSolver.setMaxIterations(maxIter);
 }
 
 void
 ConjugateGradient::setSystem(std::shared_ptr<LinearSystem<SparseMatrixd>> newSystem)
 {
     LinearSolver<SparseMatrixd>::setSystem(newSystem);
-    m_cgSolver.compute(m_linearSystem->getMatrix());
+
+    if (m_matrixFreeOperator)
+    {
+        m_blockDiagonalFunction(m_blocks);
+        if (m_preconditioner == Preconditioner::Diagonal)
+        {
+            for (Mat3d& block : m_blocks)
+            {
+                block = Mat3d(block.diagonal().asDiagonal());
+            }
+        }
+        m_matrixFreePreconditioner.computeFromBlocks(m_blocks, m_linearSystem->getRHSVector().size());
+        return;
+    }
+
+    // Only the selected preconditioner is computed
+    switch (m_preconditioner)
+    {
+    case Preconditioner::BlockJacobi:
+        m_blockJacobiCgSolver.compute(m_linearSystem->getMatrix());
+        break;
+    case Preconditioner::IncompleteCholesky:
+        m_icCgSolver.compute(m_linearSystem->getMatrix());
+        break;
+    default:
+        m_cgSolver.compute(m_linearSystem->getMatrix());
+        break;
+    }
+}
+
+void
+ConjugateGradient::setMatrixFreeOperator(MatrixFreeOperator op, BlockDiagonalFunction blockDiagonal)
+{
+    CHECK(op == nullptr || blockDiagonal != nullptr) << "Matrix free CG requires the diagonal blocks";
+    m_matrixFreeOperator    = op;
+    m_blockDiagonalFunction = blockDiagonal;
+    if (m_matrixFreeOperator && m_preconditioner == Preconditioner::IncompleteCholesky)
+    {
+        LOG(WARNING) << "Incomplete Cholesky requires the matrix, using block Jacobi matrix free";
+        m_preconditioner = Preconditioner::BlockJacobi;
+    }
 }
 
 void
@@ -171,6 +270,9 @@ ConjugateGradient::print() const
     IterativeLinearSolver::print();
 
     LOG(INFO) << "Solver: Conjugate gradient";
+    LOG(INFO) << "Preconditioner: " << (m_preconditioner == Preconditioner::Diagonal ? "Diagonal" :
+        (m_preconditioner == Preconditioner::BlockJacobi ? "BlockJacobi" : "IncompleteCholesky"));
+    LOG(INFO) << "Matrix free: " << (m_matrixFreeOperator ? "yes" : "no");
     LOG(INFO) << "Tolerance: " << m_tolerance;
     LOG(INFO) << "max. iterations: " << m_maxIterations;
 }
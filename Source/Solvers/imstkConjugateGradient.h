@@ -6,10 +6,13 @@
 
 #pragma once
 
+#include "imstkBlockJacobiPreconditioner.h"
 #include "imstkIterativeLinearSolver.h"
 
 #include <Eigen/IterativeLinearSolvers>
 
+#include <functional>
+
 namespace imstk
 {
 class LinearProjectionConstraint;
@@ -19,8 +22,33 @@ class LinearProjectionConstraint;
 ///
 /// \brief Conjugate gradient sparse linear solver for Spd matrices
 ///
+/// The preconditioner is selectable and used both by the Eigen solve and by the
+/// modified solve used with linear projection constraints. In the matrix free mode
+/// the system matrix is applied by a given operator instead of being formed.
+///
 class ConjugateGradient : public IterativeLinearSolver
 {
+public:
+    ///
+    /// \brief Preconditioner of the solve
+    ///
+    enum class Preconditioner
+    {
+        Diagonal,          ///< Inverse of the diagonal
+        BlockJacobi,       ///< Inverse of the 3x3 diagonal block of every node
+        IncompleteCholesky ///< Incomplete Cholesky factorization, not available matrix free
+    };
+
+    ///
+    /// \brief Applies the system matrix, y = A x
+    ///
+    using MatrixFreeOperator = std::function<void (const Vectord& x, Vectord& y)>;
+
+    ///
+    /// \brief Gives the 3x3 diagonal blocks of the system matrix
+    ///
+    using BlockDiagonalFunction = std::function<void (StdVectorOfMat3d& blocks)>;
+
 public:
     ConjugateGradient();
     ConjugateGradient(const SparseMatrixd& A, const Vectord& rhs);
@@ -70,6 +98,39 @@ public:
     ///
     void setTolerance(const double tolerance);
 
+    ///
+    /// \brief Set/Get the preconditioner, takes effect on the next system set
+    ///@{
+    void setPreconditioner(const Preconditioner preconditioner) { m_preconditioner = preconditioner; }
+    Preconditioner getPreconditioner() const { return m_preconditioner; }
+    ///@}
+
+    ///
+    /// \brief Set/Get warm starting. When on, the solve starts from the x given to it,
+    /// such as the solution of the previous frame, instead of zero
+    ///@{
+    void setWarmStart(const bool warmStart) { m_warmStart = warmStart; }
+    bool getWarmStart() const { return m_warmStart; }
+    ///@}
+
+    ///
+    /// \brief Set an operator applying the system matrix, the matrix of the linear system
+    /// is then not used, only its rhs. \p blockDiagonal gives the diagonal blocks for
+    /// the preconditioner, IncompleteCholesky falls back to BlockJacobi.
+    /// Set a null operator to use the matrix again
+    ///
+    void setMatrixFreeOperator(MatrixFreeOperator op, BlockDiagonalFunction blockDiagonal);
+
+    ///
+    /// \brief Returns if the system matrix is applied by an operator
+    ///
+    bool isMatrixFree() const { return m_matrixFreeOperator != nullptr; }
+
+    ///
+    /// \brief Get the number of iterations of the last solve
+    ///
+    size_t getNumIterations() const { return m_numIterations; }
+
     ///
     /// \brief Print solver information
     ///
@@ -115,8 +176,41 @@ private:
     ///
     void modifiedCGSolve(Vectord& x);
 
-    ///< Pointer to the Eigen's Conjugate gradient solver
+    ///
+    /// \brief Apply the linear projection filters to \p x
+    ///
+    void applyLinearProjectionFilters(Vectord& x, const bool setVal);
+
+    ///
+    /// \brief Apply the system matrix, y = A x
+    ///
+    void applyMatrix(const Vectord& x, Vectord& y);
+
+    ///
+    /// \brief Apply the preconditioner, z = P^-1 r
+    ///
+    void applyPreconditioner(const Vectord& r, Vectord& z);
+
+    ///< Eigen's Conjugate gradient solver with each of the preconditioners
     Eigen::ConjugateGradient<SparseMatrixd> m_cgSolver;
+    Eigen::ConjugateGradient<SparseMatrixd, Eigen::Lower, BlockJacobiPreconditioner>         m_blockJacobiCgSolver;
+    Eigen::ConjugateGradient<SparseMatrixd, Eigen::Lower, Eigen::IncompleteCholesky<double>> m_icCgSolver;
+
+    Preconditioner m_preconditioner = Preconditioner::Diagonal;
+    bool           m_warmStart      = false;
+    size_t         m_numIterations  = 0;
+    double         m_error = 0.0; ///< Relative residual of the last modified solve
+
+    MatrixFreeOperator        m_matrixFreeOperator    = nullptr;
+    BlockDiagonalFunction     m_blockDiagonalFunction = nullptr;
+    BlockJacobiPreconditioner m_matrixFreePreconditioner; ///< Preconditioner from the blocks given matrix free
+    StdVectorOfMat3d          m_blocks;                   ///< Diagonal blocks given matrix free
+
+    // Storage of the modified solve, kept between solves
+    Vectord m_res;
+    Vectord m_z;
+    Vectord m_c;
+    Vectord m_q;
 
     std::vector<LinearProjectionConstraint>* m_FixedLinearProjConstraints   = nullptr;
     std::vector<LinearProjectionConstraint>* m_DynamicLinearProjConstraints = nullptr;
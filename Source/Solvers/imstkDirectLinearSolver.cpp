@@ -7,6 +7,9 @@
 #include "imstkDirectLinearSolver.h"
 #include "imstkLogger.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace imstk
 {
 DirectLinearSolver<Matrixd>::
@@ -25,10 +28,11 @@ setSystem(std::shared_ptr<LinearSystem<Matrixd>> newSystem)
 }
 
 DirectLinearSolver<SparseMatrixd>::
-DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b)
+DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b, const Factorization factorization) :
+    m_factorization(factorization)
 {
-    m_linearSystem = std::make_shared<LinearSystem<SparseMatrixd>>(matrix, b);
-    m_solver.compute(matrix);
+    m_type = (factorization == Factorization::LU) ? Type::LUFactorization : Type::LDLTFactorization;
+    setSystem(std::make_shared<LinearSystem<SparseMatrixd>>(matrix, b));
 }
 
 void
@@ -36,7 +40,268 @@ DirectLinearSolver<SparseMatrixd>::
 setSystem(std::shared_ptr<LinearSystem<SparseMatrixd>> newSystem)
 {
     LinearSolver<SparseMatrixd>::setSystem(newSystem);
-    m_solver.compute(m_linearSystem->getMatrix());
+    const SparseMatrixd& matrix = m_linearSystem->getMatrix();
+
+    analyzePattern(matrix);
+    if (isFactorized(matrix))
+    {
+        // Drop a low rank update of previous values
+        m_updateRight.resize(0, matrix.cols());
+        return;
+    }
+    if (m_lowRankUpdate && m_factorized && computeLowRankUpdate(matrix))
+    {
+        return;
+    }
+    factorize(matrix);
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::setFactorization(const Factorization factorization)
+{
+    if (factorization == m_factorization)
+    {
+        return;
+    }
+    m_factorization = factorization;
+    m_type          = (factorization == Factorization::LU) ? Type::LUFactorization : Type::LDLTFactorization;
+
+    // Analyze and factorize again with the new method
+    m_outerIndex.clear();
+    m_innerIndex.clear();
+    m_factorized = false;
+    if (m_linearSystem)
+    {
+        setSystem(m_linearSystem);
+    }
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::setLowRankUpdate(const bool lowRankUpdate)
+{
+    m_lowRankUpdate = lowRankUpdate;
+
+    // The values of the current factorization were not kept, factorize again on the next system
+    m_factorized = false;
+    m_updateRight.resize(0, 0);
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::analyzePattern(const SparseMatrixd& matrix)
+{
+    // Only compressed matrices are compared, others are analyzed every time
+    const MatrixType::StorageIndex* outerIndex = matrix.outerIndexPtr();
+    const MatrixType::StorageIndex* innerIndex = matrix.innerIndexPtr();
+    if (matrix.isCompressed()
+        && m_outerIndex.size() == static_cast<size_t>(matrix.outerSize() + 1)
+        && m_innerIndex.size() == static_cast<size_t>(matrix.nonZeros())
+        && std::equal(m_outerIndex.begin(), m_outerIndex.end(), outerIndex)
+        && std::equal(m_innerIndex.begin(), m_innerIndex.end(), innerIndex))
+    {
+        return;
+    }
+
+    if (m_factorization == Factorization::LU)
+    {
+        m_luSolver.analyzePattern(matrix);
+    }
+    else
+    {
+        m_ldltSolver.analyzePattern(matrix);
+    }
+    m_numPatternAnalyses++;
+    m_factorized = false;
+
+    if (matrix.isCompressed())
+    {
+        m_outerIndex.assign(outerIndex, outerIndex + matrix.outerSize() + 1);
+        m_innerIndex.assign(innerIndex, innerIndex + matrix.nonZeros());
+    }
+    else
+    {
+        m_outerIndex.clear();
+        m_innerIndex.clear();
+    }
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::factorize(const SparseMatrixd& matrix)
+{
+    Eigen::ComputationInfo info;
+    if (m_factorization == Factorization::LU)
+    {
+        m_luSolver.factorize(matrix);
+        info = m_luSolver.info();
+    }
+    else
+    {
+        m_ldltSolver.factorize(matrix);
+        info = m_ldltSolver.info();
+    }
+    m_numFactorizations++;
+
+    m_factorized = (info == Eigen::Success);
+    if (!m_factorized)
+    {
+        LOG(WARNING) << "DirectLinearSolver::factorize - Factorization failed, the matrix may be singular"
+                     << (m_factorization == Factorization::LDLT ? " or not positive definite" : "");
+    }
+
+    m_updateRight.resize(0, matrix.cols());
+    if (matrix.isCompressed())
+    {
+        m_factorizedValues.assign(matrix.valuePtr(), matrix.valuePtr() + matrix.nonZeros());
+    }
+    else
+    {
+        m_factorizedValues.clear();
+    }
+}
+
+bool
+DirectLinearSolver<SparseMatrixd>::isFactorized(const SparseMatrixd& matrix) const
+{
+    // The pattern is the analyzed one when the analysis kept the factorization
+    return m_factorized && matrix.isCompressed()
+           && m_factorizedValues.size() == static_cast<size_t>(matrix.nonZeros())
+           && std::equal(m_factorizedValues.begin(), m_factorizedValues.end(), matrix.valuePtr());
+}
+
+bool
+DirectLinearSolver<SparseMatrixd>::computeLowRankUpdate(const SparseMatrixd& matrix)
+{
+    using Index = MatrixType::StorageIndex;
+    struct Change
+    {
+        Index row;
+        Index col;
+        double value;
+    };
+
+    // Entries changed since the factorization, the pattern is the same so values line up
+    std::vector<Change> changes;
+    const double*       values = matrix.valuePtr();
+    Index               j      = 0;
+    for (Index k = 0; k < matrix.outerSize(); k++)
+    {
+        for (SparseMatrixd::InnerIterator it(matrix, k); it; ++it, j++)
+        {
+            if (values[j] != m_factorizedValues[j])
+            {
+                changes.push_back({ static_cast<Index>(it.row()), static_cast<Index>(it.col()), values[j] - m_factorizedValues[j] });
+            }
+        }
+    }
+
+    const Index n = static_cast<Index>(matrix.rows());
+    if (changes.empty())
+    {
+        m_updateRight.resize(0, n);
+        return true;
+    }
+
+    // Cover the changed entries by a few indices, each covering the entries in its row and
+    // column. Greedily by number of entries, boundary conditions change the whole row and
+    // column of a fixed dof and one entry in the rows of its neighbors
+    std::unordered_map<Index, std::vector<size_t>> entriesOf;
+    for (size_t c = 0; c < changes.size(); c++)
+    {
+        entriesOf[changes[c].row].push_back(c);
+        if (changes[c].col != changes[c].row)
+        {
+            entriesOf[changes[c].col].push_back(c);
+        }
+    }
+    std::vector<std::pair<size_t, Index>> candidates;
+    candidates.reserve(entriesOf.size());
+    for (const auto& entries : entriesOf)
+    {
+        candidates.push_back({ entries.second.size(), entries.first });
+    }
+    std::sort(candidates.begin(), candidates.end(), std::greater<std::pair<size_t, Index>>());
+
+    std::vector<bool>              covered(changes.size(), false);
+    std::unordered_map<Index, int> coverId;
+    for (const auto& candidate : candidates)
+    {
+        const std::vector<size_t>& entries = entriesOf[candidate.second];
+        if (std::all_of(entries.begin(), entries.end(), [&](const size_t c) { return covered[c]; }))
+        {
+            continue;
+        }
+        if (coverId.size() == m_maxUpdateRank)
+        {
+            return false;
+        }
+        coverId[candidate.second] = static_cast<int>(coverId.size());
+        for (const size_t c : entries)
+        {
+            covered[c] = true;
+        }
+    }
+
+    // The change is E_S U + V E_S^T, U the changed rows of the cover S and V the remaining
+    // changes in the columns of S. Written as L R^T with L = [E_S V] and R^T = [U; E_S^T],
+    // columns of V without changes are left out
+    const int                           coverSize = static_cast<int>(coverId.size());
+    std::unordered_map<Index, int>      columnId;
+    std::vector<Eigen::Triplet<double>> left;
+    std::vector<Eigen::Triplet<double>> right;
+    for (const auto& cover : coverId)
+    {
+        left.push_back(Eigen::Triplet<double>(cover.first, cover.second, 1.0));
+    }
+    for (const Change& change : changes)
+    {
+        auto rowCover = coverId.find(change.row);
+        if (rowCover != coverId.end())
+        {
+            right.push_back(Eigen::Triplet<double>(rowCover->second, change.col, change.value));
+        }
+        else
+        {
+            auto columnCover = columnId.find(change.col);
+            if (columnCover == columnId.end())
+            {
+                const int id = coverSize + static_cast<int>(columnId.size());
+                columnCover = columnId.insert({ change.col, id }).first;
+                right.push_back(Eigen::Triplet<double>(id, change.col, 1.0));
+            }
+            left.push_back(Eigen::Triplet<double>(change.row, columnCover->second, change.value));
+        }
+    }
+
+    const int rank = coverSize + static_cast<int>(columnId.size());
+    m_updateLeft.resize(n, rank);
+    m_updateLeft.setFromTriplets(left.begin(), left.end());
+    m_updateRight.resize(rank, n);
+    m_updateRight.setFromTriplets(right.begin(), right.end());
+
+    // A^-1 = (A0 + L R^T)^-1 = A0^-1 - A0^-1 L (I + R^T A0^-1 L)^-1 R^T A0^-1
+    m_updateSolved.resize(n, rank);
+    Vectord column;
+    Vectord solved;
+    for (int c = 0; c < rank; c++)
+    {
+        column = m_updateLeft.col(c);
+        solveFactorized(column, solved);
+        m_updateSolved.col(c) = solved;
+    }
+    m_capacitance.compute(Matrixd::Identity(rank, rank) + m_updateRight * m_updateSolved);
+    return m_capacitance.isInvertible();
+}
+
+void
+DirectLinearSolver<SparseMatrixd>::solveFactorized(const Vectord& rhs, Vectord& x) const
+{
+    if (m_factorization == Factorization::LU)
+    {
+        x = m_luSolver.solve(rhs);
+    }
+    else
+    {
+        x = m_ldltSolver.solve(rhs);
+    }
 }
 
 void
@@ -46,7 +311,12 @@ DirectLinearSolver<SparseMatrixd>::solve(const Vectord& rhs, Vectord& x)
     {
         LOG(FATAL) << "Linear system has not been set";
     }
-    x = m_solver.solve(rhs);
+    solveFactorized(rhs, x);
+    if (m_updateRight.rows() > 0)
+    {
+        const Vectord y = m_updateRight * x;
+        x -= m_updateSolved * m_capacitance.solve(y);
+    }
 }
 
 void
@@ -56,10 +326,7 @@ DirectLinearSolver<SparseMatrixd>::solve(Vectord& x)
     {
         LOG(FATAL) << "Linear system has not been set";
     }
-    x.setZero();
-
-    auto b = m_linearSystem->getRHSVector();
-    x = m_solver.solve(b);
+    solve(m_linearSystem->getRHSVector(), x);
 }
 
 void
@@ -14,6 +14,7 @@
 #pragma warning( disable : 4127 )
 #endif
 #include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
 #include <Eigen/SparseLU>
 #ifdef WIN32
 #pragma warning( pop )
@@ -72,22 +73,39 @@ private:
 
 ///
 /// \brief Sparse direct solvers. Solves a sparse system of equations using a sparse LU
-///     decomposition.
+///     or, for symmetric positive definite systems, a sparse LDLT decomposition.
+///
+/// The symbolic analysis of the matrix is kept while its sparsity pattern stays the same,
+/// only the numeric factorization is redone when the values change. A system whose
+/// values equal the factorized ones is not factorized again.
+///
+/// With the low rank update enabled the factorization is also kept when only a few rows and
+/// columns of the matrix changed since it was computed, such as when boundary conditions
+/// are applied to other nodes. The change is then written as a low rank product L R^T and
+/// solves go through the Sherman-Morrison-Woodbury formula, until the change is too large
+/// and the matrix gets factorized again.
 ///
 template<>
 class DirectLinearSolver<SparseMatrixd>: public LinearSolver<SparseMatrixd>
 {
+public:
+    enum class Factorization
+    {
+        LU,  ///< Sparse LU with COLAMD ordering, any non singular matrix
+        LDLT ///< Simplicial LDLT with AMD ordering, symmetric positive definite matrices only
+    };
+
 public:
     ///
     /// \brief Default constructor/destructor
     ///
-    DirectLinearSolver() = default;
+    DirectLinearSolver() { m_type = Type::LUFactorization; }
     ~DirectLinearSolver() override = default;
 
     ///
     /// \brief Constructor
     ///
-    DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b);
+    DirectLinearSolver(const SparseMatrixd& matrix, const Vectord& b, const Factorization factorization = Factorization::LU);
 
     ///
     /// \brief Sets the system. System of linear equations.
@@ -104,7 +122,90 @@ public:
     ///
     void solve(const Vectord& rhs, Vectord& x);
 
+    ///
+    /// \brief Returns true if the solver is iterative
+    ///
+    bool isIterative() const override { return false; }
+
+    ///
+    /// \brief Set/Get the factorization used, changing it drops the current factorization
+    ///
+    void setFactorization(const Factorization factorization);
+    Factorization getFactorization() const { return m_factorization; }
+
+    ///
+    /// \brief Set/Get whether changes of a few rows and columns are applied as a low rank
+    /// update of the current factorization instead of factorizing again
+    ///
+    void setLowRankUpdate(const bool lowRankUpdate);
+    bool getLowRankUpdate() const { return m_lowRankUpdate; }
+
+    ///
+    /// \brief Set/Get the maximum number of rows and columns the low rank update covers before
+    /// the matrix is factorized again
+    ///
+    void setMaxUpdateRank(const size_t maxUpdateRank) { m_maxUpdateRank = maxUpdateRank; }
+    size_t getMaxUpdateRank() const { return m_maxUpdateRank; }
+
+    ///
+    /// \brief Get the number of symbolic analyses/numeric factorizations done so far
+    ///
+    size_t getNumPatternAnalyses() const { return m_numPatternAnalyses; }
+    size_t getNumFactorizations() const { return m_numFactorizations; }
+
+    ///
+    /// \brief Get the rank of the low rank update currently applied, 0 if none
+    ///
+    Eigen::Index getUpdateRank() const { return m_updateRight.rows(); }
+
+protected:
+    ///
+    /// \brief Redo the symbolic analysis if the pattern of \p matrix differs from the
+    /// analyzed one
+    ///
+    void analyzePattern(const SparseMatrixd& matrix);
+
+    ///
+    /// \brief Numeric factorization of \p matrix
+    ///
+    void factorize(const SparseMatrixd& matrix);
+
+    ///
+    /// \brief Returns if \p matrix has the values of the factorized matrix, the pattern
+    /// being the analyzed one
+    ///
+    bool isFactorized(const SparseMatrixd& matrix) const;
+
+    ///
+    /// \brief Write the change of \p matrix since the last factorization as a low rank
+    /// update, returns false if it is too large
+    ///
+    bool computeLowRankUpdate(const SparseMatrixd& matrix);
+
+    ///
+    /// \brief Solve with the factorized matrix, without the low rank update
+    ///
+    void solveFactorized(const Vectord& rhs, Vectord& x) const;
+
 private:
-    Eigen::SparseLU<SparseMatrixd, Eigen::COLAMDOrdering<MatrixType::StorageIndex>> m_solver;
+    Factorization m_factorization = Factorization::LU;
+    bool          m_lowRankUpdate = false;
+    size_t        m_maxUpdateRank = 30;
+
+    Eigen::SparseLU<SparseMatrixd, Eigen::COLAMDOrdering<MatrixType::StorageIndex>> m_luSolver;
+    Eigen::SimplicialLDLT<SparseMatrixd, Eigen::Lower> m_ldltSolver;
+    bool m_factorized = false;
+
+    std::vector<MatrixType::StorageIndex> m_outerIndex;       ///< Outer index of the analyzed pattern
+    std::vector<MatrixType::StorageIndex> m_innerIndex;       ///< Inner index of the analyzed pattern
+    std::vector<double>                   m_factorizedValues; ///< Values of the factorized matrix, compressed matrices only
+
+    Eigen::SparseMatrix<double> m_updateLeft;   ///< L of the update L R^T
+    SparseMatrixd               m_updateRight;  ///< R^T of the update L R^T
+    Matrixd                     m_updateSolved; ///< Factorized matrix solved for L
+    Eigen::FullPivLU<Matrixd>   m_capacitance;  ///< I + R^T A^-1 L
+
+    size_t m_numPatternAnalyses = 0;
+    size_t m_numFactorizations  = 0;
 };
-} // namespace imstk
\ No newline at end of file
+} // namespace imstk
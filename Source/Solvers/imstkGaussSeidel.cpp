@@ -5,6 +5,7 @@
 */
 
 #include "imstkGaussSeidel.h"
+#include "imstkLinearProjectionConstraint.h"
 #include "imstkLogger.h"
 
 namespace imstk
@@ -23,14 +24,7 @@ GaussSeidel::solve(Vectord& x)
         return;
     }
 
-    if (!m_FixedLinearProjConstraints)
-    {
-        this->gaussSeidelSolve(x);
-    }
-    else
-    {
-        // Do nothing for now!
-    }
+    this->gaussSeidelSolve(x);
 }
 
 void
@@ -45,34 +39,19 @@ GaussSeidel::gaussSeidelSolve(Vectord& x)
 {
     const auto& b = m_linearSystem->getRHSVector();
     const auto& A = m_linearSystem->getMatrix();
+    this->gatherLinearProjections(m_FixedLinearProjConstraints, m_DynamicLinearProjConstraints, A.outerSize());
 
-    // Set the initial guess to zero
-    x.setZero();
+    // Set the initial guess to zero, projected nodes to their values
+    x.setZero(b.size());
+    this->applyLinearProjections(x);
 
     auto   xOld    = x;
     size_t iterNum = 0;
     while (iterNum < this->getMaxNumIterations())
     {
-        for (auto k = 0; k < A.outerSize(); ++k)
-        {
-            double diagEle   = 0.;
-            double aggregate = 0.;
-            for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
-            {
-                auto col = it.col();
-                if (k != col)
-                {
-                    aggregate += it.value() * x[col];
-                }
-                else
-                {
-                    diagEle = it.value();
-                }
-            }
-            x[k] = (b[k] - aggregate) / diagEle; // div by zero is possible!
-        }
-
-        if ((x - xOld).norm() < 1.0e-4)
+        this->gaussSeidelSweep(A, b, x, 1.0);
+        this->projectedNodeSweep(A, b, x, x, 1.0);
+        if ((x - xOld).norm() < m_tolerance)
         {
             return;
         }
@@ -15,7 +15,8 @@ class LinearProjectionConstraint;
 ///
 /// \class GaussSeidel
 ///
-/// \brief Gauss-Seidel sparse linear solver
+/// \brief Gauss-Seidel sparse linear solver. In parallel the rows are relaxed by colors,
+/// nodes with a linear projection are relaxed as 3x3 blocks within their projection
 ///
 class GaussSeidel : public IterativeLinearSolver
 {
@@ -5,8 +5,12 @@
 */
 
 #include "imstkIterativeLinearSolver.h"
+#include "imstkLinearProjectionConstraint.h"
 #include "imstkLogger.h"
 #include "imstkMacros.h"
+#include "imstkParallelUtils.h"
+
+#include <algorithm>
 
 namespace imstk
 {
@@ -76,4 +80,216 @@ IterativeLinearSolver::solve(Vectord& imstkNotUsed(x))
     }
     */
 }
-} // namespace imstk
\ No newline at end of file
+
+void
+IterativeLinearSolver::updateRowColors(const SparseMatrixd& A)
+{
+    using Index = SparseMatrixd::StorageIndex;
+
+    // Only compressed matrices are compared, others are colored every time
+    const Index* outerIndex = A.outerIndexPtr();
+    const Index* innerIndex = A.innerIndexPtr();
+    if (A.isCompressed()
+        && m_coloredOuterIndex.size() == static_cast<size_t>(A.outerSize() + 1)
+        && m_coloredInnerIndex.size() == static_cast<size_t>(A.nonZeros())
+        && std::equal(m_coloredOuterIndex.begin(), m_coloredOuterIndex.end(), outerIndex)
+        && std::equal(m_coloredInnerIndex.begin(), m_coloredInnerIndex.end(), innerIndex))
+    {
+        return;
+    }
+
+    // Rows are coupled through the entries of either, the transpose gives the rows
+    // reading a row
+    const Eigen::SparseMatrix<double, Eigen::ColMajor> At = A;
+
+    // Greedy coloring, each row takes the smallest color none of its coupled rows has
+    std::vector<int> rowColor(static_cast<size_t>(A.outerSize()), -1);
+    std::vector<Index> colorUsedBy;
+    m_rowColors.clear();
+    for (Index k = 0; k < A.outerSize(); k++)
+    {
+        auto markColor = [&](const Index j)
+                         {
+                             if (j != k && rowColor[j] != -1)
+                             {
+                                 colorUsedBy[rowColor[j]] = k;
+                             }
+                         };
+        for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
+        {
+            markColor(static_cast<Index>(it.col()));
+        }
+        for (Eigen::SparseMatrix<double, Eigen::ColMajor>::InnerIterator it(At, k); it; ++it)
+        {
+            markColor(static_cast<Index>(it.row()));
+        }
+
+        int color = 0;
+        while (color < static_cast<int>(colorUsedBy.size()) && colorUsedBy[color] == k)
+        {
+            color++;
+        }
+        if (color == static_cast<int>(colorUsedBy.size()))
+        {
+            colorUsedBy.push_back(-1);
+            m_rowColors.push_back(std::vector<Index>());
+        }
+        rowColor[k] = color;
+        m_rowColors[color].push_back(k);
+    }
+
+    if (A.isCompressed())
+    {
+        m_coloredOuterIndex.assign(outerIndex, outerIndex + A.outerSize() + 1);
+        m_coloredInnerIndex.assign(innerIndex, innerIndex + A.nonZeros());
+    }
+    else
+    {
+        m_coloredOuterIndex.clear();
+        m_coloredInnerIndex.clear();
+    }
+}
+
+void
+IterativeLinearSolver::gatherLinearProjections(const std::vector<LinearProjectionConstraint>* fixedProjections,
+                                               const std::vector<LinearProjectionConstraint>* dynamicProjections,
+                                               const Eigen::Index                             numRows)
+{
+    m_projections.clear();
+    m_projectedRows.assign(static_cast<size_t>(numRows), false);
+    for (const std::vector<LinearProjectionConstraint>* projections : { fixedProjections, dynamicProjections })
+    {
+        if (projections == nullptr)
+        {
+            continue;
+        }
+        for (const LinearProjectionConstraint& projection : *projections)
+        {
+            m_projections.push_back(&projection);
+            const size_t row = 3 * projection.getNodeId();
+            m_projectedRows[row]     = true;
+            m_projectedRows[row + 1] = true;
+            m_projectedRows[row + 2] = true;
+        }
+    }
+}
+
+void
+IterativeLinearSolver::gaussSeidelSweep(const SparseMatrixd& A, const Vectord& b, Vectord& x, const double omega)
+{
+    auto relaxRow = [&](const SparseMatrixd::StorageIndex k)
+                    {
+                        if (m_projectedRows[k])
+                        {
+                            return;
+                        }
+                        double diagEle   = 0.;
+                        double aggregate = 0.;
+                        for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
+                        {
+                            auto col = it.col();
+                            if (k != col)
+                            {
+                                aggregate += it.value() * x[col];
+                            }
+                            else
+                            {
+                                diagEle = it.value();
+                            }
+                        }
+                        x[k] = (1.0 - omega) * x[k] + omega * (b[k] - aggregate) / diagEle; // div by zero is possible!
+                    };
+
+    if (m_parallel)
+    {
+        updateRowColors(A);
+        for (const std::vector<SparseMatrixd::StorageIndex>& rows : m_rowColors)
+        {
+            ParallelUtils::parallelFor(rows.size(), [&](const size_t i) { relaxRow(rows[i]); }, rows.size() > 256);
+        }
+    }
+    else
+    {
+        for (SparseMatrixd::StorageIndex k = 0; k < A.outerSize(); ++k)
+        {
+            relaxRow(k);
+        }
+    }
+}
+
+void
+IterativeLinearSolver::jacobiSweep(const SparseMatrixd& A, const Vectord& b, const Vectord& xOld, Vectord& x)
+{
+    ParallelUtils::parallelFor(A.outerSize(),
+        [&](const Eigen::Index k)
+        {
+            if (m_projectedRows[k])
+            {
+                return;
+            }
+            double diagEle   = 0.;
+            double aggregate = 0.;
+            for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
+            {
+                auto col = it.col();
+                if (k != col)
+                {
+                    aggregate += it.value() * xOld[col];
+                }
+                else
+                {
+                    diagEle = it.value();
+                }
+            }
+            x[k] = (b[k] - aggregate) / diagEle; // div by zero is possible!
+        }, m_parallel && A.outerSize() > 256);
+}
+
+void
+IterativeLinearSolver::projectedNodeSweep(const SparseMatrixd& A, const Vectord& b, const Vectord& xRead, Vectord& x, const double omega)
+{
+    for (const LinearProjectionConstraint* projection : m_projections)
+    {
+        const SparseMatrixd::StorageIndex row = static_cast<SparseMatrixd::StorageIndex>(3 * projection->getNodeId());
+        const Mat3d&                      P   = projection->getProjector();
+
+        // Residual and diagonal block of the node
+        Vec3d residual = b.segment<3>(row);
+        Mat3d block    = Mat3d::Zero();
+        for (int i = 0; i < 3; i++)
+        {
+            for (SparseMatrixd::InnerIterator it(A, row + i); it; ++it)
+            {
+                residual[i] -= it.value() * xRead[it.col()];
+                if (it.col() >= row && it.col() < row + 3)
+                {
+                    block(i, it.col() - row) = it.value();
+                }
+            }
+        }
+
+        // Solve the block within the range of the projection, P A P d = P r
+        Mat3d       inverse;
+        bool        invertible = false;
+        const Mat3d reduced    = P * block * P + (Mat3d::Identity() - P);
+        reduced.computeInverseWithCheck(inverse, invertible);
+        Vec3d xNode = xRead.segment<3>(row);
+        if (invertible)
+        {
+            xNode += omega * (inverse * (P * residual));
+        }
+        x.segment<3>(row) = P * xNode + (Mat3d::Identity() - P) * projection->getValue();
+    }
+}
+
+void
+IterativeLinearSolver::applyLinearProjections(Vectord& x) const
+{
+    for (const LinearProjectionConstraint* projection : m_projections)
+    {
+        const size_t row = 3 * projection->getNodeId();
+        const Mat3d& P   = projection->getProjector();
+        x.segment<3>(row) = P * x.segment<3>(row) + (Mat3d::Identity() - P) * projection->getValue();
+    }
+}
+} // namespace imstk
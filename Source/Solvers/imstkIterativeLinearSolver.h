@@ -10,6 +10,8 @@
 
 namespace imstk
 {
+class LinearProjectionConstraint;
+
 ///
 /// \class IterativeLinearSolver
 ///
@@ -61,8 +63,66 @@ public:
         return true;
     }
 
+    ///
+    /// \brief Set/Get whether the sweeps of the stationary methods run in parallel.
+    /// Gauss-Seidel style sweeps then relax the rows by colors, no two rows of a color
+    /// being coupled, instead of in order. Off by default, the serial sweeps keep the
+    /// row order
+    ///
+    void setParallel(const bool parallel) { m_parallel = parallel; }
+    bool getParallel() const { return m_parallel; }
+
+    ///
+    /// \brief Get the number of row colors of the last colored matrix
+    ///
+    size_t getNumRowColors() const { return m_rowColors.size(); }
+
 protected:
+    ///
+    /// \brief Color the rows of \p A so that no two rows of a color are coupled in either
+    /// direction. Only redone when the pattern of \p A changes
+    ///
+    void updateRowColors(const SparseMatrixd& A);
+
+    ///
+    /// \brief Gather the nodes with a linear projection, their rows are left out of the
+    /// row sweeps and relaxed as 3x3 blocks within their projection instead
+    ///
+    void gatherLinearProjections(const std::vector<LinearProjectionConstraint>* fixedProjections,
+                                 const std::vector<LinearProjectionConstraint>* dynamicProjections,
+                                 const Eigen::Index                             numRows);
+
+    ///
+    /// \brief Gauss-Seidel sweep with relaxation \p omega over the rows without projection,
+    /// each row reading the latest \p x
+    ///
+    void gaussSeidelSweep(const SparseMatrixd& A, const Vectord& b, Vectord& x, const double omega);
+
+    ///
+    /// \brief Jacobi sweep over the rows without projection, reading \p xOld only
+    ///
+    void jacobiSweep(const SparseMatrixd& A, const Vectord& b, const Vectord& xOld, Vectord& x);
+
+    ///
+    /// \brief Relax the projected nodes with residuals of \p xRead, the update of a node
+    /// is the solution of its diagonal block within the projection
+    ///
+    void projectedNodeSweep(const SparseMatrixd& A, const Vectord& b, const Vectord& xRead, Vectord& x, const double omega);
+
+    ///
+    /// \brief Set the values of the projected nodes in \p x, x = P x + (I - P) v
+    ///
+    void applyLinearProjections(Vectord& x) const;
+
     size_t  m_maxIterations = 100;  ///< Maximum number of iterations to be performed.
     Vectord m_residual;             ///< Storage for residual vector.
+
+    bool m_parallel = false;                                           ///< Sweep rows in parallel
+    std::vector<std::vector<SparseMatrixd::StorageIndex>> m_rowColors; ///< Rows of each color
+    std::vector<SparseMatrixd::StorageIndex> m_coloredOuterIndex;      ///< Outer index of the colored pattern
+    std::vector<SparseMatrixd::StorageIndex> m_coloredInnerIndex;      ///< Inner index of the colored pattern
+
+    std::vector<const LinearProjectionConstraint*> m_projections;      ///< Projections of the current solve
+    std::vector<bool> m_projectedRows;                                 ///< Whether a row belongs to a projected node
 };
 } // namespace imstk
\ No newline at end of file
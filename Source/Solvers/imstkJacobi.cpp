@@ -24,14 +24,7 @@ Jacobi::solve(Vectord& x)
         return;
     }
 
-    if (m_FixedLinearProjConstraints->size() == 0)
-    {
-        this->JacobiSolve(x);
-    }
-    else
-    {
-        // Do nothing for now!
-    }
+    this->JacobiSolve(x);
 }
 
 void
@@ -46,34 +39,19 @@ Jacobi::JacobiSolve(Vectord& x)
 {
     const auto& b = m_linearSystem->getRHSVector();
     const auto& A = m_linearSystem->getMatrix();
+    this->gatherLinearProjections(m_FixedLinearProjConstraints, m_DynamicLinearProjConstraints, A.outerSize());
 
-    // Set the initial guess to zero
-    x.setZero();
+    // Set the initial guess to zero, projected nodes to their values
+    x.setZero(b.size());
+    this->applyLinearProjections(x);
 
     auto   xOld    = x;
     size_t iterNum = 0;
     while (iterNum < this->getMaxNumIterations())
     {
-        for (auto k = 0; k < A.outerSize(); ++k)
-        {
-            double diagEle   = 0.;
-            double aggregate = 0.;
-            for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
-            {
-                auto col = it.col();
-                if (k != col)
-                {
-                    aggregate += it.value() * xOld[col];
-                }
-                else
-                {
-                    diagEle = it.value();
-                }
-            }
-            x[k] = (b[k] - aggregate) / diagEle; // div by zero is possible!
-        }
-
-        if ((x - xOld).norm() < 1.0e-4)
+        this->jacobiSweep(A, b, xOld, x);
+        this->projectedNodeSweep(A, b, xOld, x, 1.0);
+        if ((x - xOld).norm() < m_tolerance)
         {
             return;
         }
@@ -15,7 +15,8 @@ class LinearProjectionConstraint;
 ///
 /// \class Jacobi
 ///
-/// \brief Jacobi sparse linear solver
+/// \brief Jacobi sparse linear solver, rows are relaxed in parallel. Nodes with a linear
+/// projection are relaxed as 3x3 blocks within their projection
 ///
 class Jacobi : public IterativeLinearSolver
 {
@@ -27,6 +27,7 @@ public:
     {
         ConjugateGradient,
         LUFactorization,
+        LDLTFactorization,
         GaussSeidel,
         SuccessiveOverRelaxation,
         Jacobi,
@@ -98,9 +98,15 @@ NewtonSolver<SystemMatrix>::solve()
 
     size_t      iterNum;
     const auto& u      = this->m_nonLinearSystem->getUnknownVector();
-    Vectord     du     = u; // make this a class member in future
     double      error0 = MAX_D;
 
+    // The update is kept so a warm started linear solver starts from the last one
+    Vectord& du = m_du;
+    if (du.size() != u.size())
+    {
+        du.setZero(u.size());
+    }
+
     double epsilon = m_relativeTolerance * m_relativeTolerance;
     for (iterNum = 0; iterNum < m_maxIterations; ++iterNum)
     {
@@ -208,5 +208,6 @@ private:
     size_t m_maxIterations;                           ///< Maximum number of nonlinear iterations
     bool   m_useArmijo;                               ///< True if Armijo liner search is desired
     std::vector<double> m_fnorms;                     ///< Consecutive function norms
+    Vectord m_du;                                     ///< Update of the last solve, warm start of the linear solver
 };
 } // namespace imstk
\ No newline at end of file
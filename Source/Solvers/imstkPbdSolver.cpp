@@ -5,11 +5,14 @@
 */
 
 #include "imstkPbdSolver.h"
+#include "imstkCsrGraph.h"
 #include "imstkLogger.h"
 #include "imstkParallelUtils.h"
 #include "imstkPbdCollisionConstraint.h"
 #include "imstkPbdConstraintContainer.h"
 
+#include <algorithm>
+
 namespace imstk
 {
 PbdSolver::PbdSolver() :
@@ -18,6 +21,112 @@ PbdSolver::PbdSolver() :
 {
 }
 
+void
+PbdSolver::compileConstraints()
+{
+    if (m_compiledContainer == m_constraints.get() && m_compiledVersion == m_constraints->getVersion())
+    {
+        return;
+    }
+
+    // Constraints of sleeping bodies are left out, a subset of a partition is still independent
+    const PbdConstraintContainer&                      container   = *m_constraints;
+    const std::vector<std::shared_ptr<PbdConstraint>>& constraints = container.getConstraints();
+    m_compiledConstraints.clear();
+    for (const auto& constraint : constraints)
+    {
+        if (!isSleeping(constraint->getParticles()))
+        {
+            m_compiledConstraints.push_back(constraint.get());
+        }
+    }
+
+    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = container.getPartitionedConstraints();
+    m_compiledPartitions.clear();
+    m_compiledPartitionOffsets.assign(1, 0);
+    for (const auto& constraintPartition : partitionedConstraints)
+    {
+        for (const auto& constraint : constraintPartition)
+        {
+            if (!isSleeping(constraint->getParticles()))
+            {
+                m_compiledPartitions.push_back(constraint.get());
+            }
+        }
+        m_compiledPartitionOffsets.push_back(m_compiledPartitions.size());
+    }
+
+    m_compiledBlocks.clear();
+    for (const auto& block : container.getConstraintBlocks())
+    {
+        if (!isSleeping(block->getParticles()))
+        {
+            m_compiledBlocks.push_back(block.get());
+        }
+    }
+
+    m_compiledContainer = m_constraints.get();
+    m_compiledVersion   = m_constraints->getVersion();
+    m_numCompiles++;
+}
+
+void
+PbdSolver::colorConstraintLists()
+{
+    m_coloredConstraintLists.resize(std::count(m_constraintListModes.begin(), m_constraintListModes.end(),
+        ConstraintListMode::Colored));
+
+    size_t coloredIdx = 0;
+    auto   modeIter   = m_constraintListModes.begin();
+    for (auto constraintList : *m_constraintLists)
+    {
+        if (*modeIter++ != ConstraintListMode::Colored)
+        {
+            continue;
+        }
+        const std::vector<PbdConstraint*>& constraintVec = *constraintList;
+        ColoredConstraintList&             coloredList   = m_coloredConstraintLists[coloredIdx++];
+
+        // Constraints are adjacent when they share a (body, particle)
+        std::vector<size_t> keyOffsets(constraintVec.size() + 1, 0);
+        for (size_t j = 0; j < constraintVec.size(); j++)
+        {
+            keyOffsets[j + 1] = keyOffsets[j] + constraintVec[j]->getParticles().size();
+        }
+        std::vector<size_t> keys(keyOffsets.back());
+        for (size_t j = 0; j < constraintVec.size(); j++)
+        {
+            size_t keyIdx = keyOffsets[j];
+            for (const PbdParticleId& pid : constraintVec[j]->getParticles())
+            {
+                keys[keyIdx++] = PbdConstraintContainer::getParticleKey(pid);
+            }
+        }
+
+        CsrGraph constraintGraph;
+        constraintGraph.buildFromSharedKeys(keyOffsets, keys);
+        const CsrGraph::graphColorsType coloring = constraintGraph.doColoring();
+        const std::vector<unsigned short>& colors = coloring.first;
+
+        // Counting sort of the constraints by color, keeping their order within a color
+        coloredList.colorOffsets.assign(static_cast<size_t>(coloring.second) + 1, 0);
+        for (const unsigned short color : colors)
+        {
+            coloredList.colorOffsets[color + 1]++;
+        }
+        for (size_t k = 0; k < coloring.second; k++)
+        {
+            coloredList.colorOffsets[k + 1] += coloredList.colorOffsets[k];
+        }
+        std::vector<size_t> writeIds(coloredList.colorOffsets.begin(), coloredList.colorOffsets.end() - 1);
+        coloredList.constraints.resize(constraintVec.size());
+        for (size_t j = 0; j < constraintVec.size(); j++)
+        {
+            coloredList.constraints[writeIds[colors[j]]++] = constraintVec[j];
+        }
+    }
+}
+
 void
 PbdSolver::solve()
 {
@@ -26,28 +135,37 @@ PbdSolver::solve()
         m_dataTracker->getStopWatch(DataTracker::ePhysics::SolverTime_ms).start();
     }
 
-    size_t                                                          numConstraints = 0;
-    const std::vector<std::shared_ptr<PbdConstraint>>&              constraints    = m_constraints->getConstraints();
-    const std::vector<std::vector<std::shared_ptr<PbdConstraint>>>& partitionedConstraints = m_constraints->getPartitionedConstraints();
+    compileConstraints();
+    colorConstraintLists();
+
+    size_t                                  numConstraints   = 0;
+    const std::vector<PbdConstraint*>&      constraints      = m_compiledConstraints;
+    const std::vector<PbdConstraint*>&      partitions       = m_compiledPartitions;
+    const size_t                            numPartitions    = m_compiledPartitionOffsets.size() - 1;
+    const std::vector<PbdConstraintBlock*>& constraintBlocks = m_compiledBlocks;
 
     double averageC      = 0.0;
     double averageLambda = 0.0;
     numConstraints += constraints.size();
     // Zero out the Lagrange multiplier
-    for (const auto& constraint : constraints)
+    for (PbdConstraint* constraint : constraints)
     {
         constraint->zeroOutLambda();
     }
 
     // Zero out paritioned constraints
-    for (const auto& constraintPartition : partitionedConstraints)
+    numConstraints += partitions.size();
+    ParallelUtils::parallelFor(partitions.size(),
+        [&](const size_t idx)
+        {
+            partitions[idx]->zeroOutLambda();
+        });
+
+    // Zero out constraint blocks
+    for (const auto& block : constraintBlocks)
     {
-        numConstraints += constraints.size();
-        ParallelUtils::parallelFor(constraintPartition.size(),
-            [&](const size_t idx)
-            {
-                constraintPartition[idx]->zeroOutLambda();
-            });
+        numConstraints += block->size();
+        block->zeroOutLambdas();
     }
 
     // Zero out insertion/collision constraints
@@ -65,33 +183,54 @@ PbdSolver::solve()
     while (i++ < m_iterations)
     {
         // Project collision and all external constraints
+        size_t coloredIdx = 0;
+        auto   modeIter   = m_constraintListModes.begin();
         for (auto constraintList : *m_constraintLists)
         {
-            const std::vector<PbdConstraint*>& constraintVec = *constraintList;
-            for (size_t j = 0; j < constraintVec.size(); j++)
+            if (*modeIter++ == ConstraintListMode::Colored)
             {
-                constraintVec[j]->projectConstraint(*m_state, m_dt, m_solverType);
+                // Colors in sequence, constraints of a color in parallel
+                const ColoredConstraintList& coloredList = m_coloredConstraintLists[coloredIdx++];
+                for (size_t k = 0; k < coloredList.colorOffsets.size() - 1; k++)
+                {
+                    PbdConstraint* const* constraintColor = coloredList.constraints.data() + coloredList.colorOffsets[k];
+                    ParallelUtils::parallelFor(coloredList.colorOffsets[k + 1] - coloredList.colorOffsets[k],
+                        [&](const size_t idx)
+                        {
+                            constraintColor[idx]->projectConstraint(*m_state, m_dt, m_solverType);
+                        });
+                }
+            }
+            else
+            {
+                const std::vector<PbdConstraint*>& constraintVec = *constraintList;
+                for (size_t j = 0; j < constraintVec.size(); j++)
+                {
+                    constraintVec[j]->projectConstraint(*m_state, m_dt, m_solverType);
+                }
             }
         }
 
         // Project all internal body constraints
-        for (const auto& constraint : constraints)
+        for (PbdConstraint* constraint : constraints)
         {
             constraint->projectConstraint(*m_state, m_dt, m_solverType);
         }
 
-        for (const auto& constraintPartition : partitionedConstraints)
+        for (size_t k = 0; k < numPartitions; k++)
         {
-            ParallelUtils::parallelFor(constraintPartition.size(),
+            PbdConstraint* const* constraintPartition = partitions.data() + m_compiledPartitionOffsets[k];
+            ParallelUtils::parallelFor(m_compiledPartitionOffsets[k + 1] - m_compiledPartitionOffsets[k],
                 [&](const size_t idx)
                 {
                     constraintPartition[idx]->projectConstraint(*m_state, m_dt, m_solverType);
                 });
-            //// Sequential
-            //for (size_t k = 0; k < constraintPartition.size(); k++)
-            //{
-            //    constraintPartition[k]->projectConstraint(invMasses, m_dt, m_solverType, currPositions);
-            //}
+        }
+
+        // Project all structure-of-arrays constraint blocks, one call per block
+        for (const auto& block : constraintBlocks)
+        {
+            block->projectConstraints(*m_state, m_dt, m_solverType);
         }
     }
 
@@ -100,18 +239,24 @@ PbdSolver::solve()
         m_dataTracker->probeElapsedTime_s(DataTracker::ePhysics::SolverTime_ms);
         m_dataTracker->probe(DataTracker::ePhysics::NumConstraints, numConstraints);
 
-        for (const auto& constraint : constraints)
+        for (PbdConstraint* constraint : constraints)
+        {
+            averageC      += constraint->getConstraintC();
+            averageLambda += constraint->getLambda();
+        }
+
+        for (PbdConstraint* constraint : partitions)
         {
             averageC      += constraint->getConstraintC();
             averageLambda += constraint->getLambda();
         }
 
-        for (const auto& constraintPartition : partitionedConstraints)
+        for (const auto& block : constraintBlocks)
         {
-            for (size_t k = 0; k < constraintPartition.size(); k++)
+            for (size_t k = 0; k < block->size(); k++)
             {
-                averageC      += constraintPartition[k]->getConstraintC();
-                averageLambda += constraintPartition[k]->getLambda();
+                averageC      += block->getConstraintC(k);
+                averageLambda += block->getLambda(k);
             }
         }
 
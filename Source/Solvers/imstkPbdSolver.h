@@ -11,6 +11,7 @@
 
 namespace imstk
 {
+class PbdConstraintBlock;
 class PbdConstraintContainer;
 
 ///
@@ -19,9 +20,22 @@ class PbdConstraintContainer;
 /// \brief Position Based Dynamics solver
 /// This solver can solve both partitioned constraints (unordered_set of vector'd constraints) in parallel
 /// and sequentially on vector'd constraints. It requires a set of constraints, positions, and invMasses.
+/// Constraint blocks of the container are projected block by block with a batched, non-virtual loop.
+/// Constraints of sleeping bodies are left out of the solve.
 ///
 class PbdSolver : public SolverBase
 {
+public:
+    ///
+    /// \brief How a constraint list given with addConstraints is projected
+    ///
+    enum class ConstraintListMode
+    {
+        Serial = 0, ///< One constraint after another in the order of the list
+        Colored     ///< Colored every solve such that no two constraints of a color share
+                    ///< a particle, then the constraints of each color are projected in parallel
+    };
+
 public:
     PbdSolver();
     ~PbdSolver() override = default;
@@ -35,15 +49,26 @@ public:
     /// \brief Sets the constraints the solver should solve for
     /// These wil be solved sequentially
     ///
-    void setConstraints(std::shared_ptr<PbdConstraintContainer> constraints) { this->m_constraints = constraints; }
+    void setConstraints(std::shared_ptr<PbdConstraintContainer> constraints)
+    {
+        // Edits of the same container are caught by its version
+        if (constraints != m_constraints)
+        {
+            this->m_constraints = constraints;
+            m_compiledContainer = nullptr;
+        }
+    }
 
     ///
     /// \brief Add a constraint list to this solver to be solved, for quick addition/removal
-    /// particularly collision.
+    /// particularly collision. Colored lists converge like the serial ones but order
+    /// of projection is lost, precision critical lists may prefer to stay serial
     ///
-    void addConstraints(std::vector<PbdConstraint*>* constraints)
+    void addConstraints(std::vector<PbdConstraint*>* constraints,
+                        const ConstraintListMode mode = ConstraintListMode::Serial)
     {
         m_constraintLists->push_back(constraints);
+        m_constraintListModes.push_back(mode);
     }
 
     ///
@@ -56,6 +81,21 @@ public:
     ///
     void setTimeStep(const double dt) { m_dt = dt; }
 
+    ///
+    /// \brief Set which bodies sleep, by index in the PbdState. Constraints of the container
+    /// whose first particle is of a sleeping body are not projected, constraints are expected
+    /// to only connect bodies that sleep together (see PbdModel islands). Constraint lists are
+    /// always projected
+    ///
+    void setSleepingBodies(const std::vector<bool>& sleepingBodies)
+    {
+        if (sleepingBodies != m_sleepingBodies)
+        {
+            m_sleepingBodies    = sleepingBodies;
+            m_compiledContainer = nullptr;
+        }
+    }
+
     ///
     /// \brief Get Iterations. Returns current nonlinear iterations.
     ///
@@ -71,6 +111,12 @@ public:
     ///
     void solve() override;
 
+    ///
+    /// \brief Get the number of times the constraints of the container were gathered
+    /// for solving, only changes of the container or of the sleeping bodies regather them
+    ///
+    size_t getNumCompiles() const { return m_numCompiles; }
+
     ///
     /// \brief Get all the collision constraints, read only
     ///
@@ -79,7 +125,33 @@ public:
     ///
     /// \brief Clear all collision constraints
     ///
-    void clearConstraintLists() { m_constraintLists->clear(); }
+    void clearConstraintLists()
+    {
+        m_constraintLists->clear();
+        m_constraintListModes.clear();
+    }
+
+private:
+    ///
+    /// \brief Gathers raw pointers to the constraints of the container so solve
+    /// doesn't copy the container (and touch every shared_ptr refcount) each step.
+    /// Only rebuilt when the version of the container changes
+    ///
+    void compileConstraints();
+
+    ///
+    /// \brief Returns if the body of the first particle of a constraint sleeps
+    ///
+    bool isSleeping(const std::vector<PbdParticleId>& particles) const
+    {
+        return !particles.empty() && static_cast<size_t>(particles[0].first) < m_sleepingBodies.size()
+               && m_sleepingBodies[particles[0].first];
+    }
+
+    ///
+    /// \brief Colors the constraint lists added in ConstraintListMode::Colored
+    ///
+    void colorConstraintLists();
 
 private:
     size_t m_iterations = 20;                                        ///< Number of NL Gauss-Seidel iterations for constraints
@@ -87,8 +159,31 @@ private:
 
     std::shared_ptr<PbdConstraintContainer> m_constraints = nullptr; ///< Vector of constraints
 
+    ///< Non-owning snapshot of m_constraints, valid while its version is m_compiledVersion
+    const PbdConstraintContainer* m_compiledContainer = nullptr;
+    size_t m_compiledVersion = 0;
+    size_t m_numCompiles     = 0;
+    std::vector<PbdConstraint*> m_compiledConstraints;      ///< Sequential constraints
+    std::vector<PbdConstraint*> m_compiledPartitions;       ///< Partitioned constraints, one partition after another
+    std::vector<size_t>         m_compiledPartitionOffsets; ///< Start of every partition in m_compiledPartitions, numPartitions+1 long
+    std::vector<PbdConstraintBlock*> m_compiledBlocks;      ///< Constraint blocks
+    std::vector<bool> m_sleepingBodies;                     ///< Bodies whose constraints are left out when compiling
+
     ///< For quick addition
     std::shared_ptr<std::list<std::vector<PbdConstraint*>*>> m_constraintLists = nullptr;
+    std::vector<ConstraintListMode> m_constraintListModes;       ///< Mode of every list of m_constraintLists
+
+    ///
+    /// \struct ColoredConstraintList
+    ///
+    /// \brief Constraints of a colored list sorted by color
+    ///
+    struct ColoredConstraintList
+    {
+        std::vector<PbdConstraint*> constraints;
+        std::vector<size_t> colorOffsets; ///< Start of every color in constraints, numColors+1 long
+    };
+    std::vector<ColoredConstraintList> m_coloredConstraintLists; ///< One per colored list, in order
 
     PbdState* m_state = nullptr;
     PbdConstraint::SolverType m_solverType = PbdConstraint::SolverType::xPBD;
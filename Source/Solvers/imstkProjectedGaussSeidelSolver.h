@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include "imstkGraph.h"
 #include "imstkMath.h"
+#include "imstkParallelFor.h"
+
+#include <algorithm>
 
 namespace imstk
 {
@@ -15,7 +19,7 @@ namespace imstk
 ///
 /// \brief Solves a linear system using the projected gauss seidel method.
 /// Only good for diagonally dominant systems, must have elements on diagonals though.
-/// The initial guess (start) is always zero, convergence value may be specified
+/// The initial guess (start) is zero unless one is given with setGuess, convergence value may be specified
 /// with epsilon, relaxation decreases the step size (useful when may rows exist in
 /// A)
 ///
@@ -23,8 +27,16 @@ template<typename Scalar>
 class ProjectedGaussSeidelSolver
 {
 public:
-    // Sets the vector to be used for the solve
-    //void setGuess(Matrix<Scalar, -1, 1>& g) { x = g; }
+    ///
+    /// \brief Sets the initial guess used by the next solve, ie: the previous
+    /// solution for warm starting. Ignored if its size doesn't match b
+    ///
+    void setGuess(const Eigen::Matrix<Scalar, -1, 1>& g)
+    {
+        m_x = g;
+        m_useGuess = true;
+    }
+
     void setA(Eigen::SparseMatrix<Scalar>* A) { this->m_A = A; }
 
     ///
@@ -48,65 +60,177 @@ public:
     ///
     const double getEnergy() const { return m_conv; }
 
+    ///
+    /// \brief Get/Set whether rows are swept in parallel. Rows are coloured such
+    /// that no two rows of a colour are coupled in A (ie: share a body), colours
+    /// are swept in order and the rows of a colour in parallel. The colouring is
+    /// cached until the sparsity pattern of A changes. default false
+    ///@{
+    void setParallel(const bool parallel) { m_parallel = parallel; }
+    bool getParallel() const { return m_parallel; }
+    ///@}
+
     Eigen::Matrix<Scalar, -1, 1>& solve(const Eigen::Matrix<Scalar, -1, 1>& b, const Eigen::Matrix<Scalar, -1, 2>& cu)
     {
-        const Eigen::SparseMatrix<Scalar>& A = *m_A;
+        // Row major so a row's off diagonal sum only visits its stored non-zeros
+        m_Ar = *m_A;
+        const Eigen::SparseMatrix<Scalar, Eigen::RowMajor>& A = m_Ar;
 
-        // Allocate new results
-        m_x = Eigen::Matrix<Scalar, -1, 1>(b.rows());
-        m_x.setZero();
+        // Start from the guess if given, otherwise zero
+        if (!m_useGuess || m_x.size() != b.rows())
+        {
+            m_x.setZero(b.rows());
+        }
+        else
+        {
+            m_x = m_x.cwiseMax(cu.col(0)).cwiseMin(cu.col(1));
+        }
+        m_useGuess = false;
 
-        m_conv = 0.0;
+        m_diag.resize(A.rows());
+        for (Eigen::Index r = 0; r < A.rows(); r++)
+        {
+            // PGS can't converge for non-diagonal elements so its assumed
+            // we have these
+            m_diag[r] = A.coeff(r, r);
+        }
+
+        if (m_parallel)
+        {
+            updateColoring();
+        }
 
-        // Naive implementation of PGS
-        // Consider graph coloring and TBB parallizing
-        Eigen::Matrix<Scalar, -1, 1> xOld;
+        m_conv = 0.0;
         for (unsigned int i = 0; i < m_maxIterations; i++)
         {
-            xOld = m_x;
-            for (Eigen::Index r = 0; r < A.rows(); r++)
+            m_xOld = m_x;
+            if (m_parallel)
             {
-                Scalar delta = 0.0;
-
-                // Sum up rows (skip r)
-                for (Eigen::Index c = 0; c < r; c++)
+                // Rows of a colour don't read each others solution
+                for (size_t j = 0; j + 1 < m_colorOffsets.size(); j++)
                 {
-                    delta += A.coeff(r, c) * m_x[c];
+                    const size_t colorStart = m_colorOffsets[j];
+                    ParallelUtils::parallelFor(colorStart, m_colorOffsets[j + 1],
+                        [&](const size_t k)
+                        {
+                            solveRow(m_colorRows[k], b, cu);
+                        }, m_colorOffsets[j + 1] - colorStart > 50);
                 }
-                for (Eigen::Index c = r + 1; c < A.cols(); c++)
+            }
+            else
+            {
+                for (Eigen::Index r = 0; r < A.rows(); r++)
                 {
-                    delta += A.coeff(r, c) * m_x[c];
+                    solveRow(r, b, cu);
                 }
-
-                // PGS can't converge for non-diagonal elements so its assumed
-                // we have these
-                delta = (b[r] - delta) / A.coeff(r, r);
-                // Apply relaxation factor
-                m_x(r) += m_relaxation * (delta - m_x(r));
-                // Do projection *every iteration*
-                m_x(r) = std::min(cu(r, 1), std::max(cu(r, 0), m_x(r)));
             }
 
             // Check convergence
-            m_conv = (m_x - xOld).norm();
-            //printf(" %d: %f\n", i, m_conv);
+            m_conv = (m_x - m_xOld).norm();
             if (m_conv < m_epsilon)
             {
-                //printf("Eps: %f\n", conv);
                 return m_x;
             }
         }
 
-        //printf("Eps: %f\n", conv);
         return m_x;
     }
 
+protected:
+    ///
+    /// \brief Relax and project a single row
+    ///
+    void solveRow(const Eigen::Index r, const Eigen::Matrix<Scalar, -1, 1>& b, const Eigen::Matrix<Scalar, -1, 2>& cu)
+    {
+        // Sum up row (skip r)
+        Scalar delta = 0.0;
+        for (typename Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it(m_Ar, r); it; ++it)
+        {
+            if (it.col() != r)
+            {
+                delta += it.value() * m_x[it.col()];
+            }
+        }
+
+        delta = (b[r] - delta) / m_diag[r];
+        // Apply relaxation factor
+        m_x(r) += m_relaxation * (delta - m_x(r));
+        // Do projection *every iteration*
+        m_x(r) = std::min(cu(r, 1), std::max(cu(r, 0), m_x(r)));
+    }
+
+    ///
+    /// \brief Colour the rows of A such that coupled rows differ in colour,
+    /// only recomputed when the sparsity pattern changes
+    ///
+    void updateColoring()
+    {
+        const Eigen::Index rows = m_Ar.rows();
+        const Eigen::Index nnz  = m_Ar.nonZeros();
+        const auto* const  outerPtr = m_Ar.outerIndexPtr();
+        const auto* const  innerPtr = m_Ar.innerIndexPtr();
+        if (!m_colorOffsets.empty()
+            && m_colorOuterIndices.size() == static_cast<size_t>(rows + 1)
+            && m_colorInnerIndices.size() == static_cast<size_t>(nnz)
+            && std::equal(m_colorOuterIndices.begin(), m_colorOuterIndices.end(), outerPtr)
+            && std::equal(m_colorInnerIndices.begin(), m_colorInnerIndices.end(), innerPtr))
+        {
+            return;
+        }
+        m_colorOuterIndices.assign(outerPtr, outerPtr + rows + 1);
+        m_colorInnerIndices.assign(innerPtr, innerPtr + nnz);
+
+        // Each edge represents a non-zero coupling two rows
+        Graph rowGraph(static_cast<size_t>(rows));
+        for (Eigen::Index r = 0; r < rows; r++)
+        {
+            for (typename Eigen::SparseMatrix<Scalar, Eigen::RowMajor>::InnerIterator it(m_Ar, r); it; ++it)
+            {
+                if (it.col() > r)
+                {
+                    rowGraph.addEdge(static_cast<size_t>(r), static_cast<size_t>(it.col()));
+                }
+            }
+        }
+
+        const auto                         coloring  = rowGraph.doColoring(Graph::ColoringMethod::WelshPowell);
+        const std::vector<unsigned short>& colors    = coloring.first;
+        const size_t                       numColors = static_cast<size_t>(coloring.second);
+
+        // Bucket the rows by colour
+        m_colorOffsets.assign(numColors + 1, 0);
+        for (const unsigned short color : colors)
+        {
+            m_colorOffsets[color + 1]++;
+        }
+        for (size_t i = 0; i < numColors; i++)
+        {
+            m_colorOffsets[i + 1] += m_colorOffsets[i];
+        }
+        m_colorRows.resize(colors.size());
+        std::vector<size_t> fill(m_colorOffsets.begin(), m_colorOffsets.end() - 1);
+        for (size_t r = 0; r < colors.size(); r++)
+        {
+            m_colorRows[fill[colors[r]]++] = static_cast<Eigen::Index>(r);
+        }
+    }
+
 private:
     unsigned int m_maxIterations = 3;
     Scalar       m_relaxation    = static_cast<Scalar>(0.1);
     Scalar       m_epsilon       = 1.0e-4; ///< Convergence criteria
     Scalar       m_conv = 0.0;
     Eigen::Matrix<Scalar, -1, 1> m_x;      ///< Results
+    Eigen::Matrix<Scalar, -1, 1> m_xOld;   ///< Results of the previous iteration
+    Eigen::Matrix<Scalar, -1, 1> m_diag;   ///< Diagonal of A
     Eigen::SparseMatrix<Scalar>* m_A = nullptr;
+    Eigen::SparseMatrix<Scalar, Eigen::RowMajor> m_Ar; ///< Row major copy of A
+    bool m_useGuess = false;
+    bool m_parallel = false;
+
+    std::vector<Eigen::Index> m_colorRows;         ///< Rows sorted by colour
+    std::vector<size_t>       m_colorOffsets;      ///< Start of every colour in m_colorRows
+    std::vector<int>          m_colorOuterIndices; ///< Sparsity pattern the colouring was computed for
+    std::vector<int>          m_colorInnerIndices;
 };
-} // namespace imstk
\ No newline at end of file
+} // namespace imstk
@@ -24,14 +24,7 @@ SOR::solve(Vectord& x)
         return;
     }
 
-    if (m_FixedLinearProjConstraints->size() == 0)
-    {
-        this->SORSolve(x);
-    }
-    else
-    {
-        // Do nothing for now!
-    }
+    this->SORSolve(x);
 }
 
 void
@@ -46,36 +39,19 @@ SOR::SORSolve(Vectord& x)
 {
     const auto& b = m_linearSystem->getRHSVector();
     const auto& A = m_linearSystem->getMatrix();
+    this->gatherLinearProjections(m_FixedLinearProjConstraints, m_DynamicLinearProjConstraints, A.outerSize());
 
-    // Set the initial guess to zero
-    x.setZero();
+    // Set the initial guess to zero, projected nodes to their values
+    x.setZero(b.size());
+    this->applyLinearProjections(x);
 
     auto   xOld    = x;
     size_t iterNum = 0;
     while (iterNum < this->getMaxNumIterations())
     {
-        for (auto k = 0; k < A.outerSize(); ++k)
-        {
-            double diagEle   = 0.;
-            double aggregate = 0.;
-            for (SparseMatrixd::InnerIterator it(A, k); it; ++it)
-            {
-                auto col = it.col();
-                if (k != col)
-                {
-                    aggregate += it.value() * x[col];
-                }
-                else
-                {
-                    diagEle = it.value();
-                }
-            }
-            x[k] = (b[k] - aggregate) / diagEle; // div by zero is possible!
-        }
-        x *= m_relaxationFactor;
-        x += (1. - m_relaxationFactor) * xOld;
-
-        if ((x - xOld).norm() < 1.0e-4)
+        this->gaussSeidelSweep(A, b, x, m_relaxationFactor);
+        this->projectedNodeSweep(A, b, x, x, m_relaxationFactor);
+        if ((x - xOld).norm() < m_tolerance)
         {
             return;
         }
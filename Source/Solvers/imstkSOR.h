@@ -18,7 +18,9 @@ class LinearProjectionConstraint;
 ///
 /// \class SOR
 ///
-/// \brief Successive Over Relaxation (SOR) sparse linear solver
+/// \brief Successive Over Relaxation (SOR) sparse linear solver. In parallel the rows are
+/// relaxed by colors, nodes with a linear projection are relaxed as 3x3 blocks within
+/// their projection
 ///
 class SOR : public IterativeLinearSolver
 {
@@ -5,50 +5,50 @@
 */
 
 %callback("%s_cb");
-/* std::string imstk::KeyboardDeviceClient::keyPress(); */
-std::string KeyboardDeviceClient_getKeyPress();
-std::string Module_getPostUpdate();
-std::string Module_getPreUpdate();
-std::string SceneManager_getPreUpdate();
-std::string SceneManager_getPostUpdate();
+/* imstk::Signal imstk::KeyboardDeviceClient::keyPress(); */
+imstk::Signal KeyboardDeviceClient_getKeyPress();
+imstk::Signal Module_getPostUpdate();
+imstk::Signal Module_getPreUpdate();
+imstk::Signal SceneManager_getPreUpdate();
+imstk::Signal SceneManager_getPostUpdate();
 #ifdef iMSTK_USE_RENDERING_VTK
-std::string VTKViewer_getPreUpdate();
-std::string VTKViewer_getPostUpdate();
+imstk::Signal VTKViewer_getPreUpdate();
+imstk::Signal VTKViewer_getPostUpdate();
 #endif
 %nocallback;
 
 %{
     // The following functions in imstk provide pointer functions
-    // to acquire a string. Here we specify code to wrap that just
-    // directly returns the string
+    // to acquire a signal. Here we specify code to wrap that just
+    // directly returns the signal
     
-    std::string KeyboardDeviceClient_getKeyPress()
+    imstk::Signal KeyboardDeviceClient_getKeyPress()
     {
         return imstk::KeyboardDeviceClient::keyPress();
     }
 
-    std::string Module_getPostUpdate()
+    imstk::Signal Module_getPostUpdate()
     {
         return imstk::Module::postUpdate();
     }
-    std::string Module_getPreUpdate()
+    imstk::Signal Module_getPreUpdate()
     {
         return imstk::Module::preUpdate();
     }
-    std::string SceneManager_getPostUpdate()
+    imstk::Signal SceneManager_getPostUpdate()
     {
         return imstk::SceneManager::postUpdate();
     }
-    std::string SceneManager_getPreUpdate()
+    imstk::Signal SceneManager_getPreUpdate()
     {
         return imstk::SceneManager::preUpdate();
     }
 #ifdef iMSTK_USE_RENDERING_VTK
-    std::string VTKViewer_getPostUpdate()
+    imstk::Signal VTKViewer_getPostUpdate()
     {
         return imstk::VTKViewer::postUpdate();
     }
-    std::string VTKViewer_getPreUpdate()
+    imstk::Signal VTKViewer_getPreUpdate()
     {
         return imstk::VTKViewer::preUpdate();
     }
@@ -951,7 +951,7 @@ EigenType cs2Eigen(const csType& cs_data, EigenType* eigen_data)
             public System.Action<Name> action = null;
         }
 
-        public static void connect##Name (EventObject obj, SWIGTYPE_p_f___std__string arg1, System.Action<Name> action)
+        public static void connect##Name (EventObject obj, SWIGTYPE_p_f___imstk__Signal arg1, System.Action<Name> action)
         {
             Name##FuncImpl func = new Name##FuncImpl(action);
             connect##Name##Internal (obj, arg1, new Name##FuncStd(func));